@@ -0,0 +1,68 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "cdrom/cdriso.h"
+
+// The CHD sectors are addressed the same way as a single bin file holding all
+// of the tracks would be, so the CDDA tracks' start_offset works as-is.
+ssize_t PCSX::CDRIso::cdread_chd(IO<File> f, unsigned int base, void *dest, int sector) {
+    if (sector < 0) return -1;
+    sector += base / IEC60908b::FRAMESIZE_RAW;
+    if (!m_chd->readSector(sector, reinterpret_cast<uint8_t *>(dest))) return -1;
+    return IEC60908b::FRAMESIZE_RAW;
+}
+
+bool PCSX::CDRIso::handlechd(const char *isofile) {
+    m_chd.reset(new CHD(m_cdHandle));
+    if (m_chd->failed()) {
+        PCSX::g_system->printf(_("\nUnable to open CHD image %s: %s\n"), isofile, m_chd->error());
+        m_chd.reset();
+        return false;
+    }
+
+    auto &tracks = m_chd->tracks();
+    if ((tracks.size() + 1) > MAXTRACKS) {
+        PCSX::g_system->printf(_("\nToo many tracks in CHD image %s\n"), isofile);
+        m_chd.reset();
+        return false;
+    }
+
+    // Whatever a stray cue sheet may have said, the CHD metadata is authoritative.
+    for (auto &i : m_ti) {
+        i = {};
+    }
+    m_numtracks = tracks.size();
+    for (unsigned i = 0; i < tracks.size(); i++) {
+        auto &track = tracks[i];
+        auto &ti = m_ti[i + 1];
+        uint32_t storedPregap = track.pregapStored ? track.pregap : 0;
+        ti.type = track.audio ? TrackType::CDDA : TrackType::DATA;
+        ti.pregap = IEC60908b::MSF(track.pregap);
+        ti.start = IEC60908b::MSF(track.lba + storedPregap + 150);
+        ti.length = IEC60908b::MSF(track.frames - storedPregap);
+        ti.start_offset = (track.imageFrame + storedPregap) * IEC60908b::FRAMESIZE_RAW;
+    }
+    // The hunks are shared by all of the tracks, so they all go through the same handle.
+    m_ti[1].handle = m_cdHandle;
+
+    // CD audio is stored big endian in CHD images.
+    m_cddaBigEndian = true;
+    m_cdimg_read_func = &CDRIso::cdread_chd;
+    return true;
+}
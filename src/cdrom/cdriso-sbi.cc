@@ -34,8 +34,9 @@ bool PCSX::CDRIso::LoadSBI(const char *filename) {
     // 4-byte SBI header
     sbihandle->read(buffer, 4);
     while (!sbihandle->eof()) {
-        sbihandle->read(sbitime[sbicount++], 3);
-        sbihandle->read(buffer, 11);
+        sbihandle->read(sbitime[sbicount], 3);
+        sbihandle->read(buffer, 1);
+        sbihandle->read(sbiq[sbicount++], 10);
     }
 
     PCSX::g_system->printf(_("Loaded SBI file: %s.\n"), filename);
@@ -43,15 +44,17 @@ bool PCSX::CDRIso::LoadSBI(const char *filename) {
     return true;
 }
 
-bool PCSX::CDRIso::CheckSBI(const uint8_t *time) {
+bool PCSX::CDRIso::CheckSBI(const uint8_t *time) { return findSBI(time) != nullptr; }
+
+const uint8_t *PCSX::CDRIso::findSBI(const uint8_t *time) {
     int lcv;
 
     // both BCD format
     for (lcv = 0; lcv < sbicount; lcv++) {
-        if (time[0] == sbitime[lcv][0] && time[1] == sbitime[lcv][1] && time[2] == sbitime[lcv][2]) return true;
+        if (time[0] == sbitime[lcv][0] && time[1] == sbitime[lcv][1] && time[2] == sbitime[lcv][2]) return sbiq[lcv];
     }
 
-    return false;
+    return nullptr;
 }
 
 void PCSX::CDRIso::UnloadSBI() { sbicount = 0; }
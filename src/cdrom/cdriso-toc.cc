@@ -117,10 +117,7 @@ bool PCSX::CDRIso::parsetoc(const char *isofileStr) {
             } else {
                 sscanf(linebuf, "DATAFILE \"%[^\"]\" %8s", name, time);
                 m_ti[m_numtracks].length = IEC60908b::MSF(time);
-                m_ti[m_numtracks].handle.setFile(new UvFile(filename / name));
-                if (g_emulator->settings.get<Emulator::SettingFullCaching>()) {
-                    m_ti[m_numtracks].handle.asA<UvFile>()->startCaching();
-                }
+                m_ti[m_numtracks].handle.setFile(openImageFile(filename / name));
             }
         } else if (!strcmp(token, "FILE")) {
             sscanf(linebuf, "FILE \"%[^\"]\" #%d %8s %8s", name, &t, time, time2);
@@ -75,6 +75,22 @@ PCSX::CDRIso::CDRIso() {
     if (ret != Z_OK) throw("Unable to initialize zlib context");
 }
 
+// With full caching enabled, image files get mapped in memory rather than
+// copied on the heap; the OS then only has to page in what it's asked for.
+// Files which can't be mapped fall back to a fully cached UvFile.
+PCSX::File *PCSX::CDRIso::openImageFile(const std::filesystem::path &path) {
+    if (!g_emulator->settings.get<Emulator::SettingFullCaching>()) return new UvFile(path);
+    MmapFile *mapped = new MmapFile(path);
+    if (!mapped->failed()) {
+        mapped->prefetch();
+        return mapped;
+    }
+    delete mapped;
+    UvFile *fi = new UvFile(path);
+    if (!fi->failed()) fi->startCaching();
+    return fi;
+}
+
 // this function tries to get the .sub file of the given .img
 bool PCSX::CDRIso::opensubfile(const char *isoname) {
     char subname[MAXPATHLEN];
@@ -122,7 +138,7 @@ ssize_t PCSX::CDRIso::cdread_sub_mixed(IO<File> f, unsigned int base, void *dest
     f->readAt(m_subbuffer.raw, IEC60908b::SUB_FRAMESIZE,
               base + sector * (IEC60908b::FRAMESIZE_RAW + IEC60908b::SUB_FRAMESIZE) + IEC60908b::FRAMESIZE_RAW);
 
-    if (m_subChanRaw) decodeRawSubData();
+    if (m_subChanRaw) decodeRawSubData(m_subbuffer);
 
     return ret;
 }
@@ -227,19 +243,21 @@ ssize_t PCSX::CDRIso::cdread_2048(IO<File> f, unsigned int base, void *dest_, in
     dest[10] = 0xff;
     dest[11] = 0x00;
     IEC60908b::MSF(sector + 150).toBCD(dest + 12);
-    m_cdbuffer[15] = 2;
-    m_cdbuffer[16] = m_cdbuffer[20] = 0;
-    m_cdbuffer[17] = m_cdbuffer[21] = 0;
-    m_cdbuffer[18] = m_cdbuffer[22] = 8;
-    m_cdbuffer[19] = m_cdbuffer[23] = 0;
+    dest[15] = 2;
+    dest[16] = dest[20] = 0;
+    dest[17] = dest[21] = 0;
+    dest[18] = dest[22] = 8;
+    dest[19] = dest[23] = 0;
 
-    IEC60908b::computeEDCECC(m_cdbuffer);
+    IEC60908b::computeEDCECC(dest);
 
     return ret;
 }
 
-uint8_t *PCSX::CDRIso::getBuffer() {
-    if (m_useCompressed) {
+const uint8_t *PCSX::CDRIso::getBuffer() {
+    if (m_mappedSector) return m_mappedSector + 12;
+    // The read-ahead engine always copies sectors out into m_cdbuffer.
+    if (m_useCompressed && !m_readAhead) {
         return m_compr_img->buff_raw[m_compr_img->sector_in_blk] + 12;
     } else {
         return m_cdbuffer + 12;
@@ -263,7 +281,8 @@ bool PCSX::CDRIso::open(IO<File> isoFile) {
         m_cdHandle.reset();
         return false;
     }
-    if (g_emulator->settings.get<Emulator::SettingFullCaching>() && m_cdHandle.isA<UvFile>()) {
+    if (g_emulator->settings.get<Emulator::SettingFullCaching>() && m_cdHandle.isA<UvFile>() &&
+        !m_cdHandle.asA<UvFile>()->caching()) {
         m_cdHandle.asA<UvFile>()->startCaching();
     }
 
@@ -293,7 +312,13 @@ bool PCSX::CDRIso::open(IO<File> isoFile) {
         PCSX::g_system->printf("[+mds]");
     }
     // TODO Is it possible that cue/ccd+ecm? otherwise use else if below to supressn extra checks
-    if (handlepbp(reinterpret_cast<const char *>(m_isoPath.string().c_str()))) {
+    if (CHD::isCHD(m_cdHandle)) {
+        if (!handlechd(reinterpret_cast<const char *>(m_isoPath.string().c_str()))) {
+            m_cdHandle.reset();
+            return false;
+        }
+        PCSX::g_system->printf("[chd]");
+    } else if (handlepbp(reinterpret_cast<const char *>(m_isoPath.string().c_str()))) {
         PCSX::g_system->printf("[pbp]");
         m_useCompressed = true;
         m_cdimg_read_func = &CDRIso::cdread_compressed;
@@ -312,7 +337,7 @@ bool PCSX::CDRIso::open(IO<File> isoFile) {
         PCSX::g_system->printf("[+sbi]");
     }
 
-    if (!m_ecm_file_detected) {
+    if (!m_ecm_file_detected && !m_chd) {
         // guess whether it is mode1/2048
         if (m_cdHandle->size() % 2048 == 0) {
             unsigned int modeTest = m_cdHandle->readAt<uint32_t>(0);
@@ -331,7 +356,11 @@ bool PCSX::CDRIso::open(IO<File> isoFile) {
         m_ti[1].start = IEC60908b::MSF(0, 2, 0);
         m_ti[1].pregap = IEC60908b::MSF(0, 0, 0);
         m_ti[1].handle = m_cdHandle;
-        m_ti[1].length = IEC60908b::MSF(m_ti[1].handle->size() / 2352);
+        if (m_ecmIndex && m_ecmIndex->complete()) {
+            m_ti[1].length = IEC60908b::MSF(m_ecmIndex->sectors());
+        } else {
+            m_ti[1].length = IEC60908b::MSF(m_ti[1].handle->size() / 2352);
+        }
     }
 
     if (m_ppf.load(m_isoPath)) {
@@ -349,16 +378,36 @@ bool PCSX::CDRIso::open(IO<File> isoFile) {
 
     // make sure we have another handle open for cdda
     if (m_numtracks > 1 && !m_ti[1].handle) {
-        m_ti[1].handle.setFile(new UvFile(m_isoPath));
-        if (g_emulator->settings.get<Emulator::SettingFullCaching>()) {
-            m_ti[1].handle.asA<UvFile>()->startCaching();
-        }
+        m_ti[1].handle.setFile(openImageFile(m_isoPath));
+    }
+
+    if ((m_cdimg_read_func == &CDRIso::cdread_normal) && m_cdHandle.isA<MmapFile>()) {
+        m_mappedImage = m_cdHandle.asA<MmapFile>()->data();
+        m_mappedSize = m_cdHandle->size();
+    }
+
+    // Mixed subchannel images update m_subbuffer as a side effect of reading
+    // a sector, so we can't serve them out of order. Mapped images are already
+    // as fast as the read-ahead engine could ever make them, and the OS is
+    // taking care of reading the file ahead of us.
+    if (g_emulator->settings.get<Emulator::SettingReadAhead>() && !m_subChanMixed && !m_mappedImage) {
+        m_readAhead.reset(new ReadAheadCache(
+            [this](uint32_t track, uint32_t sector, uint8_t *dest) { return fetchSector(track, sector, dest); }));
     }
 
     return true;
 }
 
 void PCSX::CDRIso::close() {
+    // Waits for any in-flight prefetch, which may still be using the handles.
+    m_readAhead.reset();
+    m_mappedImage = nullptr;
+    m_mappedSize = 0;
+    m_mappedSector = nullptr;
+    // Same for the ECM indexer, if it's still walking the image.
+    m_ecmIndex.reset();
+    // And for the CHD's own prefetches.
+    m_chd.reset();
     m_cdHandle.reset();
     m_subHandle.reset();
 
@@ -379,15 +428,7 @@ void PCSX::CDRIso::close() {
 
     memset(m_cdbuffer, 0, sizeof(m_cdbuffer));
     m_useCompressed = false;
-    // ECM LUT
-    free(m_ecm_savetable);
-    m_ecm_savetable = nullptr;
-
-    if (m_decoded_ecm) {
-        m_decoded_ecm.reset();
-        free(m_decoded_ecm_buffer);
-        m_decoded_ecm_buffer = nullptr;
-    }
+    m_ecmReader.reset();
     m_ecm_file_detected = false;
 }
 
@@ -424,17 +465,17 @@ PCSX::IEC60908b::MSF PCSX::CDRIso::getPregap(uint8_t track) {
 
 // Decode 'raw' subchannel data from being packed bitwise.
 // Essentially is a bitwise matrix transposition.
-void PCSX::CDRIso::decodeRawSubData() {
+void PCSX::CDRIso::decodeRawSubData(IEC60908b::Sub &sub) {
     unsigned char subQData[12];
     memset(subQData, 0, sizeof(subQData));
 
     for (int i = 0; i < 8 * 12; i++) {
-        if (m_subbuffer.raw[i] & (1 << 6)) {  // only subchannel Q is needed
+        if (sub.raw[i] & (1 << 6)) {  // only subchannel Q is needed
             subQData[i >> 3] |= (1 << (7 - (i & 7)));
         }
     }
 
-    memcpy(&m_subbuffer.Q, subQData, 12);
+    memcpy(&sub.Q, subQData, 12);
 }
 
 // read track
@@ -453,17 +494,27 @@ bool PCSX::CDRIso::readTrack(const IEC60908b::MSF time) {
         }
     }
 
-    ret = (*this.*m_cdimg_read_func)(m_cdHandle, 0, m_cdbuffer, sector);
-    if (ret < 0) return false;
+    // Sectors needing a patch still have to be copied out of the mapping first.
+    m_mappedSector = nullptr;
+    if (m_mappedImage && (sector >= 0) && ((size_t(sector) + 1) * IEC60908b::FRAMESIZE_RAW <= m_mappedSize) &&
+        !m_ppf.hasPatch(time)) {
+        m_mappedSector = m_mappedImage + size_t(sector) * IEC60908b::FRAMESIZE_RAW;
+    } else if (m_readAhead) {
+        if (!m_readAhead->read(0, sector, m_cdbuffer)) return false;
+    } else {
+        std::unique_lock<std::mutex> lock(m_decodeMutex);
+        ret = (*this.*m_cdimg_read_func)(m_cdHandle, 0, m_cdbuffer, sector);
+        if (ret < 0) return false;
+    }
 
     if (m_subHandle) {
         m_subHandle->rSeek(sector * IEC60908b::SUB_FRAMESIZE, SEEK_SET);
         m_subHandle->read(m_subbuffer.raw, IEC60908b::SUB_FRAMESIZE);
 
-        if (m_subChanRaw) decodeRawSubData();
+        if (m_subChanRaw) decodeRawSubData(m_subbuffer);
     }
 
-    m_ppf.maybePatchSector(m_cdbuffer, time);
+    if (!m_mappedSector) m_ppf.maybePatchSector(m_cdbuffer, time);
 
     return true;
 }
@@ -480,11 +531,16 @@ unsigned PCSX::CDRIso::readSectors(uint32_t lba, void *buffer_, unsigned count)
         auto ptr = buffer + actual * IEC60908b::FRAMESIZE_RAW;
         if (lba < m_ti[1].length.toLBA()) {
             IEC60908b::MSF time(lba + 150);
-            long ret = (*this.*m_cdimg_read_func)(m_cdHandle, 0, ptr, lba++);
+            long ret;
+            {
+                std::unique_lock<std::mutex> lock(m_decodeMutex);
+                ret = (*this.*m_cdimg_read_func)(m_cdHandle, 0, ptr, lba++);
+            }
             m_ppf.maybePatchSector(ptr, time);
             if (ret < 0) return actual;
         } else {
-            if (!readCDDA(IEC60908b::MSF(lba++), ptr)) return actual;
+            // readCDDA wants an absolute time, with the 2 seconds lead-in.
+            if (!readCDDA(IEC60908b::MSF(lba++ + 150), ptr)) return actual;
         }
         actual++;
     }
@@ -501,6 +557,22 @@ const PCSX::IEC60908b::Sub *PCSX::CDRIso::getBufferSub() {
     return nullptr;
 }
 
+bool PCSX::CDRIso::readSubchannel(uint32_t lba, IEC60908b::Sub *sub) {
+    ssize_t ret;
+    if (m_subHandle) {
+        ret = m_subHandle->readAt(sub->raw, IEC60908b::SUB_FRAMESIZE, size_t(lba) * IEC60908b::SUB_FRAMESIZE);
+    } else if (m_subChanMixed && m_cdHandle) {
+        ret = m_cdHandle->readAt(
+            sub->raw, IEC60908b::SUB_FRAMESIZE,
+            size_t(lba) * (IEC60908b::FRAMESIZE_RAW + IEC60908b::SUB_FRAMESIZE) + IEC60908b::FRAMESIZE_RAW);
+    } else {
+        return false;
+    }
+    if (ret != IEC60908b::SUB_FRAMESIZE) return false;
+    if (m_subChanRaw) decodeRawSubData(*sub);
+    return true;
+}
+
 // read CDDA sector into buffer
 bool PCSX::CDRIso::readCDDA(IEC60908b::MSF msf, unsigned char *buffer) {
     unsigned int file, track, track_start = 0;
@@ -527,15 +599,13 @@ bool PCSX::CDRIso::readCDDA(IEC60908b::MSF msf, unsigned char *buffer) {
         return true;
     }
 
-    file = 1;
-    if (m_multifile) {
-        // find the file that contains this track
-        for (file = track; file > 1; file--) {
-            if (m_ti[file].handle) break;
-        }
+    if (m_readAhead) {
+        ret = m_readAhead->read(track, lba - track_start, buffer) ? IEC60908b::FRAMESIZE_RAW : -1;
+    } else {
+        std::unique_lock<std::mutex> lock(m_decodeMutex);
+        file = findTrackFile(track);
+        ret = (*this.*m_cdimg_read_func)(m_ti[file].handle, m_ti[track].start_offset, buffer, lba - track_start);
     }
-
-    ret = (*this.*m_cdimg_read_func)(m_ti[file].handle, m_ti[track].start_offset, buffer, lba - track_start);
     if (ret != IEC60908b::FRAMESIZE_RAW) {
         memset(buffer, 0, IEC60908b::FRAMESIZE_RAW);
         return false;
@@ -554,4 +624,40 @@ bool PCSX::CDRIso::readCDDA(IEC60908b::MSF msf, unsigned char *buffer) {
     return true;
 }
 
-bool PCSX::CDRIso::failed() { return !m_cdHandle && !m_ecm_savetable && !m_decoded_ecm; }
+// find the file that contains this track
+unsigned PCSX::CDRIso::findTrackFile(unsigned track) {
+    unsigned file = 1;
+    if (m_multifile) {
+        for (file = track; file > 1; file--) {
+            if (m_ti[file].handle) break;
+        }
+    }
+    return file;
+}
+
+// Called by the read-ahead engine, potentially from another thread.
+// Track 0 is the data handle, anything else is a CDDA track.
+bool PCSX::CDRIso::fetchSector(uint32_t track, uint32_t sector, uint8_t *dest) {
+    std::unique_lock<std::mutex> lock(m_decodeMutex);
+    if (!m_cdHandle || m_cdHandle->failed()) return false;
+    if (track == 0) {
+        return (*this.*m_cdimg_read_func)(m_cdHandle, 0, dest, sector) > 0;
+    }
+    if (track > m_numtracks) return false;
+    if (sector >= m_ti[track].length.toLBA()) return false;
+    auto file = findTrackFile(track);
+    return (*this.*m_cdimg_read_func)(m_ti[file].handle, m_ti[track].start_offset, dest, sector) ==
+           IEC60908b::FRAMESIZE_RAW;
+}
+
+void PCSX::CDRIso::prefetch(const IEC60908b::MSF time) {
+    if (!m_readAhead) return;
+    int sector = time.toLBA() - 150;
+    if (m_pregapOffset && (sector >= m_pregapOffset)) sector -= 2 * 75;
+    if (sector < 0) return;
+    // A handful of sectors is enough to absorb the seek; if the game
+    // keeps on reading, the sequential predictor will take over.
+    m_readAhead->prefetch(0, sector, 8);
+}
+
+bool PCSX::CDRIso::failed() { return !m_cdHandle && !m_ecmIndex; }
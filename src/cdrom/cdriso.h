@@ -23,9 +23,15 @@
 #include <zlib.h>
 
 #include <filesystem>
+#include <memory>
+#include <mutex>
 
+#include "cdrom/chd.h"
+#include "cdrom/ecmindex.h"
 #include "cdrom/ppf.h"
+#include "cdrom/readahead.h"
 #include "core/psxemulator.h"
+#include "support/mmapfile.h"
 #include "support/uvfile.h"
 #include "supportpsx/iec-60908b.h"
 
@@ -35,7 +41,7 @@ class CDRIso {
   public:
     CDRIso(const std::filesystem::path& path) : CDRIso() {
         m_isoPath = path;
-        open(new UvFile(m_isoPath));
+        open(openImageFile(m_isoPath));
     }
     CDRIso(IO<File> isoFile) : CDRIso() {
         m_isoPath = isoFile->filename();
@@ -54,10 +60,28 @@ class CDRIso {
     IEC60908b::MSF getPregap(uint8_t track);
     bool readTrack(const IEC60908b::MSF time);
     unsigned readSectors(uint32_t lba, void* buffer, unsigned count);
-    uint8_t* getBuffer();
+    const uint8_t* getBuffer();
     const IEC60908b::Sub* getBufferSub();
+    // Reads the subchannel data of a sector, if the image has any, without
+    // touching the main channel. Safe to call from any thread.
+    bool readSubchannel(uint32_t lba, IEC60908b::Sub* sub);
     bool readCDDA(const IEC60908b::MSF msf, unsigned char* buffer);
     PPF* getPPF() { return &m_ppf; }
+    // Hints the read-ahead engine, if enabled, that the drive is about to read from there.
+    void prefetch(const IEC60908b::MSF time);
+    ReadAheadCache::Stats getReadAheadStats() {
+        return m_readAhead ? m_readAhead->getStats() : ReadAheadCache::Stats{};
+    }
+    bool hasReadAhead() { return !!m_readAhead; }
+    // Forked children don't have the I/O thread. The parent waits for the
+    // image's work in flight before forking, and the children then do it all
+    // on their own thread.
+    void prepareFork() {
+        if (m_chd) m_chd->waitIdle();
+    }
+    void forked() {
+        if (m_chd) m_chd->decodeInline();
+    }
 
     bool failed();
 
@@ -65,6 +89,9 @@ class CDRIso {
     unsigned m_cdrIsoMultidiskSelect;
 
     bool CheckSBI(const uint8_t* time);
+    // Returns the 10 bytes of Q data stored for this BCD time, if any.
+    const uint8_t* findSBI(const uint8_t* time);
+    bool hasSBI() { return sbicount > 0; }
 
   private:
     CDRIso();
@@ -77,6 +104,11 @@ class CDRIso {
     bool m_useCompressed = false;
     z_stream m_zstr;
 
+    // The read functions aren't reentrant, and the read-ahead engine calls
+    // them from its prefetch thread, so every call needs to hold this.
+    std::mutex m_decodeMutex;
+    std::unique_ptr<ReadAheadCache> m_readAhead;
+
     IO<File> m_cdHandle;
     IO<File> m_subHandle;
 
@@ -90,6 +122,12 @@ class CDRIso {
     uint8_t m_cdbuffer[2352];
     IEC60908b::Sub m_subbuffer;
 
+    // Plain images which got mapped in memory have their sectors served
+    // directly out of the mapping, without going through m_cdbuffer.
+    const uint8_t* m_mappedImage = nullptr;
+    size_t m_mappedSize = 0;
+    const uint8_t* m_mappedSector = nullptr;
+
     bool m_cddaBigEndian = false;
     /* Frame offset into CD image where pregap data would be found if it was there.
      * If a game seeks there we must *not* return subchannel data since it's
@@ -110,30 +148,17 @@ class CDRIso {
 
     read_func_t m_cdimg_read_func = nullptr;
 
-    uint32_t m_len_decoded_ecm_buffer = 0;  // same as decoded ECM file length or 2x size
-    uint32_t m_len_ecm_savetable = 0;       // same as sector count of decoded ECM file or 2x count
-
-    uint32_t m_decoded_ecm_sectors = 0;  // disabled
-
     bool m_ecm_file_detected = false;
-    uint32_t m_prevsector;
+    std::unique_ptr<ECMIndex> m_ecmIndex;
+    std::unique_ptr<ECMIndex::Reader> m_ecmReader;
+    // Decoder state right after the last decoded sector, for sequential reads.
+    ECMIndex::Cursor m_ecmLast;
 
-    IO<File> m_decoded_ecm = nullptr;
-    void* m_decoded_ecm_buffer = nullptr;
+    std::unique_ptr<CHD> m_chd;
 
     // Function that is used to read CD normally
     read_func_t m_cdimg_read_func_o = nullptr;
 
-    struct ECMFILELUT {
-        int32_t sector;
-        int32_t filepos;
-    };
-
-    ECMFILELUT* m_ecm_savetable = nullptr;
-
-    static inline const size_t ECM_SECTOR_SIZE[4] = {1, 2352, 2336, 2336};
-    static inline const uint8_t ZEROADDRESS[4] = {0, 0, 0, 0};
-
     struct trackinfo {
         TrackType type = TrackType::CLOSED;
         IEC60908b::MSF pregap;
@@ -150,10 +175,12 @@ class CDRIso {
     struct trackinfo m_ti[MAXTRACKS];
 
     // redump.org SBI files
-    uint8_t sbitime[256][3], sbicount;
+    uint8_t sbitime[256][3], sbicount = 0;
+    uint8_t sbiq[256][10];
     PPF m_ppf;
 
-    void decodeRawSubData();
+    static File* openImageFile(const std::filesystem::path& path);
+    static void decodeRawSubData(IEC60908b::Sub& sub);
     bool parsetoc(const char* isofile);
     bool parsecue(const char* isofile);
     bool parseccd(const char* isofile);
@@ -161,6 +188,7 @@ class CDRIso {
     bool handlepbp(const char* isofile);
     bool handlecbin(const char* isofile);
     bool handleecm(const char* isoname, IO<File> cdh, int32_t* accurate_length);
+    bool handlechd(const char* isofile);
     bool opensubfile(const char* isoname);
     bool opensbifile(const char* isoname);
 
@@ -171,6 +199,9 @@ class CDRIso {
     ssize_t cdread_compressed(IO<File> f, unsigned int base, void* dest, int sector);
     ssize_t cdread_2048(IO<File> f, unsigned int base, void* dest, int sector);
     ssize_t ecmDecode(IO<File> f, unsigned int base, void* dest, int sector);
+    ssize_t cdread_chd(IO<File> f, unsigned int base, void* dest, int sector);
+    bool fetchSector(uint32_t track, uint32_t sector, uint8_t* dest);
+    unsigned findTrackFile(unsigned track);
 
     void printTracks();
     void UnloadSBI();
@@ -0,0 +1,305 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+// FLAC frame decoder for CHD hunks. CHD only stores the frames themselves,
+// without the stream header, so anything the frame headers defer to the
+// STREAMINFO block defaults to 16 bits samples. Only what's necessary to
+// decode 16 bits audio is implemented, but all of the subframe types are.
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include "cdrom/chd.h"
+
+namespace {
+
+template <typename T, unsigned bits, T poly>
+constexpr std::array<T, 256> generateCRCTable() {
+    std::array<T, 256> table = {};
+    for (unsigned i = 0; i < 256; i++) {
+        T crc = T(i << (bits - 8));
+        for (unsigned j = 0; j < 8; j++) {
+            crc = (crc & (T(1) << (bits - 1))) ? T((crc << 1) ^ poly) : T(crc << 1);
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+constexpr auto c_crc8Table = generateCRCTable<uint8_t, 8, 0x07>();
+constexpr auto c_crc16Table = generateCRCTable<uint16_t, 16, 0x8005>();
+
+uint8_t crc8(const uint8_t *data, size_t size) {
+    uint8_t crc = 0;
+    while (size--) crc = c_crc8Table[crc ^ *data++];
+    return crc;
+}
+
+uint16_t crc16(const uint8_t *data, size_t size) {
+    uint16_t crc = 0;
+    while (size--) crc = (crc << 8) ^ c_crc16Table[(crc >> 8) ^ *data++];
+    return crc;
+}
+
+class FlacBitReader {
+  public:
+    FlacBitReader(const uint8_t *data, size_t size) : m_data(data), m_size(size) {}
+    bool overflow() const { return m_bit > m_size * 8; }
+    size_t bytePosition() const { return m_bit >> 3; }
+    void align() { m_bit = (m_bit + 7) & ~size_t(7); }
+
+    uint32_t read(unsigned bits) {
+        if (bits == 0) return 0;
+        size_t byte = m_bit >> 3;
+        uint64_t v = 0;
+        for (unsigned i = 0; i < 8; i++, byte++) v = (v << 8) | (byte < m_size ? m_data[byte] : 0);
+        v <<= m_bit & 7;
+        m_bit += bits;
+        return uint32_t(v >> (64 - bits));
+    }
+    int32_t readSigned(unsigned bits) {
+        if (bits == 0) return 0;
+        uint32_t v = read(bits);
+        if (bits < 32 && (v & (1u << (bits - 1)))) v |= ~0u << bits;
+        return int32_t(v);
+    }
+    // Counts zeroes until the next set bit, and skips over it.
+    uint32_t readUnary() {
+        uint32_t count = 0;
+        while (!overflow()) {
+            unsigned offset = m_bit & 7;
+            unsigned v = (m_bit >> 3) < m_size ? uint8_t(m_data[m_bit >> 3] << offset) : 0;
+            if (v == 0) {
+                count += 8 - offset;
+                m_bit += 8 - offset;
+                continue;
+            }
+            while (!(v & 0x80)) {
+                v <<= 1;
+                count++;
+                m_bit++;
+            }
+            m_bit++;
+            return count;
+        }
+        return count;
+    }
+
+  private:
+    const uint8_t *m_data;
+    size_t m_size;
+    size_t m_bit = 0;
+};
+
+bool decodeResidual(FlacBitReader &bits, int32_t *out, unsigned blockSize, unsigned order) {
+    unsigned method = bits.read(2);
+    if (method > 1) return false;
+    unsigned paramBits = method == 0 ? 4 : 5;
+    unsigned escape = (1 << paramBits) - 1;
+    unsigned partitionOrder = bits.read(4);
+    unsigned partitions = 1 << partitionOrder;
+    if ((blockSize % partitions) != 0) return false;
+    unsigned partitionSize = blockSize >> partitionOrder;
+    if (partitionSize < order) return false;
+
+    unsigned sample = order;
+    for (unsigned partition = 0; partition < partitions; partition++) {
+        unsigned count = partition == 0 ? partitionSize - order : partitionSize;
+        unsigned param = bits.read(paramBits);
+        if (param == escape) {
+            unsigned raw = bits.read(5);
+            for (unsigned i = 0; i < count; i++) out[sample++] = bits.readSigned(raw);
+        } else {
+            for (unsigned i = 0; i < count; i++) {
+                uint32_t v = (bits.readUnary() << param) | bits.read(param);
+                out[sample++] = int32_t(v >> 1) ^ -int32_t(v & 1);
+            }
+        }
+        if (bits.overflow()) return false;
+    }
+    return true;
+}
+
+bool decodeSubframe(FlacBitReader &bits, int32_t *out, unsigned blockSize, unsigned bps) {
+    if (bits.read(1) != 0) return false;
+    unsigned type = bits.read(6);
+    unsigned wasted = 0;
+    if (bits.read(1)) wasted = bits.readUnary() + 1;
+    if (wasted >= bps) return false;
+    bps -= wasted;
+
+    if (type == 0) {
+        int32_t v = bits.readSigned(bps);
+        for (unsigned i = 0; i < blockSize; i++) out[i] = v;
+    } else if (type == 1) {
+        for (unsigned i = 0; i < blockSize; i++) out[i] = bits.readSigned(bps);
+    } else if ((type >= 8) && (type <= 12)) {
+        unsigned order = type & 7;
+        if (order > blockSize) return false;
+        for (unsigned i = 0; i < order; i++) out[i] = bits.readSigned(bps);
+        if (!decodeResidual(bits, out, blockSize, order)) return false;
+        // Corrupted streams could overflow these, hence the 64 bits arithmetic.
+        for (unsigned i = order; i < blockSize; i++) {
+            int64_t prediction = 0;
+            switch (order) {
+                case 1:
+                    prediction = out[i - 1];
+                    break;
+                case 2:
+                    prediction = 2 * int64_t(out[i - 1]) - out[i - 2];
+                    break;
+                case 3:
+                    prediction = 3 * int64_t(out[i - 1]) - 3 * int64_t(out[i - 2]) + out[i - 3];
+                    break;
+                case 4:
+                    prediction =
+                        4 * int64_t(out[i - 1]) - 6 * int64_t(out[i - 2]) + 4 * int64_t(out[i - 3]) - out[i - 4];
+                    break;
+            }
+            out[i] = int32_t(prediction + out[i]);
+        }
+    } else if (type >= 32) {
+        unsigned order = (type & 31) + 1;
+        if (order > blockSize) return false;
+        for (unsigned i = 0; i < order; i++) out[i] = bits.readSigned(bps);
+        unsigned precision = bits.read(4) + 1;
+        if (precision == 16) return false;
+        int shift = bits.readSigned(5);
+        if (shift < 0) return false;
+        int32_t coefs[32];
+        for (unsigned i = 0; i < order; i++) coefs[i] = bits.readSigned(precision);
+        if (!decodeResidual(bits, out, blockSize, order)) return false;
+        for (unsigned i = order; i < blockSize; i++) {
+            int64_t sum = 0;
+            for (unsigned j = 0; j < order; j++) sum += int64_t(coefs[j]) * out[i - j - 1];
+            out[i] = int32_t((sum >> shift) + out[i]);
+        }
+    } else {
+        return false;
+    }
+
+    if (wasted) {
+        for (unsigned i = 0; i < blockSize; i++) out[i] = int32_t(uint32_t(out[i]) << wasted);
+    }
+    return !bits.overflow();
+}
+
+}  // namespace
+
+uint32_t PCSX::CHD::decompressFlac(const uint8_t *src, uint32_t srcLen, uint8_t *dest, uint32_t destLen,
+                                   unsigned channels) {
+    const uint32_t totalSamples = destLen / (2 * channels);
+    uint32_t decoded = 0;
+    uint32_t offset = 0;
+    std::vector<int32_t> samples[8];
+
+    while (decoded < totalSamples) {
+        const uint8_t *frame = src + offset;
+        FlacBitReader bits(frame, srcLen - offset);
+
+        if (bits.read(15) != (0xfff8 >> 1)) return 0;
+        bits.read(1);
+        unsigned blockSizeCode = bits.read(4);
+        unsigned sampleRateCode = bits.read(4);
+        unsigned channelAssignment = bits.read(4);
+        unsigned sampleSizeCode = bits.read(3);
+        bits.read(1);
+        // The frame or sample number, UTF-8 style; we only need to skip it.
+        uint32_t first = bits.read(8);
+        unsigned extra = 0;
+        while ((extra < 6) && (first & (0x40 >> extra))) extra++;
+        if ((first & 0x80) && (extra == 0)) return 0;
+        bits.read(8 * extra);
+
+        unsigned blockSize;
+        if (blockSizeCode == 0) {
+            return 0;
+        } else if (blockSizeCode == 1) {
+            blockSize = 192;
+        } else if (blockSizeCode <= 5) {
+            blockSize = 576 << (blockSizeCode - 2);
+        } else if (blockSizeCode == 6) {
+            blockSize = bits.read(8) + 1;
+        } else if (blockSizeCode == 7) {
+            blockSize = bits.read(16) + 1;
+        } else {
+            blockSize = 256 << (blockSizeCode - 8);
+        }
+        if (sampleRateCode == 12) {
+            bits.read(8);
+        } else if ((sampleRateCode == 13) || (sampleRateCode == 14)) {
+            bits.read(16);
+        } else if (sampleRateCode == 15) {
+            return 0;
+        }
+        if ((sampleSizeCode != 0) && (sampleSizeCode != 4)) return 0;
+        const unsigned bps = 16;
+        unsigned frameChannels = channelAssignment < 8 ? channelAssignment + 1 : 2;
+        if ((channelAssignment > 10) || (frameChannels != channels)) return 0;
+
+        size_t headerSize = bits.bytePosition();
+        if (bits.read(8) != crc8(frame, headerSize)) return 0;
+
+        for (unsigned c = 0; c < channels; c++) {
+            samples[c].resize(blockSize);
+            // The side channel has one more bit of precision.
+            bool side = ((channelAssignment == 8) && (c == 1)) || ((channelAssignment == 9) && (c == 0)) ||
+                        ((channelAssignment == 10) && (c == 1));
+            if (!decodeSubframe(bits, samples[c].data(), blockSize, bps + (side ? 1 : 0))) return 0;
+        }
+        bits.align();
+        size_t frameSize = bits.bytePosition();
+        if (bits.overflow() || ((frameSize + 2) > (srcLen - offset))) return 0;
+        if (bits.read(16) != crc16(frame, frameSize)) return 0;
+        offset += frameSize + 2;
+
+        int32_t *left = samples[0].data();
+        int32_t *right = samples[1].data();
+        switch (channelAssignment) {
+            case 8:
+                for (unsigned i = 0; i < blockSize; i++) right[i] = int32_t(int64_t(left[i]) - right[i]);
+                break;
+            case 9:
+                for (unsigned i = 0; i < blockSize; i++) left[i] = int32_t(int64_t(left[i]) + right[i]);
+                break;
+            case 10:
+                for (unsigned i = 0; i < blockSize; i++) {
+                    int64_t mid = (int64_t(left[i]) * 2) | (right[i] & 1);
+                    int64_t side = right[i];
+                    left[i] = int32_t((mid + side) >> 1);
+                    right[i] = int32_t((mid - side) >> 1);
+                }
+                break;
+        }
+
+        unsigned count = std::min(blockSize, totalSamples - decoded);
+        uint8_t *out = dest + decoded * 2 * channels;
+        for (unsigned i = 0; i < count; i++) {
+            for (unsigned c = 0; c < channels; c++) {
+                int16_t v = int16_t(samples[c][i]);
+                *out++ = uint8_t(v >> 8);
+                *out++ = uint8_t(v);
+            }
+        }
+        decoded += count;
+    }
+
+    return offset;
+}
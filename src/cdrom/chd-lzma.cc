@@ -0,0 +1,271 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+// Raw LZMA decoder for CHD hunks, following the reference decoder from the
+// LZMA SDK's LzmaSpec.cpp. CHD streams have no header: the properties are
+// always lc=3, lp=0, pb=2, and the decompressed size is the hunk's size. Since
+// the whole output is decoded in one go, the output buffer is the dictionary.
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "cdrom/chd.h"
+
+namespace {
+
+constexpr unsigned c_lc = 3;
+constexpr unsigned c_pb = 2;
+constexpr unsigned c_numStates = 12;
+constexpr unsigned c_numPosStatesMax = 1 << 4;
+constexpr unsigned c_numLenToPosStates = 4;
+constexpr unsigned c_numAlignBits = 4;
+constexpr unsigned c_startPosModelIndex = 4;
+constexpr unsigned c_endPosModelIndex = 14;
+constexpr unsigned c_numFullDistances = 1 << (c_endPosModelIndex >> 1);
+constexpr unsigned c_matchMinLen = 2;
+constexpr uint16_t c_probInit = 1 << 10;
+
+class RangeDecoder {
+  public:
+    RangeDecoder(const uint8_t *data, uint32_t size) : m_data(data), m_size(size) {
+        // The first byte of the stream is always zero.
+        if (nextByte() != 0) m_corrupted = true;
+        for (unsigned i = 0; i < 4; i++) m_code = (m_code << 8) | nextByte();
+        if (m_code == m_range) m_corrupted = true;
+    }
+    bool corrupted() const { return m_corrupted; }
+
+    unsigned decodeBit(uint16_t *prob) {
+        uint32_t bound = (m_range >> 11) * *prob;
+        unsigned bit;
+        if (m_code < bound) {
+            *prob += ((1 << 11) - *prob) >> 5;
+            m_range = bound;
+            bit = 0;
+        } else {
+            *prob -= *prob >> 5;
+            m_code -= bound;
+            m_range -= bound;
+            bit = 1;
+        }
+        normalize();
+        return bit;
+    }
+
+    uint32_t decodeDirectBits(unsigned numBits) {
+        uint32_t res = 0;
+        do {
+            m_range >>= 1;
+            m_code -= m_range;
+            uint32_t t = 0 - (m_code >> 31);
+            m_code += m_range & t;
+            if (m_code == m_range) m_corrupted = true;
+            normalize();
+            res = (res << 1) + (t + 1);
+        } while (--numBits);
+        return res;
+    }
+
+    uint32_t bitTree(uint16_t *probs, unsigned numBits) {
+        uint32_t m = 1;
+        for (unsigned i = 0; i < numBits; i++) m = (m << 1) + decodeBit(&probs[m]);
+        return m - (1 << numBits);
+    }
+
+    uint32_t bitTreeReverse(uint16_t *probs, unsigned numBits) {
+        uint32_t m = 1;
+        uint32_t symbol = 0;
+        for (unsigned i = 0; i < numBits; i++) {
+            unsigned bit = decodeBit(&probs[m]);
+            m = (m << 1) + bit;
+            symbol |= bit << i;
+        }
+        return symbol;
+    }
+
+  private:
+    uint8_t nextByte() {
+        if (m_pos < m_size) return m_data[m_pos++];
+        m_corrupted = true;
+        return 0;
+    }
+    void normalize() {
+        if (m_range < (1 << 24)) {
+            m_range <<= 8;
+            m_code = (m_code << 8) | nextByte();
+        }
+    }
+
+    const uint8_t *m_data;
+    uint32_t m_size;
+    uint32_t m_pos = 0;
+    uint32_t m_range = 0xffffffff;
+    uint32_t m_code = 0;
+    bool m_corrupted = false;
+};
+
+class LenDecoder {
+  public:
+    LenDecoder() {
+        std::fill_n(m_low[0], sizeof(m_low) / sizeof(uint16_t), c_probInit);
+        std::fill_n(m_mid[0], sizeof(m_mid) / sizeof(uint16_t), c_probInit);
+        std::fill_n(m_high, 256, c_probInit);
+    }
+    unsigned decode(RangeDecoder &rc, unsigned posState) {
+        if (rc.decodeBit(&m_choice) == 0) return rc.bitTree(m_low[posState], 3);
+        if (rc.decodeBit(&m_choice2) == 0) return 8 + rc.bitTree(m_mid[posState], 3);
+        return 16 + rc.bitTree(m_high, 8);
+    }
+
+  private:
+    uint16_t m_choice = c_probInit;
+    uint16_t m_choice2 = c_probInit;
+    uint16_t m_low[c_numPosStatesMax][1 << 3];
+    uint16_t m_mid[c_numPosStatesMax][1 << 3];
+    uint16_t m_high[1 << 8];
+};
+
+struct Probabilities {
+    Probabilities() {
+        std::fill_n(literals, sizeof(literals) / sizeof(uint16_t), c_probInit);
+        std::fill_n(posSlot[0], sizeof(posSlot) / sizeof(uint16_t), c_probInit);
+        std::fill_n(posDecoders, sizeof(posDecoders) / sizeof(uint16_t), c_probInit);
+        std::fill_n(align, sizeof(align) / sizeof(uint16_t), c_probInit);
+        std::fill_n(isMatch, sizeof(isMatch) / sizeof(uint16_t), c_probInit);
+        std::fill_n(isRep, sizeof(isRep) / sizeof(uint16_t), c_probInit);
+        std::fill_n(isRepG0, sizeof(isRepG0) / sizeof(uint16_t), c_probInit);
+        std::fill_n(isRepG1, sizeof(isRepG1) / sizeof(uint16_t), c_probInit);
+        std::fill_n(isRepG2, sizeof(isRepG2) / sizeof(uint16_t), c_probInit);
+        std::fill_n(isRep0Long, sizeof(isRep0Long) / sizeof(uint16_t), c_probInit);
+    }
+    uint16_t literals[0x300 << c_lc];
+    uint16_t posSlot[c_numLenToPosStates][1 << 6];
+    uint16_t posDecoders[1 + c_numFullDistances - c_endPosModelIndex];
+    uint16_t align[1 << c_numAlignBits];
+    uint16_t isMatch[c_numStates << 4];
+    uint16_t isRep[c_numStates];
+    uint16_t isRepG0[c_numStates];
+    uint16_t isRepG1[c_numStates];
+    uint16_t isRepG2[c_numStates];
+    uint16_t isRep0Long[c_numStates << 4];
+    LenDecoder lenDecoder;
+    LenDecoder repLenDecoder;
+};
+
+uint32_t decodeDistance(RangeDecoder &rc, Probabilities &p, unsigned len) {
+    unsigned lenState = std::min(len, c_numLenToPosStates - 1);
+    unsigned posSlot = rc.bitTree(p.posSlot[lenState], 6);
+    if (posSlot < c_startPosModelIndex) return posSlot;
+    unsigned numDirectBits = (posSlot >> 1) - 1;
+    uint32_t dist = (2 | (posSlot & 1)) << numDirectBits;
+    if (posSlot < c_endPosModelIndex) {
+        return dist + rc.bitTreeReverse(p.posDecoders + dist - posSlot, numDirectBits);
+    }
+    dist += rc.decodeDirectBits(numDirectBits - c_numAlignBits) << c_numAlignBits;
+    return dist + rc.bitTreeReverse(p.align, c_numAlignBits);
+}
+
+}  // namespace
+
+bool PCSX::CHD::decompressLzma(const uint8_t *src, uint32_t srcLen, uint8_t *dest, uint32_t destLen) {
+    RangeDecoder rc(src, srcLen);
+    if (rc.corrupted()) return false;
+    // About 30KB worth of probabilities, so keep them off the stack.
+    std::unique_ptr<Probabilities> probs(new Probabilities());
+    Probabilities &p = *probs;
+
+    uint32_t rep0 = 0, rep1 = 0, rep2 = 0, rep3 = 0;
+    unsigned state = 0;
+    uint32_t pos = 0;
+
+    while (pos < destLen) {
+        unsigned posState = pos & ((1 << c_pb) - 1);
+
+        if (rc.decodeBit(&p.isMatch[(state << 4) + posState]) == 0) {
+            uint8_t prevByte = pos ? dest[pos - 1] : 0;
+            uint16_t *literals = &p.literals[0x300 * (prevByte >> (8 - c_lc))];
+            unsigned symbol = 1;
+            if (state >= 7) {
+                if (rep0 >= pos) return false;
+                unsigned matchByte = dest[pos - rep0 - 1];
+                do {
+                    unsigned matchBit = (matchByte >> 7) & 1;
+                    matchByte <<= 1;
+                    unsigned bit = rc.decodeBit(&literals[((1 + matchBit) << 8) + symbol]);
+                    symbol = (symbol << 1) | bit;
+                    if (matchBit != bit) break;
+                } while (symbol < 0x100);
+            }
+            while (symbol < 0x100) symbol = (symbol << 1) | rc.decodeBit(&literals[symbol]);
+            dest[pos++] = symbol - 0x100;
+            state = state < 4 ? 0 : (state < 10 ? state - 3 : state - 6);
+            continue;
+        }
+
+        unsigned len;
+        if (rc.decodeBit(&p.isRep[state]) != 0) {
+            if (pos == 0) return false;
+            if (rc.decodeBit(&p.isRepG0[state]) == 0) {
+                if (rc.decodeBit(&p.isRep0Long[(state << 4) + posState]) == 0) {
+                    // Short rep: a single byte at rep0.
+                    state = state < 7 ? 9 : 11;
+                    if (rep0 >= pos) return false;
+                    dest[pos] = dest[pos - rep0 - 1];
+                    pos++;
+                    continue;
+                }
+            } else {
+                uint32_t dist;
+                if (rc.decodeBit(&p.isRepG1[state]) == 0) {
+                    dist = rep1;
+                } else {
+                    if (rc.decodeBit(&p.isRepG2[state]) == 0) {
+                        dist = rep2;
+                    } else {
+                        dist = rep3;
+                        rep3 = rep2;
+                    }
+                    rep2 = rep1;
+                }
+                rep1 = rep0;
+                rep0 = dist;
+            }
+            len = p.repLenDecoder.decode(rc, posState);
+            state = state < 7 ? 8 : 11;
+        } else {
+            rep3 = rep2;
+            rep2 = rep1;
+            rep1 = rep0;
+            len = p.lenDecoder.decode(rc, posState);
+            state = state < 7 ? 7 : 10;
+            rep0 = decodeDistance(rc, p, len);
+            // End marker; the hunk is shorter than expected.
+            if (rep0 == 0xffffffff) return false;
+        }
+
+        len += c_matchMinLen;
+        if (rep0 >= pos) return false;
+        len = std::min(len, destLen - pos);
+        // The source and destination can overlap, so this can't be a memmove.
+        for (unsigned i = 0; i < len; i++, pos++) dest[pos] = dest[pos - rep0 - 1];
+    }
+
+    return !rc.corrupted();
+}
@@ -0,0 +1,802 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "cdrom/chd.h"
+
+#include <string.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <array>
+
+#include "fmt/format.h"
+
+namespace {
+
+constexpr uint32_t makeTag(char a, char b, char c, char d) {
+    return (uint32_t(uint8_t(a)) << 24) | (uint32_t(uint8_t(b)) << 16) | (uint32_t(uint8_t(c)) << 8) | uint8_t(d);
+}
+
+constexpr uint32_t CODEC_NONE = 0;
+constexpr uint32_t CODEC_ZLIB = makeTag('z', 'l', 'i', 'b');
+constexpr uint32_t CODEC_LZMA = makeTag('l', 'z', 'm', 'a');
+constexpr uint32_t CODEC_FLAC = makeTag('f', 'l', 'a', 'c');
+constexpr uint32_t CODEC_CD_ZLIB = makeTag('c', 'd', 'z', 'l');
+constexpr uint32_t CODEC_CD_LZMA = makeTag('c', 'd', 'l', 'z');
+constexpr uint32_t CODEC_CD_FLAC = makeTag('c', 'd', 'f', 'l');
+
+constexpr uint32_t CDROM_TRACK_METADATA_TAG = makeTag('C', 'H', 'T', 'R');
+constexpr uint32_t CDROM_TRACK_METADATA2_TAG = makeTag('C', 'H', 'T', '2');
+
+constexpr unsigned c_headerSize = 124;
+constexpr unsigned c_subcodeSize = 96;
+constexpr uint8_t c_syncHeader[12] = {0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00};
+
+uint64_t getBE(const uint8_t *data, unsigned bytes) {
+    uint64_t r = 0;
+    for (unsigned i = 0; i < bytes; i++) r = (r << 8) | data[i];
+    return r;
+}
+
+void putBE(uint8_t *data, uint64_t value, unsigned bytes) {
+    for (unsigned i = bytes; i > 0; i--) {
+        data[i - 1] = value & 0xff;
+        value >>= 8;
+    }
+}
+
+constexpr std::array<uint16_t, 256> c_crc16Table = []() {
+    std::array<uint16_t, 256> table = {};
+    for (unsigned i = 0; i < 256; i++) {
+        uint16_t crc = i << 8;
+        for (unsigned j = 0; j < 8; j++) crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        table[i] = crc;
+    }
+    return table;
+}();
+
+// CRC-16/CCITT, which is what CHD uses for both the map and the hunks.
+uint16_t crc16(const uint8_t *data, size_t size) {
+    uint16_t crc = 0xffff;
+    while (size--) crc = (crc << 8) ^ c_crc16Table[(crc >> 8) ^ *data++];
+    return crc;
+}
+
+// MSB-first bit reader; reading past the end yields zeroes, and sets the overflow flag.
+class BitReader {
+  public:
+    BitReader(const uint8_t *data, size_t size) : m_data(data), m_size(size) {}
+    uint32_t peek(unsigned bits) {
+        if (bits == 0) return 0;
+        while (m_bits < bits) {
+            if (m_pos < m_size) m_buffer |= uint64_t(m_data[m_pos]) << (56 - m_bits);
+            m_pos++;
+            m_bits += 8;
+        }
+        return m_buffer >> (64 - bits);
+    }
+    void remove(unsigned bits) {
+        m_buffer <<= bits;
+        m_bits -= bits;
+    }
+    uint32_t read(unsigned bits) {
+        uint32_t r = peek(bits);
+        remove(bits);
+        return r;
+    }
+    bool overflow() const { return (m_pos - m_bits / 8) > m_size; }
+
+  private:
+    const uint8_t *m_data;
+    const size_t m_size;
+    size_t m_pos = 0;
+    uint64_t m_buffer = 0;
+    unsigned m_bits = 0;
+};
+
+// The canonical Huffman flavor used by CHD to compress its map. Note that the code
+// assignment differs from the usual canonical scheme, as the longest codes get
+// the lowest values.
+class HuffmanDecoder {
+  public:
+    HuffmanDecoder(unsigned numCodes, unsigned maxBits)
+        : m_numCodes(numCodes), m_maxBits(maxBits), m_lengths(numCodes), m_lookup(1 << maxBits) {}
+
+    bool importTreeRle(BitReader &bits) {
+        unsigned numBits = m_maxBits >= 16 ? 5 : m_maxBits >= 8 ? 4 : 3;
+        unsigned node = 0;
+        while (node < m_numCodes) {
+            unsigned length = bits.read(numBits);
+            if (length != 1) {
+                m_lengths[node++] = length;
+                continue;
+            }
+            // A 1 is an escape code; a double 1 is a single 1, otherwise it's a repeat.
+            length = bits.read(numBits);
+            if (length == 1) {
+                m_lengths[node++] = length;
+                continue;
+            }
+            unsigned repeat = bits.read(numBits) + 3;
+            if ((node + repeat) > m_numCodes) return false;
+            while (repeat--) m_lengths[node++] = length;
+        }
+        return assignCodes() && !bits.overflow();
+    }
+
+    unsigned decode(BitReader &bits) {
+        uint16_t lookup = m_lookup[bits.peek(m_maxBits)];
+        bits.remove(lookup & 0x1f);
+        return lookup >> 5;
+    }
+
+  private:
+    bool assignCodes() {
+        uint32_t histogram[33] = {0};
+        for (auto length : m_lengths) {
+            if (length > m_maxBits) return false;
+            histogram[length]++;
+        }
+        uint32_t start = 0;
+        for (unsigned length = 32; length > 0; length--) {
+            uint32_t next = (start + histogram[length]) >> 1;
+            if ((length != 1) && ((next * 2) != (start + histogram[length]))) return false;
+            histogram[length] = start;
+            start = next;
+        }
+        for (unsigned code = 0; code < m_numCodes; code++) {
+            unsigned length = m_lengths[code];
+            if (length == 0) continue;
+            uint32_t bits = histogram[length]++;
+            unsigned shift = m_maxBits - length;
+            uint16_t value = (code << 5) | length;
+            for (uint32_t i = bits << shift; i < ((bits + 1) << shift); i++) m_lookup[i] = value;
+        }
+        return true;
+    }
+
+    const unsigned m_numCodes;
+    const unsigned m_maxBits;
+    std::vector<unsigned> m_lengths;
+    std::vector<uint16_t> m_lookup;
+};
+
+}  // namespace
+
+bool PCSX::CHD::isCHD(IO<File> file) {
+    char magic[8];
+    if (file->readAt(magic, sizeof(magic), 0) != sizeof(magic)) return false;
+    return memcmp(magic, "MComprHD", sizeof(magic)) == 0;
+}
+
+PCSX::CHD::CHD(IO<File> file, unsigned cacheSize, unsigned window)
+    : m_file(file), m_capacity(std::max(cacheSize, window + 2)), m_window(window) {
+    if (!parseHeader() || !readMap()) return;
+    m_entries.reset(new Entry[m_capacity]);
+    for (unsigned i = 0; i < m_capacity; i++) {
+        m_entries[i].data.reset(new uint8_t[m_hunkBytes]);
+        m_free.push_back(&m_entries[i]);
+    }
+}
+
+PCSX::CHD::~CHD() { waitIdle(); }
+
+void PCSX::CHD::waitIdle() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this]() { return m_inFlight == 0; });
+}
+
+bool PCSX::CHD::parseHeader() {
+    uint8_t header[c_headerSize];
+    if ((m_file->readAt(header, c_headerSize, 0) != c_headerSize) || (memcmp(header, "MComprHD", 8) != 0)) {
+        m_error = "Not a CHD file";
+        return false;
+    }
+    uint32_t version = getBE(header + 12, 4);
+    if ((version != 5) || (getBE(header + 8, 4) != c_headerSize)) {
+        m_error = fmt::format("Unsupported CHD version {}", version);
+        return false;
+    }
+    for (unsigned i = 0; i < 4; i++) {
+        uint32_t codec = m_compressors[i] = getBE(header + 16 + i * 4, 4);
+        switch (codec) {
+            case CODEC_NONE:
+            case CODEC_ZLIB:
+            case CODEC_LZMA:
+            case CODEC_FLAC:
+            case CODEC_CD_ZLIB:
+            case CODEC_CD_LZMA:
+            case CODEC_CD_FLAC:
+                break;
+            default:
+                m_error = fmt::format("Unsupported CHD codec {:c}{:c}{:c}{:c}", char(codec >> 24), char(codec >> 16),
+                                      char(codec >> 8), char(codec));
+                return false;
+        }
+    }
+    m_logicalBytes = getBE(header + 32, 8);
+    m_mapOffset = getBE(header + 40, 8);
+    m_hunkBytes = getBE(header + 56, 4);
+    m_unitBytes = getBE(header + 60, 4);
+    if ((m_unitBytes != FRAME_SIZE) || (m_hunkBytes == 0) || ((m_hunkBytes % FRAME_SIZE) != 0) ||
+        (m_hunkBytes > 16 * 1024 * 1024)) {
+        m_error = "Not a CD CHD file";
+        return false;
+    }
+    for (unsigned i = 104; i < 124; i++) {
+        if (header[i] != 0) {
+            m_error = "CHD files with a parent aren't supported";
+            return false;
+        }
+    }
+    m_hunkCount = (m_logicalBytes + m_hunkBytes - 1) / m_hunkBytes;
+    return parseMetadata(getBE(header + 48, 8));
+}
+
+bool PCSX::CHD::readMap() {
+    m_map.resize(m_hunkCount);
+    if (m_compressors[0] != CODEC_NONE) return decompressMap(m_mapOffset);
+
+    // Uncompressed images have a plain map of hunk indices, with 0 meaning an empty hunk.
+    std::vector<uint8_t> raw(m_hunkCount * 4);
+    if (m_file->readAt(raw.data(), raw.size(), m_mapOffset) != raw.size()) {
+        m_error = "Short CHD map";
+        return false;
+    }
+    for (uint32_t i = 0; i < m_hunkCount; i++) {
+        m_map[i].type = COMPRESSION_NONE;
+        m_map[i].offset = getBE(&raw[i * 4], 4) * m_hunkBytes;
+    }
+    return true;
+}
+
+/* Adapted from libchdr's decompress_v5_map() */
+bool PCSX::CHD::decompressMap(uint64_t mapOffset) {
+    uint8_t header[16];
+    if (m_file->readAt(header, sizeof(header), mapOffset) != sizeof(header)) {
+        m_error = "Short CHD map";
+        return false;
+    }
+    uint32_t mapBytes = getBE(header, 4);
+    uint64_t firstOffset = getBE(header + 4, 6);
+    uint16_t mapCrc = getBE(header + 10, 2);
+    unsigned lengthBits = header[12];
+    unsigned selfBits = header[13];
+    unsigned parentBits = header[14];
+
+    std::vector<uint8_t> compressed(mapBytes);
+    if (m_file->readAt(compressed.data(), mapBytes, mapOffset + sizeof(header)) != mapBytes) {
+        m_error = "Short CHD map";
+        return false;
+    }
+    BitReader bits(compressed.data(), mapBytes);
+    HuffmanDecoder decoder(16, 8);
+    if (!decoder.importTreeRle(bits)) {
+        m_error = "Corrupted CHD map";
+        return false;
+    }
+
+    // First pass: the compression types, run length encoded.
+    std::vector<uint8_t> raw(m_hunkCount * 12);
+    uint8_t lastType = 0;
+    unsigned repeat = 0;
+    for (uint32_t hunk = 0; hunk < m_hunkCount; hunk++) {
+        uint8_t *entry = &raw[hunk * 12];
+        if (repeat > 0) {
+            entry[0] = lastType;
+            repeat--;
+            continue;
+        }
+        unsigned value = decoder.decode(bits);
+        if (value == COMPRESSION_RLE_SMALL) {
+            entry[0] = lastType;
+            repeat = 2 + decoder.decode(bits);
+        } else if (value == COMPRESSION_RLE_LARGE) {
+            entry[0] = lastType;
+            repeat = 2 + 16 + (decoder.decode(bits) << 4);
+            repeat += decoder.decode(bits);
+        } else {
+            entry[0] = lastType = value;
+        }
+    }
+
+    // Second pass: the offsets, lengths and CRCs, with pseudo-types turned into base types.
+    uint64_t currentOffset = firstOffset;
+    uint64_t lastSelf = 0;
+    uint64_t lastParent = 0;
+    for (uint32_t hunk = 0; hunk < m_hunkCount; hunk++) {
+        uint8_t *entry = &raw[hunk * 12];
+        uint64_t offset = currentOffset;
+        uint32_t length = 0;
+        uint16_t crc = 0;
+        switch (entry[0]) {
+            case COMPRESSION_TYPE_0:
+            case COMPRESSION_TYPE_1:
+            case COMPRESSION_TYPE_2:
+            case COMPRESSION_TYPE_3:
+                currentOffset += length = bits.read(lengthBits);
+                crc = bits.read(16);
+                break;
+            case COMPRESSION_NONE:
+                currentOffset += length = m_hunkBytes;
+                crc = bits.read(16);
+                break;
+            case COMPRESSION_SELF:
+                lastSelf = offset = bits.read(selfBits);
+                break;
+            case COMPRESSION_PARENT:
+                lastParent = offset = bits.read(parentBits);
+                break;
+            case COMPRESSION_SELF_1:
+                lastSelf++;
+                [[fallthrough]];
+            case COMPRESSION_SELF_0:
+                entry[0] = COMPRESSION_SELF;
+                offset = lastSelf;
+                break;
+            case COMPRESSION_PARENT_SELF:
+                entry[0] = COMPRESSION_PARENT;
+                lastParent = offset = (uint64_t(hunk) * m_hunkBytes) / m_unitBytes;
+                break;
+            case COMPRESSION_PARENT_1:
+                lastParent += m_hunkBytes / m_unitBytes;
+                [[fallthrough]];
+            case COMPRESSION_PARENT_0:
+                entry[0] = COMPRESSION_PARENT;
+                offset = lastParent;
+                break;
+            default:
+                m_error = "Corrupted CHD map";
+                return false;
+        }
+        putBE(entry + 1, length, 3);
+        putBE(entry + 4, offset, 6);
+        putBE(entry + 10, crc, 2);
+        m_map[hunk].type = MapType(entry[0]);
+        m_map[hunk].length = length;
+        m_map[hunk].offset = offset;
+        m_map[hunk].crc = crc;
+    }
+
+    if (bits.overflow() || (crc16(raw.data(), raw.size()) != mapCrc)) {
+        m_error = "Corrupted CHD map";
+        return false;
+    }
+    return true;
+}
+
+bool PCSX::CHD::parseMetadata(uint64_t offset) {
+    struct Parsed {
+        unsigned number;
+        Track track;
+    };
+    std::vector<Parsed> parsed;
+
+    // The metadata is a linked list of tagged entries; the guard is against loops.
+    for (unsigned guard = 0; offset && (guard < 1024); guard++) {
+        uint8_t header[16];
+        if (m_file->readAt(header, sizeof(header), offset) != sizeof(header)) break;
+        uint32_t tag = getBE(header, 4);
+        uint32_t length = getBE(header + 5, 3);
+        uint64_t data = offset + sizeof(header);
+        offset = getBE(header + 8, 8);
+        if ((tag != CDROM_TRACK_METADATA_TAG) && (tag != CDROM_TRACK_METADATA2_TAG)) continue;
+
+        std::string text(length, '\0');
+        if (m_file->readAt(text.data(), length, data) != length) break;
+        Parsed entry = {};
+        std::string type, pregapType;
+        size_t pos = 0;
+        while (pos < text.size()) {
+            size_t end = text.find_first_of(" \0", pos, 2);
+            if (end == std::string::npos) end = text.size();
+            std::string_view token(text.data() + pos, end - pos);
+            pos = end + 1;
+            auto colon = token.find(':');
+            if (colon == std::string_view::npos) continue;
+            auto key = token.substr(0, colon);
+            std::string value(token.substr(colon + 1));
+            if (key == "TRACK") {
+                entry.number = strtoul(value.c_str(), nullptr, 10);
+            } else if (key == "TYPE") {
+                type = value;
+            } else if (key == "FRAMES") {
+                entry.track.frames = strtoul(value.c_str(), nullptr, 10);
+            } else if (key == "PREGAP") {
+                entry.track.pregap = strtoul(value.c_str(), nullptr, 10);
+            } else if (key == "PGTYPE") {
+                pregapType = value;
+            } else if (key == "POSTGAP") {
+                entry.track.postgap = strtoul(value.c_str(), nullptr, 10);
+            }
+        }
+
+        if (type == "AUDIO") {
+            entry.track.audio = true;
+        } else if ((type == "MODE1") || (type == "MODE2_FORM1")) {
+            entry.track.dataSize = 2048;
+        } else if ((type == "MODE2") || (type == "MODE2_FORM_MIX")) {
+            entry.track.dataSize = 2336;
+        } else if (type == "MODE2_FORM2") {
+            entry.track.dataSize = 2324;
+        } else if ((type != "MODE1_RAW") && (type != "MODE2_RAW")) {
+            m_error = fmt::format("Unsupported CHD track type {}", type);
+            return false;
+        }
+        // A pregap type starting with V means the pregap's data is stored in the image.
+        entry.track.pregapStored = !pregapType.empty() && (pregapType[0] == 'V');
+        if (!entry.track.pregapStored && (entry.track.frames < entry.track.pregap)) entry.track.pregap = 0;
+        parsed.push_back(entry);
+    }
+
+    if (parsed.empty()) {
+        m_error = "No CD track information in CHD file";
+        return false;
+    }
+    std::sort(parsed.begin(), parsed.end(), [](const Parsed &a, const Parsed &b) { return a.number < b.number; });
+
+    uint32_t chdFrame = 0;
+    uint32_t imageFrame = 0;
+    uint32_t lba = 0;
+    for (auto &entry : parsed) {
+        auto &track = entry.track;
+        if (!track.pregapStored) lba += track.pregap;
+        track.chdFrame = chdFrame;
+        track.imageFrame = imageFrame;
+        track.lba = lba;
+        chdFrame += (track.frames + TRACK_PADDING - 1) / TRACK_PADDING * TRACK_PADDING;
+        imageFrame += track.frames;
+        lba += track.frames + track.postgap;
+        m_tracks.push_back(track);
+    }
+    if ((uint64_t(chdFrame) * FRAME_SIZE) > m_logicalBytes) {
+        m_error = "CHD track information doesn't match its size";
+        return false;
+    }
+    return true;
+}
+
+uint32_t PCSX::CHD::imageFrames() const {
+    if (m_tracks.empty()) return 0;
+    return m_tracks.back().imageFrame + m_tracks.back().frames;
+}
+
+const PCSX::CHD::Track *PCSX::CHD::findTrack(uint32_t sector) const {
+    for (auto &track : m_tracks) {
+        if ((sector >= track.imageFrame) && (sector < (track.imageFrame + track.frames))) return &track;
+    }
+    return nullptr;
+}
+
+bool PCSX::CHD::decodeHunk(uint32_t hunk, uint8_t *dest) {
+    std::unique_ptr<uint8_t[]> src;
+    return readHunk(hunk, src) && unpackHunk(hunk, src.get(), dest);
+}
+
+bool PCSX::CHD::readHunk(uint32_t &hunk, std::unique_ptr<uint8_t[]> &src) {
+    for (unsigned depth = 0;; depth++) {
+        if (hunk >= m_hunkCount) return false;
+        const auto &entry = m_map[hunk];
+        if (entry.type != COMPRESSION_SELF) break;
+        // Identical to another hunk, which has its own CRC.
+        if ((depth > 16) || (entry.offset == hunk)) return false;
+        hunk = entry.offset;
+    }
+    const auto &entry = m_map[hunk];
+    switch (entry.type) {
+        case COMPRESSION_TYPE_0:
+        case COMPRESSION_TYPE_1:
+        case COMPRESSION_TYPE_2:
+        case COMPRESSION_TYPE_3:
+            src.reset(new uint8_t[entry.length]);
+            return m_file->readAt(src.get(), entry.length, entry.offset) == entry.length;
+        case COMPRESSION_NONE:
+            if ((m_compressors[0] == CODEC_NONE) && (entry.offset == 0)) {
+                src.reset();
+                return true;
+            }
+            src.reset(new uint8_t[m_hunkBytes]);
+            return m_file->readAt(src.get(), m_hunkBytes, entry.offset) == m_hunkBytes;
+        default:
+            return false;
+    }
+}
+
+bool PCSX::CHD::unpackHunk(uint32_t hunk, const uint8_t *src, uint8_t *dest) {
+    const auto &entry = m_map[hunk];
+    if (entry.type == COMPRESSION_NONE) {
+        if (!src) {
+            memset(dest, 0, m_hunkBytes);
+            return true;
+        }
+        memcpy(dest, src, m_hunkBytes);
+    } else if (!decompress(m_compressors[entry.type], src, entry.length, dest, m_hunkBytes)) {
+        return false;
+    }
+    // Uncompressed images don't have any CRC in their map.
+    if (m_compressors[0] == CODEC_NONE) return true;
+    return crc16(dest, m_hunkBytes) == entry.crc;
+}
+
+bool PCSX::CHD::decompress(uint32_t codec, const uint8_t *src, uint32_t srcLen, uint8_t *dest, uint32_t destLen) {
+    switch (codec) {
+        case CODEC_ZLIB:
+            return decompressZlib(src, srcLen, dest, destLen);
+        case CODEC_LZMA:
+            return decompressLzma(src, srcLen, dest, destLen);
+        case CODEC_FLAC: {
+            // The first byte tells the endianness of the samples.
+            if ((srcLen < 1) || ((src[0] != 'L') && (src[0] != 'B'))) return false;
+            if (decompressFlac(src + 1, srcLen - 1, dest, destLen, 2) == 0) return false;
+            if (src[0] == 'L') {
+                for (uint32_t i = 0; (i + 1) < destLen; i += 2) std::swap(dest[i], dest[i + 1]);
+            }
+            return true;
+        }
+        case CODEC_CD_ZLIB:
+        case CODEC_CD_LZMA:
+        case CODEC_CD_FLAC:
+            return decompressCD(codec, src, srcLen, dest, destLen);
+    }
+    return false;
+}
+
+bool PCSX::CHD::decompressZlib(const uint8_t *src, uint32_t srcLen, uint8_t *dest, uint32_t destLen) {
+    z_stream zstr = {};
+    if (inflateInit2(&zstr, -MAX_WBITS) != Z_OK) return false;
+    zstr.next_in = const_cast<Bytef *>(src);
+    zstr.avail_in = srcLen;
+    zstr.next_out = dest;
+    zstr.avail_out = destLen;
+    int ret = inflate(&zstr, Z_FINISH);
+    bool success = ((ret == Z_STREAM_END) || (ret == Z_OK) || (ret == Z_BUF_ERROR)) && (zstr.total_out == destLen);
+    inflateEnd(&zstr);
+    return success;
+}
+
+/* Adapted from libchdr's cdzl/cdlz/cdfl_codec_decompress() */
+bool PCSX::CHD::decompressCD(uint32_t codec, const uint8_t *src, uint32_t srcLen, uint8_t *dest, uint32_t destLen) {
+    const uint32_t frames = destLen / FRAME_SIZE;
+    const uint32_t sectorBytes = frames * IEC60908b::FRAMESIZE_RAW;
+    const uint32_t subcodeBytes = frames * c_subcodeSize;
+    std::unique_ptr<uint8_t[]> buffer(new uint8_t[sectorBytes + subcodeBytes]);
+    uint32_t eccBytes = 0;
+
+    if (codec == CODEC_CD_FLAC) {
+        // Audio only, so there's no ECC bitmap, nor length header.
+        uint32_t consumed = decompressFlac(src, srcLen, buffer.get(), sectorBytes, 2);
+        if (consumed == 0) return false;
+        if (!decompressZlib(src + consumed, srcLen - consumed, buffer.get() + sectorBytes, subcodeBytes)) return false;
+    } else {
+        const uint32_t lengthBytes = destLen < 65536 ? 2 : 3;
+        eccBytes = (frames + 7) / 8;
+        const uint32_t headerBytes = eccBytes + lengthBytes;
+        if (srcLen < headerBytes) return false;
+        uint32_t baseLength = getBE(src + eccBytes, lengthBytes);
+        if ((headerBytes + baseLength) > srcLen) return false;
+        const uint8_t *base = src + headerBytes;
+        bool success = codec == CODEC_CD_LZMA ? decompressLzma(base, baseLength, buffer.get(), sectorBytes)
+                                              : decompressZlib(base, baseLength, buffer.get(), sectorBytes);
+        if (!success) return false;
+        if (!decompressZlib(base + baseLength, srcLen - headerBytes - baseLength, buffer.get() + sectorBytes,
+                            subcodeBytes)) {
+            return false;
+        }
+    }
+
+    for (uint32_t frame = 0; frame < frames; frame++) {
+        uint8_t *sector = dest + frame * FRAME_SIZE;
+        memcpy(sector, buffer.get() + frame * IEC60908b::FRAMESIZE_RAW, IEC60908b::FRAMESIZE_RAW);
+        memcpy(sector + IEC60908b::FRAMESIZE_RAW, buffer.get() + sectorBytes + frame * c_subcodeSize, c_subcodeSize);
+        // Sectors flagged here had their sync and ECC stripped, as they could be rebuilt.
+        if (eccBytes && (src[frame / 8] & (1 << (frame % 8)))) {
+            memcpy(sector, c_syncHeader, sizeof(c_syncHeader));
+            IEC60908b::computeECC(sector);
+        }
+    }
+    return true;
+}
+
+PCSX::CHD::Entry *PCSX::CHD::allocate() {
+    Entry *entry = nullptr;
+    if (!m_free.empty()) {
+        entry = &*m_free.begin();
+    } else if (!m_lru.empty()) {
+        entry = &*(--m_lru.end());
+        m_index.unlink(entry);
+    } else {
+        // Everything is in flight.
+        return nullptr;
+    }
+    static_cast<EntryList::Node *>(entry)->unlink();
+    entry->state = Entry::State::PENDING;
+    return entry;
+}
+
+void PCSX::CHD::release(Entry *entry) {
+    m_index.unlink(entry);
+    entry->state = Entry::State::FREE;
+    m_free.push_back(entry);
+}
+
+bool PCSX::CHD::readSector(uint32_t sector, uint8_t *dest) {
+    if (failed()) return false;
+    const Track *track = findTrack(sector);
+    if (!track) return false;
+    const uint64_t position = uint64_t(track->chdFrame + (sector - track->imageFrame)) * FRAME_SIZE;
+    const uint32_t hunk = position / m_hunkBytes;
+    const uint32_t offset = position % m_hunkBytes;
+    const uint32_t lba = track->lba + (sector - track->imageFrame);
+    uint8_t data[IEC60908b::FRAMESIZE_RAW];
+    std::vector<Job *> jobs;
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        Entry *entry = nullptr;
+        while (true) {
+            auto i = m_index.find(hunk);
+            if (i == m_index.end()) break;
+            if (i->state == Entry::State::PENDING) {
+                // A worker is already on it, and it's going to be faster to wait.
+                m_cv.wait(lock);
+                continue;
+            }
+            entry = &*i;
+            break;
+        }
+
+        if (entry) {
+            m_stats.hits++;
+            m_lru.push_front(entry);
+            memcpy(data, entry->data.get() + offset, track->dataSize);
+        } else {
+            m_stats.misses++;
+            entry = allocate();
+            if (entry) m_index.insert(hunk, entry);
+            lock.unlock();
+            std::unique_ptr<uint8_t[]> temp;
+            uint8_t *buffer = entry ? entry->data.get() : (temp.reset(new uint8_t[m_hunkBytes]), temp.get());
+            bool success = decodeHunk(hunk, buffer);
+            if (success) memcpy(data, buffer + offset, track->dataSize);
+            lock.lock();
+            if (entry) {
+                if (success) {
+                    entry->state = Entry::State::READY;
+                    m_lru.push_front(entry);
+                } else {
+                    release(entry);
+                }
+                m_cv.notify_all();
+            }
+            if (!success) return false;
+        }
+
+        if (hunk != m_lastHunk) {
+            if (hunk == (m_lastHunk + 1)) {
+                for (unsigned i = 1; i <= m_window; i++) {
+                    Job *job = schedule(hunk + i);
+                    if (job) jobs.push_back(job);
+                }
+            }
+            m_lastHunk = hunk;
+        }
+    }
+    // The workers may be waiting on the lock, and the file may need them.
+    for (auto job : jobs) dispatch(job);
+
+    // Rebuild the bits of cooked sectors that aren't stored.
+    if (track->dataSize == IEC60908b::FRAMESIZE_RAW) {
+        memcpy(dest, data, IEC60908b::FRAMESIZE_RAW);
+        return true;
+    }
+    memset(dest, 0, IEC60908b::FRAMESIZE_RAW);
+    memcpy(dest, c_syncHeader, sizeof(c_syncHeader));
+    IEC60908b::MSF(lba + 150).toBCD(dest + 12);
+    dest[15] = 2;
+    switch (track->dataSize) {
+        case 2048:
+            dest[18] = dest[22] = 8;
+            memcpy(dest + 24, data, 2048);
+            break;
+        case 2324:
+            dest[18] = dest[22] = 0x20;
+            memcpy(dest + 24, data, 2324);
+            break;
+        case 2336:
+            // These already come with their subheader, EDC and ECC.
+            memcpy(dest + 16, data, 2336);
+            return true;
+    }
+    IEC60908b::computeEDCECC(dest);
+    return true;
+}
+
+PCSX::CHD::Job *PCSX::CHD::schedule(uint32_t hunk) {
+    if (hunk >= m_hunkCount) return nullptr;
+    if (m_index.find(hunk) != m_index.end()) return nullptr;
+    Entry *entry = allocate();
+    if (!entry) return nullptr;
+    m_index.insert(hunk, entry);
+
+    auto job = new Job();
+    job->self = this;
+    job->hunk = hunk;
+    job->entry = entry;
+    job->req.data = job;
+    m_inFlight++;
+    return job;
+}
+
+void PCSX::CHD::dispatch(Job *job) {
+    // Only the decoding is offloaded; the data gets read right here.
+    if (!readHunk(job->hunk, job->src)) {
+        cancelJob(job);
+        delete job;
+        return;
+    }
+    if (m_inline) {
+        runJob(job);
+        delete job;
+        return;
+    }
+    request([job](auto loop) {
+        int ret = uv_queue_work(
+            loop, &job->req,
+            [](uv_work_t *req) {
+                auto job = reinterpret_cast<Job *>(req->data);
+                job->self->runJob(job);
+            },
+            [](uv_work_t *req, int status) {
+                auto job = reinterpret_cast<Job *>(req->data);
+                if (status != 0) job->self->cancelJob(job);
+                delete job;
+            });
+        if (ret != 0) {
+            job->self->cancelJob(job);
+            delete job;
+        }
+    });
+}
+
+void PCSX::CHD::cancelJob(Job *job) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    release(job->entry);
+    m_inFlight--;
+    m_cv.notify_all();
+}
+
+void PCSX::CHD::runJob(Job *job) {
+    // The entry is pending, so nobody else is going to look at its data.
+    bool success = unpackHunk(job->hunk, job->src.get(), job->entry->data.get());
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (success) {
+        job->entry->state = Entry::State::READY;
+        m_lru.push_front(job->entry);
+        m_stats.prefetched++;
+    } else {
+        release(job->entry);
+    }
+    m_inFlight--;
+    m_cv.notify_all();
+}
+
+PCSX::CHD::Stats PCSX::CHD::getStats() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_stats;
+}
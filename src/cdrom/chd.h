@@ -0,0 +1,204 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "support/file.h"
+#include "support/hashtable.h"
+#include "support/list.h"
+#include "support/uvfile.h"
+#include "supportpsx/iec-60908b.h"
+
+namespace PCSX {
+
+// Reader for CD images stored in MAME's CHD v5 format. The image is split into
+// hunks of a few frames each, which are compressed individually with one of the
+// four codecs declared in the header. CD frames are 2352 bytes of sector data,
+// followed by 96 bytes of subchannel data, and each track is padded to a multiple
+// of 4 frames.
+//
+// Decoded hunks are kept in a small LRU cache. When the hunks are being read in
+// sequence, the next few ones get decoded ahead of time on libuv's threadpool,
+// each hunk being its own work item, so they're decoded in parallel. Their data
+// is read beforehand by the reader's thread: the workers never touch the file, as
+// a UvFile read queues its own request on that same pool and waits for it.
+// Forked children don't have the I/O thread which queues them, so there, the
+// prefetched hunks get decoded inline instead.
+//
+// Supported codecs are zlib, LZMA and FLAC, both in their plain and CD flavors.
+// Images with a parent aren't supported.
+class CHD : public UvThreadOp {
+  public:
+    static constexpr unsigned FRAME_SIZE = IEC60908b::FRAMESIZE_RAW + 96;
+    static constexpr unsigned TRACK_PADDING = 4;
+
+    struct Track {
+        bool audio = false;
+        // Bytes of sector data stored per frame; 2048, 2336 or 2352.
+        unsigned dataSize = IEC60908b::FRAMESIZE_RAW;
+        // Frames stored in the image, including the pregap if pregapStored is set.
+        uint32_t frames = 0;
+        uint32_t pregap = 0;
+        bool pregapStored = false;
+        uint32_t postgap = 0;
+        // First frame of the track in the CHD, which accounts for the padding.
+        uint32_t chdFrame = 0;
+        // First frame of the track when all of the tracks' stored frames are laid
+        // out back to back, the way a single bin file would.
+        uint32_t imageFrame = 0;
+        // Disc address of the first stored frame, without the 2 seconds lead-in.
+        uint32_t lba = 0;
+    };
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t prefetched = 0;
+    };
+
+    static bool isCHD(IO<File> file);
+
+    CHD(IO<File> file, unsigned cacheSize = 64, unsigned window = 4);
+    ~CHD();
+    bool failed() const { return !m_error.empty(); }
+    const std::string& error() const { return m_error; }
+    const std::vector<Track>& tracks() const { return m_tracks; }
+    uint32_t imageFrames() const;
+
+    // Reads a raw 2352-byte sector, addressed in the bin-like layout described above.
+    // Cooked sectors get their header, EDC and ECC rebuilt.
+    bool readSector(uint32_t sector, uint8_t* dest);
+    Stats getStats();
+    // Waits for the prefetches in flight, which a fork would leave pending
+    // forever in the child.
+    void waitIdle();
+    // From then on, decodes the prefetched hunks on the reader's thread,
+    // for processes without the I/O thread.
+    void decodeInline() { m_inline = true; }
+
+  private:
+    virtual bool canCache() const override { return false; }
+
+    enum MapType : uint8_t {
+        COMPRESSION_TYPE_0 = 0,
+        COMPRESSION_TYPE_1 = 1,
+        COMPRESSION_TYPE_2 = 2,
+        COMPRESSION_TYPE_3 = 3,
+        COMPRESSION_NONE = 4,
+        COMPRESSION_SELF = 5,
+        COMPRESSION_PARENT = 6,
+        COMPRESSION_RLE_SMALL = 7,
+        COMPRESSION_RLE_LARGE = 8,
+        COMPRESSION_SELF_0 = 9,
+        COMPRESSION_SELF_1 = 10,
+        COMPRESSION_PARENT_SELF = 11,
+        COMPRESSION_PARENT_0 = 12,
+        COMPRESSION_PARENT_1 = 13,
+    };
+    struct MapEntry {
+        MapType type = COMPRESSION_NONE;
+        uint32_t length = 0;
+        uint64_t offset = 0;
+        uint16_t crc = 0;
+    };
+
+    struct Entry;
+    typedef Intrusive::HashTable<uint32_t, Entry> Index;
+    typedef Intrusive::List<Entry> EntryList;
+    struct Entry : public Index::Node, public EntryList::Node {
+        enum class State { FREE, PENDING, READY } state = State::FREE;
+        std::unique_ptr<uint8_t[]> data;
+    };
+    struct Job {
+        uv_work_t req;
+        CHD* self;
+        uint32_t hunk;
+        Entry* entry;
+        std::unique_ptr<uint8_t[]> src;
+    };
+
+    bool parseHeader();
+    bool readMap();
+    bool decompressMap(uint64_t mapOffset);
+    bool parseMetadata(uint64_t metaOffset);
+    const Track* findTrack(uint32_t sector) const;
+
+    bool decodeHunk(uint32_t hunk, uint8_t* dest);
+    // Follows the hunk's self references, updating it to the hunk actually stored,
+    // and reads its data. The data is left empty for hunks which are all zeroes.
+    bool readHunk(uint32_t& hunk, std::unique_ptr<uint8_t[]>& src);
+    // Doesn't touch the file, so it's safe to call from any thread.
+    bool unpackHunk(uint32_t hunk, const uint8_t* src, uint8_t* dest);
+    bool decompress(uint32_t codec, const uint8_t* src, uint32_t srcLen, uint8_t* dest, uint32_t destLen);
+    static bool decompressZlib(const uint8_t* src, uint32_t srcLen, uint8_t* dest, uint32_t destLen);
+    static bool decompressLzma(const uint8_t* src, uint32_t srcLen, uint8_t* dest, uint32_t destLen);
+    // Decodes raw FLAC frames into big endian interleaved 16 bits samples, and
+    // returns the amount of bytes consumed, or 0 on error.
+    static uint32_t decompressFlac(const uint8_t* src, uint32_t srcLen, uint8_t* dest, uint32_t destLen,
+                                   unsigned channels);
+    bool decompressCD(uint32_t codec, const uint8_t* src, uint32_t srcLen, uint8_t* dest, uint32_t destLen);
+
+    // All of these need m_mutex to be held.
+    Entry* allocate();
+    void release(Entry* entry);
+    Job* schedule(uint32_t hunk);
+
+    void dispatch(Job* job);
+    void runJob(Job* job);
+    void cancelJob(Job* job);
+
+    IO<File> m_file;
+    std::string m_error;
+
+    uint32_t m_compressors[4] = {0, 0, 0, 0};
+    uint64_t m_logicalBytes = 0;
+    uint64_t m_mapOffset = 0;
+    uint32_t m_hunkBytes = 0;
+    uint32_t m_unitBytes = 0;
+    uint32_t m_hunkCount = 0;
+    std::vector<MapEntry> m_map;
+    std::vector<Track> m_tracks;
+
+    const unsigned m_capacity;
+    const unsigned m_window;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    unsigned m_inFlight = 0;
+    bool m_inline = false;
+    Index m_index;
+    // Most recently used entries are at the front.
+    EntryList m_lru;
+    EntryList m_free;
+    // Needs to be destroyed first, so entries can unlink themselves.
+    std::unique_ptr<Entry[]> m_entries;
+    uint32_t m_lastHunk = 0xffffffff;
+
+    Stats m_stats;
+};
+
+}  // namespace PCSX
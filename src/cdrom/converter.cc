@@ -0,0 +1,262 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "cdrom/converter.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <semaphore>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "cdrom/cdriso.h"
+#include "fmt/format.h"
+#include "support/file.h"
+#include "supportpsx/iec-60908b.h"
+
+namespace {
+
+struct TrackLayout {
+    PCSX::CDRIso::TrackType type;
+    // Where INDEX 00 and INDEX 01 land in the output file.
+    uint32_t pregapStart;
+    uint32_t start;
+    unsigned mode = 2;
+};
+
+struct SBIEntry {
+    uint32_t lba;
+    uint8_t q[10];
+};
+
+struct WorkUnit {
+    WorkUnit() : ready(0) {}
+    std::binary_semaphore ready;
+    uint32_t first;
+    uint32_t count;
+    std::vector<uint8_t> sectors;
+    std::vector<SBIEntry> sbi;
+    PCSX::ImageConverter::Report report;
+};
+
+bool hasSync(const uint8_t *sector) {
+    static constexpr uint8_t sync[12] = {0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00};
+    return memcmp(sector, sync, sizeof(sync)) == 0;
+}
+
+}  // namespace
+
+PCSX::ImageConverter::Report PCSX::ImageConverter::toCueBin(const std::filesystem::path &cue) {
+    using namespace IEC60908b;
+    const unsigned threadCount = std::max(m_options.threads, 1u);
+    const unsigned chunkSize = std::max(m_options.chunkSize, 1u);
+    std::filesystem::path bin = cue;
+    bin.replace_extension(".bin");
+    std::filesystem::path sbiPath = cue;
+    sbiPath.replace_extension(".sbi");
+
+    const unsigned tracks = m_iso->getTN();
+    std::vector<TrackLayout> layout(tracks + 1);
+    uint8_t probe[FRAMESIZE_RAW];
+    for (unsigned t = 1; t <= tracks; t++) {
+        layout[t].type = m_iso->getTrackType(t);
+        layout[t].start = m_iso->getTD(t).toLBA() - 150;
+        layout[t].pregapStart = layout[t].start - m_iso->getPregap(t).toLBA();
+        if (layout[t].type == CDRIso::TrackType::DATA) {
+            if (m_iso->readSectors(layout[t].start, probe, 1) != 1) {
+                throw std::runtime_error(fmt::format("Unable to read the first sector of track {}", t));
+            }
+            if (hasSync(probe)) layout[t].mode = probe[15];
+        }
+    }
+    const uint32_t total = layout[tracks].start + m_iso->getLength(tracks).toLBA();
+    auto trackOf = [&layout, tracks](uint32_t lba) {
+        unsigned t = tracks;
+        while ((t > 1) && (lba < layout[t].pregapStart)) t--;
+        return t;
+    };
+
+    Sub sub;
+    const bool hasSub = m_iso->readSubchannel(0, &sub);
+    const bool hasSBI = m_iso->hasSBI();
+
+    IO<File> binFile(new PosixFile(bin, FileOps::TRUNCATE));
+    if (binFile->failed()) throw std::runtime_error(fmt::format("Unable to create {}", bin.string()));
+
+    // Workers can only run that many chunks ahead of the writer.
+    const unsigned window = threadCount * 2;
+    std::unique_ptr<WorkUnit[]> units(new WorkUnit[window]);
+    std::counting_semaphore<> slots(window);
+    const unsigned chunks = (total + chunkSize - 1) / chunkSize;
+    std::atomic<unsigned> nextChunk = 0;
+    std::atomic<bool> aborted = false;
+
+    auto process = [&](CDRIso *reader, WorkUnit &unit) {
+        uint8_t *data = unit.sectors.data();
+        // readSectors stops at the first failure, so skip over the bad ones.
+        uint32_t done = 0;
+        while (done < unit.count) {
+            done += reader->readSectors(unit.first + done, data + done * FRAMESIZE_RAW, unit.count - done);
+            if (done < unit.count) {
+                memset(data + done * FRAMESIZE_RAW, 0, FRAMESIZE_RAW);
+                unit.report.unreadable++;
+                done++;
+            }
+        }
+
+        for (uint32_t i = 0; i < unit.count; i++) {
+            const uint32_t lba = unit.first + i;
+            uint8_t *sector = data + i * FRAMESIZE_RAW;
+            const auto &track = layout[trackOf(lba)];
+            if (m_options.regenerateEDCECC && (track.type == CDRIso::TrackType::DATA) && hasSync(sector) &&
+                (sector[15] == 2)) {
+                uint8_t fixed[FRAMESIZE_RAW];
+                memcpy(fixed, sector, FRAMESIZE_RAW);
+                computeEDCECC(fixed);
+                if (memcmp(fixed, sector, FRAMESIZE_RAW) != 0) {
+                    static constexpr uint8_t zero[4] = {0, 0, 0, 0};
+                    const bool form2 = sector[18] & 0x20;
+                    if (!form2 || (memcmp(sector + 2348, zero, sizeof(zero)) != 0)) {
+                        memcpy(sector, fixed, FRAMESIZE_RAW);
+                        unit.report.regenerated++;
+                    }
+                }
+            }
+
+            uint8_t time[3];
+            MSF(lba + 150).toBCD(time);
+            const uint8_t *sbiq = hasSBI ? m_iso->findSBI(time) : nullptr;
+            Sub subchannel;
+            if (hasSub && reader->readSubchannel(lba, &subchannel)) {
+                uint16_t crc = (subchannel.CRC[0] << 8) | subchannel.CRC[1];
+                const bool badQ = subqCRC(subchannel.Q) != crc;
+                if (badQ) {
+                    SBIEntry entry{lba};
+                    memcpy(entry.q, subchannel.Q, sizeof(entry.q));
+                    unit.sbi.push_back(entry);
+                    unit.report.subqErrors++;
+                }
+                if (hasSBI && (badQ != (sbiq != nullptr))) unit.report.sbiMismatches++;
+            } else if (sbiq) {
+                SBIEntry entry{lba};
+                memcpy(entry.q, sbiq, sizeof(entry.q));
+                unit.sbi.push_back(entry);
+            }
+        }
+    };
+
+    // A CDRIso serializes its reads, so each worker gets the image opened
+    // again, with its own file handles, to decode it in parallel. Workers
+    // whose image fails to open share the caller's.
+    std::vector<std::unique_ptr<CDRIso>> readers;
+    for (unsigned i = 0; i < threadCount; i++) {
+        readers.emplace_back(new CDRIso(m_iso->getIsoPath()));
+        if (readers.back()->failed()) readers.back().reset();
+    }
+
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < threadCount; i++) {
+        CDRIso *reader = readers[i] ? readers[i].get() : m_iso;
+        workers.emplace_back([&, reader]() {
+            while (true) {
+                slots.acquire();
+                if (aborted.load()) return;
+                unsigned chunk = nextChunk.fetch_add(1);
+                if (chunk >= chunks) {
+                    slots.release();
+                    return;
+                }
+                auto &unit = units[chunk % window];
+                unit.first = chunk * chunkSize;
+                unit.count = std::min(chunkSize, total - unit.first);
+                unit.sectors.resize(unit.count * FRAMESIZE_RAW);
+                unit.sbi.clear();
+                unit.report = {};
+                process(reader, unit);
+                unit.report.sectors = unit.count;
+                unit.ready.release();
+            }
+        });
+    }
+    auto stopWorkers = [&]() {
+        aborted.store(true);
+        slots.release(threadCount);
+        for (auto &worker : workers) worker.join();
+    };
+
+    Report report;
+    std::vector<SBIEntry> sbi;
+    for (unsigned chunk = 0; chunk < chunks; chunk++) {
+        auto &unit = units[chunk % window];
+        unit.ready.acquire();
+        const ssize_t size = unit.sectors.size();
+        if (binFile->write(unit.sectors.data(), size) != size) {
+            stopWorkers();
+            throw std::runtime_error(fmt::format("Unable to write to {}", bin.string()));
+        }
+        report.sectors += unit.report.sectors;
+        report.unreadable += unit.report.unreadable;
+        report.regenerated += unit.report.regenerated;
+        report.subqErrors += unit.report.subqErrors;
+        report.sbiMismatches += unit.report.sbiMismatches;
+        sbi.insert(sbi.end(), unit.sbi.begin(), unit.sbi.end());
+        slots.release();
+    }
+    stopWorkers();
+    binFile->close();
+
+    std::string cueData = fmt::format("FILE \"{}\" BINARY\n", bin.filename().string());
+    for (unsigned t = 1; t <= tracks; t++) {
+        const auto &track = layout[t];
+        const char *type = track.type == CDRIso::TrackType::CDDA ? "AUDIO"
+                           : track.mode == 1                      ? "MODE1/2352"
+                                                                  : "MODE2/2352";
+        cueData += fmt::format("  TRACK {:02} {}\n", t, type);
+        if (track.pregapStart != track.start) cueData += fmt::format("    INDEX 00 {}\n", MSF(track.pregapStart));
+        cueData += fmt::format("    INDEX 01 {}\n", MSF(track.start));
+    }
+    IO<File> cueFile(new PosixFile(cue, FileOps::TRUNCATE));
+    if (cueFile->failed() || (cueFile->write(cueData.data(), cueData.size()) != ssize_t(cueData.size()))) {
+        throw std::runtime_error(fmt::format("Unable to write to {}", cue.string()));
+    }
+    cueFile->close();
+
+    // Same layout as what CDRIso::LoadSBI expects: a header, then for each
+    // sector its BCD time, a type byte, and the full Q data.
+    if (!sbi.empty()) {
+        IO<File> sbiFile(new PosixFile(sbiPath, FileOps::TRUNCATE));
+        if (sbiFile->failed()) throw std::runtime_error(fmt::format("Unable to create {}", sbiPath.string()));
+        sbiFile->write("SBI", 4);
+        for (auto &entry : sbi) {
+            uint8_t record[14];
+            MSF(entry.lba + 150).toBCD(record);
+            record[3] = 1;
+            memcpy(record + 4, entry.q, sizeof(entry.q));
+            sbiFile->write(record, sizeof(record));
+        }
+        sbiFile->close();
+    }
+    report.sbiEntries = sbi.size();
+
+    return report;
+}
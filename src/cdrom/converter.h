@@ -0,0 +1,67 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <filesystem>
+#include <thread>
+
+namespace PCSX {
+
+class CDRIso;
+
+// Converts anything CDRIso can read into a single bin file with its cue sheet,
+// and an sbi file if the disc has any subchannel Q errors. Sectors are read,
+// decoded and verified in chunks by a pool of workers, each with its own
+// reader, while the calling thread writes them out in order.
+//
+// Mode 2 sectors get their EDC and ECC recomputed, and rewritten if they don't
+// match, except for Form 2 sectors with a zeroed EDC, which is legal. When the
+// image has subchannel data, the Q CRC of each sector is checked, and compared
+// against the SBI data loaded alongside the image, if any.
+class ImageConverter {
+  public:
+    struct Options {
+        unsigned threads = std::thread::hardware_concurrency();
+        // Sectors per work unit.
+        unsigned chunkSize = 256;
+        bool regenerateEDCECC = true;
+    };
+    struct Report {
+        uint32_t sectors = 0;
+        uint32_t unreadable = 0;
+        uint32_t regenerated = 0;
+        uint32_t subqErrors = 0;
+        // Sectors flagged by only one of the subchannel data and the SBI file.
+        uint32_t sbiMismatches = 0;
+        uint32_t sbiEntries = 0;
+    };
+
+    ImageConverter(CDRIso* iso, const Options& options) : m_iso(iso), m_options(options) {}
+    // Writes the .cue file and its .bin and .sbi siblings. Throws on I/O errors.
+    Report toCueBin(const std::filesystem::path& cue);
+
+  private:
+    CDRIso* m_iso;
+    Options m_options;
+};
+
+}  // namespace PCSX
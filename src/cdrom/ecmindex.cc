@@ -0,0 +1,282 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "cdrom/ecmindex.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+namespace {
+
+constexpr uint32_t c_sidecarMagic = 0x494d4345;  // 'ECMI'
+constexpr uint32_t c_sidecarVersion = 1;
+constexpr size_t c_sidecarHeaderSize = 28;
+constexpr size_t c_sidecarEntrySize = 13;
+
+void reconstructSector(uint8_t *sector, uint8_t type) {
+    // Sync
+    sector[0x000] = 0x00;
+    memset(sector + 0x001, 0xff, 10);
+    sector[0x00b] = 0x00;
+
+    switch (type) {
+        case 1:
+            // Mode
+            sector[0x00f] = 0x01;
+            // Empty
+            memset(sector + 0x814, 0, 8);
+            break;
+        case 2:
+        case 3:
+            // Mode
+            sector[0x00f] = 0x02;
+            // Subheaders
+            sector[0x010] = sector[0x014];
+            sector[0x011] = sector[0x015];
+            sector[0x012] = sector[0x016];
+            sector[0x013] = sector[0x017];
+            break;
+    }
+
+    PCSX::IEC60908b::computeEDCECC(sector);
+}
+
+}  // namespace
+
+bool PCSX::ECMIndex::Reader::fill() {
+    ssize_t r = m_file->readAt(m_buffer.get(), m_bufferSize, m_pos);
+    if (r <= 0) return false;
+    m_start = m_pos;
+    m_end = m_pos + r;
+    return true;
+}
+
+bool PCSX::ECMIndex::Reader::read(uint8_t *dest, uint32_t size) {
+    while (size) {
+        if ((m_pos < m_start) || (m_pos >= m_end)) {
+            if (!fill()) return false;
+        }
+        uint32_t chunk = std::min(size, m_end - m_pos);
+        memcpy(dest, m_buffer.get() + m_pos - m_start, chunk);
+        dest += chunk;
+        m_pos += chunk;
+        size -= chunk;
+    }
+    return true;
+}
+
+/* Adapted from ecm.c:unecmify() (C) Neill Corlett */
+PCSX::ECMIndex::Step PCSX::ECMIndex::step(Reader &reader, Cursor &cursor, uint8_t *sector, uint32_t processFrom) {
+    if (cursor.remaining == 0) {
+        int c = reader.getc();
+        if (c < 0) return Step::ERROR;
+        int bits = 5;
+        uint8_t type = c & 3;
+        uint32_t num = (c >> 2) & 0x1f;
+        while (c & 0x80) {
+            c = reader.getc();
+            if (c < 0) return Step::ERROR;
+            if ((bits > 31) || ((uint32_t)(c & 0x7f)) >= (0x80000000U >> (bits - 1))) return Step::ERROR;
+            num |= ((uint32_t)(c & 0x7f)) << bits;
+            bits += 7;
+        }
+        // End indicator
+        if (num == 0xffffffff) return Step::END;
+        cursor.type = type;
+        cursor.remaining = num + 1;
+    }
+
+    uint32_t offset = cursor.bytes % IEC60908b::FRAMESIZE_RAW;
+    uint32_t size = 0;
+    uint32_t payload = 0;
+    switch (cursor.type) {
+        case 0:  // META
+            size = payload = std::min(cursor.remaining, uint32_t(IEC60908b::FRAMESIZE_RAW) - offset);
+            break;
+        case 1:  // Mode 1
+            size = 2352;
+            payload = 0x803;
+            break;
+        case 2:  // Mode 2 (XA), form 1
+            size = 2336;
+            payload = 0x804;
+            break;
+        case 3:  // Mode 2 (XA), form 2
+            size = 2336;
+            payload = 0x918;
+            break;
+    }
+
+    if ((cursor.bytes + size) <= processFrom) {
+        reader.skip(payload);
+    } else {
+        switch (cursor.type) {
+            case 0:
+                if (!reader.read(sector + offset, size)) return Step::ERROR;
+                break;
+            case 1:
+                if (!reader.read(sector + 0x00c, 0x003)) return Step::ERROR;
+                if (!reader.read(sector + 0x010, 0x800)) return Step::ERROR;
+                reconstructSector(sector, cursor.type);
+                break;
+            case 2:
+            case 3:
+                if (!reader.read(sector + 0x014, payload)) return Step::ERROR;
+                reconstructSector(sector, cursor.type);
+                break;
+        }
+    }
+
+    cursor.filepos = reader.tell();
+    cursor.bytes += size;
+    cursor.remaining -= cursor.type == 0 ? size : 1;
+    return Step::OK;
+}
+
+PCSX::ECMIndex::ECMIndex(IO<File> image, unsigned interval) : m_image(image), m_interval(interval) {
+    m_entries.emplace_back();
+}
+
+PCSX::ECMIndex::~ECMIndex() {
+    m_cancel.store(true, std::memory_order_relaxed);
+    if (m_thread.joinable()) m_thread.join();
+}
+
+bool PCSX::ECMIndex::scan(IO<File> file) {
+    // The walk only reads record headers, but they're densely packed enough
+    // that it's cheaper to read the file in large chunks than to seek around.
+    Reader reader(file, HEADER_SIZE, 256 * 1024);
+    Cursor cursor;
+    uint32_t next = m_interval;
+    while (!m_cancel.load(std::memory_order_relaxed)) {
+        switch (step(reader, cursor, nullptr, 0xffffffff)) {
+            case Step::ERROR:
+                return false;
+            case Step::END:
+                m_sectors = cursor.sector();
+                m_complete.store(true, std::memory_order_release);
+                return true;
+            case Step::OK:
+                break;
+        }
+        if (cursor.aligned() && (cursor.sector() >= next)) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_entries.push_back(cursor);
+            next = cursor.sector() + m_interval;
+        }
+    }
+    return false;
+}
+
+bool PCSX::ECMIndex::build() {
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_running || complete()) return complete();
+        m_entries.resize(1);
+    }
+    return scan(m_image);
+}
+
+bool PCSX::ECMIndex::buildAsync(const std::filesystem::path &sidecar) {
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_running || complete()) return true;
+    }
+    // UvFile reads are serviced by libuv's threadpool, and its handle can go
+    // away from under a concurrent reader once caching completes, so the walk
+    // gets a plain file of its own instead.
+    auto filename = m_image->filename();
+    if (filename.empty()) return false;
+    IO<File> file(new PosixFile(filename));
+    if (file->failed()) return false;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_entries.resize(1);
+        m_running = true;
+    }
+    if (m_thread.joinable()) m_thread.join();
+    m_thread = std::thread([this, file, sidecar]() {
+        if (scan(file) && !sidecar.empty()) save(sidecar);
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_running = false;
+    });
+    return true;
+}
+
+PCSX::ECMIndex::Cursor PCSX::ECMIndex::find(uint32_t sector) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto i = std::upper_bound(m_entries.begin(), m_entries.end(), sector,
+                              [](uint32_t sector, const Cursor &cursor) { return sector < cursor.sector(); });
+    return *--i;
+}
+
+bool PCSX::ECMIndex::load(const std::filesystem::path &path) {
+    IO<File> file(new PosixFile(path));
+    if (file->failed()) return false;
+    if (file->read<uint32_t>() != c_sidecarMagic) return false;
+    if (file->read<uint32_t>() != c_sidecarVersion) return false;
+    if (file->read<uint32_t>() != m_interval) return false;
+    if (file->read<uint64_t>() != m_image->size()) return false;
+    uint32_t sectors = file->read<uint32_t>();
+    uint32_t count = file->read<uint32_t>();
+    if ((count == 0) || (count > (sectors / m_interval + 1))) return false;
+    if (file->size() != (c_sidecarHeaderSize + count * c_sidecarEntrySize)) return false;
+
+    std::vector<Cursor> entries;
+    entries.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+        Cursor cursor;
+        cursor.filepos = file->read<uint32_t>();
+        cursor.bytes = file->read<uint32_t>();
+        cursor.remaining = file->read<uint32_t>();
+        cursor.type = file->byte();
+        if (!cursor.aligned() || (cursor.type > 3) || (cursor.sector() > sectors)) return false;
+        if (!entries.empty() && (entries.back().bytes >= cursor.bytes)) return false;
+        entries.push_back(cursor);
+    }
+    if ((entries[0].bytes != 0) || (entries[0].filepos != HEADER_SIZE)) return false;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_running) return false;
+    m_entries = std::move(entries);
+    m_sectors = sectors;
+    m_complete.store(true, std::memory_order_release);
+    return true;
+}
+
+bool PCSX::ECMIndex::save(const std::filesystem::path &path) {
+    if (!complete()) return false;
+    IO<File> file(new PosixFile(path, FileOps::TRUNCATE));
+    if (file->failed()) return false;
+    file->write<uint32_t>(c_sidecarMagic);
+    file->write<uint32_t>(c_sidecarVersion);
+    file->write<uint32_t>(m_interval);
+    file->write<uint64_t>(m_image->size());
+    file->write<uint32_t>(m_sectors);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    file->write<uint32_t>(m_entries.size());
+    for (auto &cursor : m_entries) {
+        file->write<uint32_t>(cursor.filepos);
+        file->write<uint32_t>(cursor.bytes);
+        file->write<uint32_t>(cursor.remaining);
+        file->write<uint8_t>(cursor.type);
+    }
+    return true;
+}
@@ -0,0 +1,130 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "support/file.h"
+#include "supportpsx/iec-60908b.h"
+
+namespace PCSX {
+
+// Random access index for ECM images. The ECM format is a stream of records, each
+// with a type and a count, so figuring out where a given sector lives in the file
+// requires walking all of the records before it. The index walks the file once,
+// and remembers the decoder state every `interval` sectors, which means seeking
+// anywhere in the image will never decode more than `interval` sectors.
+//
+// The walk can be done synchronously, or in the background on a thread of its own,
+// in which case lookups will return the furthest position indexed so far. The
+// result can be saved next to the image, so the next run doesn't have to do it.
+class ECMIndex {
+  public:
+    static constexpr unsigned HEADER_SIZE = 4;
+
+    // The decoder state in between two sectors.
+    struct Cursor {
+        // Position of either the next record header, or the next payload in the current record.
+        uint32_t filepos = HEADER_SIZE;
+        // Amount of decoded bytes before that position.
+        uint32_t bytes = 0;
+        // Units left to decode in the current record. Zero if filepos points to a header.
+        uint32_t remaining = 0;
+        uint8_t type = 0;
+        uint32_t sector() const { return bytes / IEC60908b::FRAMESIZE_RAW; }
+        bool aligned() const { return (bytes % IEC60908b::FRAMESIZE_RAW) == 0; }
+    };
+
+    // Buffered reader on top of readAt, so it never touches the file's cursor,
+    // and doesn't go through one File call per record header.
+    class Reader {
+      public:
+        Reader(IO<File> file, uint32_t pos, unsigned bufferSize = 16384)
+            : m_file(file), m_buffer(new uint8_t[bufferSize]), m_bufferSize(bufferSize), m_pos(pos) {}
+        int getc() {
+            if ((m_pos < m_start) || (m_pos >= m_end)) {
+                if (!fill()) return -1;
+            }
+            return m_buffer[m_pos++ - m_start];
+        }
+        bool read(uint8_t* dest, uint32_t size);
+        void seek(uint32_t pos) { m_pos = pos; }
+        void skip(uint32_t size) { m_pos += size; }
+        uint32_t tell() const { return m_pos; }
+
+      private:
+        bool fill();
+        IO<File> m_file;
+        std::unique_ptr<uint8_t[]> m_buffer;
+        const unsigned m_bufferSize;
+        uint32_t m_pos;
+        uint32_t m_start = 0;
+        uint32_t m_end = 0;
+    };
+
+    enum class Step { OK, END, ERROR };
+    // Decodes the next unit of the stream, meaning either a whole sector, or a run
+    // of raw bytes that doesn't cross a sector boundary. Units which end before
+    // the `processFrom` byte offset are skipped over instead of being decoded
+    // into `sector`, which then may be nullptr when only walking the stream.
+    static Step step(Reader& reader, Cursor& cursor, uint8_t* sector, uint32_t processFrom);
+
+    ECMIndex(IO<File> image, unsigned interval = 64);
+    ~ECMIndex();
+
+    // Walks the whole image right away.
+    bool build();
+    // Walks the image from a background thread, through a handle of its own so
+    // it never shares one with the emulation, optionally saving the index once
+    // done. Returns false if the image couldn't be opened a second time.
+    bool buildAsync(const std::filesystem::path& sidecar = {});
+    bool load(const std::filesystem::path& path);
+    bool save(const std::filesystem::path& path);
+
+    // Returns the closest indexed position at or before the sector.
+    Cursor find(uint32_t sector);
+    bool complete() const { return m_complete.load(std::memory_order_acquire); }
+    // Total amount of sectors in the image; only valid once the index is complete.
+    uint32_t sectors() const { return m_sectors; }
+
+  private:
+    bool scan(IO<File> file);
+
+    IO<File> m_image;
+    const unsigned m_interval;
+
+    std::mutex m_mutex;
+    std::thread m_thread;
+    bool m_running = false;
+    std::atomic<bool> m_cancel = false;
+    std::atomic<bool> m_complete = false;
+    uint32_t m_sectors = 0;
+    // Sorted by position, and the first entry is always the beginning of the stream.
+    std::vector<Cursor> m_entries;
+};
+
+}  // namespace PCSX
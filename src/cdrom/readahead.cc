@@ -0,0 +1,207 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+
+#include "cdrom/readahead.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+PCSX::ReadAheadCache::ReadAheadCache(Fetcher&& fetcher, unsigned capacity, unsigned window)
+    : m_fetcher(std::move(fetcher)),
+      m_capacity(capacity),
+      m_window(std::min(window, capacity / 2)),
+      m_entries(new Entry[capacity]) {
+    for (unsigned i = 0; i < m_capacity; i++) m_free.push_back(&m_entries[i]);
+    m_thread = std::thread([this]() { run(); });
+}
+
+PCSX::ReadAheadCache::~ReadAheadCache() {
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_closing = true;
+    }
+    m_queueCv.notify_all();
+    // Waits for the job in progress, if any, which may still be using the image.
+    m_thread.join();
+}
+
+PCSX::ReadAheadCache::Entry* PCSX::ReadAheadCache::allocate() {
+    Entry* entry = nullptr;
+    if (!m_free.empty()) {
+        entry = &*m_free.begin();
+    } else if (!m_lru.empty()) {
+        entry = &*(--m_lru.end());
+        if (!entry->used) m_stats.wasted++;
+        m_index.unlink(entry);
+    } else {
+        // Everything is in flight.
+        return nullptr;
+    }
+    static_cast<EntryList::Node*>(entry)->unlink();
+    entry->state = Entry::State::PENDING;
+    entry->used = false;
+    return entry;
+}
+
+void PCSX::ReadAheadCache::release(Entry* entry) {
+    m_index.unlink(entry);
+    entry->state = Entry::State::FREE;
+    m_free.push_back(entry);
+}
+
+bool PCSX::ReadAheadCache::read(uint32_t track, uint32_t sector, uint8_t* dest) {
+    const uint64_t key = makeKey(track, sector);
+    bool hit = false;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            auto i = m_index.find(key);
+            if (i == m_index.end()) break;
+            if (i->state == Entry::State::PENDING) {
+                // The prefetcher is already on it, and it's going to
+                // be faster to wait than to race it for the image.
+                m_cv.wait(lock);
+                continue;
+            }
+            memcpy(dest, i->data, IEC60908b::FRAMESIZE_RAW);
+            i->used = true;
+            m_lru.push_front(&*i);
+            m_stats.hits++;
+            hit = true;
+            break;
+        }
+        if (!hit) m_stats.misses++;
+    }
+
+    if (!hit) {
+        if (!m_fetcher(track, sector, dest)) return false;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_index.find(key) == m_index.end()) {
+            Entry* entry = allocate();
+            if (entry) {
+                memcpy(entry->data, dest, IEC60908b::FRAMESIZE_RAW);
+                entry->state = Entry::State::READY;
+                entry->used = true;
+                m_index.insert(key, entry);
+                m_lru.push_front(entry);
+            }
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    predict(track, sector);
+    return true;
+}
+
+void PCSX::ReadAheadCache::prefetch(uint32_t track, uint32_t sector, unsigned count) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    schedule(track, sector, std::min(count, m_window));
+}
+
+void PCSX::ReadAheadCache::flush() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_lru.empty()) release(&*m_lru.begin());
+}
+
+PCSX::ReadAheadCache::Stats PCSX::ReadAheadCache::getStats() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void PCSX::ReadAheadCache::predict(uint32_t track, uint32_t sector) {
+    if ((track == m_lastTrack) && (sector == (m_lastSector + 1))) {
+        m_streak++;
+    } else {
+        m_streak = 0;
+        m_aheadUntil = sector;
+    }
+    m_lastTrack = track;
+    m_lastSector = sector;
+
+    // A single read after a seek isn't a stream yet; the CD-ROM controller
+    // often reads a sector just to update its subchannel position.
+    if (m_streak == 0) return;
+    // Don't issue tiny jobs: wait until half of the window has been consumed.
+    if (m_aheadUntil > (sector + m_window / 2)) return;
+    uint32_t start = std::max(m_aheadUntil, sector) + 1;
+    uint32_t end = sector + m_window;
+    schedule(track, start, end - start + 1);
+    m_aheadUntil = end;
+}
+
+void PCSX::ReadAheadCache::schedule(uint32_t track, uint32_t sector, unsigned count) {
+    Job* job = nullptr;
+    for (unsigned i = 0; i < count; i++) {
+        uint64_t key = makeKey(track, sector + i);
+        if (m_index.find(key) != m_index.end()) continue;
+        Entry* entry = allocate();
+        if (!entry) break;
+        m_index.insert(key, entry);
+        if (!job) {
+            job = &m_queue.emplace_back();
+            job->track = track;
+        }
+        job->sectors.emplace_back(sector + i, entry);
+    }
+    if (!job) return;
+    m_queueCv.notify_one();
+}
+
+void PCSX::ReadAheadCache::run() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_queueCv.wait(lock, [this]() { return m_closing || !m_queue.empty(); });
+        if (m_closing) break;
+        Job job = std::move(m_queue.front());
+        m_queue.pop_front();
+        lock.unlock();
+        runJob(job);
+        lock.lock();
+    }
+    while (!m_queue.empty()) {
+        cancelJob(m_queue.front());
+        m_queue.pop_front();
+    }
+}
+
+void PCSX::ReadAheadCache::runJob(Job& job) {
+    auto i = job.sectors.begin();
+    for (; i != job.sectors.end(); i++) {
+        // The entry is pending, so nobody else is going to look at its data.
+        bool success = m_fetcher(job.track, i->first, i->second->data);
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!success) break;
+        i->second->state = Entry::State::READY;
+        m_lru.push_front(i->second);
+        m_stats.prefetched++;
+        m_cv.notify_all();
+    }
+
+    // Most likely the end of the track; no point in trying the rest.
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (; i != job.sectors.end(); i++) release(i->second);
+    m_cv.notify_all();
+}
+
+void PCSX::ReadAheadCache::cancelJob(Job& job) {
+    for (auto& i : job.sectors) release(i.second);
+    m_cv.notify_all();
+}
@@ -0,0 +1,128 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+
+#pragma once
+
+#include <stdint.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "support/hashtable.h"
+#include "support/list.h"
+#include "supportpsx/iec-60908b.h"
+
+namespace PCSX {
+
+// Read-ahead engine for CDRIso. Sectors are addressed by a (track, sector) pair,
+// where track 0 designates the main data handle, and any other value designates
+// the handle of a CDDA track. The cache holds decoded raw sectors, before any PPF
+// patching or byte swapping is applied.
+//
+// Prefetch jobs run on a thread of their own, which means they can still use
+// the blocking File API. They can't go on libuv's threadpool: a UvFile read
+// queues its own request on that pool and waits for it, which deadlocks once
+// all of the pool's threads are busy prefetching. The fetcher is called from
+// both the emulation thread and the prefetch thread, and is responsible for
+// serializing accesses to the underlying image.
+class ReadAheadCache {
+  public:
+    typedef std::function<bool(uint32_t track, uint32_t sector, uint8_t* dest)> Fetcher;
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t prefetched = 0;
+        // Sectors that got evicted before anyone read them.
+        uint64_t wasted = 0;
+    };
+
+    ReadAheadCache(Fetcher&& fetcher, unsigned capacity = 1024, unsigned window = 32);
+    ~ReadAheadCache();
+
+    // Reads a sector, either from the cache, or synchronously through the fetcher
+    // on a miss. Sequential reads will keep the next window of sectors in flight.
+    bool read(uint32_t track, uint32_t sector, uint8_t* dest);
+    // Starts fetching a run of sectors ahead of time, typically on a seek.
+    void prefetch(uint32_t track, uint32_t sector, unsigned count);
+    // Drops all of the decoded sectors. In-flight ones will still land.
+    void flush();
+    Stats getStats();
+
+  private:
+    static constexpr uint64_t makeKey(uint32_t track, uint32_t sector) { return (uint64_t(track) << 32) | sector; }
+
+    struct Entry;
+    typedef Intrusive::HashTable<uint64_t, Entry> Index;
+    typedef Intrusive::List<Entry> EntryList;
+    struct Entry : public Index::Node, public EntryList::Node {
+        enum class State { FREE, PENDING, READY } state = State::FREE;
+        bool used = false;
+        uint8_t data[IEC60908b::FRAMESIZE_RAW];
+    };
+    struct Job {
+        uint32_t track;
+        std::vector<std::pair<uint32_t, Entry*>> sectors;
+    };
+
+    // All of these need m_mutex to be held.
+    Entry* allocate();
+    void release(Entry* entry);
+    void schedule(uint32_t track, uint32_t sector, unsigned count);
+    void predict(uint32_t track, uint32_t sector);
+    void cancelJob(Job& job);
+
+    void run();
+    void runJob(Job& job);
+
+    Fetcher m_fetcher;
+    const unsigned m_capacity;
+    const unsigned m_window;
+
+    std::mutex m_mutex;
+    // Signaled whenever a pending entry lands.
+    std::condition_variable m_cv;
+    // Signaled whenever a job gets queued, or on destruction.
+    std::condition_variable m_queueCv;
+    std::deque<Job> m_queue;
+    bool m_closing = false;
+    std::thread m_thread;
+
+    Index m_index;
+    // Most recently used entries are at the front.
+    EntryList m_lru;
+    EntryList m_free;
+    // Needs to be destroyed first, so entries can unlink themselves.
+    std::unique_ptr<Entry[]> m_entries;
+
+    uint32_t m_lastTrack = 0;
+    uint32_t m_lastSector = 0xffffffff;
+    uint32_t m_aheadUntil = 0;
+    unsigned m_streak = 0;
+
+    Stats m_stats;
+};
+
+}  // namespace PCSX
@@ -680,7 +680,8 @@ template <int size, bool signExtend>
 void DynaRecCPU::recompileLoad(uint32_t code) {
     if (m_gprs[_Rs_].isConst()) {  // Store the address in first argument register
         const uint32_t addr = m_gprs[_Rs_].val + _Imm_;
-        const auto pointer = PCSX::g_emulator->m_mem->pointerRead(addr);
+        const auto& mem = PCSX::g_emulator->m_mem;
+        const auto pointer = mem->isHooked(addr) ? nullptr : mem->pointerRead(addr);
 
         if (pointer != nullptr && (_Rt_) != 0) {
             allocateRegWithoutLoad(_Rt_);
@@ -1007,7 +1008,8 @@ void DynaRecCPU::recRFE(uint32_t code) {
 void DynaRecCPU::recSB(uint32_t code) {
     if (m_gprs[_Rs_].isConst()) {
         const uint32_t addr = m_gprs[_Rs_].val + _Imm_;
-        const auto pointer = PCSX::g_emulator->m_mem->pointerWrite(addr, 8);
+        const auto& mem = PCSX::g_emulator->m_mem;
+        const auto pointer = mem->isHooked(addr) ? nullptr : mem->pointerWrite(addr, 8);
 
         if (pointer != nullptr) {
             if (m_gprs[_Rt_].isConst()) {
@@ -1048,7 +1050,8 @@ void DynaRecCPU::recSB(uint32_t code) {
 void DynaRecCPU::recSH(uint32_t code) {
     if (m_gprs[_Rs_].isConst()) {
         const uint32_t addr = m_gprs[_Rs_].val + _Imm_;
-        const auto pointer = PCSX::g_emulator->m_mem->pointerWrite(addr, 16);
+        const auto& mem = PCSX::g_emulator->m_mem;
+        const auto pointer = mem->isHooked(addr) ? nullptr : mem->pointerWrite(addr, 16);
         if (pointer != nullptr) {
             if (m_gprs[_Rt_].isConst()) {
                 store<16>(m_gprs[_Rt_].val & 0xFFFF, pointer);
@@ -1118,7 +1121,8 @@ void DynaRecCPU::recSH(uint32_t code) {
 void DynaRecCPU::recSW(uint32_t code) {
     if (m_gprs[_Rs_].isConst()) {
         const uint32_t addr = m_gprs[_Rs_].val + _Imm_;
-        const auto pointer = PCSX::g_emulator->m_mem->pointerWrite(addr, 32);
+        const auto& mem = PCSX::g_emulator->m_mem;
+        const auto pointer = mem->isHooked(addr) ? nullptr : mem->pointerWrite(addr, 32);
         if (pointer != nullptr) {
             if (m_gprs[_Rt_].isConst()) {
                 store<32>(m_gprs[_Rt_].val, pointer);
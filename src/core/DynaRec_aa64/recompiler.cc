@@ -115,7 +115,7 @@ DynarecCallback* DynaRecCPU::getBlockPointer(uint32_t pc) {
 void DynaRecCPU::signalShellReached(DynaRecCPU* that) {
     if (!that->m_shellStarted) {
         that->m_shellStarted = true;
-        PCSX::g_system->m_eventBus->signal(PCSX::Events::ExecutionFlow::ShellReached{});
+        PCSX::g_emulator->m_eventBus->signal(PCSX::Events::ExecutionFlow::ShellReached{});
     }
 }
 
@@ -136,6 +136,7 @@ void DynaRecCPU::uncompileAll() {
 }
 
 void DynaRecCPU::flushCache() {
+    PCSX::g_emulator->m_perfCounters->add(PCSX::PerfCounters::Counter::DynarecFlushes);
     gen.Reset();       // Reset the emitter's code pointer and code size variables
     emitDispatcher();  // Re-emit dispatcher
     uncompileAll();    // Mark all blocks as uncompiled
@@ -184,13 +185,13 @@ void DynaRecCPU::emitDispatcher() {
 
     loadThisPointer(arg1.X());  // Poll events
     call(recBranchTestWrapper);
-    gen.Mov(runningPointer, (uintptr_t)PCSX::g_system->runningPtr());   // Move runningPtr to runningPointer register
-    gen.Ldrb(w0, MemOperand(runningPointer));                           // Check if PCSX::g_system->running is true
-    gen.Cbz(w0, &done);                                                 // If it's not, return
-    gen.Mov(runningPointer, (uintptr_t)PCSX::g_system->quittingPtr());  // Load pointer to "quitting" variable
-    gen.Ldrb(w0, MemOperand(runningPointer));                           // Check if PCSX::g_system->quitting is true
-    gen.Cbnz(w0, &done);                                                // If it is, return
-    emitBlockLookup();                                                  // Otherwise, look up next block
+    gen.Mov(runningPointer, (uintptr_t)PCSX::g_emulator->runningPtr());  // Move runningPtr to runningPointer register
+    gen.Ldrb(w0, MemOperand(runningPointer));                            // Check if the emulator is running
+    gen.Cbz(w0, &done);                                                  // If it's not, return
+    gen.Mov(runningPointer, (uintptr_t)PCSX::g_system->quittingPtr());   // Load pointer to "quitting" variable
+    gen.Ldrb(w0, MemOperand(runningPointer));                            // Check if PCSX::g_system->quitting is true
+    gen.Cbnz(w0, &done);                                                 // If it is, return
+    emitBlockLookup();                                                   // Otherwise, look up next block
 
     gen.align();
 
@@ -246,6 +247,8 @@ DynarecCallback DynaRecCPU::recompile(DynarecCallback* callback, uint32_t pc, bo
 
     const auto startingPC = m_pc;
     int count = 0;  // How many instructions have we compiled?
+    auto& perfCounters = PCSX::g_emulator->m_perfCounters;
+    perfCounters->add(PCSX::PerfCounters::Counter::DynarecBlocks);
 
 #if defined(__APPLE__)
     gen.setRW();  // Mark code cache as readable/writeable before emitting code
@@ -307,6 +310,10 @@ DynarecCallback DynaRecCPU::recompile(DynarecCallback* callback, uint32_t pc, bo
     gen.Ldr(x0, MemOperand(contextPointer, CYCLE_OFFSET));  // Fetch cycle count from memory
     gen.Add(x0, x0, count * PCSX::Emulator::BIAS);          // Add block cycles
     gen.Str(x0, MemOperand(contextPointer, CYCLE_OFFSET));  // Store cycles back to memory
+    gen.Mov(x1, (uintptr_t)perfCounters->instructionCounter(PCSX::PerfCounters::BlockType::Dynarec));
+    gen.Ldr(x0, MemOperand(x1));  // Count the block's instructions
+    gen.Add(x0, x0, count);
+    gen.Str(x0, MemOperand(x1));
 
     // Link block else return to dispatcher
     if (m_linkedPC && ENABLE_BLOCK_LINKING && m_linkedPC.value() != startingPC) {
@@ -27,6 +27,7 @@
 #include <stdexcept>
 #include <string>
 
+#include "core/perf-counters.h"
 #include "emitter.h"
 #include "fmt/format.h"
 #include "regAllocation.h"
@@ -202,6 +203,9 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
 
     static void signalShellReached(DynaRecCPU* that);
     static DynarecCallback recRecompileWrapper(DynaRecCPU* that, DynarecCallback* callback) {
+        // Also covers the blocks compiled while linking this one.
+        PCSX::PerfCounters::ScopedTimer timer(PCSX::g_emulator->m_perfCounters.get(),
+                                              PCSX::PerfCounters::Subsystem::Dynarec);
         return that->recompile(callback, that->m_regs.pc);
     }
 
@@ -234,6 +238,7 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
             *pointer++ = m_uncompiledBlock;
         }
     }
+    virtual void memoryHookAdded() final { uncompileAll(); }
     virtual void Shutdown() final;
     virtual bool isDynarec() final { return true; }
 
@@ -22,6 +22,9 @@
 #if defined(DYNAREC_X86_64)
 #include <cassert>
 
+#include "core/accesstracker.h"
+#include "core/debug.h"
+
 bool DynaRecCPU::Init() {
     // Initialize recompiler memory
     // Check for 8MB RAM expansion
@@ -126,7 +129,7 @@ DynarecCallback* DynaRecCPU::getBlockPointer(uint32_t pc) {
 void DynaRecCPU::signalShellReached(DynaRecCPU* that) {
     if (!that->m_shellStarted) {
         that->m_shellStarted = true;
-        PCSX::g_system->m_eventBus->signal(PCSX::Events::ExecutionFlow::ShellReached{});
+        PCSX::g_emulator->m_eventBus->signal(PCSX::Events::ExecutionFlow::ShellReached{});
     }
 }
 
@@ -147,6 +150,7 @@ void DynaRecCPU::uncompileAll() {
 }
 
 void DynaRecCPU::flushCache() {
+    PCSX::g_emulator->m_perfCounters->add(PCSX::PerfCounters::Counter::DynarecFlushes);
     gen.reset();       // Reset the emitter's code pointer and code size variables
     emitDispatcher();  // Re-emit dispatcher
     uncompileAll();    // Mark all blocks as uncompiled
@@ -201,17 +205,18 @@ void DynaRecCPU::emitDispatcher() {
 
     // Poll events
     emitMemberFunctionCall(&PCSX::R3000Acpu::branchTest, this);
-    gen.mov(runningPointer, (uintptr_t)PCSX::g_system->runningPtr());   // Load pointer to "running" variable
-    gen.test(Xbyak::util::byte[runningPointer], 1);                     // Check if PCSX::g_system->running is true
-    gen.jz(done);                                                       // If it's not, return
-    gen.mov(runningPointer, (uintptr_t)PCSX::g_system->quittingPtr());  // Load pointer to "quitting" variable
-    gen.test(Xbyak::util::byte[runningPointer], 1);                     // Check if PCSX::g_system->running is true
-    gen.jnz(done);                                                      // If it is, return
-    emitBlockLookup();                                                  // Otherwise, look up next block
+    gen.mov(runningPointer, (uintptr_t)PCSX::g_emulator->runningPtr());  // Load pointer to "running" variable
+    gen.test(Xbyak::util::byte[runningPointer], 1);                      // Check if the emulator is running
+    gen.jz(done);                                                        // If it's not, return
+    gen.mov(runningPointer, (uintptr_t)PCSX::g_system->quittingPtr());   // Load pointer to "quitting" variable
+    gen.test(Xbyak::util::byte[runningPointer], 1);                      // Check if PCSX::g_system->running is true
+    gen.jnz(done);                                                       // If it is, return
+    emitBlockLookup();                                                   // Otherwise, look up next block
 
     gen.align(16);
     // Code for exiting JIT context
     gen.L(done);
+    m_exitDispatcher = gen.getCurr<DynarecCallback>();
 
     // Deallocate shadow stack space on Windows
     if constexpr (isWindows()) {
@@ -331,6 +336,8 @@ DynarecCallback DynaRecCPU::recompile(uint32_t pc, bool fullLoadDelayEmulation,
 
     // If we somehow ended up compiling a block at an invalid PC, throw an error.
     if (!isPcValid(m_pc)) return m_invalidBlock;
+    auto& perfCounters = PCSX::g_emulator->m_perfCounters;
+    perfCounters->add(PCSX::PerfCounters::Counter::DynarecBlocks);
 
     const auto startingPC = m_pc;
     unsigned count = 0;                                 // How many instructions have we compiled?
@@ -357,6 +364,10 @@ DynarecCallback DynaRecCPU::recompile(uint32_t pc, bool fullLoadDelayEmulation,
         }
     }
 
+    if (m_debugging && PCSX::g_emulator->m_debug->hasBreakpoint(m_pc, PCSX::Debug::BreakpointType::Exec)) {
+        emitBreakpointCheck();
+    }
+
     if (!m_fullLoadDelayEmulation) {
         const auto isActiveOffset = (uintptr_t)&m_runtimeLoadDelay.active - (uintptr_t)this;
 
@@ -374,7 +385,14 @@ DynarecCallback DynaRecCPU::recompile(uint32_t pc, bool fullLoadDelayEmulation,
         if (m_stopCompiling) {
             return false;
         }
-        if (count >= MAX_BLOCK_SIZE && !m_delayedLoadInfo[0].active && !m_delayedLoadInfo[1].active) {
+        const bool loadPending = m_delayedLoadInfo[0].active || m_delayedLoadInfo[1].active;
+        // Execution breakpoints need to start their own block, so that they can be checked on entry.
+        // Breakpoints in delay slots, or right behind a pending load, can't be split off, and won't trigger.
+        if (m_debugging && !loadPending &&
+            PCSX::g_emulator->m_debug->hasBreakpoint(m_pc, PCSX::Debug::BreakpointType::Exec)) {
+            return false;
+        }
+        if (count >= MAX_BLOCK_SIZE && !loadPending) {
             return false;
         }
         return true;
@@ -406,6 +424,13 @@ DynarecCallback DynaRecCPU::recompile(uint32_t pc, bool fullLoadDelayEmulation,
         m_pc += 4;  // Increment recompiler PC
         count++;    // Increment instruction count
 
+        if (m_debugging) {
+            emitWatchpointCheck(code);
+        }
+        if (m_tracking) {
+            emitAccessTracking(code);
+        }
+
         const auto func = m_recBSC[code >> 26];  // Look up the opcode in our decoding LUT
         (*this.*func)(code);                     // Jump into the handler to recompile it
         return true;
@@ -444,6 +469,9 @@ DynarecCallback DynaRecCPU::recompile(uint32_t pc, bool fullLoadDelayEmulation,
     if (!m_pcWrittenBack) {
         gen.mov(dword[contextPointer + PC_OFFSET], m_pc);
     }
+    if (m_tracking) {
+        emitExecTracking(startingPC, m_pc);
+    }
 
     // If this was the block at 0x8003'0000 (Start of shell), don't link the PC in case we fastboot
     if (startingPC == 0x80030000) {
@@ -454,6 +482,11 @@ DynarecCallback DynaRecCPU::recompile(uint32_t pc, bool fullLoadDelayEmulation,
     }
 
     gen.add(qword[contextPointer + CYCLE_OFFSET], count * PCSX::Emulator::BIAS);  // Add block cycles;
+    const auto blockType = m_fullLoadDelayEmulation    ? PCSX::PerfCounters::BlockType::DynarecLoadDelay
+                           : (m_debugging || m_tracking) ? PCSX::PerfCounters::BlockType::DynarecInstrumented
+                                                         : PCSX::PerfCounters::BlockType::Dynarec;
+    gen.mov(rax, (uintptr_t)perfCounters->instructionCounter(blockType));
+    gen.add(qword[rax], count);  // Count the block's instructions
     if (m_linkedPC && ENABLE_BLOCK_LINKING && m_linkedPC.value() != startingPC) {
         handleLinking();
     } else {
@@ -531,6 +564,177 @@ void DynaRecCPU::handleLinking() {
     }
 }
 
+void DynaRecCPU::updateInstrumentation() {
+    const bool debugging = PCSX::g_emulator->settings.get<PCSX::Emulator::SettingDebugSettings>()
+                               .get<PCSX::Emulator::DebugSettings::Debug>();
+    const bool tracking = PCSX::g_emulator->m_accessTracker->enabled();
+    // The debugger checks and the access stamps are baked in the blocks, so recompile them all
+    if ((debugging != m_debugging) || (tracking != m_tracking)) {
+        m_debugging = debugging;
+        m_tracking = tracking;
+        uncompileAll();
+    }
+    if (m_debugging) {
+        m_watchedPages = PCSX::g_emulator->m_debug->watchedPages();
+    }
+}
+
+void DynaRecCPU::breakpointAdded(uint32_t address, unsigned width) {
+    // Blocks starting a bit before the breakpoint may run through it. They can go a few instructions
+    // past MAX_BLOCK_SIZE, to finish their delay slot or their pending loads.
+    const uint32_t window = (MAX_BLOCK_SIZE + 8) * 4;
+    const uint32_t start = address > window ? (address - window) & ~3 : 0;
+    for (uint32_t pc = start; pc < address + width; pc += 4) {
+        if (isPcValid(pc)) {
+            *getBlockPointer(pc) = m_uncompiledBlock;
+        }
+    }
+}
+
+// Returns false if we need to stop before running the block at pc
+bool DynaRecCPU::checkBreakpoint(uint32_t pc) {
+    if (m_breakpointPC == pc) {  // We're resuming from this very breakpoint
+        m_breakpointPC = std::nullopt;
+        return true;
+    }
+
+    PCSX::g_emulator->m_debug->checkExec(pc);
+    if (PCSX::g_emulator->running()) {
+        return true;
+    }
+    m_breakpointPC = pc;
+    return false;
+}
+
+void DynaRecCPU::checkWatchpointWrapper(uint32_t address, uint32_t code) {
+    PCSX::g_emulator->m_debug->checkMemoryAccess(code, address);
+}
+
+// Emitted at the start of blocks that begin with an execution breakpoint. Nothing has run yet, so we can
+// leave the JIT right away, without polling events, and come back to the same block when resuming.
+void DynaRecCPU::emitBreakpointCheck() {
+    Label noBreakpoint;
+
+    loadThisPointer(arg1.cvt64());
+    gen.mov(arg2, m_pc);
+    call(checkBreakpointWrapper);
+    gen.test(al, al);
+    gen.jnz(noBreakpoint);
+    gen.jmp((void*)m_exitDispatcher);
+    gen.L(noBreakpoint);
+}
+
+// Emitted before loads and stores: look the address up in the debugger's page map, and only call into the
+// debugger when the page holds a breakpoint of the right type. A triggered watchpoint pauses the emulation,
+// which then stops at the end of the block.
+void DynaRecCPU::emitWatchpointCheck(uint32_t code) {
+    using BreakpointType = PCSX::Debug::BreakpointType;
+    uint8_t mask;
+    switch (code >> 26) {
+        case 0x20:  // LB
+        case 0x21:  // LH
+        case 0x22:  // LWL
+        case 0x23:  // LW
+        case 0x24:  // LBU
+        case 0x25:  // LHU
+        case 0x26:  // LWR
+        case 0x32:  // LWC2
+            mask = PCSX::Debug::watchMask(BreakpointType::Read);
+            break;
+        case 0x28:  // SB
+        case 0x29:  // SH
+        case 0x2a:  // SWL
+        case 0x2b:  // SW
+        case 0x2e:  // SWR
+        case 0x3a:  // SWC2
+            mask = PCSX::Debug::watchMask(BreakpointType::Write);
+            break;
+        default:
+            return;
+    }
+
+    Label skip;
+    // Flush volatiles first, on both paths, so that the register allocator state stays the same
+    prepareForCall();
+    if (m_gprs[_Rs_].isConst()) {
+        const uint32_t address = m_gprs[_Rs_].val + _Imm_;
+        loadAddress(rax, (void*)&m_watchedPages[PCSX::Debug::watchPage(address)]);
+        gen.test(Xbyak::util::byte[rax], mask);
+        gen.jz(skip);
+        gen.mov(arg1, address);
+    } else {
+        if (m_gprs[_Rs_].isAllocated()) {
+            gen.moveAndAdd(arg1, m_gprs[_Rs_].allocatedReg, _Imm_);
+        } else {
+            gen.mov(arg1, dword[contextPointer + GPR_OFFSET(_Rs_)]);
+            gen.add(arg1, _Imm_);
+        }
+        gen.mov(eax, arg1);
+        gen.and_(eax, 0x1fffffff);
+        gen.shr(eax, PCSX::Debug::c_watchPageShift);
+        loadAddress(arg2.cvt64(), (void*)m_watchedPages);
+        gen.test(Xbyak::util::byte[arg2.cvt64() + rax], mask);
+        gen.jz(skip);
+    }
+
+    gen.mov(dword[contextPointer + PC_OFFSET], m_pc - 4);  // So that the debugger reports the right PC
+    gen.mov(arg2, code);
+    call(checkWatchpointWrapper);
+    gen.L(skip);
+}
+
+// Emitted before loads and stores to constant addresses in RAM, which the recompiler turns into plain
+// pointer accesses that never reach the memory functions. Other accesses get marked by the memory functions.
+void DynaRecCPU::emitAccessTracking(uint32_t code) {
+    using Access = PCSX::AccessTracker::Access;
+    Access access;
+    switch (code >> 26) {
+        case 0x20:  // LB
+        case 0x21:  // LH
+        case 0x22:  // LWL
+        case 0x23:  // LW
+        case 0x24:  // LBU
+        case 0x25:  // LHU
+        case 0x26:  // LWR
+        case 0x32:  // LWC2
+            access = Access::Read;
+            break;
+        case 0x28:  // SB
+        case 0x29:  // SH
+        case 0x2a:  // SWL
+        case 0x2b:  // SW
+        case 0x2e:  // SWR
+        case 0x3a:  // SWC2
+            access = Access::Write;
+            break;
+        default:
+            return;
+    }
+    if (!m_gprs[_Rs_].isConst()) return;
+
+    auto& tracker = PCSX::g_emulator->m_accessTracker;
+    uint32_t* slot = tracker->stamp(access, m_gprs[_Rs_].val + _Imm_);
+    if (!slot) return;
+    load<32, false>(arg1, tracker->nowPtr());
+    store<32>(arg1, slot);
+}
+
+// Emitted at the end of blocks: stamp all of the lines the block was compiled from at once.
+void DynaRecCPU::emitExecTracking(uint32_t start, uint32_t end) {
+    using PCSX::AccessTracker;
+    auto& tracker = PCSX::g_emulator->m_accessTracker;
+    bool loaded = false;
+    for (uint32_t line = start & ~(AccessTracker::c_lineSize - 1); line < end; line += AccessTracker::c_lineSize) {
+        uint32_t* slot = tracker->stamp(AccessTracker::Access::Exec, line);
+        if (!slot) continue;
+        if (!loaded) {
+            load<32, false>(arg1, tracker->nowPtr());
+            loaded = true;
+        }
+        store<32>(arg1, slot);
+    }
+}
+
 void DynaRecCPU::handleShellReached() {
     Xbyak::Label alreadyReached;
 
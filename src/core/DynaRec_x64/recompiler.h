@@ -29,6 +29,7 @@
 #include <string>
 
 #include "core/gpu.h"
+#include "core/perf-counters.h"
 #include "emitter.h"
 #include "fmt/format.h"
 #include "profiler.h"
@@ -113,6 +114,8 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     DynarecCallback m_loadDelayHandler;  // Pointer to the code that will handle load delays at the start of a block
     // Pointer to the code that will be executed when a block needs to be recompiled with full load delay support
     DynarecCallback m_needFullLoadDelays;
+    // Pointer to the code that leaves the JIT context right away, without polling events
+    DynarecCallback m_exitDispatcher;
 
     Emitter gen;
     uint32_t m_pc;  // Recompiler PC
@@ -123,6 +126,15 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     bool m_fullLoadDelayEmulation;
     uint32_t m_ramSize;  // RAM is 2MB on retail units, 8MB on some DTL units (Can be toggled in GUI)
 
+    // When the debugger is enabled, blocks stop right before execution breakpoints, which get checked when
+    // entering the block, and loads and stores check the debugger's page map before looking breakpoints up.
+    bool m_debugging = false;
+    const uint8_t* m_watchedPages = nullptr;
+    std::optional<uint32_t> m_breakpointPC;  // The breakpoint we stopped at, so that resuming doesn't stop again
+    // When the access tracker is enabled, blocks stamp the lines they run from when they end, and loads and
+    // stores to constant RAM addresses stamp their line inline. Everything else goes through the memory functions.
+    bool m_tracking = false;
+
     // Used to hold info when we've got a load delay between the end of a block and the start of another
     // For example, when there's an lw instruction in the delay slot of a branch
     struct {
@@ -208,8 +220,9 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     virtual void Shutdown() final;
     virtual bool isDynarec() final { return true; }
     virtual void Execute() final {
-        ZoneScoped;         // Tell the Tracy profiler to do its thing
-        (*m_dispatcher)();  // Jump to assembly dispatcher
+        ZoneScoped;               // Tell the Tracy profiler to do its thing
+        updateInstrumentation();  // Recompile everything if the debugger or the access tracker got toggled
+        (*m_dispatcher)();        // Jump to assembly dispatcher
     }
     // For the GUI dynarec disassembly widget
     virtual const uint8_t* getBufferPtr() final { return gen.getCode<const uint8_t*>(); }
@@ -225,6 +238,9 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
         }
     }
 
+    virtual void breakpointAdded(uint32_t address, unsigned width) final;
+    virtual void memoryHookAdded() final { uncompileAll(); }
+
     virtual void invalidateCache() override final {
         memset(m_regs.iCacheAddr, 0xff, sizeof(m_regs.iCacheAddr));
         memset(m_regs.iCacheCode, 0xff, sizeof(m_regs.iCacheCode));
@@ -365,7 +381,12 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     static void recErrorWrapper(DynaRecCPU* that) { that->error(); }
 
     static void signalShellReached(DynaRecCPU* that);
+    static bool checkBreakpointWrapper(DynaRecCPU* that, uint32_t pc) { return that->checkBreakpoint(pc); }
+    static void checkWatchpointWrapper(uint32_t address, uint32_t code);
     static DynarecCallback recRecompileWrapper(DynaRecCPU* that, bool fullLoadDelayEmulation) {
+        // Also covers the blocks compiled while linking this one.
+        PCSX::PerfCounters::ScopedTimer timer(PCSX::g_emulator->m_perfCounters.get(),
+                                              PCSX::PerfCounters::Subsystem::Dynarec);
         return that->recompile(that->m_regs.pc, fullLoadDelayEmulation);
     }
 
@@ -380,6 +401,13 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     void handleShellReached();
     void emitBlockLookup();
 
+    void updateInstrumentation();
+    bool checkBreakpoint(uint32_t pc);
+    void emitBreakpointCheck();
+    void emitWatchpointCheck(uint32_t code);
+    void emitAccessTracking(uint32_t code);
+    void emitExecTracking(uint32_t start, uint32_t end);
+
     std::string m_symbols;
     RecompilerProfiler<10000000> m_profiler;
 
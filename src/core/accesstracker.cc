@@ -0,0 +1,73 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/accesstracker.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "core/psxemulator.h"
+
+void PCSX::AccessTracker::setEnabled(bool enabled) {
+    if (enabled && !m_stamps[0]) {
+        for (auto& stamps : m_stamps) stamps.reset(new uint32_t[c_lineCount]);
+        clear();
+    }
+    m_ramMask = g_emulator->getRamMask();
+    m_enabled = enabled;
+}
+
+void PCSX::AccessTracker::clear() {
+    if (!m_stamps[0]) return;
+    for (auto& stamps : m_stamps) memset(stamps.get(), 0, c_lineCount * sizeof(uint32_t));
+}
+
+uint32_t PCSX::AccessTracker::lastAccess(Access access, uint32_t line) const {
+    if (!m_stamps[0] || (line >= c_lineCount)) return 0;
+    return m_stamps[static_cast<unsigned>(access)][line];
+}
+
+void PCSX::AccessTracker::heat(Access access, uint32_t firstLine, uint32_t lines, unsigned halfLife,
+                               uint8_t* out) const {
+    if (halfLife == 0) halfLife = 1;
+    const uint32_t* stamps = m_stamps[static_cast<unsigned>(access)].get();
+    for (uint32_t i = 0; i < lines; i++) {
+        const uint32_t line = firstLine + i;
+        const uint32_t stamp = (stamps && (line < c_lineCount)) ? stamps[line] : 0;
+        if (stamp == 0) {
+            out[i] = 0;
+            continue;
+        }
+        const uint32_t halvings = (m_now - stamp) / halfLife;
+        out[i] = halvings >= 8 ? 1 : std::max(255u >> halvings, 1u);
+    }
+}
+
+const char* PCSX::AccessTracker::accessName(Access access) {
+    switch (access) {
+        case Access::Read:
+            return "read";
+        case Access::Write:
+            return "write";
+        case Access::Exec:
+            return "exec";
+    }
+    return "unknown";
+}
@@ -0,0 +1,99 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+
+#include "core/psxemulator.h"
+#include "core/system.h"
+#include "support/eventbus.h"
+
+namespace PCSX {
+
+// Records when each 16-byte line of the main RAM was last read, written, and
+// executed, for ICU64-style access maps. Timestamps are frame counts, bumped
+// on every vsync, so that marking an access is a single store, cheap enough to
+// sit in the memory functions, and to be emitted inline by the dynarec. How
+// hot a line is gets computed from its timestamp when the map is read, so
+// nothing has to walk the arrays every frame to decay them.
+//
+// Only the main RAM is tracked. A timestamp of 0 means the line has never been
+// accessed since the last clear.
+class AccessTracker {
+  public:
+    enum class Access : unsigned { Read, Write, Exec };
+    static constexpr unsigned c_accessCount = 3;
+    static constexpr unsigned c_lineShift = 4;
+    static constexpr uint32_t c_lineSize = 1 << c_lineShift;
+    static constexpr uint32_t c_lineCount = 0x800000 >> c_lineShift;
+
+    AccessTracker() : m_listener(g_emulator->m_eventBus) {
+        m_listener.listen<Events::GPU::VSync>([this](const auto& event) {
+            if (m_enabled) m_now++;
+        });
+        m_listener.listen<Events::ExecutionFlow::Reset>([this](const auto& event) { clear(); });
+    }
+
+    bool enabled() const { return m_enabled; }
+    // The arrays are allocated on first use, and kept afterwards, since
+    // compiled code may still hold pointers to them.
+    void setEnabled(bool enabled);
+    void clear();
+
+    uint32_t now() const { return m_now; }
+    const uint32_t* nowPtr() const { return &m_now; }
+
+    // The timestamp slot for the line holding this address, or nullptr if
+    // the tracker is off, or the address isn't in the main RAM.
+    uint32_t* stamp(Access access, uint32_t address) {
+        if (!m_enabled) return nullptr;
+        if ((address & 0x1fffffff) >= 0x800000) return nullptr;
+        return &m_stamps[static_cast<unsigned>(access)][lineOf(address)];
+    }
+    void mark(Access access, uint32_t address) {
+        uint32_t* slot = stamp(access, address);
+        if (slot) *slot = m_now;
+    }
+
+    // The line holding this RAM address, accounting for the mirrors.
+    uint32_t lineOf(uint32_t address) const { return (address & 0x1fffffff & m_ramMask) >> c_lineShift; }
+    // The number of lines actually backed by RAM, as 2MB machines only
+    // ever touch the first quarter of the arrays.
+    uint32_t ramLines() const { return (m_ramMask + 1) >> c_lineShift; }
+    uint32_t lastAccess(Access access, uint32_t line) const;
+    // Fills out with one byte per line, starting at the given line: 255 for
+    // lines accessed during the current frame, halving every halfLife frames
+    // down to 1, and 0 for lines never accessed.
+    void heat(Access access, uint32_t firstLine, uint32_t lines, unsigned halfLife, uint8_t* out) const;
+
+    static const char* accessName(Access access);
+
+  private:
+    bool m_enabled = false;
+    uint32_t m_now = 1;
+    uint32_t m_ramMask = 0x1fffff;
+    std::unique_ptr<uint32_t[]> m_stamps[c_accessCount];
+    EventBus::Listener m_listener;
+};
+
+}  // namespace PCSX
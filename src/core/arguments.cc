@@ -28,6 +28,8 @@ PCSX::Arguments::Arguments(const CommandLine::args& args) {
     if (args.get<bool>("stdout") && !args.get<bool>("tui")) m_stdoutEnabled = true;
     if (args.get<bool>("no-ui") || args.get<bool>("cli")) m_stdoutEnabled = true;
     if (args.get<bool>("testmode") || args.get<bool>("no-gui-log")) m_guiLogsEnabled = false;
+    // Disc conversion happens before any UI exists.
+    if (args.get<std::string>("convert").has_value()) m_guiLogsEnabled = false;
     if (args.get<bool>("testmode")) m_testModeEnabled = true;
     if (args.get<bool>("portable")) m_portable = true;
     auto portablePath = args.get<std::string_view>("portable");
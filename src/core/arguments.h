@@ -45,7 +45,7 @@ class Arguments {
     bool isLuaStdoutEnabled() const { return m_luaStdoutEnabled; }
 
     // Returns true if the GUI logs window should be enabled.
-    // Disabled with -testmode or -no-gui-log.
+    // Disabled with -testmode, -no-gui-log, or -convert.
     bool isGUILogsEnabled() const { return m_guiLogsEnabled; }
 
     // Returns true if the the flag -testmode was used.
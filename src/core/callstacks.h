@@ -21,6 +21,7 @@
 
 #include <stdint.h>
 
+#include "core/psxemulator.h"
 #include "core/system.h"
 #include "support/eventbus.h"
 #include "support/list.h"
@@ -67,7 +68,7 @@ class CallStacks {
     EventBus::Listener m_listener;
 
   public:
-    CallStacks() : m_listener(g_system->m_eventBus) {
+    CallStacks() : m_listener(g_emulator->m_eventBus) {
         m_listener.listen<Events::ExecutionFlow::Reset>([this](const auto& event) {
             m_callstacks.clear();
             m_current = nullptr;
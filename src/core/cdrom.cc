@@ -27,6 +27,7 @@
 
 #include "cdrom/iso9660-reader.h"
 #include "core/debug.h"
+#include "core/perf-counters.h"
 #include "core/psxdma.h"
 #include "core/psxemulator.h"
 #include "spu/interface.h"
@@ -411,8 +412,11 @@ class CDRomImpl : public PCSX::CDRom {
         if (m_iso->getTrackType(m_curTrack) == PCSX::CDRIso::TrackType::CDDA) {
             m_suceeded = false;
         } else {
+            PCSX::PerfCounters::ScopedTimer timer(PCSX::g_emulator->m_perfCounters.get(),
+                                                  PCSX::PerfCounters::Subsystem::CDRom);
             m_suceeded = m_iso->readTrack(time);
             if (m_suceeded) m_prev = time;
+            PCSX::g_emulator->m_perfCounters->add(PCSX::PerfCounters::Counter::CDDataSectors);
         }
 
         const PCSX::IEC60908b::Sub *sub = m_iso->getBufferSub();
@@ -536,7 +540,12 @@ class CDRomImpl : public PCSX::CDRom {
             m_trackChanged = true;
         }
 
-        m_iso->readCDDA(m_setSectorPlay, m_transfer);
+        {
+            PCSX::PerfCounters::ScopedTimer timer(PCSX::g_emulator->m_perfCounters.get(),
+                                                  PCSX::PerfCounters::Subsystem::CDRom);
+            m_iso->readCDDA(m_setSectorPlay, m_transfer);
+            PCSX::g_emulator->m_perfCounters->add(PCSX::PerfCounters::Counter::CDAudioSectors);
+        }
         if (!m_irq && !m_stat && (m_mode & (MODE_AUTOPAUSE | MODE_REPORT))) cdrPlayInterrupt_Autopause();
 
         if (!m_play) return;
@@ -981,7 +990,7 @@ class CDRomImpl : public PCSX::CDRom {
                 // Crusaders of Might and Magic - update getlocl now
                 // - fixes cutscene speech
                 {
-                    uint8_t *buf = m_iso->getBuffer();
+                    const uint8_t *buf = m_iso->getBuffer();
                     if (buf != NULL) memcpy(m_transfer, buf, 8);
                 }
 
@@ -1105,7 +1114,7 @@ class CDRomImpl : public PCSX::CDRom {
     }
 
     void readInterrupt() final {
-        uint8_t *buf;
+        const uint8_t *buf;
 
         if (!m_reading) return;
 
@@ -1299,6 +1308,7 @@ class CDRomImpl : public PCSX::CDRom {
 
                     m_setSector = set_loc;
                     m_setlocPending = 1;
+                    m_iso->prefetch(set_loc);
                 }
                 break;
 
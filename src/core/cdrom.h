@@ -57,11 +57,17 @@ class CDRom {
     std::shared_ptr<CDRIso> getIso() { return m_iso; }
     void clearIso() {
         m_iso.reset();
-        g_system->m_eventBus->signal(Events::IsoMounted{});
+        g_emulator->m_eventBus->signal(Events::IsoMounted{});
     }
     void setIso(CDRIso* iso) {
         m_iso.reset(iso);
-        g_system->m_eventBus->signal(Events::IsoMounted{});
+        g_emulator->m_eventBus->signal(Events::IsoMounted{});
+    }
+    // Mounts an image which is kept around elsewhere, such as in a cache of
+    // images shared between runs.
+    void setIso(std::shared_ptr<CDRIso> iso) {
+        m_iso = std::move(iso);
+        g_emulator->m_eventBus->signal(Events::IsoMounted{});
     }
 
     const std::string& getCDRomID() { return m_cdromId; }
@@ -41,7 +41,7 @@ enum {
     MAP_EXEC_JAL = 128,
 };
 
-PCSX::Debug::Debug() : m_listener(g_system->m_eventBus) {
+PCSX::Debug::Debug() : m_listener(g_emulator->m_eventBus) {
     m_listener.listen<PCSX::Events::ExecutionFlow::Reset>([this](auto&) {
         m_checkKernel = false;
         clearMaps();
@@ -316,8 +316,15 @@ void PCSX::Debug::checkBP(uint32_t address, BreakpointType type, uint32_t width,
         }
     }
 
+    // Most accesses are nowhere near any breakpoint.
+    if (!isWatched(address, width, type)) return;
+
     auto end = m_breakpoints.end();
     uint32_t normalizedAddress = normalizeAddress(address & ~0xe0000000);
+    // The read and write hooks get checked by the memory functions instead.
+    if ((type == BreakpointType::Exec) && !m_memoryHooks.empty()) {
+        runMemoryHooks(address, normalizedAddress, type, width, 0);
+    }
 
     BreakpointTemporaryListType torun;
     for (auto it = m_breakpoints.find(normalizedAddress, normalizedAddress + width - 1); it != end; it++) {
@@ -330,8 +337,175 @@ void PCSX::Debug::checkBP(uint32_t address, BreakpointType type, uint32_t width,
         auto it = torun.begin();
         auto bp = &*it;
         torun.erase(it);
-        if (!triggerBP(bp, address, width, cause)) delete bp;
+        if (!triggerBP(bp, address, width, cause)) {
+            delete bp;
+            m_watchedPagesDirty = true;
+        }
+    }
+}
+
+void PCSX::Debug::checkMemoryAccess(uint32_t code, uint32_t address) {
+    switch (code >> 26) {
+        case 0x20:  // LB
+        case 0x24:  // LBU
+            checkBP(address, BreakpointType::Read, 1);
+            break;
+        case 0x21:  // LH
+        case 0x25:  // LHU
+            checkBP(address, BreakpointType::Read, 2);
+            break;
+        case 0x22:  // LWL
+        case 0x26:  // LWR
+            address &= ~3;
+            [[fallthrough]];
+        case 0x23:  // LW
+        case 0x32:  // LWC2
+            checkBP(address, BreakpointType::Read, 4);
+            break;
+        case 0x28:  // SB
+            checkBP(address, BreakpointType::Write, 1);
+            break;
+        case 0x29:  // SH
+            checkBP(address, BreakpointType::Write, 2);
+            break;
+        case 0x2a:  // SWL
+        case 0x2e:  // SWR
+            address &= ~3;
+            [[fallthrough]];
+        case 0x2b:  // SW
+        case 0x3a:  // SWC2
+            checkBP(address, BreakpointType::Write, 4);
+            break;
+    }
+}
+
+bool PCSX::Debug::hasBreakpoint(uint32_t address, BreakpointType type, unsigned width) {
+    if (!isWatched(address, width, type)) return false;
+    uint32_t normalizedAddress = normalizeAddress(address & ~0xe0000000);
+    for (auto it = m_breakpoints.find(normalizedAddress, normalizedAddress + width - 1); it != m_breakpoints.end();
+         it++) {
+        if (it->type() == type) return true;
+    }
+    for (auto it = m_memoryHooks.find(normalizedAddress, normalizedAddress + width - 1); it != m_memoryHooks.end();
+         it++) {
+        if (it->type() == type) return true;
     }
+    return false;
+}
+
+PCSX::Debug::Breakpoint* PCSX::Debug::insertBreakpoint(uint32_t address, unsigned width, Breakpoint* bp) {
+    m_breakpoints.insert(address, address + width - 1, bp);
+    markWatchedPages(m_watchedPages, bp->type(), bp->getLow(), bp->getHigh());
+    if ((bp->type() == BreakpointType::Exec) && g_emulator->m_cpu) g_emulator->m_cpu->breakpointAdded(address, width);
+    return bp;
+}
+
+// Without the ram expansion, the 2MB of RAM are mirrored four times, and
+// accesses are only normalized once they hit checkBP, so all of the mirrors
+// of a page need to be marked.
+void PCSX::Debug::markWatchedPages(uint8_t* pages, BreakpointType type, uint32_t low, uint32_t high) {
+    const bool ramExpansion = g_emulator->settings.get<Emulator::Setting8MB>();
+    const uint8_t mask = watchMask(type);
+    const uint32_t mirrors = 0x00600000 >> c_watchPageShift;
+    for (uint32_t page = watchPage(low); page <= watchPage(high); page++) {
+        if (!ramExpansion && (page < (0x1f000000 >> c_watchPageShift))) {
+            for (uint32_t mirror = 0; mirror <= mirrors; mirror += 0x00200000 >> c_watchPageShift) {
+                pages[(page & ~mirrors) | mirror] |= mask;
+            }
+        } else {
+            pages[page] |= mask;
+        }
+    }
+}
+
+const uint8_t* PCSX::Debug::watchedPages() {
+    if (m_watchedPagesDirty) {
+        m_watchedPagesDirty = false;
+        memset(m_watchedPages, 0, sizeof(m_watchedPages));
+        for (auto& bp : m_breakpoints) markWatchedPages(m_watchedPages, bp.type(), bp.getLow(), bp.getHigh());
+        for (auto& hook : m_memoryHooks) {
+            if (hook.type() == BreakpointType::Exec) {
+                markWatchedPages(m_watchedPages, hook.type(), hook.getLow(), hook.getHigh());
+            }
+        }
+    }
+    return m_watchedPages;
+}
+
+PCSX::Debug::MemoryHook* PCSX::Debug::addMemoryHook(uint32_t address, BreakpointType type, unsigned width,
+                                                    bool synchronous) {
+    if (type == BreakpointType::Exec) {
+        const bool debugging = g_emulator->settings.get<Emulator::SettingDebugSettings>()
+                                   .get<Emulator::DebugSettings::Debug>();
+        if (!debugging) return nullptr;
+    }
+    address &= ~0xe0000000;
+    auto hook = new MemoryHook(m_nextMemoryHookId++, type, synchronous);
+    m_memoryHooks.insert(address, address + width - 1, hook);
+    if (type == BreakpointType::Exec) {
+        markWatchedPages(m_watchedPages, type, address, address + width - 1);
+        if (g_emulator->m_cpu) g_emulator->m_cpu->breakpointAdded(address, width);
+    } else {
+        updateHookedPages();
+        // Recompiled code may access the page directly, without going through the memory functions.
+        if (g_emulator->m_cpu) g_emulator->m_cpu->memoryHookAdded();
+    }
+    return hook;
+}
+
+void PCSX::Debug::removeMemoryHook(MemoryHook* hook) {
+    const bool exec = hook->type() == BreakpointType::Exec;
+    delete hook;
+    if (exec) {
+        m_watchedPagesDirty = true;
+    } else {
+        updateHookedPages();
+    }
+}
+
+// The memory functions only look at the map while there are hooks, so that
+// they don't cost anything more than a test otherwise.
+void PCSX::Debug::updateHookedPages() {
+    memset(m_hookedPages, 0, sizeof(m_hookedPages));
+    bool any = false;
+    for (auto& hook : m_memoryHooks) {
+        if (hook.type() == BreakpointType::Exec) continue;
+        markWatchedPages(m_hookedPages, hook.type(), hook.getLow(), hook.getHigh());
+        any = true;
+    }
+    g_emulator->m_mem->setHookedPages(any ? m_hookedPages : nullptr);
+}
+
+void PCSX::Debug::memoryHookAccess(uint32_t address, BreakpointType type, unsigned width, uint32_t value) {
+    if (!(m_hookedPages[watchPage(address)] & watchMask(type))) return;
+    runMemoryHooks(address, normalizeAddress(address & ~0xe0000000), type, width, value);
+}
+
+void PCSX::Debug::runMemoryHooks(uint32_t address, uint32_t normalizedAddress, BreakpointType type, uint32_t width,
+                                 uint32_t value) {
+    const uint32_t pc = g_emulator->m_cpu->m_regs.pc;
+    bool synchronous = false;
+    for (auto it = m_memoryHooks.find(normalizedAddress, normalizedAddress + width - 1); it != m_memoryHooks.end();
+         it++) {
+        if (it->type() != type) continue;
+        if (m_memoryHookHits.size() >= c_maxQueuedHits) {
+            m_droppedMemoryHookHits++;
+            continue;
+        }
+        m_memoryHookHits.push_back({it->id(), pc, address, value, uint8_t(type), uint8_t(width)});
+        synchronous |= it->synchronous();
+    }
+    if (synchronous) g_system->pause();
+}
+
+const PCSX::Debug::MemoryHookHit* PCSX::Debug::takeMemoryHookHits(uint32_t& count, uint32_t& dropped) {
+    // Both buffers keep their capacity from one call to the next.
+    m_memoryHookDelivery.clear();
+    std::swap(m_memoryHookHits, m_memoryHookDelivery);
+    count = m_memoryHookDelivery.size();
+    dropped = m_droppedMemoryHookHits;
+    m_droppedMemoryHookHits = 0;
+    return m_memoryHookDelivery.data();
 }
 
 std::string PCSX::Debug::generateFlowIDC() {
@@ -21,6 +21,7 @@
 
 #include <functional>
 #include <string>
+#include <vector>
 
 #include "core/psxemulator.h"
 #include "core/system.h"
@@ -48,6 +49,33 @@ class Debug {
         checkBP(address, BreakpointType::Write, len, cause.c_str());
     }
 
+    // For the CPU cores which don't go through process() for every
+    // instruction: checks the execution breakpoints at pc, and the memory
+    // breakpoints of a single load or store instruction accessing address.
+    void checkExec(uint32_t pc) { checkBP(pc, BreakpointType::Exec, 4); }
+    void checkMemoryAccess(uint32_t code, uint32_t address);
+    // Whether there's any breakpoint or memory hook of that type at address,
+    // regardless of it being enabled.
+    bool hasBreakpoint(uint32_t address, BreakpointType type, unsigned width = 4);
+
+    // One byte per 4KB page of the physical address space, with one bit per
+    // breakpoint type, which is set for the pages holding breakpoints of that
+    // type, mirrors included. Pages can stay marked for a while after their
+    // breakpoints got removed, but never the other way around, so this can be
+    // checked before looking up the breakpoints tree, and the pointer stays
+    // valid for the lifetime of the debugger.
+    static constexpr unsigned c_watchPageShift = 12;
+    static constexpr uint8_t watchMask(BreakpointType type) { return 1 << unsigned(type); }
+    static uint32_t watchPage(uint32_t address) { return (address & 0x1fffffff) >> c_watchPageShift; }
+    const uint8_t* watchedPages();
+    bool isWatched(uint32_t address, unsigned width, BreakpointType type) const {
+        const uint32_t last = watchPage(address + width - 1);
+        for (uint32_t page = watchPage(address);; page = (page + 1) & (sizeof(m_watchedPages) - 1)) {
+            if (m_watchedPages[page] & watchMask(type)) return true;
+            if (page == last) return false;
+        }
+    }
+
   private:
     void checkBP(uint32_t address, BreakpointType type, uint32_t width, const char* cause = "");
 
@@ -110,6 +138,56 @@ class Debug {
         friend class Debug;
     };
 
+    // Memory hooks are a lighter alternative to breakpoints, for scripts which
+    // instrument a lot of accesses. They never stop the emulation, and don't
+    // run anything when hit: their hits are queued up, for the script to take
+    // them all at once, typically once per frame. A hit on a synchronous hook
+    // also pauses the emulation, right after the access, so that nothing else
+    // runs before the script sees it.
+    //
+    // Read and write hooks are checked by the memory functions themselves,
+    // against their own map of hooked pages, so they work with or without the
+    // debugger, and cost a single test per access while none are set. SWL and
+    // SWR read the word they merge into, so they also count as reads. DMA
+    // transfers aren't seen. Execution hooks go through the breakpoints
+    // checks, and need the debugger to be enabled.
+    struct MemoryHookHit {
+        uint32_t hook;
+        // Only exact under the interpreter; the dynarec doesn't keep the pc
+        // up to date within its blocks.
+        uint32_t pc;
+        uint32_t address;
+        // For writes, the value written.
+        uint32_t value;
+        uint8_t type;
+        uint8_t width;
+    };
+
+    class MemoryHook;
+    typedef Intrusive::Tree<uint32_t, MemoryHook> MemoryHookTreeType;
+    class MemoryHook : public MemoryHookTreeType::Node {
+      public:
+        MemoryHook(uint32_t id, BreakpointType type, bool synchronous)
+            : m_id(id), m_type(type), m_synchronous(synchronous) {}
+        uint32_t id() const { return m_id; }
+        BreakpointType type() const { return m_type; }
+        bool synchronous() const { return m_synchronous; }
+
+      private:
+        const uint32_t m_id;
+        const BreakpointType m_type;
+        const bool m_synchronous;
+    };
+
+    // Returns nullptr for execution hooks while the debugger is disabled.
+    MemoryHook* addMemoryHook(uint32_t address, BreakpointType type, unsigned width, bool synchronous);
+    void removeMemoryHook(MemoryHook* hook);
+    // Called by the memory functions for accesses to hooked pages.
+    void memoryHookAccess(uint32_t address, BreakpointType type, unsigned width, uint32_t value);
+    // Hands over the hits queued so far. The buffer stays valid until the
+    // next call. Hits past c_maxQueuedHits are dropped, and counted.
+    const MemoryHookHit* takeMemoryHookHits(uint32_t& count, uint32_t& dropped);
+
     void stepIn() {
         m_step = STEP_IN;
         startStepping();
@@ -146,7 +224,7 @@ class Debug {
         }) {
         uint32_t base = address & 0xe0000000;
         address &= ~0xe0000000;
-        return &*m_breakpoints.insert(address, address + width - 1, new Breakpoint(type, source, invoker, base));
+        return insertBreakpoint(address, width, new Breakpoint(type, source, invoker, base));
     }
     inline Breakpoint* addBreakpoint(
         uint32_t address, BreakpointType type, unsigned width, const std::string& source, std::string label,
@@ -156,23 +234,42 @@ class Debug {
         }) {
         uint32_t base = address & 0xe0000000;
         address &= ~0xe0000000;
-        return &*m_breakpoints.insert(address, address + width - 1, new Breakpoint(type, source, invoker, base, label));
+        return insertBreakpoint(address, width, new Breakpoint(type, source, invoker, base, label));
     }
     const BreakpointTreeType& getTree() { return m_breakpoints; }
     const Breakpoint* lastBP() { return m_lastBP; }
     void removeBreakpoint(const Breakpoint* bp) {
         if (m_lastBP == bp) m_lastBP = nullptr;
         delete const_cast<Breakpoint*>(bp);
+        m_watchedPagesDirty = true;
     }
     void removeAllBreakpoints() {
         m_breakpoints.clear();
         m_lastBP = nullptr;
+        m_watchedPagesDirty = true;
     }
 
   private:
+    Breakpoint* insertBreakpoint(uint32_t address, unsigned width, Breakpoint* bp);
     bool triggerBP(Breakpoint* bp, uint32_t address, unsigned width, const char* reason = "");
     BreakpointTreeType m_breakpoints;
 
+    void markWatchedPages(uint8_t* pages, BreakpointType type, uint32_t low, uint32_t high);
+    uint8_t m_watchedPages[0x20000] = {0};
+    bool m_watchedPagesDirty = false;
+
+    void runMemoryHooks(uint32_t address, uint32_t normalizedAddress, BreakpointType type, uint32_t width,
+                        uint32_t value);
+    void updateHookedPages();
+    static constexpr size_t c_maxQueuedHits = 0x100000;
+    MemoryHookTreeType m_memoryHooks;
+    // Same layout as m_watchedPages, for the read and write hooks only.
+    uint8_t m_hookedPages[0x20000] = {0};
+    std::vector<MemoryHookHit> m_memoryHookHits;
+    std::vector<MemoryHookHit> m_memoryHookDelivery;
+    uint32_t m_droppedMemoryHookHits = 0;
+    uint32_t m_nextMemoryHookId = 1;
+
     uint8_t m_mainMemoryMap[0x00800000] = {0};
     uint8_t m_biosMemoryMap[0x00080000] = {0};
     uint8_t m_scratchPadMap[0x00000400] = {0};
@@ -46,6 +46,28 @@ void pushEvent(PCSX::Lua L, const PCSX::Events::ExecutionFlow::Reset& e) {
     L.settable();
 }
 
+template <>
+void pushEvent(PCSX::Lua L, const PCSX::Events::SaveStates::Saved& e) {
+    L.newtable();
+    L.push("path");
+    L.push(e.path);
+    L.settable();
+    L.push("success");
+    L.push(e.success);
+    L.settable();
+}
+
+template <>
+void pushEvent(PCSX::Lua L, const PCSX::Events::SaveStates::Loaded& e) {
+    L.newtable();
+    L.push("path");
+    L.push(e.path);
+    L.settable();
+    L.push("success");
+    L.push(e.success);
+    L.settable();
+}
+
 template <>
 void pushEvent(PCSX::Lua L, const PCSX::Events::GUI::JumpToPC& e) {
     L.newtable();
@@ -197,6 +219,10 @@ void PCSX::LuaBindings::open_events(Lua L) {
                 createListener<Events::ExecutionFlow::Reset>(L);
             } else if (name == "ExecutionFlow::SaveStateLoaded") {
                 createListener<Events::ExecutionFlow::SaveStateLoaded>(L);
+            } else if (name == "SaveStates::Saved") {
+                createListener<Events::SaveStates::Saved>(L);
+            } else if (name == "SaveStates::Loaded") {
+                createListener<Events::SaveStates::Loaded>(L);
             } else if (name == "GUI::JumpToPC") {
                 createListener<Events::GUI::JumpToPC>(L);
             } else if (name == "GUI::JumpToMemory") {
@@ -0,0 +1,252 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/fork.h"
+
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+#include <zlib.h>
+
+#include "core/cdrom.h"
+#include "core/memory-export.h"
+#include "core/psxemulator.h"
+#include "core/psxmem.h"
+#include "core/r3000a.h"
+#include "core/sstate.h"
+#include "core/system.h"
+
+PCSX::Fork::Fork() : m_listener(g_system->m_eventBus) {
+    m_listener.listen<Events::GPU::VSync>([this](const auto& event) {
+        if (m_framesLeft && !--m_framesLeft) g_system->pause();
+    });
+}
+
+#if defined(_WIN32) || defined(_WIN64)
+
+bool PCSX::Fork::supported() { return false; }
+int PCSX::Fork::spawn(unsigned count) { return -2; }
+void PCSX::Fork::runFrames(unsigned frames) {}
+void PCSX::Fork::report(std::string_view output, bool success) { abort(); }
+const std::vector<PCSX::Fork::Result>& PCSX::Fork::collect() { return m_results; }
+bool PCSX::Fork::waitAny(Result& result) { return false; }
+
+#else
+
+namespace {
+
+bool writeAll(int fd, const void* data, size_t size) {
+    auto ptr = reinterpret_cast<const uint8_t*>(data);
+    while (size) {
+        ssize_t written = write(fd, ptr, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        ptr += written;
+        size -= written;
+    }
+    return true;
+}
+
+bool readAll(int fd, void* data, size_t size) {
+    auto ptr = reinterpret_cast<uint8_t*>(data);
+    while (size) {
+        ssize_t got = read(fd, ptr, size);
+        if (got < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (got == 0) return false;
+        ptr += got;
+        size -= got;
+    }
+    return true;
+}
+
+}  // namespace
+
+bool PCSX::Fork::supported() { return true; }
+
+int PCSX::Fork::spawn(unsigned count) {
+    if (inChild() || g_system->running()) return -2;
+    // Children can't render with the parent's GL context, nor read the disc
+    // through the parent's I/O thread.
+    if (g_emulator->settings.get<Emulator::SettingHardwareRenderer>()) return -2;
+    if (!g_emulator->m_cdrom->getIso()->failed() &&
+        (!g_emulator->settings.get<Emulator::SettingFullCaching>() ||
+         g_emulator->settings.get<Emulator::SettingReadAhead>())) {
+        return -2;
+    }
+    g_emulator->m_cdrom->getIso()->prepareFork();
+    fflush(stdout);
+    fflush(stderr);
+
+    // Children from earlier spawns may still be running, and are left alone.
+    const size_t first = m_children.size();
+    for (unsigned i = 0; i < count; i++) {
+        int fds[2];
+        if (pipe(fds) < 0) break;
+        int pid = fork();
+        if (pid < 0) {
+            close(fds[0]);
+            close(fds[1]);
+            break;
+        }
+        if (pid == 0) {
+            close(fds[0]);
+            for (auto& child : m_children) close(child.fd);
+            m_children.clear();
+            m_index = i;
+            m_pipe = fds[1];
+            g_system->setHeadless();
+            g_emulator->m_cdrom->getIso()->forked();
+            // The parent holds off until the main RAM has been copied away.
+            bool unshared = g_emulator->m_mem->m_wramShared.unshare() && g_emulator->m_memoryExport->unshare();
+            uint8_t ready = unshared ? 1 : 0;
+            writeAll(m_pipe, &ready, 1);
+            if (!unshared) _exit(1);
+            return m_index;
+        }
+        close(fds[1]);
+        uint8_t ready = 0;
+        if (!readAll(fds[0], &ready, 1) || !ready) {
+            close(fds[0]);
+            waitpid(pid, nullptr, 0);
+            break;
+        }
+        m_children.push_back({pid, fds[0]});
+    }
+
+    if (m_children.size() == first + count) return -1;
+    for (size_t i = first; i < m_children.size(); i++) {
+        auto& child = m_children[i];
+        kill(child.pid, SIGKILL);
+        close(child.fd);
+        waitpid(child.pid, nullptr, 0);
+    }
+    m_children.resize(first);
+    return -2;
+}
+
+void PCSX::Fork::runFrames(unsigned frames) {
+    if (!inChild() || !frames) return;
+    m_framesLeft = frames;
+    g_system->resume();
+    while (g_system->running()) g_emulator->m_cpu->Execute();
+    m_framesLeft = 0;
+}
+
+// The report is a success byte, the hash of the final state, and the
+// length-prefixed output.
+void PCSX::Fork::report(std::string_view output, bool success) {
+    if (!inChild()) abort();
+    auto state = SaveStates::save();
+    uint32_t header[3];
+    header[0] = success ? 1 : 0;
+    header[1] = crc32(0L, reinterpret_cast<const Bytef*>(state.data()), state.size());
+    header[2] = output.size();
+    bool sent = writeAll(m_pipe, header, sizeof(header)) && writeAll(m_pipe, output.data(), output.size());
+    close(m_pipe);
+    _exit(sent ? 0 : 1);
+}
+
+PCSX::Fork::Result PCSX::Fork::finish(const Child& child) {
+    Result result;
+    result.pid = child.pid;
+    uint32_t header[3];
+    bool received = readAll(child.fd, header, sizeof(header));
+    if (received) {
+        result.output.resize(header[2]);
+        received = readAll(child.fd, result.output.data(), header[2]);
+    }
+    close(child.fd);
+    int status = 0;
+    while ((waitpid(child.pid, &status, 0) < 0) && (errno == EINTR));
+    if (received) {
+        result.stateHash = header[1];
+        result.success = header[0] && WIFEXITED(status) && (WEXITSTATUS(status) == 0);
+    } else {
+        result.output.clear();
+    }
+    return result;
+}
+
+const std::vector<PCSX::Fork::Result>& PCSX::Fork::collect() {
+    m_results.clear();
+    if (inChild()) return m_results;
+    // Children get drained one after the other; the ones further down the
+    // list merely block on their pipe until their turn comes.
+    for (auto& child : m_children) m_results.push_back(finish(child));
+    m_children.clear();
+    return m_results;
+}
+
+bool PCSX::Fork::waitAny(Result& result) {
+    if (inChild() || m_children.empty()) return false;
+    std::vector<pollfd> fds(m_children.size());
+    for (size_t i = 0; i < fds.size(); i++) {
+        fds[i].fd = m_children[i].fd;
+        fds[i].events = POLLIN;
+        fds[i].revents = 0;
+    }
+    // A child that dies without reporting closes its pipe, which also wakes
+    // us up, as a hangup.
+    while (true) {
+        int ready = poll(fds.data(), fds.size(), -1);
+        if (ready > 0) break;
+        if ((ready < 0) && (errno != EINTR)) return false;
+    }
+    for (size_t i = 0; i < fds.size(); i++) {
+        if (!fds[i].revents) continue;
+        result = finish(m_children[i]);
+        m_children.erase(m_children.begin() + i);
+        return true;
+    }
+    return false;
+}
+
+#endif
+
+const std::vector<PCSX::Fork::Result>& PCSX::Fork::run(unsigned count,
+                                                        std::function<std::string(unsigned index)> body) {
+    int index = spawn(count);
+    if (index == -2) {
+        m_results.clear();
+        return m_results;
+    }
+    if (index >= 0) {
+        std::string output;
+        bool success = true;
+        try {
+            output = body(index);
+        } catch (std::exception& e) {
+            output = e.what();
+            success = false;
+        } catch (...) {
+            success = false;
+        }
+        report(output, success);
+    }
+    return collect();
+}
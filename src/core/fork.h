@@ -0,0 +1,97 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "support/eventbus.h"
+
+namespace PCSX {
+
+// Forks the emulator into child processes, which all start from the exact
+// same machine state, and explore from there on their own. The memory of the
+// parent is shared copy-on-write by the kernel, except for the main RAM,
+// which is backed by a shared memory mapping, and gets copied once by each
+// child as it starts. This is only available on platforms with fork().
+//
+// The children are headless: they have no UI, no audio output, and none of
+// the parent's threads. This means the emulation only works with the software
+// renderer, and with the disc image fully cached. It also means the SPU stays
+// frozen in the children, since it runs on its own thread.
+//
+// Each child reports back a single blob of output, along with a hash of its
+// final state, through a pipe, before exiting.
+class Fork {
+  public:
+    struct Result {
+        int pid = -1;
+        bool success = false;
+        uint32_t stateHash = 0;
+        std::string output;
+    };
+
+    Fork();
+    static bool supported();
+
+    // Forks the paused emulator into count children. Returns the index of the
+    // child within each of them, -1 within the parent, or -2 on failure, in
+    // which case none of the new children are left behind. Children of
+    // earlier spawns keep running until collected.
+    int spawn(unsigned count);
+    // Convenience wrapper around spawn, collect, and report, which runs the
+    // body within each child, and sends back what it returns.
+    const std::vector<Result>& run(unsigned count, std::function<std::string(unsigned index)> body);
+
+    // Child side.
+    bool inChild() const { return m_index >= 0; }
+    // Emulates that many frames, or until something pauses the emulation.
+    void runFrames(unsigned frames);
+    [[noreturn]] void report(std::string_view output, bool success = true);
+
+    // Parent side. Waits for all of the outstanding children, in the order
+    // they were spawned.
+    const std::vector<Result>& collect();
+    // Waits for whichever outstanding child finishes first, which lets the
+    // parent keep a pool of children busy. Returns false if there are none.
+    bool waitAny(Result& result);
+    unsigned outstanding() const { return m_children.size(); }
+    int lastSpawned() const { return m_children.empty() ? -1 : m_children.back().pid; }
+    const std::vector<Result>& results() const { return m_results; }
+
+  private:
+    struct Child {
+        int pid;
+        int fd;
+    };
+    Result finish(const Child& child);
+    std::vector<Child> m_children;
+    std::vector<Result> m_results;
+    int m_index = -1;
+    int m_pipe = -1;
+    unsigned m_framesLeft = 0;
+    EventBus::Listener m_listener;
+};
+
+}  // namespace PCSX
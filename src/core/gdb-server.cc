@@ -21,10 +21,13 @@
 
 #include <assert.h>
 
+#include <algorithm>
 #include <magic_enum_all.hpp>
+#include <vector>
 
 #include "core/cdrom.h"
 #include "core/debug.h"
+#include "core/memory-export.h"
 #include "core/psxemulator.h"
 #include "core/psxmem.h"
 #include "core/r3000a.h"
@@ -116,8 +119,13 @@ PCSX::GdbClient::GdbClient(uv_tcp_t* srv) : m_listener(g_system->m_eventBus) {
         // we technically should specify here why we stopped, but we don't have
         // the architecture for this just yet. Maybe that'll be part of the pause
         // event later on.
-        if (m_waitingForTrap) write("T05");
+        if (m_nonStop) {
+            if (!m_waitingForShell) reportStop(m_stopSignal);
+        } else if (m_waitingForTrap) {
+            write("T05");
+        }
         m_waitingForTrap = false;
+        m_stopSignal = 5;
     });
     m_listener.listen<Events::ExecutionFlow::ShellReached>([this](const auto& event) {
         if (!m_waitingForShell) return;
@@ -391,11 +399,11 @@ std::pair<uint64_t, uint64_t> PCSX::GdbClient::parseCursor(const std::string& cu
 void PCSX::GdbClient::writePaged(const std::string& out, const std::string& cursorStr) {
     auto [off, len] = parseCursor(cursorStr);
     if (len < (out.length() - off)) {
-        writef("m%s", out.substr(off, len).c_str());
+        write("m" + out.substr(off, len));
     } else if (off != 0) {
-        writef("l%s", out.substr(off, len).c_str());
+        write("l" + out.substr(off, len));
     } else {
-        writef("l%s", out.c_str());
+        write("l" + out);
     }
 }
 
@@ -470,6 +478,45 @@ void PCSX::GdbClient::setOneRegister(int n, uint32_t value) {
     }
 }
 
+void PCSX::GdbClient::writeMemory(uint32_t address, const uint8_t* data, size_t size) {
+    if (size == 0) return;
+    g_emulator->m_mem->getMemoryAsFile()->writeAt(data, size, address);
+    // gdb loads code this way, which the dynarec may have compiled already.
+    g_emulator->m_cpu->Clear(address & ~3, ((address & 3) + size + 3) / 4);
+}
+
+std::string PCSX::GdbClient::stopReply(unsigned signal) {
+    return fmt::format("T{:02x}thread:{};", signal, m_multiprocess ? "p1.t1" : "1");
+}
+
+void PCSX::GdbClient::reportStop(unsigned signal) {
+    // Only one notification may be in flight; anything else waits until gdb
+    // asks for it with vStopped.
+    if (m_stopPending) {
+        m_stopQueued = true;
+        return;
+    }
+    m_stopPending = true;
+    writeNotification("Stop:" + stopReply(signal));
+}
+
+void PCSX::GdbClient::resume(bool step) {
+    // In all-stop mode, the stop reply is the answer to the resume. In
+    // non-stop mode, it comes later as a notification.
+    if (m_nonStop) write("OK");
+    if (step) {
+        if (g_system->running()) g_system->pause();
+        m_waitingForTrap = true;
+        g_emulator->m_debug->stepIn();
+    } else {
+        // Console output packets are only valid while gdb waits for the stop
+        // reply; in non-stop mode, they'd be taken as answers to later commands.
+        m_canReceiveLogs = !m_nonStop;
+        g_system->resume();
+        m_waitingForTrap = true;
+    }
+}
+
 void PCSX::GdbClient::processCommand() {
     if (m_ackEnabled) sendAck();
     if (g_emulator->settings.get<Emulator::SettingDebugSettings>().get<Emulator::DebugSettings::GdbServerTrace>()) {
@@ -487,7 +534,11 @@ void PCSX::GdbClient::processCommand() {
         write("OK");
     } else if (m_cmd == "?") {
         // query reason for stop
-        if (g_system->running()) {
+        if (m_nonStop) {
+            // gdb follows up with vStopped, which has nothing else to report.
+            m_stopQueued = false;
+            write(g_system->running() ? "OK" : stopReply(5));
+        } else if (g_system->running()) {
             write("S00");
         } else {  // we may need one for 02 ? SIGINT
             write("S05");
@@ -505,12 +556,12 @@ void PCSX::GdbClient::processCommand() {
     } else if (m_cmd == "g") {
         // read general register
         // replies with all registers
-        std::string all = "";
-        startStream();
+        std::string all;
+        all.reserve(72 * 8);
         // the protocol really wants 72 registers:
         // 32 gpr + status + lo + hi + badv + cause + 32 fpr + 3 fpu registers
-        for (int i = 0; i < 72; i++) stream(dumpOneRegister(i));
-        stopStream();
+        for (int i = 0; i < 72; i++) all += dumpOneRegister(i);
+        write(std::move(all));
     } else if (StringsHelpers::startsWith(m_cmd, "p")) {
         if (m_cmd.size() != 3) {
             write("E00");
@@ -540,43 +591,66 @@ void PCSX::GdbClient::processCommand() {
         write("OK");
     } else if (m_cmd == "c") {
         // continue - this doesn't technically have a reply, only when the target stops later, using T05.
-        m_canReceiveLogs = true;
-        g_system->resume();
-        m_waitingForTrap = true;
-    } else if (m_cmd[0] == 'M') {
-        // write memory
-        auto elements = StringsHelpers::split(m_cmd, ":");
-        auto [off, len] = parseCursor(elements[0].substr(1));
+        resume(false);
+    } else if ((m_cmd[0] == 'M') || (m_cmd[0] == 'X')) {
+        // write memory, either hex encoded, or as binary data
+        auto colon = m_cmd.find(':');
+        if (colon == std::string::npos) {
+            write("E01");
+            return;
+        }
+        auto [off, len] = parseCursor(m_cmd.substr(1, colon - 1));
         if (((off == 0x8000f800) && (len == 0x800)) || ((off == 0x8000ffea) && (len == 22))) {
             // heuristic for our ps-exe.ld and cpe.ld
             write("OK");
             return;
         }
-        size_t i = 0;
-        IO<File> memFile = g_emulator->m_mem->getMemoryAsFile();
-        memFile->wSeek(off);
-        while (len--) {
-            uint8_t c = fromHexChar(elements[1][i * 2 + 0]);
-            c <<= 4;
-            c |= fromHexChar(elements[1][i * 2 + 1]);
-            memFile->write(c);
-            i++;
+        const char* data = m_cmd.data() + colon + 1;
+        const size_t available = m_cmd.size() - colon - 1;
+        if (m_cmd[0] == 'X') {
+            // gdb probes for X support with an empty write, which lands here too.
+            if (available < len) {
+                write("E01");
+                return;
+            }
+            writeMemory(off, reinterpret_cast<const uint8_t*>(data), len);
+        } else {
+            if (available < len * 2) {
+                write("E01");
+                return;
+            }
+            std::vector<uint8_t> bytes(len);
+            for (size_t i = 0; i < len; i++) {
+                bytes[i] = (fromHexChar(data[i * 2 + 0]) << 4) | fromHexChar(data[i * 2 + 1]);
+            }
+            writeMemory(off, bytes.data(), len);
         }
         write("OK");
-    } else if (m_cmd[0] == 'm') {
-        // read memory
+    } else if ((m_cmd[0] == 'm') || (m_cmd[0] == 'x')) {
+        // read memory, either hex encoded, or as escaped binary data
         auto [off, len] = parseCursor(m_cmd.substr(1));
-        startStream();
-        IO<File> memFile = g_emulator->m_mem->getMemoryAsFile();
-        memFile->rSeek(off);
-        while (len--) {
-            uint8_t v = memFile->read<uint8_t>();
-            char s[3] = {0, 0, 0};
-            s[0] = toHex[v >> 4];
-            s[1] = toHex[(v & 0x0f)];
-            stream(s);
+        len = std::min(len, uint64_t(PACKET_SIZE));
+        std::vector<uint8_t> bytes(len);
+        g_emulator->m_mem->getMemoryAsFile()->readAt(bytes.data(), len, off);
+        std::string reply;
+        if (m_cmd[0] == 'x') {
+            reply.reserve(len + len / 8 + 1);
+            reply += 'b';
+            for (auto v : bytes) {
+                if ((v == '#') || (v == '$') || (v == '}') || (v == '*')) {
+                    reply += '}';
+                    v ^= 0x20;
+                }
+                reply += v;
+            }
+        } else {
+            reply.reserve(len * 2);
+            for (auto v : bytes) {
+                reply += toHex[v >> 4];
+                reply += toHex[v & 0x0f];
+            }
         }
-        stopStream();
+        write(std::move(reply));
     } else if ((m_cmd[0] == 'z') || (m_cmd[0] == 'Z')) {
         // insert or remove breakpoint
         enum class Action {
@@ -651,9 +725,52 @@ void PCSX::GdbClient::processCommand() {
                 return;
         }
     } else if (m_cmd == "s") {
-        if (g_system->running()) g_system->pause();
-        m_waitingForTrap = true;
-        g_emulator->m_debug->stepIn();
+        resume(true);
+    } else if (m_cmd == "vCont?") {
+        write("vCont;c;C;s;S;t");
+    } else if (StringsHelpers::startsWith(m_cmd, "vCont;")) {
+        // We only have the one thread, so the first action is the only one
+        // that can apply.
+        switch (m_cmd[6]) {
+            case 'c':
+            case 'C':
+                resume(false);
+                break;
+            case 's':
+            case 'S':
+                resume(true);
+                break;
+            case 't':
+                write("OK");
+                if (g_system->running()) {
+                    m_stopSignal = 0;
+                    g_system->pause();
+                } else {
+                    reportStop(0);
+                }
+                break;
+            default:
+                write("E01");
+                break;
+        }
+    } else if (m_cmd == "vCtrlC") {
+        write("OK");
+        g_system->pause();
+    } else if (m_cmd == "vStopped") {
+        m_stopPending = false;
+        if (m_stopQueued && !g_system->running()) {
+            m_stopQueued = false;
+            m_stopPending = true;
+            write(stopReply(m_stopSignal));
+        } else {
+            m_stopQueued = false;
+            write("OK");
+        }
+    } else if (StringsHelpers::startsWith(m_cmd, "QNonStop:")) {
+        m_nonStop = m_cmd == "QNonStop:1";
+        if (m_nonStop) m_canReceiveLogs = false;
+        m_stopPending = m_stopQueued = false;
+        write("OK");
     } else if (m_cmd == "Hc0") {
         // thread stuff
         write("OK");
@@ -665,14 +782,15 @@ void PCSX::GdbClient::processCommand() {
         write("OK");
     } else if (StringsHelpers::startsWith(m_cmd, qSupported)) {
         auto elements = StringsHelpers::split(m_cmd.substr(qSupported.length()), ";");
-        bool multiprocess = false;
+        m_multiprocess = false;
         for (const auto& element : elements) {
             if (element == "multiprocess+") {
-                multiprocess = true;
+                m_multiprocess = true;
             }
         }
-        std::string answer = "PacketSize=47ff;qXfer:threads:read+;QStartNoAckMode+";
-        if (multiprocess) {
+        std::string answer = fmt::format(
+            "PacketSize={:x};qXfer:threads:read+;QStartNoAckMode+;QNonStop+;binary-upload+", PACKET_SIZE);
+        if (m_multiprocess) {
             answer += ";multiprocess+";
         }
         if (g_emulator->settings.get<Emulator::SettingDebugSettings>().get<Emulator::DebugSettings::GdbManifest>()) {
@@ -766,8 +884,10 @@ void PCSX::GdbClient::processMonitorCommand(const std::string& cmd) {
         } else {
             if (words[1] == "wram") {
                 writeEscaped(g_emulator->m_mem->m_wramShared.getSharedName());
+            } else if (words[1] == "export") {
+                writeEscaped(g_emulator->m_memoryExport->getSharedName());
             } else {
-                writeEscaped("Unknown type. Valid types: wram");
+                writeEscaped("Unknown type. Valid types: wram, export");
             }
         }
     }
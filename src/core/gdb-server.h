@@ -98,6 +98,14 @@ class GdbClient : public Intrusive::List<GdbClient>::Node {
         req->enqueue(this);
         va_end(a);
     }
+    // Asynchronous notifications are framed like packets, but start with a
+    // '%' and aren't acknowledged.
+    void writeNotification(std::string&& msg) {
+        auto* req = new WriteRequest();
+        req->m_before = '%';
+        req->m_slice.acquire(std::move(msg));
+        req->enqueue(this);
+    }
     void writePaged(const std::string& out, const std::string& cursorStr);
     void writeEscaped(const std::string& out);
     void sendAck() {
@@ -106,31 +114,6 @@ class GdbClient : public Intrusive::List<GdbClient>::Node {
         req->enqueueRaw(this);
     }
 
-    void startStream() {
-        m_crc = 0;
-        auto* req = new WriteRequest();
-        req->m_slice.copy("$", 1);
-        req->enqueueRaw(this);
-    }
-
-    void stream(const std::string& data) {
-        for (int i = 0; i < data.length(); i++) {
-            m_crc += data[i];
-        }
-        auto* req = new WriteRequest();
-        req->m_slice.copy(data.data(), data.size());
-        req->enqueueRaw(this);
-    }
-
-    void stopStream() {
-        auto* req = new WriteRequest();
-        char end[3] = {'#'};
-        end[1] = toHex[m_crc >> 4];
-        end[2] = toHex[m_crc & 0x0f];
-        req->m_slice.copy(end, 3);
-        req->enqueueRaw(this);
-    }
-
     static const char toHex[];
     struct WriteRequest : public Intrusive::HashTable<uintptr_t, WriteRequest>::Node {
         void enqueue(GdbClient* client) {
@@ -181,7 +164,10 @@ class GdbClient : public Intrusive::List<GdbClient>::Node {
     };
     friend struct WriteRequest;
     Intrusive::HashTable<uintptr_t, WriteRequest> m_requests;
-    static constexpr size_t BUFFER_SIZE = 256;
+    static constexpr size_t BUFFER_SIZE = 0x4000;
+    // What we advertise in qSupported. This is the largest packet gdb will
+    // send us, and gdb sizes its memory transfers after it.
+    static constexpr size_t PACKET_SIZE = 0x10000;
     static void allocTrampoline(uv_handle_t* handle, size_t suggestedSize, uv_buf_t* buf) {
         GdbClient* client = static_cast<GdbClient*>(handle->data);
         client->alloc(suggestedSize, buf);
@@ -215,6 +201,10 @@ class GdbClient : public Intrusive::List<GdbClient>::Node {
     void processMonitorCommand(const std::string&);
     Slice passthroughData(Slice slice);
     std::pair<uint64_t, uint64_t> parseCursor(const std::string& cursorStr);
+    void writeMemory(uint32_t address, const uint8_t* data, size_t size);
+    std::string stopReply(unsigned signal);
+    void resume(bool step);
+    void reportStop(unsigned signal);
 
     std::string dumpOneRegister(int n);
     void setOneRegister(int n, uint32_t value);
@@ -238,6 +228,13 @@ class GdbClient : public Intrusive::List<GdbClient>::Node {
     bool m_waitingForTrap = false;
     bool m_waitingForShell = false;
     bool m_exception = false;
+    bool m_multiprocess = false;
+    // In non-stop mode, stops are reported with a Stop notification, which
+    // gdb acknowledges with vStopped, instead of replying to the resume.
+    bool m_nonStop = false;
+    bool m_stopPending = false;
+    bool m_stopQueued = false;
+    unsigned m_stopSignal = 5;
     // Not sure about the logic here; we need to keep an eye on when
     // gdb complains about invalid responses, and toggle this accordingly.
     bool m_canReceiveLogs = false;
@@ -25,6 +25,7 @@
 
 #include "core/debug.h"
 #include "core/gpulogger.h"
+#include "core/perf-counters.h"
 #include "core/pgxp_mem.h"
 #include "core/psxdma.h"
 #include "core/psxhw.h"
@@ -37,6 +38,15 @@
 
 namespace PCSX {
 
+namespace {
+
+// Twice the area of a triangle, for the performance counters.
+unsigned doubleTriangleArea(int x0, int y0, int x1, int y1, int x2, int y2) {
+    return std::abs((x1 - x0) * (y2 - y0) - (x2 - x0) * (y1 - y0));
+}
+
+}  // namespace
+
 // clang-format off
 // clang-format doesn't understand duff's device pattern...
 template <GPU::Shading shading, GPU::Shape shape, GPU::Textured textured, GPU::Blend blend, GPU::Modulation modulation>
@@ -94,6 +104,11 @@ void GPU::Poly<shading, shape, textured, blend, modulation>::processWrite(Buffer
     }
     offset = m_gpu->m_lastOffset;
     m_gpu->m_defaultProcessor.setActive();
+    unsigned area = doubleTriangleArea(x[0], y[0], x[1], y[1], x[2], y[2]);
+    if constexpr (shape == Shape::Quad) area += doubleTriangleArea(x[1], y[1], x[2], y[2], x[3], y[3]);
+    g_emulator->m_perfCounters->addPrimitive(
+        textured == Textured::Yes ? PerfCounters::Primitive::TexturedTriangle : PerfCounters::Primitive::Triangle,
+        shape == Shape::Quad ? 2 : 1, area / 2);
     g_emulator->m_gpuLogger->addNode(*this, origin, origvalue, length);
     m_gpu->write0(this);
 }
@@ -152,6 +167,11 @@ void GPU::Line<shading, lineType, blend>::processWrite(Buffer & buf, Logged::Ori
     offset = m_gpu->m_lastOffset;
     m_gpu->m_defaultProcessor.setActive();
     if ((colors.size() >= 2) && ((colors.size() == x.size()))) {
+        unsigned pixels = 0;
+        for (unsigned i = 1; i < x.size(); i++) {
+            pixels += std::max(std::abs(x[i] - x[i - 1]), std::abs(y[i] - y[i - 1]));
+        }
+        g_emulator->m_perfCounters->addPrimitive(PerfCounters::Primitive::Line, x.size() - 1, pixels);
         g_emulator->m_gpuLogger->addNode(*this, origin, origvalue, length);
         m_gpu->write0(this);
     } else {
@@ -220,6 +240,8 @@ void GPU::Rect<size, textured, blend, modulation>::processWrite(Buffer & buf, Lo
     }
     offset = m_gpu->m_lastOffset;
     m_gpu->m_defaultProcessor.setActive();
+    g_emulator->m_perfCounters->addPrimitive(
+        textured == Textured::Yes ? PerfCounters::Primitive::Sprite : PerfCounters::Primitive::Rectangle, 1, w * h);
     g_emulator->m_gpuLogger->addNode(*this, origin, origvalue, length);
     m_gpu->write0(this);
 }
@@ -889,6 +911,7 @@ void PCSX::GPU::FastFill::processWrite(Buffer &buf, Logged::Origin origin, uint3
             clipped = GPU::clip(x, y, w, h);
             m_state = READ_COLOR;
             m_gpu->m_defaultProcessor.setActive();
+            g_emulator->m_perfCounters->addPrimitive(PerfCounters::Primitive::Fill, 1, w * h);
             g_emulator->m_gpuLogger->addNode(*this, origin, origvalue, length);
             m_gpu->write0(this);
             return;
@@ -930,6 +953,7 @@ void PCSX::GPU::BlitVramVram::processWrite(Buffer &buf, Logged::Origin origin, u
             clipped |= GPU::clip(dX, dY, w, h);
             m_state = READ_COMMAND;
             m_gpu->m_defaultProcessor.setActive();
+            g_emulator->m_perfCounters->addPrimitive(PerfCounters::Primitive::BlitVramVram, 1, w * h);
             g_emulator->m_gpuLogger->addNode(*this, origin, origvalue, length);
             m_gpu->write0(this);
             return;
@@ -987,6 +1011,7 @@ void PCSX::GPU::BlitRamVram::processWrite(Buffer &buf, Logged::Origin origin, ui
         clipped = GPU::clip(x, y, w, h);
         m_state = READ_COMMAND;
         m_gpu->m_defaultProcessor.setActive();
+        g_emulator->m_perfCounters->addPrimitive(PerfCounters::Primitive::BlitRamVram, 1, w * h);
         g_emulator->m_gpuLogger->addNode(*this, origin, origvalue, length);
         m_gpu->partialUpdateVRAM(x, y, w, h, data.data<uint16_t>(), PartialUpdateVram::Synchronous);
     }
@@ -1020,6 +1045,7 @@ void PCSX::GPU::BlitVramRam::processWrite(Buffer &buf, Logged::Origin origin, ui
             clipped = GPU::clip(x, y, w, h);
             m_state = READ_COMMAND;
             m_gpu->m_defaultProcessor.setActive();
+            g_emulator->m_perfCounters->addPrimitive(PerfCounters::Primitive::BlitVramRam, 1, w * h);
             g_emulator->m_gpuLogger->addNode(*this, origin, origvalue, length);
             m_gpu->m_vramReadSlice = m_gpu->getVRAM();
             for (auto l = y; l < y + h; l++) {
@@ -60,7 +60,7 @@ void main() {
 }
 )";
 
-PCSX::GPULogger::GPULogger() : m_listener(g_system->m_eventBus) {
+PCSX::GPULogger::GPULogger() : m_listener(g_emulator->m_eventBus) {
     m_listener.listen<Events::GPU::VSync>([this](auto event) {
         m_frameCounter++;
         if (m_breakOnVSync) {
@@ -28,11 +28,18 @@ enum SectorMode {
 
 typedef struct { char opaque[?]; } LuaIso;
 typedef struct { char opaque[?]; } IsoReader;
+typedef struct {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t prefetched;
+    uint64_t wasted;
+} ReadAheadStats;
 
 void deleteIso(LuaIso* wrapper);
 bool isIsoFailed(LuaIso* wrapper);
 void isoClearPPF(LuaIso* wrapper);
 void isoSavePPF(LuaIso* wrapper);
+void isoGetReadAheadStats(LuaIso* wrapper, ReadAheadStats* stats);
 LuaIso* getCurrentIso();
 LuaIso* openIso(const char* path);
 LuaIso* openIsoFromFile(LuaFile* wrapper);
@@ -69,6 +76,16 @@ local function createIsoWrapper(wrapper)
         createReader = function(self) return createIsoReaderWrapper(C.createIsoReader(self._wrapper)) end,
         clearPPF = function(self) C.isoClearPPF(self._wrapper) end,
         savePPF = function(self) C.isoSavePPF(self._wrapper) end,
+        readAheadStats = function(self)
+            local stats = ffi.new('ReadAheadStats')
+            C.isoGetReadAheadStats(self._wrapper, stats)
+            return {
+                hits = tonumber(stats.hits),
+                misses = tonumber(stats.misses),
+                prefetched = tonumber(stats.prefetched),
+                wasted = tonumber(stats.wasted),
+            }
+        end,
         open = function(self, lba, size, mode)
             if type(size) == 'string' and mode == nil then
                 mode = size
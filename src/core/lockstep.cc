@@ -0,0 +1,260 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/lockstep.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+
+#include "core/disr3000a.h"
+#include "core/psxemulator.h"
+#include "core/psxmem.h"
+#include "core/r3000a.h"
+#include "core/sstate-io.h"
+#include "core/sstate.h"
+#include "core/system.h"
+#include "fmt/format.h"
+#include "support/eventbus.h"
+#include "support/file.h"
+
+namespace {
+
+// Enough to tell what went wrong, without drowning the report.
+constexpr size_t c_maxTrace = 4096;
+constexpr size_t c_maxMemoryDifferences = 16;
+
+struct CpuState {
+    PCSX::psxGPRRegs GPR;
+    PCSX::psxCP0Regs CP0;
+    PCSX::psxCP2Data CP2D;
+    PCSX::psxCP2Ctrl CP2C;
+    uint32_t pc;
+    uint64_t cycle;
+};
+
+CpuState captureCpu() {
+    auto& regs = PCSX::g_emulator->m_cpu->m_regs;
+    CpuState state;
+    memcpy(&state.GPR, &regs.GPR, sizeof(state.GPR));
+    memcpy(&state.CP0, &regs.CP0, sizeof(state.CP0));
+    memcpy(&state.CP2D, &regs.CP2D, sizeof(state.CP2D));
+    memcpy(&state.CP2C, &regs.CP2C, sizeof(state.CP2C));
+    state.pc = regs.pc;
+    state.cycle = regs.cycle;
+    return state;
+}
+
+void compareCpu(const CpuState& dynarec, const CpuState& interpreter, std::vector<std::string>& out) {
+    auto check = [&out](const char* name, uint64_t a, uint64_t b) {
+        if (a != b) out.push_back(fmt::format("{}: dynarec {:08x}, interpreter {:08x}", name, a, b));
+    };
+    check("pc", dynarec.pc, interpreter.pc);
+    check("cycle", dynarec.cycle, interpreter.cycle);
+    for (unsigned i = 0; i < 32; i++) check(PCSX::Disasm::s_disRNameGPR[i], dynarec.GPR.r[i], interpreter.GPR.r[i]);
+    check("lo", dynarec.GPR.n.lo, interpreter.GPR.n.lo);
+    check("hi", dynarec.GPR.n.hi, interpreter.GPR.n.hi);
+    for (unsigned i = 0; i < 32; i++) check(PCSX::Disasm::s_disRNameCP0[i], dynarec.CP0.r[i], interpreter.CP0.r[i]);
+    for (unsigned i = 0; i < 32; i++) {
+        check(PCSX::Disasm::s_disRNameCP2D[i], dynarec.CP2D.r[i], interpreter.CP2D.r[i]);
+    }
+    for (unsigned i = 0; i < 32; i++) {
+        check(PCSX::Disasm::s_disRNameCP2C[i], dynarec.CP2C.r[i], interpreter.CP2C.r[i]);
+    }
+}
+
+}  // namespace
+
+PCSX::Lockstep::Lockstep() {}
+PCSX::Lockstep::~Lockstep() {}
+
+void PCSX::Lockstep::activate(bool dynarec) {
+    if (g_emulator->m_cpu->isDynarec() != dynarec) std::swap(g_emulator->m_cpu, m_idle);
+}
+
+void PCSX::Lockstep::runToShell() {
+    if (g_emulator->m_cpu->m_shellStarted) return;
+    bool reached = false;
+    EventBus::Listener listener(g_emulator->m_eventBus);
+    listener.listen<Events::ExecutionFlow::ShellReached>([&reached](const auto& event) {
+        reached = true;
+        g_system->pause();
+    });
+    g_system->resume();
+    while (!reached && g_system->running()) g_emulator->m_cpu->Execute();
+}
+
+bool PCSX::Lockstep::loadCheckpoint(const std::filesystem::path& path) {
+    IO<File> file(new PosixFile(path));
+    if (file->failed()) return false;
+    std::string data = file->readString(file->size());
+    std::string state;
+    if (!SaveStateIO::decompress(data, state)) return false;
+    return SaveStates::load(state);
+}
+
+void PCSX::Lockstep::runSlice(const std::string& checkpoint, unsigned count, uint64_t endCycle, bool detailed,
+                              Slice& slice) {
+    slice = {};
+    auto& mem = g_emulator->m_mem;
+    const size_t ramSize = g_emulator->getRamMask() + 1;
+
+    // The dynarec first, with the emulation quietly paused, so that it
+    // returns after each dispatch. Anything it does to pause the emulation
+    // gets lost, but the interpreter will do it again right after.
+    activate(true);
+    SaveStates::load(checkpoint);
+    slice.startCycle = g_emulator->m_cpu->m_regs.cycle;
+    slice.startPC = g_emulator->m_cpu->m_regs.pc;
+    g_emulator->setRunningQuietly(false);
+    while ((slice.dispatches < count) && (g_emulator->m_cpu->m_regs.cycle < endCycle) && !g_system->quitting()) {
+        g_emulator->m_cpu->Execute();
+        slice.dispatches++;
+    }
+    g_emulator->setRunningQuietly(true);
+    slice.endCycle = g_emulator->m_cpu->m_regs.cycle;
+    const CpuState dynarecCpu = captureCpu();
+    const StateHash::Digest dynarecDigest = m_hash.update();
+    std::vector<uint8_t> dynarecRam;
+    if (detailed) dynarecRam.assign(mem->m_wram, mem->m_wram + ramSize);
+
+    activate(false);
+    SaveStates::load(checkpoint);
+    auto& regs = g_emulator->m_cpu->m_regs;
+    while ((regs.cycle < slice.endCycle) && g_system->running()) {
+        if (detailed && (slice.disassembly.size() < c_maxTrace)) {
+            auto ptr = reinterpret_cast<const uint32_t*>(mem->pointerRead(regs.pc));
+            if (ptr) {
+                slice.disassembly.push_back(
+                    fmt::format("{:08x}: {:08x}  {}", regs.pc, *ptr, Disasm::asString(*ptr, 0, regs.pc)));
+            } else {
+                slice.disassembly.push_back(fmt::format("{:08x}: ????????", regs.pc));
+            }
+        }
+        g_emulator->m_cpu->ExecuteInstruction();
+    }
+    // The emulated software paused or quit, and there's nothing to compare
+    // against past that point.
+    slice.interrupted = !g_system->running();
+    if (slice.interrupted) return;
+
+    const CpuState interpreterCpu = captureCpu();
+    const auto& interpreterDigest = m_hash.update();
+    compareCpu(dynarecCpu, interpreterCpu, slice.differences);
+    for (unsigned i = 0; i < StateHash::c_regionCount; i++) {
+        const auto region = static_cast<StateHash::Region>(i);
+        if (region == StateHash::Region::SPURAM) continue;
+        const auto& a = dynarecDigest.pages[i];
+        const auto& b = interpreterDigest.pages[i];
+        for (size_t page = 0; page < std::min(a.size(), b.size()); page++) {
+            if (a[page] == b[page]) continue;
+            slice.differences.push_back(fmt::format("{} page {} (offset {:08x}) differs", StateHash::regionName(region),
+                                                    page, page * StateHash::c_pageSize));
+            break;
+        }
+    }
+    if (detailed && !dynarecRam.empty()) {
+        size_t reported = 0;
+        for (size_t offset = 0; (offset < ramSize) && (reported < c_maxMemoryDifferences); offset += 4) {
+            uint32_t a, b;
+            memcpy(&a, dynarecRam.data() + offset, sizeof(a));
+            memcpy(&b, mem->m_wram + offset, sizeof(b));
+            if (a == b) continue;
+            slice.differences.push_back(
+                fmt::format("ram {:08x}: dynarec {:08x}, interpreter {:08x}", 0x80000000 | offset, a, b));
+            reported++;
+        }
+    }
+    slice.matched = slice.differences.empty();
+}
+
+PCSX::Lockstep::Result PCSX::Lockstep::run(const Options& options) {
+    Result result;
+    const bool startedOnDynarec = g_emulator->m_cpu->isDynarec();
+    m_idle = startedOnDynarec ? Cpus::Interpreted() : Cpus::DynaRec();
+    if (!m_idle) {
+        result.supported = false;
+        return result;
+    }
+    m_idle->Init();
+    m_idle->psxSetPGXPMode(0);
+    m_idle->m_symbols = g_emulator->m_cpu->m_symbols;
+    m_idle->m_shellStarted = g_emulator->m_cpu->m_shellStarted;
+    m_hash.reset();
+
+    const uint64_t startCycle = g_emulator->m_cpu->m_regs.cycle;
+    const uint64_t endCycle = options.cycles ? startCycle + options.cycles : std::numeric_limits<uint64_t>::max();
+    const unsigned sliceSize = std::max(options.sliceSize, 1u);
+    g_system->resume();
+
+    Slice slice;
+    while (g_system->running() && (g_emulator->m_cpu->m_regs.cycle < endCycle)) {
+        std::string checkpoint = SaveStates::save();
+        runSlice(checkpoint, sliceSize, endCycle, false, slice);
+        if (slice.interrupted) break;
+        if (slice.matched) {
+            result.dispatches += slice.dispatches;
+            continue;
+        }
+
+        // Replaying the slice one dispatch at a time, to find the first one
+        // which diverges.
+        Mismatch mismatch{slice.startCycle, slice.startPC, false, slice.differences, {}};
+        const unsigned dispatches = slice.dispatches;
+        Slice single;
+        for (unsigned i = 0; i < dispatches; i++) {
+            runSlice(checkpoint, 1, endCycle, true, single);
+            if (single.interrupted) break;
+            if (!single.matched) {
+                mismatch = {single.startCycle, single.startPC, true, single.differences, single.disassembly};
+                break;
+            }
+            result.dispatches++;
+            checkpoint = SaveStates::save();
+        }
+        result.mismatch = mismatch;
+        break;
+    }
+
+    result.cycles = g_emulator->m_cpu->m_regs.cycle - startCycle;
+    if (startedOnDynarec) {
+        std::string state = SaveStates::save();
+        activate(true);
+        SaveStates::load(state);
+    }
+    m_idle.reset();
+    g_system->pause();
+    return result;
+}
+
+std::string PCSX::Lockstep::format(const Result& result) {
+    if (!result.supported) return "The dynarec isn't available on this platform.\n";
+    std::string out = fmt::format("Ran {} dispatches over {} cycles.\n", result.dispatches, result.cycles);
+    if (!result.mismatch.has_value()) return out + "No divergence found.\n";
+    const auto& mismatch = result.mismatch.value();
+    out += fmt::format("Divergence in the {} starting at pc {:08x}, cycle {}:\n",
+                       mismatch.narrowed ? "dispatch" : "slice", mismatch.pc, mismatch.cycle);
+    for (auto& difference : mismatch.differences) out += fmt::format("  {}\n", difference);
+    if (!mismatch.disassembly.empty()) {
+        out += "Instructions run by the interpreter over it:\n";
+        for (auto& line : mismatch.disassembly) out += fmt::format("  {}\n", line);
+    }
+    return out;
+}
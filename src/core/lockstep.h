@@ -0,0 +1,109 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "core/statehash.h"
+
+namespace PCSX {
+
+class R3000Acpu;
+
+// Differential testing of the dynarec against the interpreter. Both cores
+// run the same code from the same checkpoint, one after the other, and the
+// resulting machine states get compared. The unit of lockstep is a dispatch
+// of the dynarec: a block, or a chain of linked blocks, after which the
+// dynarec returns to its dispatcher. The interpreter then runs instruction by
+// instruction over the same amount of cycles.
+//
+// Each core gets its own copy of the machine by restoring the checkpoint, a
+// save state, before running. Since that's costly, a whole slice of
+// dispatches is compared at once, and only when a slice diverges does it get
+// replayed one dispatch at a time, to find the first one which differs. That
+// one is reported with the register and memory differences, and the
+// disassembly of what the interpreter ran over it.
+//
+// The interpreter only services events after branch delay slots, while the
+// dynarec does so after each dispatch, so code which gets interrupted in the
+// middle of a chain of linked blocks may legitimately diverge. SPU RAM isn't
+// compared, as the SPU thread writes to it on its own.
+class Lockstep {
+  public:
+    struct Options {
+        unsigned sliceSize = 1024;
+        // Stops after that many emulated cycles, or only when the emulation
+        // pauses or quits if zero.
+        uint64_t cycles = 0;
+    };
+    struct Mismatch {
+        uint64_t cycle;
+        uint32_t pc;
+        // False if the slice diverged, but none of its dispatches did when
+        // replayed alone, which points at timing differences.
+        bool narrowed;
+        std::vector<std::string> differences;
+        std::vector<std::string> disassembly;
+    };
+    struct Result {
+        bool supported = true;
+        uint64_t dispatches = 0;
+        uint64_t cycles = 0;
+        std::optional<Mismatch> mismatch;
+    };
+
+    Lockstep();
+    ~Lockstep();
+    // Runs from the current state, and leaves the emulator paused, on the
+    // core it started with.
+    Result run(const Options& options);
+    // Runs the emulation normally until the shell is reached, and the binary
+    // to load, if any, got loaded, as the binary loader can only run once.
+    static void runToShell();
+    // Loads a save state file synchronously, compressed or not, to start from.
+    static bool loadCheckpoint(const std::filesystem::path& path);
+    static std::string format(const Result& result);
+
+  private:
+    struct Slice {
+        unsigned dispatches = 0;
+        uint64_t startCycle = 0;
+        uint64_t endCycle = 0;
+        uint32_t startPC = 0;
+        bool interrupted = false;
+        bool matched = false;
+        std::vector<std::string> differences;
+        std::vector<std::string> disassembly;
+    };
+
+    void activate(bool dynarec);
+    void runSlice(const std::string& checkpoint, unsigned count, uint64_t endCycle, bool detailed, Slice& slice);
+
+    std::unique_ptr<R3000Acpu> m_idle;
+    StateHash m_hash;
+};
+
+}  // namespace PCSX
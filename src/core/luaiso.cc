@@ -40,6 +40,9 @@ void deleteIso(LuaIso* wrapper) { delete wrapper; }
 bool isIsoFailed(LuaIso* wrapper) { return wrapper->iso->failed(); }
 void isoClearPPF(LuaIso* wrapper) { wrapper->iso->getPPF()->clear(); }
 void isoSavePPF(LuaIso* wrapper) { wrapper->iso->getPPF()->save(wrapper->iso->getIsoPath()); }
+void isoGetReadAheadStats(LuaIso* wrapper, PCSX::ReadAheadCache::Stats* stats) {
+    *stats = wrapper->iso->getReadAheadStats();
+}
 LuaIso* getCurrentIso() { return new LuaIso(PCSX::g_emulator->m_cdrom->getIso()); }
 LuaIso* openIso(const char* path) { return new LuaIso(std::make_shared<PCSX::CDRIso>(path)); }
 LuaIso* openIsoFromFile(PCSX::LuaFFI::LuaFile* wrapper) {
@@ -89,6 +92,7 @@ static void registerAllSymbols(PCSX::Lua L) {
     REGISTER(L, isIsoFailed);
     REGISTER(L, isoClearPPF);
     REGISTER(L, isoSavePPF);
+    REGISTER(L, isoGetReadAheadStats);
     REGISTER(L, getCurrentIso);
     REGISTER(L, openIso);
     REGISTER(L, openIsoFromFile);
@@ -0,0 +1,164 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/memory-export.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <new>
+
+#include "core/gpu.h"
+#include "core/psxemulator.h"
+#include "core/psxmem.h"
+#include "core/r3000a.h"
+#include "core/spu.h"
+#include "core/system.h"
+#include "fmt/format.h"
+
+namespace {
+
+// In the order enable() adds them.
+enum RegionIndex : unsigned {
+    SCRATCHPAD,
+    REGISTERS,
+    VRAM,
+    SPURAM,
+};
+
+constexpr size_t c_pageSize = 4096;
+constexpr size_t c_scratchpadSize = 1024;
+constexpr size_t c_vramSize = 1024 * 512 * 2;
+constexpr size_t c_spuRamSize = 512 * 1024;
+
+size_t alignToPage(size_t size) { return (size + c_pageSize - 1) & ~(c_pageSize - 1); }
+
+}  // namespace
+
+PCSX::MemoryExport::MemoryExport() : m_listener(g_emulator->m_eventBus) {
+    // Same naming scheme as the main RAM, so that several emulators in the
+    // same process don't export into each other.
+    static std::atomic<unsigned> s_instances = 0;
+    unsigned instance = s_instances.fetch_add(1);
+    m_name = instance == 0 ? "export" : fmt::format("export{}", instance);
+
+    m_listener.listen<Events::SettingsLoaded>([this](const auto& event) {
+        auto& debugSettings = g_emulator->settings.get<Emulator::SettingDebugSettings>();
+        if (debugSettings.get<Emulator::DebugSettings::SharedMemoryExport>() && !enabled()) enable();
+    });
+    m_listener.listen<Events::Quitting>([this](const auto& event) { disable(); });
+    m_listener.listen<Events::ExecutionFlow::Pause>([this](const auto& event) { publish(true); });
+    m_listener.listen<Events::ExecutionFlow::Run>([this](const auto& event) { resume(); });
+}
+
+bool PCSX::MemoryExport::enable() {
+    if (enabled()) return true;
+    const size_t size = c_headerSize + alignToPage(c_scratchpadSize) + alignToPage(sizeof(Registers)) +
+                        alignToPage(c_vramSize) + alignToPage(c_spuRamSize);
+    m_sharedMem.reset(new SharedMem());
+    if (!m_sharedMem->init(m_name.c_str(), size, true)) {
+        g_system->message("%s", _("Unable to create the shared memory export segment\n"));
+        m_sharedMem.reset();
+        return false;
+    }
+
+    m_header = new (m_sharedMem->getPtr()) Header();
+    m_header->version = c_version;
+    m_header->headerSize = c_headerSize;
+    m_header->sequence.store(1, std::memory_order_relaxed);
+    auto& ramName = g_emulator->m_mem->m_wramShared.getSharedName();
+    strncpy(m_header->ramName, ramName.c_str(), sizeof(m_header->ramName) - 1);
+    m_header->ramSize = g_emulator->settings.get<Emulator::Setting8MB>() ? 8 * 1024 * 1024 : 2 * 1024 * 1024;
+    m_end = c_headerSize;
+    addRegion("scratchpad", c_scratchpadSize);
+    addRegion("registers", sizeof(Registers));
+    addRegion("vram", c_vramSize);
+    addRegion("spuram", c_spuRamSize);
+    m_stable = false;
+    // The magic goes in last, so that readers never see a half-filled header.
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(m_header->magic, c_magic, sizeof(c_magic));
+
+    publish(true);
+    resume();
+    return true;
+}
+
+void PCSX::MemoryExport::disable() {
+    if (!enabled()) return;
+    m_header = nullptr;
+    m_sharedMem.reset();
+}
+
+void PCSX::MemoryExport::addRegion(const char* name, size_t size) {
+    auto& region = m_header->regions[m_header->regionCount++];
+    strncpy(region.name, name, sizeof(region.name) - 1);
+    region.offset = m_end;
+    region.size = size;
+    m_end += alignToPage(size);
+}
+
+void PCSX::MemoryExport::vsync(bool presenting) {
+    if (!enabled()) return;
+    m_header->frame++;
+    publish(presenting);
+}
+
+void PCSX::MemoryExport::publish(bool full) {
+    if (!enabled()) return;
+    // Published twice in a row, such as when pausing during vsync: the
+    // readers need to see the update, so go through an odd value again.
+    if (m_stable) m_header->sequence.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const uint64_t frame = m_header->frame;
+    memcpy(region(SCRATCHPAD), g_emulator->m_mem->m_hard, c_scratchpadSize);
+    m_header->regions[SCRATCHPAD].frame = frame;
+
+    auto& regs = g_emulator->m_cpu->m_regs;
+    auto registers = reinterpret_cast<Registers*>(region(REGISTERS));
+    std::copy_n(regs.GPR.r, 34, registers->gpr);
+    registers->pc = regs.pc;
+    std::copy_n(regs.CP0.r, 32, registers->cp0);
+    m_header->regions[REGISTERS].frame = frame;
+    m_header->cycle = regs.cycle;
+
+    if (full) {
+        auto vram = g_emulator->m_gpu->getVRAM();
+        memcpy(region(VRAM), vram.data(), std::min(vram.size(), uint32_t(c_vramSize)));
+        m_header->regions[VRAM].frame = frame;
+        auto& spu = g_emulator->m_spu;
+        spu->lockSPURAM();
+        memcpy(region(SPURAM), spu->getSPURAM(), c_spuRamSize);
+        spu->unlockSPURAM();
+        m_header->regions[SPURAM].frame = frame;
+    }
+    m_header->running = g_system->running();
+
+    m_header->sequence.fetch_add(1, std::memory_order_release);
+    m_stable = true;
+}
+
+void PCSX::MemoryExport::resume() {
+    if (!enabled() || !m_stable || !g_system->running()) return;
+    m_header->sequence.fetch_add(1, std::memory_order_relaxed);
+    m_header->running = 1;
+    std::atomic_thread_fence(std::memory_order_release);
+    m_stable = false;
+}
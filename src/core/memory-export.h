@@ -0,0 +1,125 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "support/eventbus.h"
+#include "support/sharedmem.h"
+
+namespace PCSX {
+
+// Exports the state of the emulated machine into a named shared memory
+// segment, for external processes to map read-only. The main RAM is already
+// a shared segment of its own, named in the header, and is exposed as is,
+// without any copy. The rest lives in places which can't be shared directly,
+// such as the VRAM of the hardware renderer, so it is copied into the export
+// segment at each frame boundary.
+//
+// The segment starts with a Header, followed by the regions it lists. The
+// header's sequence counter is a seqlock: it is odd while the emulated CPU is
+// running and the memory changes under the reader's feet, and gets bumped to
+// an even value once the regions are published, either at vsync, or when the
+// emulation pauses. A consistent snapshot of any region, including the main
+// RAM, is read this way:
+//
+//   do {
+//       do { seq = header->sequence.load(acquire); } while (seq & 1);
+//       ... copy what's needed ...
+//       atomic_thread_fence(acquire);
+//   } while (header->sequence.load(relaxed) != seq);
+//
+// When running, the stable window only lasts while the emulator presents the
+// frame, so readers should copy what they need, and not work in place. The
+// VRAM and SPU RAM regions are only refreshed on frames the emulator actually
+// presents, which their frame field reflects.
+class MemoryExport {
+  public:
+    static constexpr char c_magic[8] = {'P', 'C', 'S', 'X', 'E', 'X', 'P', 'T'};
+    static constexpr uint32_t c_version = 1;
+    static constexpr size_t c_headerSize = 4096;
+    static constexpr unsigned c_maxRegions = 16;
+
+    struct Region {
+        char name[16];
+        uint64_t offset;
+        uint64_t size;
+        // The frame this region was last copied at.
+        uint64_t frame;
+    };
+    // The "registers" region.
+    struct Registers {
+        uint32_t gpr[34];  // r0 to r31, then lo and hi
+        uint32_t pc;
+        uint32_t cp0[32];
+        uint32_t padding;
+    };
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t headerSize;
+        std::atomic<uint32_t> sequence;
+        uint32_t running;
+        uint64_t frame;
+        uint64_t cycle;
+        // The shared segment holding the main RAM, and how much of it is used.
+        char ramName[64];
+        uint32_t ramSize;
+        uint32_t regionCount;
+        Region regions[c_maxRegions];
+    };
+    static_assert(std::atomic<uint32_t>::is_always_lock_free);
+    static_assert(sizeof(Header) <= c_headerSize);
+
+    MemoryExport();
+    bool enable();
+    void disable();
+    bool enabled() const { return m_header != nullptr; }
+    // For forked processes, which must stop writing into their parent's export.
+    bool unshare() { return m_sharedMem ? m_sharedMem->unshare() : true; }
+    std::string getSharedName() { return m_sharedMem ? m_sharedMem->getSharedName() : std::string(); }
+
+    // Called at vsync, before the frame gets presented. Publishes a new
+    // frame, with the VRAM and SPU RAM only if presenting is set.
+    void vsync(bool presenting);
+    // Called once the frame is presented; makes the sequence odd again, if
+    // the emulation is running.
+    void resume();
+
+  private:
+    // Copies the regions and makes the sequence even.
+    void publish(bool full);
+    void addRegion(const char* name, size_t size);
+    uint8_t* region(unsigned index) { return m_sharedMem->getPtr() + m_header->regions[index].offset; }
+
+    std::string m_name;
+    std::unique_ptr<SharedMem> m_sharedMem;
+    Header* m_header = nullptr;
+    size_t m_end = 0;
+    bool m_stable = false;
+    EventBus::Listener m_listener;
+};
+
+}  // namespace PCSX
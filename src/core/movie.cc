@@ -0,0 +1,285 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/movie.h"
+
+#include <string.h>
+#include <zlib.h>
+
+#include <string>
+
+#include "core/psxemulator.h"
+#include "core/psxmem.h"
+#include "core/r3000a.h"
+#include "core/sstate-io.h"
+#include "core/sstate.h"
+#include "core/system.h"
+
+namespace {
+
+constexpr uint8_t c_magic[7] = {'P', 'C', 'S', 'X', 'M', 'O', 'V'};
+constexpr size_t c_inputSize = 10;
+
+void putU32(std::vector<uint8_t>& out, uint32_t value) {
+    for (unsigned i = 0; i < 4; i++) out.push_back(value >> (i * 8));
+}
+
+uint32_t getU32(const uint8_t* in) { return in[0] | (in[1] << 8) | (in[2] << 16) | (uint32_t(in[3]) << 24); }
+
+void putInput(std::vector<uint8_t>& out, const PCSX::Pads::Input& input) {
+    out.push_back(input.buttons & 0xff);
+    out.push_back(input.buttons >> 8);
+    out.push_back(input.rightJoyX);
+    out.push_back(input.rightJoyY);
+    out.push_back(input.leftJoyX);
+    out.push_back(input.leftJoyY);
+    out.push_back(input.mouseButtons);
+    out.push_back(input.mouseDeltaX);
+    out.push_back(input.mouseDeltaY);
+    out.push_back(input.analogMode ? 1 : 0);
+}
+
+}  // namespace
+
+PCSX::Movie::Movie() : m_listener(g_emulator->m_eventBus) {
+    m_listener.listen<Events::GPU::VSync>([this](const auto& event) { endFrame(); });
+    // Resets aren't part of the recording, so neither it nor a playback can
+    // go on past one.
+    m_listener.listen<Events::ExecutionFlow::Reset>([this](const auto& event) {
+        if (!active()) return;
+        g_system->log(LogClass::SYSTEM, "Movie stopped by a reset at frame %u\n", m_frame);
+        stop();
+    });
+}
+
+bool PCSX::Movie::record(const std::filesystem::path& path, Start start) {
+    stop();
+    IO<File> file(new PosixFile(path, FileOps::TRUNCATE));
+    if (file->failed()) return false;
+
+    std::string state;
+    if (start == Start::SaveState) {
+        state = SaveStateIO::compress(SaveStates::save(), SaveStateIO::Codec::GZip);
+    } else {
+        g_system->hardReset();
+    }
+
+    m_buffer.assign(c_magic, c_magic + sizeof(c_magic));
+    m_buffer.push_back(c_version);
+    putU32(m_buffer, g_emulator->m_mem->getBiosCRC32());
+    putU32(m_buffer, c_hashInterval);
+    m_buffer.push_back(static_cast<uint8_t>(start));
+    if (start == Start::SaveState) {
+        putU32(m_buffer, state.size());
+        m_buffer.insert(m_buffer.end(), state.begin(), state.end());
+    }
+
+    m_file = file;
+    m_recording = true;
+    m_frame = 0;
+    m_hashInterval = c_hashInterval;
+    m_desyncFrame.reset();
+    m_hasLast[0] = m_hasLast[1] = false;
+    flush();
+    return true;
+}
+
+bool PCSX::Movie::play(const std::filesystem::path& path) {
+    stop();
+    IO<File> file(new PosixFile(path));
+    if (file->failed()) return false;
+    std::vector<uint8_t> data(file->size());
+    if (file->read(data.data(), data.size()) != ssize_t(data.size())) return false;
+
+    static constexpr size_t headerSize = sizeof(c_magic) + 1 + 4 + 4 + 1;
+    if ((data.size() < headerSize) || (memcmp(data.data(), c_magic, sizeof(c_magic)) != 0)) return false;
+    const uint8_t* ptr = data.data() + sizeof(c_magic);
+    if (*ptr++ != c_version) return false;
+    const uint32_t biosCRC = getU32(ptr);
+    const uint32_t hashInterval = getU32(ptr + 4);
+    const Start start = static_cast<Start>(ptr[8]);
+    ptr += 9;
+    if (!hashInterval) return false;
+
+    std::string state;
+    if (start == Start::SaveState) {
+        const uint8_t* end = data.data() + data.size();
+        if ((end - ptr) < 4) return false;
+        const uint32_t size = getU32(ptr);
+        ptr += 4;
+        if (size_t(end - ptr) < size) return false;
+        std::string_view compressed(reinterpret_cast<const char*>(ptr), size);
+        if (!SaveStateIO::decompress(compressed, state)) return false;
+        ptr += size;
+        if (!SaveStates::load(state)) return false;
+    } else if (start == Start::PowerOn) {
+        g_system->hardReset();
+    } else {
+        return false;
+    }
+    if (g_emulator->m_mem->getBiosCRC32() != biosCRC) {
+        g_system->log(LogClass::SYSTEM, "Movie recorded with a different BIOS, playback will likely desync\n");
+    }
+
+    m_position = ptr - data.data();
+    m_buffer = std::move(data);
+    m_playing = true;
+    m_frame = 0;
+    m_hashInterval = hashInterval;
+    m_desyncFrame.reset();
+    m_hasLast[0] = m_hasLast[1] = false;
+    return true;
+}
+
+void PCSX::Movie::stop() {
+    if (m_recording) {
+        flush();
+        m_file->close();
+        m_file.reset();
+    }
+    m_recording = m_playing = false;
+    m_buffer.clear();
+    m_position = 0;
+}
+
+void PCSX::Movie::flush() {
+    if (!m_recording || m_buffer.empty()) return;
+    m_file->write(m_buffer.data(), m_buffer.size());
+    m_buffer.clear();
+}
+
+// The main RAM and the CPU registers cover the bulk of what a desync
+// changes, at a fraction of the cost of hashing a full save state.
+uint32_t PCSX::Movie::hashState() {
+    auto& regs = g_emulator->m_cpu->m_regs;
+    uint32_t crc = crc32(0L, Z_NULL, 0);
+    crc = crc32(crc, g_emulator->m_mem->m_wram, g_emulator->getRamMask() + 1);
+    crc = crc32(crc, reinterpret_cast<const Bytef*>(&regs.GPR), sizeof(regs.GPR));
+    crc = crc32(crc, reinterpret_cast<const Bytef*>(&regs.pc), sizeof(regs.pc));
+    return crc;
+}
+
+void PCSX::Movie::desync() {
+    if (m_desyncFrame.has_value()) return;
+    m_desyncFrame = m_frame;
+    g_system->log(LogClass::SYSTEM, "Movie playback desynced at frame %u\n", m_frame);
+}
+
+bool PCSX::Movie::readInput(Pads::Input& input) {
+    if ((m_buffer.size() - m_position) < c_inputSize) return false;
+    const uint8_t* ptr = m_buffer.data() + m_position;
+    input.buttons = ptr[0] | (ptr[1] << 8);
+    input.rightJoyX = ptr[2];
+    input.rightJoyY = ptr[3];
+    input.leftJoyX = ptr[4];
+    input.leftJoyY = ptr[5];
+    input.mouseButtons = ptr[6];
+    input.mouseDeltaX = ptr[7];
+    input.mouseDeltaY = ptr[8];
+    input.analogMode = ptr[9];
+    m_position += c_inputSize;
+    return true;
+}
+
+void PCSX::Movie::poll(unsigned port, Pads::Input& input) {
+    if (m_recording) {
+        if (m_hasLast[port] && (m_last[port] == input)) {
+            m_buffer.push_back(TOKEN_REPEAT | port);
+        } else {
+            m_buffer.push_back(TOKEN_INPUT | port);
+            putInput(m_buffer, input);
+        }
+        m_last[port] = input;
+        m_hasLast[port] = true;
+        if (m_buffer.size() >= c_flushSize) flush();
+        return;
+    }
+    if (!m_playing) return;
+
+    if (m_position < m_buffer.size()) {
+        const uint8_t token = m_buffer[m_position];
+        const uint8_t type = token & ~1;
+        if (((type == TOKEN_INPUT) || (type == TOKEN_REPEAT)) && ((token & 1) == port)) {
+            m_position++;
+            if (type == TOKEN_INPUT) m_hasLast[port] = readInput(m_last[port]);
+            if (m_hasLast[port]) {
+                input = m_last[port];
+                return;
+            }
+        }
+    }
+    // The emulation polls where the recording didn't.
+    desync();
+    if (m_hasLast[port]) input = m_last[port];
+}
+
+void PCSX::Movie::endFrame() {
+    if (m_recording) {
+        m_frame++;
+        m_buffer.push_back(TOKEN_FRAME);
+        if (!(m_frame % m_hashInterval)) {
+            m_buffer.push_back(TOKEN_HASH);
+            putU32(m_buffer, hashState());
+        }
+        if (m_buffer.size() >= c_flushSize) flush();
+        return;
+    }
+    if (!m_playing) return;
+
+    m_frame++;
+    // Whatever is left before the end of the frame are polls the emulation
+    // didn't do.
+    bool skipped = false;
+    bool truncated = false;
+    while ((m_position < m_buffer.size()) && (m_buffer[m_position] != TOKEN_FRAME)) {
+        // The hash token has its low bit set, so it can't be masked like the port tokens.
+        const uint8_t token = m_buffer[m_position];
+        const uint8_t type = token & ~1;
+        const size_t size = token == TOKEN_HASH ? 5 : type == TOKEN_INPUT ? 1 + c_inputSize : 1;
+        if (size > (m_buffer.size() - m_position)) {
+            truncated = true;
+            break;
+        }
+        m_position += size;
+        skipped = true;
+    }
+    if (skipped) desync();
+    if (m_position < m_buffer.size()) m_position++;
+    if ((m_position < m_buffer.size()) && (m_buffer[m_position] == TOKEN_HASH)) {
+        if ((m_buffer.size() - m_position) < 5) {
+            truncated = true;
+        } else {
+            if (getU32(m_buffer.data() + m_position + 1) != hashState()) desync();
+            m_position += 5;
+        }
+    }
+    // A token cut short means the file itself is incomplete, and nothing
+    // after it can be trusted.
+    if (truncated) {
+        g_system->log(LogClass::SYSTEM, "Movie file truncated at frame %u\n", m_frame);
+        desync();
+        m_position = m_buffer.size();
+    }
+
+    if (m_position >= m_buffer.size()) {
+        g_system->log(LogClass::SYSTEM, "Movie playback finished after %u frames\n", m_frame);
+        stop();
+        g_system->pause();
+    }
+}
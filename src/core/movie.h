@@ -0,0 +1,97 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+#include "core/pad.h"
+#include "support/eventbus.h"
+#include "support/file.h"
+
+namespace PCSX {
+
+// Input movies: the input of both pads, recorded each time the emulated
+// software polls them, which replays bit for bit on the same emulator, as
+// long as it starts from the same point, and runs with the same settings.
+// Since the input gets tied to the polls, and not to any amount of time, a
+// movie can be played back at any speed, including unthrottled.
+//
+// The file is a header, followed by a stream of tokens, written as the
+// movie gets recorded:
+//   - the magic "PCSXMOV", a version byte, the CRC of the BIOS, how many
+//     frames there are between state hashes, and how the movie starts: from
+//     power on, or from the gzipped save state which follows,
+//   - 0x00 | port: a poll of that port, with its full input,
+//   - 0x02 | port: a poll of that port, with the same input as the last one,
+//   - 0x04: the end of a frame,
+//   - 0x05: a hash of the main RAM and CPU registers, at the end of a frame.
+// During playback, the hashes and the polls are checked against the
+// recording, and the first frame where they differ is reported as a desync.
+class Movie {
+  public:
+    enum class Start : uint8_t { PowerOn, SaveState };
+
+    Movie();
+    ~Movie() { stop(); }
+
+    bool record(const std::filesystem::path& path, Start start);
+    bool play(const std::filesystem::path& path);
+    void stop();
+
+    bool active() const { return m_recording || m_playing; }
+    bool recording() const { return m_recording; }
+    bool playing() const { return m_playing; }
+    uint32_t frame() const { return m_frame; }
+    std::optional<uint32_t> desyncFrame() const { return m_desyncFrame; }
+
+    // Called by the pads on each poll, with the input sampled from the host,
+    // which gets replaced when playing back.
+    void poll(unsigned port, Pads::Input& input);
+
+  private:
+    static constexpr uint8_t c_version = 1;
+    static constexpr uint32_t c_hashInterval = 60;
+    static constexpr size_t c_flushSize = 64 * 1024;
+    enum : uint8_t { TOKEN_INPUT = 0x00, TOKEN_REPEAT = 0x02, TOKEN_FRAME = 0x04, TOKEN_HASH = 0x05 };
+
+    static uint32_t hashState();
+    void endFrame();
+    void desync();
+    void flush();
+    bool readInput(Pads::Input& input);
+
+    IO<File> m_file;
+    std::vector<uint8_t> m_buffer;
+    size_t m_position = 0;
+    bool m_recording = false;
+    bool m_playing = false;
+    uint32_t m_frame = 0;
+    uint32_t m_hashInterval = c_hashInterval;
+    std::optional<uint32_t> m_desyncFrame;
+    Pads::Input m_last[2];
+    bool m_hasLast[2] = {false, false};
+    EventBus::Listener m_listener;
+};
+
+}  // namespace PCSX
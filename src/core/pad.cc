@@ -29,6 +29,7 @@
 #include <cmath>
 #include <magic_enum_all.hpp>
 
+#include "core/movie.h"
 #include "core/psxemulator.h"
 #include "core/system.h"
 #include "fmt/format.h"
@@ -145,6 +146,10 @@ class PadsImpl : public PCSX::Pads {
 
         // Analog stick values in range (0 - 255) where 128 = center
         uint8_t rightJoyX, rightJoyY, leftJoyX, leftJoyY;
+
+        // Mouse buttons, in the layout of the mouse reply, and movement
+        uint8_t mouseButtons = 0x0c;
+        int8_t mouseDeltaX = 0, mouseDeltaY = 0;
     };
 
     enum class PadCommands : uint8_t {
@@ -165,6 +170,8 @@ class PadsImpl : public PCSX::Pads {
         uint8_t poll(uint8_t value, uint32_t& padState);
         uint8_t doDualshockCommand(uint32_t& padState);
         void getButtons();
+        Input getInput();
+        void setInput(const Input& input);
         bool isControllerButtonPressed(int button, GLFWgamepadstate* state);
         bool isControllerConnected() { return m_settings.get<SettingConnected>(); }
 
@@ -178,6 +185,8 @@ class PadsImpl : public PCSX::Pads {
         void keyboardEvent(const PCSX::Events::Keyboard&);
         int& getButtonFromGUIIndex(int buttonIndex);
 
+        // The pads of the same emulator, for the gamepads they scanned.
+        PadsImpl* m_parent = nullptr;
         int m_scancodes[16];
         int m_padMapping[16];
         PadType m_type;
@@ -205,8 +214,6 @@ class PadsImpl : public PCSX::Pads {
     unsigned m_selectedPadForConfig = 0;
 };
 
-static PadsImpl* s_pads = nullptr;
-
 static ImGuiKey GlfwKeyToImGuiKey(int key) {
     switch (key) {
         case GLFW_KEY_TAB:
@@ -425,11 +432,13 @@ static ImGuiKey GlfwKeyToImGuiKey(int key) {
 }
 
 void PadsImpl::init() {
-    s_pads = this;
     scanGamepads();
+    // GLFW only calls this from the UI thread, which runs the UI's emulator.
     glfwSetJoystickCallback([](int jid, int event) {
-        s_pads->scanGamepads();
-        s_pads->map();
+        if (!PCSX::g_emulator) return;
+        auto pads = static_cast<PadsImpl*>(PCSX::g_emulator->m_pads.get());
+        pads->scanGamepads();
+        pads->map();
     });
     PCSX::g_system->findResource(
         [](const std::filesystem::path& filename) -> bool {
@@ -450,12 +459,10 @@ void PadsImpl::init() {
     map();
 }
 
-void PadsImpl::shutdown() {
-    glfwSetJoystickCallback(nullptr);
-    s_pads = nullptr;
-}
+void PadsImpl::shutdown() { glfwSetJoystickCallback(nullptr); }
 
-PadsImpl::PadsImpl() : m_listener(PCSX::g_system->m_eventBus) {
+PadsImpl::PadsImpl() : m_listener(PCSX::g_emulator->m_eventBus) {
+    for (auto& pad : m_pads) pad.m_parent = this;
     m_listener.listen<PCSX::Events::Keyboard>([this](const auto& event) {
         if (m_showCfg) {
             m_pads[m_selectedPadForConfig].keyboardEvent(event);
@@ -497,7 +504,7 @@ void PadsImpl::map() {
 }
 
 void PadsImpl::Pad::map() {
-    m_padID = s_pads->m_gamepadsMap[m_settings.get<SettingControllerID>()];
+    m_padID = m_parent->m_gamepadsMap[m_settings.get<SettingControllerID>()];
     m_type = m_settings.get<SettingDeviceType>();
 
     // L3/R3 are only avalable on analog controllers
@@ -574,6 +581,22 @@ void PadsImpl::Pad::getButtons() {
         return;
     }
 
+    if (m_type == PadType::Mouse) {
+        const int leftClick = ImGui::IsMouseDown(ImGuiMouseButton_Left) ? 0 : 1;
+        const int rightClick = ImGui::IsMouseDown(ImGuiMouseButton_Right) ? 0 : 1;
+        const auto& io = ImGui::GetIO();
+        const float scaleX = m_settings.get<SettingMouseSensitivityX>();
+        const float scaleY = m_settings.get<SettingMouseSensitivityY>();
+
+        const float deltaX = io.MouseDelta.x * scaleX;
+        const float deltaY = io.MouseDelta.y * scaleY;
+
+        // Left/right click are inverted in the response byte, ie 0 = pressed
+        pad.mouseButtons = (leftClick << 3) | (rightClick << 2);
+        pad.mouseDeltaX = (int8_t)std::clamp<float>(deltaX, -128.f, 127.f);
+        pad.mouseDeltaY = (int8_t)std::clamp<float>(deltaY, -128.f, 127.f);
+    }
+
     GLFWgamepadstate state;
     int hasPad = GLFW_FALSE;
     const auto& inputType = m_settings.get<SettingInputType>();
@@ -678,10 +701,45 @@ void PadsImpl::Pad::getButtons() {
     pad.buttonStatus = result ^ 0xffff;  // Controls are inverted, so 0 = pressed
 }
 
+PCSX::Pads::Input PadsImpl::Pad::getInput() {
+    Input input;
+    input.buttons = m_data.buttonStatus & m_data.overrides;
+    input.rightJoyX = m_data.rightJoyX;
+    input.rightJoyY = m_data.rightJoyY;
+    input.leftJoyX = m_data.leftJoyX;
+    input.leftJoyY = m_data.leftJoyY;
+    input.mouseButtons = m_data.mouseButtons;
+    input.mouseDeltaX = m_data.mouseDeltaX;
+    input.mouseDeltaY = m_data.mouseDeltaY;
+    input.analogMode = m_analogMode;
+    return input;
+}
+
+void PadsImpl::Pad::setInput(const Input& input) {
+    m_data.buttonStatus = input.buttons;
+    m_data.rightJoyX = input.rightJoyX;
+    m_data.rightJoyY = input.rightJoyY;
+    m_data.leftJoyX = input.leftJoyX;
+    m_data.leftJoyY = input.leftJoyY;
+    m_data.mouseButtons = input.mouseButtons;
+    m_data.mouseDeltaX = input.mouseDeltaX;
+    m_data.mouseDeltaY = input.mouseDeltaY;
+    m_analogMode = input.analogMode;
+}
+
 uint8_t PadsImpl::startPoll(Port port) {
     int index = magic_enum::enum_integer(port);
-    m_pads[index].getButtons();
-    return m_pads[index].startPoll();
+    auto& pad = m_pads[index];
+    pad.getButtons();
+    // A movie being recorded gets to see the input, and one being played
+    // back gets to replace it.
+    auto& movie = PCSX::g_emulator->m_movie;
+    if (movie->active()) {
+        Input input = pad.getInput();
+        movie->poll(index, input);
+        pad.setInput(input);
+    }
+    return pad.startPoll();
 }
 
 uint8_t PadsImpl::poll(uint8_t value, Port port, uint32_t& padState) {
@@ -815,20 +873,10 @@ uint8_t PadsImpl::Pad::read() {
 
     switch (m_type) {
         case PadType::Mouse: {
-            const int leftClick = ImGui::IsMouseDown(ImGuiMouseButton_Left) ? 0 : 1;
-            const int rightClick = ImGui::IsMouseDown(ImGuiMouseButton_Right) ? 0 : 1;
-            const auto& io = ImGui::GetIO();
-            const float scaleX = m_settings.get<SettingMouseSensitivityX>();
-            const float scaleY = m_settings.get<SettingMouseSensitivityY>();
-
-            const float deltaX = io.MouseDelta.x * scaleX;
-            const float deltaY = io.MouseDelta.y * scaleY;
-
             // The top 4 bits are always set to 1, the low 2 bits seem to always be set to 0.
-            // Left/right click are inverted in the response byte, ie 0 = pressed
-            m_mousepar[3] = 0xf0 | (leftClick << 3) | (rightClick << 2);
-            m_mousepar[4] = (int8_t)std::clamp<float>(deltaX, -128.f, 127.f);
-            m_mousepar[5] = (int8_t)std::clamp<float>(deltaY, -128.f, 127.f);
+            m_mousepar[3] = 0xf0 | pad.mouseButtons;
+            m_mousepar[4] = pad.mouseDeltaX;
+            m_mousepar[5] = pad.mouseDeltaY;
 
             memcpy(m_buf, m_mousepar, 6);
             m_bufferLen = 6;
@@ -1110,11 +1158,11 @@ bool PadsImpl::Pad::configure() {
 
     const char* preview = _("No gamepad selected or connected");
     auto& id = m_settings.get<SettingControllerID>().value;
-    int glfwjid = id >= 0 ? s_pads->m_gamepadsMap[id] : -1;
+    int glfwjid = id >= 0 ? m_parent->m_gamepadsMap[id] : -1;
 
     std::vector<const char*> gamepadsNames;
 
-    for (auto& m : s_pads->m_gamepadsMap) {
+    for (auto& m : m_parent->m_gamepadsMap) {
         if (m == -1) {
             continue;
         }
@@ -1384,4 +1432,4 @@ void PadsImpl::setLua(PCSX::Lua L) {
     assert(L.gettop() == 0);
 }
 
-PCSX::Pads* PCSX::Pads::factory() { return s_pads = new PadsImpl(); }
+PCSX::Pads* PCSX::Pads::factory() { return new PadsImpl(); }
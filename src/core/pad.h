@@ -34,6 +34,20 @@ class Pads {
   public:
     enum class Port { Port1 = 0, Port2 };
 
+    // Everything the host feeds into a pad when it gets polled, which is what
+    // input movies record and replay.
+    struct Input {
+        // Active low, with the Lua overrides already applied.
+        uint16_t buttons = 0xffff;
+        uint8_t rightJoyX = 0x80, rightJoyY = 0x80, leftJoyX = 0x80, leftJoyY = 0x80;
+        // Bits 3 and 2 are the left and right buttons, active low.
+        uint8_t mouseButtons = 0x0c;
+        int8_t mouseDeltaX = 0, mouseDeltaY = 0;
+        bool analogMode = false;
+
+        bool operator==(const Input&) const = default;
+    };
+
     virtual ~Pads() = default;
 
     virtual void init() = 0;
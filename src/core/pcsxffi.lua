@@ -63,6 +63,18 @@ void enableBreakpoint(Breakpoint*);
 void disableBreakpoint(Breakpoint*);
 bool breakpointEnabled(Breakpoint*);
 void removeBreakpoint(Breakpoint*);
+
+typedef struct {
+    uint32_t hook, pc, address, value;
+    uint8_t type, width;
+} MemoryHookHit;
+typedef struct { uint8_t opaque[?]; } MemoryHook;
+
+MemoryHook* addMemoryHook(uint32_t address, enum BreakpointType type, unsigned width, bool synchronous);
+uint32_t memoryHookId(MemoryHook*);
+void removeMemoryHook(MemoryHook*);
+const MemoryHookHit* takeMemoryHookHits(uint32_t* count, uint32_t* dropped);
+
 void pauseEmulator();
 void resumeEmulator();
 void softResetEmulator();
@@ -87,13 +99,147 @@ LuaSlice* createSaveState();
 void loadSaveStateFromSlice(LuaSlice*);
 void loadSaveStateFromFile(LuaFile*);
 
+void rewindCapture();
+bool rewindStepBack(unsigned count);
+bool rewindStepForward(unsigned count);
+bool rewindRestore(uint32_t index);
+void rewindClear();
+uint32_t rewindCount();
+uint32_t rewindPosition();
+
+typedef struct {
+    LuaSlice* output;
+    uint32_t stateHash;
+    int32_t pid;
+    bool success;
+} LuaForkResult;
+
+bool forkSupported();
+int32_t forkSpawn(uint32_t count);
+void forkRunFrames(uint32_t frames);
+void forkReport(const char* output, uint32_t size, bool success);
+uint32_t forkCollect();
+LuaForkResult forkResult(uint32_t index);
+
 LuaFile* getMemoryAsFile();
 
+float getSpeedScale();
+void setSpeedScale(float scale);
+bool isUnthrottled();
+void setUnthrottled(bool unthrottled);
+
+bool movieRecord(const char* path, bool fromState);
+bool moviePlay(const char* path);
+void movieStop();
+bool movieRecording();
+bool moviePlaying();
+uint32_t movieFrame();
+int64_t movieDesyncFrame();
+
+uint64_t stateHashUpdate();
+uint64_t stateHashRegion(uint32_t region);
+uint32_t stateHashRehashedPages();
+const char* stateHashRegionName(uint32_t region);
+LuaSlice* stateHashDigest();
+int32_t stateHashCompare(LuaSlice* a, LuaSlice* b, uint32_t* page);
+
+uint32_t perfCountersCount();
+const char* perfCounterName(uint32_t index);
+const char* perfCounterLabel(uint32_t index);
+void perfCountersSample(bool lastFrame, double* values);
+
+void accessTrackerEnable(bool enabled);
+bool accessTrackerEnabled();
+void accessTrackerClear();
+uint32_t accessTrackerNow();
+uint32_t accessTrackerLastAccess(uint32_t access, uint32_t address);
+LuaSlice* accessTrackerHeat(uint32_t access, uint32_t address, uint32_t size, uint32_t halfLife);
+
+typedef struct { uint8_t opaque[?]; } TraceReader;
+typedef struct {
+    uint32_t address;
+    uint32_t value;
+    uint8_t size;
+    bool write;
+} TraceMemoryAccess;
+typedef struct {
+    uint64_t index;
+    uint64_t cycle;
+    uint32_t pc;
+    uint32_t code;
+    uint64_t changed;
+    uint32_t regs[37];
+    unsigned accessCount;
+    TraceMemoryAccess accesses[3];
+} TraceRecord;
+
+bool traceStart(const char* path);
+void traceStop();
+bool traceRecording();
+uint64_t traceInstructions();
+TraceReader* traceOpen(const char* path);
+void traceClose(TraceReader* reader);
+uint64_t traceCount(TraceReader* reader);
+uint32_t traceRead(TraceReader* reader, uint64_t first, uint32_t count, TraceRecord* out);
+int64_t traceFindCycle(TraceReader* reader, uint64_t cycle);
+
 void quit(int code);
 ]]
 
 local C = ffi.load 'PCSX'
 
+local accessTrackerKinds = { read = 0, write = 1, exec = 2 }
+
+-- Converts a decoded TraceRecord into a plain table, with registers indexed
+-- the same way as in the file: the GPRs, lo, hi, then Status, Cause, and EPC.
+local function traceRecordToTable(r)
+    local regs, changed = {}, {}
+    for i = 0, 36 do
+        regs[i] = r.regs[i]
+        if bit.band(r.changed, bit.lshift(1ULL, i)) ~= 0 then changed[#changed + 1] = i end
+    end
+    local accesses = {}
+    for i = 0, r.accessCount - 1 do
+        local a = r.accesses[i]
+        accesses[i + 1] = { address = a.address, value = a.value, size = a.size, write = a.write }
+    end
+    return {
+        index = r.index,
+        cycle = r.cycle,
+        pc = r.pc,
+        code = r.code,
+        regs = regs,
+        changed = changed,
+        accesses = accesses,
+    }
+end
+
+local function openTrace(path)
+    local reader = C.traceOpen(path)
+    if reader == nil then return nil end
+    reader = ffi.gc(reader, C.traceClose)
+    return {
+        _reader = reader,
+        count = function(self) return C.traceCount(self._reader) end,
+        -- Returns an array of up to count records, starting at index first.
+        read = function(self, first, count)
+            count = count or 1
+            local records = ffi.new('TraceRecord[?]', count)
+            local filled = C.traceRead(self._reader, first, count, records)
+            local ret = {}
+            for i = 0, filled - 1 do ret[i + 1] = traceRecordToTable(records[i]) end
+            return ret
+        end,
+        -- The index of the first record at or after cycle, or nil.
+        findCycle = function(self, cycle)
+            local index = C.traceFindCycle(self._reader, cycle)
+            if index < 0 then return nil end
+            return index
+        end,
+        close = function(self) C.traceClose(ffi.gc(self._reader, nil)) self._reader = nil end,
+    }
+end
+
 local function removeBreakpoint(bp)
     C.removeBreakpoint(ffi.gc(bp._wrapper, nil))
     bp._wrapper = ffi.cast('Breakpoint*', 0)
@@ -154,6 +300,89 @@ local function addBreakpoint(address, bptype, width, cause, invoker, label)
     return bp
 end
 
+-- Weak values, so that hooks the script dropped still get collected.
+local memoryHooks = setmetatable({}, { __mode = 'v' })
+local memoryHookTypes = { [0] = 'Exec', 'Read', 'Write' }
+local memoryHookCounts = ffi.new('uint32_t[2]')
+local memoryHooksDraining = false
+
+-- Each hook gets called once per drain, with all of its hits in order.
+local function dispatchMemoryHooks(hits, count)
+    local batches = {}
+    local order = {}
+    for i = 0, count - 1 do
+        local hit = hits[i]
+        local hook = memoryHooks[hit.hook]
+        if hook ~= nil then
+            local batch = batches[hook]
+            if batch == nil then
+                batch = {}
+                batches[hook] = batch
+                order[#order + 1] = hook
+            end
+            batch[#batch + 1] = {
+                pc = hit.pc,
+                address = hit.address,
+                value = hit.value,
+                width = hit.width,
+                type = memoryHookTypes[hit.type],
+            }
+        end
+    end
+    for _, hook in ipairs(order) do hook._callback(batches[hook]) end
+end
+
+local function flushMemoryHooks()
+    local hits = C.takeMemoryHookHits(memoryHookCounts, memoryHookCounts + 1)
+    local count, dropped = memoryHookCounts[0], memoryHookCounts[1]
+    if dropped ~= 0 then C.luaMessage('Lua memory hooks dropped ' .. tostring(dropped) .. ' hits', true) end
+    if count == 0 then return end
+    local ok, err = pcall(dispatchMemoryHooks, hits, count)
+    if not ok then C.luaMessage('Lua memory hook failed: ' .. tostring(err), true) end
+end
+
+-- The hits are drained outside of the emulation, once per tick, for as long
+-- as there are hooks left.
+local function drainMemoryHooks()
+    flushMemoryHooks()
+    if next(memoryHooks) == nil then
+        memoryHooksDraining = false
+    else
+        PCSX.nextTick(drainMemoryHooks)
+    end
+end
+
+local function removeMemoryHook(hook)
+    if hook._wrapper == nil then return end
+    memoryHooks[hook._id] = nil
+    C.removeMemoryHook(hook._wrapper)
+    hook._wrapper = nil
+end
+
+local function addMemoryHook(address, hooktype, width, callback, synchronous)
+    if type(address) ~= 'number' then error 'PCSX.addMemoryHook needs an address' end
+    if not validBpTypes[hooktype] then error 'PCSX.addMemoryHook needs a valid hook type' end
+    if width == nil then width = 4 end
+    if type(width) ~= 'number' then error 'PCSX.addMemoryHook needs a width that is a number' end
+    if type(callback) ~= 'function' then error 'PCSX.addMemoryHook needs a callback that is a function' end
+    local wrapper = C.addMemoryHook(address, hooktype, width, synchronous == true)
+    if wrapper == nil then error 'PCSX.addMemoryHook needs the debugger to be enabled for Exec hooks' end
+    local hook = {
+        _wrapper = wrapper,
+        _id = C.memoryHookId(wrapper),
+        _callback = callback,
+        _proxy = newproxy(),
+        remove = function(hook) removeMemoryHook(hook) end,
+    }
+    memoryHooks[hook._id] = hook
+    debug.setmetatable(hook._proxy, { __gc = function() removeMemoryHook(hook) end })
+    if not memoryHooksDraining then
+        memoryHooksDraining = true
+        PCSX.nextTick(drainMemoryHooks)
+    end
+    return hook
+end
+
 local function printLike(callback, ...)
     local s = ''
     for i, v in ipairs({ ... }) do s = s .. tostring(v) .. ' ' end
@@ -182,6 +411,8 @@ PCSX = {
     getReadLUT = function() return C.getReadLUT() end,
     getWriteLUT = function() return C.getWriteLUT() end,
     addBreakpoint = addBreakpoint,
+    addMemoryHook = addMemoryHook,
+    flushMemoryHooks = flushMemoryHooks,
     pauseEmulator = function() C.pauseEmulator() end,
     resumeEmulator = function() C.resumeEmulator() end,
     softResetEmulator = function() C.softResetEmulator() end,
@@ -221,7 +452,157 @@ PCSX = {
             error('loadSaveState: requires a Slice or File as input')
         end
     end,
+    Rewind = {
+        capture = function() C.rewindCapture() end,
+        stepBack = function(count) return C.rewindStepBack(count or 1) end,
+        stepForward = function(count) return C.rewindStepForward(count or 1) end,
+        restore = function(index) return C.rewindRestore(index) end,
+        clear = function() C.rewindClear() end,
+        count = function() return C.rewindCount() end,
+        position = function() return C.rewindPosition() end,
+    },
+    Fork = {
+        supported = function() return C.forkSupported() end,
+        -- Runs fn(index) within count children, and returns what each of them
+        -- returned as a string, along with the hash of their final state.
+        run = function(count, fn)
+            if type(fn) ~= 'function' then error('Fork.run: requires a function') end
+            local index = C.forkSpawn(count)
+            if index == -2 then error('Fork.run: unable to fork the emulator') end
+            if index >= 0 then
+                local success, output = pcall(fn, index)
+                output = tostring(output or '')
+                C.forkReport(output, #output, success)
+            end
+            local results = {}
+            for i = 0, C.forkCollect() - 1 do
+                local r = C.forkResult(i)
+                results[i + 1] = {
+                    pid = r.pid,
+                    success = r.success,
+                    stateHash = r.stateHash,
+                    output = Support.File._createSliceWrapper(r.output),
+                }
+            end
+            return results
+        end,
+        runFrames = function(frames) C.forkRunFrames(frames or 1) end,
+    },
     getMemoryAsFile = function() return Support.File._createFileWrapper(C.getMemoryAsFile()) end,
+    -- The speed is a factor of realtime, or 'unlimited' to run as fast as possible.
+    getSpeed = function()
+        if C.isUnthrottled() then return 'unlimited' end
+        return C.getSpeedScale()
+    end,
+    setSpeed = function(speed)
+        if speed == 'unlimited' then
+            C.setUnthrottled(true)
+            return
+        end
+        if type(speed) ~= 'number' or speed <= 0 then error('setSpeed: requires a positive number or \'unlimited\'') end
+        C.setSpeedScale(speed)
+        C.setUnthrottled(false)
+    end,
+    Movie = {
+        -- Records from a hard reset, or from the current state if fromState is true.
+        record = function(path, fromState) return C.movieRecord(path, fromState == true) end,
+        play = function(path) return C.moviePlay(path) end,
+        stop = function() C.movieStop() end,
+        isRecording = function() return C.movieRecording() end,
+        isPlaying = function() return C.moviePlaying() end,
+        frame = function() return C.movieFrame() end,
+        -- The first frame where the playback diverged from the recording, or nil.
+        desyncFrame = function()
+            local frame = tonumber(C.movieDesyncFrame())
+            if frame < 0 then return nil end
+            return frame
+        end,
+    },
+    StateHash = {
+        -- Hashes the machine state, and returns the overall hash.
+        update = function() return C.stateHashUpdate() end,
+        -- The per region hashes of the last update, keyed by region name.
+        regions = function()
+            local ret = {}
+            local i = 0
+            while true do
+                local name = C.stateHashRegionName(i)
+                if name == nil then break end
+                ret[ffi.string(name)] = C.stateHashRegion(i)
+                i = i + 1
+            end
+            return ret
+        end,
+        rehashedPages = function() return C.stateHashRehashedPages() end,
+        -- The full digest of the last update, as a Slice, to compare against later on.
+        digest = function() return Support.File._createSliceWrapper(C.stateHashDigest()) end,
+        -- Returns nil if both digests are identical, or the region name and
+        -- page index of their first difference.
+        compare = function(a, b)
+            if type(a) ~= 'table' or a._type ~= 'Slice' or type(b) ~= 'table' or b._type ~= 'Slice' then
+                error('StateHash.compare: requires two Slices')
+            end
+            local page = ffi.new('uint32_t[1]')
+            local region = C.stateHashCompare(a._wrapper, b._wrapper, page)
+            if region == -2 then error('StateHash.compare: malformed digest') end
+            if region == -1 then return nil end
+            return ffi.string(C.stateHashRegionName(region)), page[0]
+        end,
+    },
+    PerfCounters = {
+        -- The current totals, or with lastFrame set, how much each of them
+        -- moved during the last complete frame. Keyed by the metric names of
+        -- /api/v1/metrics, without the pcsx_ prefix; labelled metrics are
+        -- tables keyed by label value. Host times are in seconds.
+        sample = function(lastFrame)
+            local count = C.perfCountersCount()
+            local values = ffi.new('double[?]', count)
+            C.perfCountersSample(lastFrame == true, values)
+            local ret = {}
+            for i = 0, count - 1 do
+                local name = ffi.string(C.perfCounterName(i))
+                local label = ffi.string(C.perfCounterLabel(i))
+                if label == '' then
+                    ret[name] = values[i]
+                else
+                    ret[name] = ret[name] or {}
+                    ret[name][label] = values[i]
+                end
+            end
+            return ret
+        end,
+    },
+    AccessTracker = {
+        enable = function(enabled) C.accessTrackerEnable(enabled ~= false) end,
+        enabled = function() return C.accessTrackerEnabled() end,
+        clear = function() C.accessTrackerClear() end,
+        -- The current timestamp, in frames.
+        now = function() return C.accessTrackerNow() end,
+        -- The timestamp of the last 'read', 'write', or 'exec' access to the
+        -- 16-byte line holding address, or nil if it was never accessed.
+        lastAccess = function(access, address)
+            local kind = accessTrackerKinds[access] or error('AccessTracker: invalid access type')
+            local stamp = C.accessTrackerLastAccess(kind, address)
+            if stamp == 0 then return nil end
+            return stamp
+        end,
+        -- A Slice with one byte per 16-byte line of the range: 255 for lines
+        -- accessed this frame, halving every halfLife frames, and 0 for lines
+        -- never accessed.
+        heat = function(access, address, size, halfLife)
+            local kind = accessTrackerKinds[access] or error('AccessTracker: invalid access type')
+            return Support.File._createSliceWrapper(C.accessTrackerHeat(kind, address, size, halfLife or 30))
+        end,
+    },
+    Trace = {
+        -- Records every instruction the interpreter runs into a trace file.
+        start = function(path) return C.traceStart(path) end,
+        stop = function() C.traceStop() end,
+        recording = function() return C.traceRecording() end,
+        instructions = function() return C.traceInstructions() end,
+        -- Opens a trace file for querying, or returns nil.
+        open = openTrace,
+    },
     quit = function(code) C.quit(code or 0) end,
 }
 
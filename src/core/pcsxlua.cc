@@ -19,12 +19,19 @@
 
 #include "core/pcsxlua.h"
 
+#include "core/accesstracker.h"
 #include "core/debug.h"
+#include "core/fork.h"
 #include "core/gpu.h"
+#include "core/movie.h"
+#include "core/perf-counters.h"
 #include "core/psxemulator.h"
 #include "core/psxmem.h"
 #include "core/r3000a.h"
+#include "core/rewind.h"
 #include "core/sstate.h"
+#include "core/statehash.h"
+#include "core/trace-recorder.h"
 #include "lua/luafile.h"
 #include "lua/luawrapper.h"
 
@@ -77,6 +84,15 @@ void removeBreakpoint(LuaBreakpoint* wrapper) {
     wrapper->wrapper.destroyAll();
     delete wrapper;
 }
+PCSX::Debug::MemoryHook* addMemoryHook(uint32_t address, PCSX::Debug::BreakpointType type, unsigned width,
+                                       bool synchronous) {
+    return PCSX::g_emulator->m_debug->addMemoryHook(address, type, width, synchronous);
+}
+uint32_t memoryHookId(PCSX::Debug::MemoryHook* hook) { return hook->id(); }
+void removeMemoryHook(PCSX::Debug::MemoryHook* hook) { PCSX::g_emulator->m_debug->removeMemoryHook(hook); }
+const PCSX::Debug::MemoryHookHit* takeMemoryHookHits(uint32_t* count, uint32_t* dropped) {
+    return PCSX::g_emulator->m_debug->takeMemoryHookHits(*count, *dropped);
+}
 void pauseEmulator() { PCSX::g_system->pause(); }
 void resumeEmulator() { PCSX::g_system->resume(); }
 void softResetEmulator() { PCSX::g_system->softReset(); }
@@ -117,10 +133,157 @@ void loadSaveStateFromFile(PCSX::LuaFFI::LuaFile* file) {
     PCSX::SaveStates::load(data.asStringView());
 }
 
+void rewindCapture() { PCSX::g_emulator->m_rewind->capture(); }
+bool rewindStepBack(unsigned count) { return PCSX::g_emulator->m_rewind->stepBack(count); }
+bool rewindStepForward(unsigned count) { return PCSX::g_emulator->m_rewind->stepForward(count); }
+bool rewindRestore(uint32_t index) { return PCSX::g_emulator->m_rewind->restore(index); }
+void rewindClear() { PCSX::g_emulator->m_rewind->clear(); }
+uint32_t rewindCount() { return PCSX::g_emulator->m_rewind->count(); }
+uint32_t rewindPosition() { return PCSX::g_emulator->m_rewind->position(); }
+
+struct LuaForkResult {
+    PCSX::Slice* output;
+    uint32_t stateHash;
+    int32_t pid;
+    bool success;
+};
+
+bool forkSupported() { return PCSX::Fork::supported(); }
+int32_t forkSpawn(uint32_t count) { return PCSX::g_emulator->m_fork->spawn(count); }
+void forkRunFrames(uint32_t frames) { PCSX::g_emulator->m_fork->runFrames(frames); }
+void forkReport(const char* output, uint32_t size, bool success) {
+    PCSX::g_emulator->m_fork->report(std::string_view(output, size), success);
+}
+uint32_t forkCollect() { return PCSX::g_emulator->m_fork->collect().size(); }
+LuaForkResult forkResult(uint32_t index) {
+    LuaForkResult ret = {};
+    auto& results = PCSX::g_emulator->m_fork->results();
+    if (index >= results.size()) {
+        ret.output = new PCSX::Slice();
+        return ret;
+    }
+    auto& result = results[index];
+    ret.output = new PCSX::Slice();
+    ret.output->copy(result.output);
+    ret.stateHash = result.stateHash;
+    ret.pid = result.pid;
+    ret.success = result.success;
+    return ret;
+}
+
 PCSX::LuaFFI::LuaFile* getMemoryAsFile() {
     return new PCSX::LuaFFI::LuaFile(PCSX::g_emulator->m_mem->getMemoryAsFile());
 }
 
+float getSpeedScale() { return PCSX::g_emulator->settings.get<PCSX::Emulator::SettingScaler>() / 100.0f; }
+void setSpeedScale(float scale) { PCSX::g_emulator->settings.get<PCSX::Emulator::SettingScaler>() = scale * 100.0f; }
+bool isUnthrottled() { return PCSX::g_emulator->settings.get<PCSX::Emulator::SettingUnthrottled>(); }
+void setUnthrottled(bool unthrottled) {
+    PCSX::g_emulator->settings.get<PCSX::Emulator::SettingUnthrottled>() = unthrottled;
+}
+
+bool movieRecord(const char* path, bool fromState) {
+    return PCSX::g_emulator->m_movie->record(path,
+                                             fromState ? PCSX::Movie::Start::SaveState : PCSX::Movie::Start::PowerOn);
+}
+bool moviePlay(const char* path) { return PCSX::g_emulator->m_movie->play(path); }
+void movieStop() { PCSX::g_emulator->m_movie->stop(); }
+bool movieRecording() { return PCSX::g_emulator->m_movie->recording(); }
+bool moviePlaying() { return PCSX::g_emulator->m_movie->playing(); }
+uint32_t movieFrame() { return PCSX::g_emulator->m_movie->frame(); }
+int64_t movieDesyncFrame() {
+    auto frame = PCSX::g_emulator->m_movie->desyncFrame();
+    return frame.has_value() ? int64_t(frame.value()) : -1;
+}
+
+uint64_t stateHashUpdate() { return PCSX::g_emulator->m_stateHash->update().hash; }
+uint64_t stateHashRegion(uint32_t region) {
+    if (region >= PCSX::StateHash::c_regionCount) return 0;
+    return PCSX::g_emulator->m_stateHash->digest().regionHashes[region];
+}
+uint32_t stateHashRehashedPages() { return PCSX::g_emulator->m_stateHash->rehashedPages(); }
+const char* stateHashRegionName(uint32_t region) {
+    if (region >= PCSX::StateHash::c_regionCount) return nullptr;
+    return PCSX::StateHash::regionName(static_cast<PCSX::StateHash::Region>(region));
+}
+PCSX::Slice* stateHashDigest() { return new PCSX::Slice(PCSX::g_emulator->m_stateHash->digest().serialize()); }
+// Returns the diverging region, -1 if the digests are identical, or -2 if
+// either of them is malformed.
+int32_t stateHashCompare(PCSX::Slice* a, PCSX::Slice* b, uint32_t* page) {
+    PCSX::StateHash::Digest digestA, digestB;
+    if (!digestA.deserialize(a->asStringView()) || !digestB.deserialize(b->asStringView())) return -2;
+    auto divergence = PCSX::StateHash::compare(digestA, digestB);
+    if (!divergence.has_value()) return -1;
+    *page = divergence->page;
+    return static_cast<int32_t>(divergence->region);
+}
+
+uint32_t perfCountersCount() { return PCSX::PerfCounters::c_valueCount; }
+const char* perfCounterName(uint32_t index) {
+    if (index >= PCSX::PerfCounters::c_valueCount) return nullptr;
+    return PCSX::PerfCounters::metric(index).name.data();
+}
+const char* perfCounterLabel(uint32_t index) {
+    if (index >= PCSX::PerfCounters::c_valueCount) return nullptr;
+    return PCSX::PerfCounters::metric(index).labelValue.data();
+}
+// Fills values with perfCountersCount() entries.
+void perfCountersSample(bool lastFrame, double* values) {
+    auto& counters = PCSX::g_emulator->m_perfCounters;
+    const auto snapshot = lastFrame ? counters->lastFrame() : counters->sample();
+    for (unsigned i = 0; i < PCSX::PerfCounters::c_valueCount; i++) {
+        values[i] = PCSX::PerfCounters::scaled(i, snapshot[i]);
+    }
+}
+
+void accessTrackerEnable(bool enabled) { PCSX::g_emulator->m_accessTracker->setEnabled(enabled); }
+bool accessTrackerEnabled() { return PCSX::g_emulator->m_accessTracker->enabled(); }
+void accessTrackerClear() { PCSX::g_emulator->m_accessTracker->clear(); }
+uint32_t accessTrackerNow() { return PCSX::g_emulator->m_accessTracker->now(); }
+uint32_t accessTrackerLastAccess(uint32_t access, uint32_t address) {
+    if (access >= PCSX::AccessTracker::c_accessCount) return 0;
+    auto& tracker = PCSX::g_emulator->m_accessTracker;
+    return tracker->lastAccess(static_cast<PCSX::AccessTracker::Access>(access), tracker->lineOf(address));
+}
+// One byte per line, from the line holding address, for size bytes.
+PCSX::Slice* accessTrackerHeat(uint32_t access, uint32_t address, uint32_t size, uint32_t halfLife) {
+    if (access >= PCSX::AccessTracker::c_accessCount) return nullptr;
+    auto& tracker = PCSX::g_emulator->m_accessTracker;
+    const uint32_t first = tracker->lineOf(address);
+    const uint32_t lines = (size + PCSX::AccessTracker::c_lineSize - 1) >> PCSX::AccessTracker::c_lineShift;
+    std::string heat(lines, '\0');
+    tracker->heat(static_cast<PCSX::AccessTracker::Access>(access), first, lines, halfLife,
+                  reinterpret_cast<uint8_t*>(heat.data()));
+    return new PCSX::Slice(std::move(heat));
+}
+
+bool traceStart(const char* path) { return PCSX::g_emulator->m_traceRecorder->start(path); }
+void traceStop() { PCSX::g_emulator->m_traceRecorder->stop(); }
+bool traceRecording() { return PCSX::g_emulator->m_traceRecorder->recording(); }
+uint64_t traceInstructions() { return PCSX::g_emulator->m_traceRecorder->instructions(); }
+PCSX::InstructionTrace::Reader* traceOpen(const char* path) {
+    auto reader = new PCSX::InstructionTrace::Reader();
+    if (reader->open(path)) return reader;
+    delete reader;
+    return nullptr;
+}
+void traceClose(PCSX::InstructionTrace::Reader* reader) { delete reader; }
+uint64_t traceCount(PCSX::InstructionTrace::Reader* reader) { return reader->count(); }
+// Fills out with up to count records, and returns how many were decoded.
+uint32_t traceRead(PCSX::InstructionTrace::Reader* reader, uint64_t first, uint32_t count,
+                   PCSX::InstructionTrace::Record* out) {
+    uint32_t filled = 0;
+    reader->read(first, count, [&filled, out](const PCSX::InstructionTrace::Record& record) {
+        out[filled++] = record;
+        return true;
+    });
+    return filled;
+}
+int64_t traceFindCycle(PCSX::InstructionTrace::Reader* reader, uint64_t cycle) {
+    auto index = reader->findCycle(cycle);
+    return index ? static_cast<int64_t>(*index) : -1;
+}
+
 void quit(int code) { PCSX::g_system->quit(code); }
 
 }  // namespace
@@ -151,6 +314,10 @@ static void registerAllSymbols(PCSX::Lua L) {
     REGISTER(L, disableBreakpoint);
     REGISTER(L, breakpointEnabled);
     REGISTER(L, removeBreakpoint);
+    REGISTER(L, addMemoryHook);
+    REGISTER(L, memoryHookId);
+    REGISTER(L, removeMemoryHook);
+    REGISTER(L, takeMemoryHookHits);
     REGISTER(L, pauseEmulator);
     REGISTER(L, resumeEmulator);
     REGISTER(L, softResetEmulator);
@@ -164,7 +331,56 @@ static void registerAllSymbols(PCSX::Lua L) {
     REGISTER(L, createSaveState);
     REGISTER(L, loadSaveStateFromSlice);
     REGISTER(L, loadSaveStateFromFile);
+    REGISTER(L, rewindCapture);
+    REGISTER(L, rewindStepBack);
+    REGISTER(L, rewindStepForward);
+    REGISTER(L, rewindRestore);
+    REGISTER(L, rewindClear);
+    REGISTER(L, rewindCount);
+    REGISTER(L, rewindPosition);
+    REGISTER(L, forkSupported);
+    REGISTER(L, forkSpawn);
+    REGISTER(L, forkRunFrames);
+    REGISTER(L, forkReport);
+    REGISTER(L, forkCollect);
+    REGISTER(L, forkResult);
     REGISTER(L, getMemoryAsFile);
+    REGISTER(L, getSpeedScale);
+    REGISTER(L, setSpeedScale);
+    REGISTER(L, isUnthrottled);
+    REGISTER(L, setUnthrottled);
+    REGISTER(L, movieRecord);
+    REGISTER(L, moviePlay);
+    REGISTER(L, movieStop);
+    REGISTER(L, movieRecording);
+    REGISTER(L, moviePlaying);
+    REGISTER(L, movieFrame);
+    REGISTER(L, movieDesyncFrame);
+    REGISTER(L, stateHashUpdate);
+    REGISTER(L, stateHashRegion);
+    REGISTER(L, stateHashRehashedPages);
+    REGISTER(L, stateHashRegionName);
+    REGISTER(L, stateHashDigest);
+    REGISTER(L, stateHashCompare);
+    REGISTER(L, perfCountersCount);
+    REGISTER(L, perfCounterName);
+    REGISTER(L, perfCounterLabel);
+    REGISTER(L, perfCountersSample);
+    REGISTER(L, accessTrackerEnable);
+    REGISTER(L, accessTrackerEnabled);
+    REGISTER(L, accessTrackerClear);
+    REGISTER(L, accessTrackerNow);
+    REGISTER(L, accessTrackerLastAccess);
+    REGISTER(L, accessTrackerHeat);
+    REGISTER(L, traceStart);
+    REGISTER(L, traceStop);
+    REGISTER(L, traceRecording);
+    REGISTER(L, traceInstructions);
+    REGISTER(L, traceOpen);
+    REGISTER(L, traceClose);
+    REGISTER(L, traceCount);
+    REGISTER(L, traceRead);
+    REGISTER(L, traceFindCycle);
     REGISTER(L, quit);
     L.settable();
     L.pop();
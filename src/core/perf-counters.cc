@@ -0,0 +1,161 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/perf-counters.h"
+
+#include "cdrom/cdriso.h"
+#include "core/cdrom.h"
+#include "core/psxemulator.h"
+#include "core/r3000a.h"
+#include "core/system.h"
+#include "fmt/format.h"
+
+namespace {
+
+using Metric = PCSX::PerfCounters::Metric;
+
+constexpr std::string_view c_instructionsHelp = "Emulated instructions executed, by type of block.";
+constexpr std::string_view c_primitivesHelp = "GPU primitives and transfers processed, by type.";
+constexpr std::string_view c_pixelsHelp = "Pixels covered by the GPU primitives and transfers, by type.";
+constexpr std::string_view c_dmaHelp = "Bytes transferred through DMA, by channel.";
+constexpr std::string_view c_hostTimeHelp =
+    "Host time spent in each subsystem; the frame subsystem is the wall time between vsyncs.";
+
+const Metric c_metrics[] = {
+    {"frames_total", "Emulated frames.", "", "", false, false},
+    {"cpu_cycles_total", "Emulated CPU cycles.", "", "", false, false},
+    {"dynarec_blocks_compiled_total", "Blocks compiled by the dynarec.", "", "", false, false},
+    {"dynarec_cache_flushes_total", "Flushes of the dynarec code cache.", "", "", false, false},
+    {"dynarec_code_cache_bytes", "Bytes used in the dynarec code cache.", "", "", true, false},
+    {"cdrom_sectors_read_total", "Sectors read from the CD-ROM image.", "kind", "data", false, false},
+    {"cdrom_sectors_read_total", "Sectors read from the CD-ROM image.", "kind", "audio", false, false},
+    {"cdrom_cache_hits_total", "Sectors found in the CD-ROM read-ahead cache.", "", "", false, false},
+    {"cdrom_cache_misses_total", "Sectors missing from the CD-ROM read-ahead cache.", "", "", false, false},
+    {"spu_samples_mixed_total", "Stereo samples mixed by the SPU.", "", "", false, false},
+
+    {"cpu_instructions_total", c_instructionsHelp, "block", "interpreted", false, false},
+    {"cpu_instructions_total", c_instructionsHelp, "block", "interpreted_debug", false, false},
+    {"cpu_instructions_total", c_instructionsHelp, "block", "dynarec", false, false},
+    {"cpu_instructions_total", c_instructionsHelp, "block", "dynarec_load_delay", false, false},
+    {"cpu_instructions_total", c_instructionsHelp, "block", "dynarec_instrumented", false, false},
+
+    {"gpu_primitives_total", c_primitivesHelp, "type", "triangle", false, false},
+    {"gpu_primitives_total", c_primitivesHelp, "type", "textured_triangle", false, false},
+    {"gpu_primitives_total", c_primitivesHelp, "type", "line", false, false},
+    {"gpu_primitives_total", c_primitivesHelp, "type", "rectangle", false, false},
+    {"gpu_primitives_total", c_primitivesHelp, "type", "sprite", false, false},
+    {"gpu_primitives_total", c_primitivesHelp, "type", "fill", false, false},
+    {"gpu_primitives_total", c_primitivesHelp, "type", "blit_vram_vram", false, false},
+    {"gpu_primitives_total", c_primitivesHelp, "type", "blit_ram_vram", false, false},
+    {"gpu_primitives_total", c_primitivesHelp, "type", "blit_vram_ram", false, false},
+
+    {"gpu_pixels_total", c_pixelsHelp, "type", "triangle", false, false},
+    {"gpu_pixels_total", c_pixelsHelp, "type", "textured_triangle", false, false},
+    {"gpu_pixels_total", c_pixelsHelp, "type", "line", false, false},
+    {"gpu_pixels_total", c_pixelsHelp, "type", "rectangle", false, false},
+    {"gpu_pixels_total", c_pixelsHelp, "type", "sprite", false, false},
+    {"gpu_pixels_total", c_pixelsHelp, "type", "fill", false, false},
+    {"gpu_pixels_total", c_pixelsHelp, "type", "blit_vram_vram", false, false},
+    {"gpu_pixels_total", c_pixelsHelp, "type", "blit_ram_vram", false, false},
+    {"gpu_pixels_total", c_pixelsHelp, "type", "blit_vram_ram", false, false},
+
+    {"dma_bytes_total", c_dmaHelp, "channel", "mdec_in", false, false},
+    {"dma_bytes_total", c_dmaHelp, "channel", "mdec_out", false, false},
+    {"dma_bytes_total", c_dmaHelp, "channel", "gpu", false, false},
+    {"dma_bytes_total", c_dmaHelp, "channel", "cdrom", false, false},
+    {"dma_bytes_total", c_dmaHelp, "channel", "spu", false, false},
+    {"dma_bytes_total", c_dmaHelp, "channel", "pio", false, false},
+    {"dma_bytes_total", c_dmaHelp, "channel", "otc", false, false},
+
+    {"host_seconds_total", c_hostTimeHelp, "subsystem", "frame", false, true},
+    {"host_seconds_total", c_hostTimeHelp, "subsystem", "gpu", false, true},
+    {"host_seconds_total", c_hostTimeHelp, "subsystem", "spu", false, true},
+    {"host_seconds_total", c_hostTimeHelp, "subsystem", "cdrom", false, true},
+    {"host_seconds_total", c_hostTimeHelp, "subsystem", "dynarec", false, true},
+    {"host_seconds_total", c_hostTimeHelp, "subsystem", "present", false, true},
+};
+static_assert(sizeof(c_metrics) / sizeof(c_metrics[0]) == PCSX::PerfCounters::c_valueCount);
+
+}  // namespace
+
+PCSX::PerfCounters::PerfCounters() : m_listener(g_system->m_eventBus) {
+    // Don't account the time spent paused to the frame.
+    m_listener.listen<Events::ExecutionFlow::Run>(
+        [this](const auto& event) { m_lastVSync = std::chrono::steady_clock::now(); });
+}
+
+const PCSX::PerfCounters::Metric& PCSX::PerfCounters::metric(unsigned index) { return c_metrics[index]; }
+
+double PCSX::PerfCounters::scaled(unsigned index, uint64_t value) {
+    return c_metrics[index].seconds ? value / 1e9 : double(value);
+}
+
+PCSX::PerfCounters::Snapshot PCSX::PerfCounters::sample() {
+    auto& cpu = g_emulator->m_cpu;
+    m_values[unsigned(Counter::Cycles)] = cpu->m_regs.cycle;
+    m_values[unsigned(Counter::DynarecCodeCacheBytes)] = cpu->isDynarec() ? cpu->getBufferSize() : 0;
+    auto iso = g_emulator->m_cdrom->getIso();
+    auto stats = iso ? iso->getReadAheadStats() : ReadAheadCache::Stats{};
+    m_values[unsigned(Counter::CDCacheHits)] = stats.hits;
+    m_values[unsigned(Counter::CDCacheMisses)] = stats.misses;
+    m_values[unsigned(Counter::SPUSamples)] = m_spuSamples.load(std::memory_order_relaxed);
+    m_values[c_hostTimeBase + unsigned(Subsystem::SPU)] = m_spuNanoseconds.load(std::memory_order_relaxed);
+    return m_values;
+}
+
+void PCSX::PerfCounters::frame() {
+    auto now = std::chrono::steady_clock::now();
+    addTime(Subsystem::Frame, now - m_lastVSync);
+    m_lastVSync = now;
+    add(Counter::Frames);
+
+    auto current = sample();
+    for (unsigned i = 0; i < c_valueCount; i++) {
+        // The sampled values can go back, such as when the CPU gets reset,
+        // or when a new disc image gets loaded.
+        if (c_metrics[i].gauge || (current[i] < m_frameStart[i])) {
+            m_lastFrame[i] = current[i];
+        } else {
+            m_lastFrame[i] = current[i] - m_frameStart[i];
+        }
+    }
+    m_frameStart = current;
+}
+
+std::string PCSX::PerfCounters::prometheus() {
+    auto values = sample();
+    std::string ret;
+    std::string_view family;
+    for (unsigned i = 0; i < c_valueCount; i++) {
+        auto& metric = c_metrics[i];
+        if (metric.name != family) {
+            family = metric.name;
+            ret += fmt::format("# HELP pcsx_{} {}\n# TYPE pcsx_{} {}\n", metric.name, metric.help, metric.name,
+                               metric.gauge ? "gauge" : "counter");
+        }
+        ret += fmt::format("pcsx_{}", metric.name);
+        if (!metric.label.empty()) ret += fmt::format("{{{}=\"{}\"}}", metric.label, metric.labelValue);
+        if (metric.seconds) {
+            ret += fmt::format(" {}\n", scaled(i, values[i]));
+        } else {
+            ret += fmt::format(" {}\n", values[i]);
+        }
+    }
+    return ret;
+}
@@ -0,0 +1,170 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <string_view>
+
+#include "support/eventbus.h"
+
+namespace PCSX {
+
+// Always-on counters of what the emulator does, cheap enough to be bumped
+// from the hot paths: each one is a plain addition. They only ever go up, and
+// get sampled by whoever is interested, such as the web server, which exposes
+// them in the Prometheus text format, or Lua. Some values are not counted,
+// but read from their owner at sampling time, such as the CPU cycles, or the
+// hits of the CD-ROM read-ahead cache.
+//
+// Everything is written from the emulation thread, apart from the SPU mixing
+// statistics, which come from the SPU thread, and are atomic for this reason.
+// Sampling is done from the emulation thread too.
+class PerfCounters {
+  public:
+    enum class Counter : unsigned {
+        Frames,
+        Cycles,                 // Sampled.
+        DynarecBlocks,          // Compiled blocks.
+        DynarecFlushes,         // Code cache flushes.
+        DynarecCodeCacheBytes,  // Sampled; a gauge.
+        CDDataSectors,
+        CDAudioSectors,
+        CDCacheHits,    // Sampled.
+        CDCacheMisses,  // Sampled.
+        SPUSamples,     // Sampled, from the SPU thread.
+    };
+    static constexpr unsigned c_counterCount = 10;
+    // The flavors of code executing emulated instructions.
+    enum class BlockType : unsigned {
+        Interpreted,
+        InterpretedDebug,
+        Dynarec,
+        DynarecLoadDelay,     // Blocks compiled with full load delay emulation.
+        DynarecInstrumented,  // Blocks compiled with the debugger or the access tracker enabled.
+    };
+    static constexpr unsigned c_blockTypeCount = 5;
+    enum class Primitive : unsigned {
+        Triangle,
+        TexturedTriangle,
+        Line,
+        Rectangle,
+        Sprite,
+        Fill,
+        BlitVramVram,
+        BlitRamVram,
+        BlitVramRam,
+    };
+    static constexpr unsigned c_primitiveCount = 9;
+    static constexpr unsigned c_dmaChannelCount = 7;
+    // Host time spent in the various parts of the emulator. The CPU gets
+    // whatever is left of the frame.
+    enum class Subsystem : unsigned {
+        Frame,    // Wall time between two vsyncs.
+        GPU,      // GPU DMA, and vblank.
+        SPU,      // Mixing, in the SPU thread.
+        CDRom,    // Reading sectors from the image.
+        Dynarec,  // Compiling blocks.
+        Present,  // Presenting the frame and updating the UI.
+    };
+    static constexpr unsigned c_subsystemCount = 6;
+
+    PerfCounters();
+
+    // All the values, laid out one family after the other.
+    static constexpr unsigned c_instructionsBase = c_counterCount;
+    static constexpr unsigned c_primitivesBase = c_instructionsBase + c_blockTypeCount;
+    static constexpr unsigned c_pixelsBase = c_primitivesBase + c_primitiveCount;
+    static constexpr unsigned c_dmaBase = c_pixelsBase + c_primitiveCount;
+    static constexpr unsigned c_hostTimeBase = c_dmaBase + c_dmaChannelCount;
+    static constexpr unsigned c_valueCount = c_hostTimeBase + c_subsystemCount;
+    typedef std::array<uint64_t, c_valueCount> Snapshot;
+
+    struct Metric {
+        std::string_view name;
+        std::string_view help;
+        // Empty for metrics without any label.
+        std::string_view label;
+        std::string_view labelValue;
+        bool gauge;
+        // Stored in nanoseconds, exposed in seconds.
+        bool seconds;
+    };
+    static const Metric& metric(unsigned index);
+    // The value as exposed, applying the unit conversion of the metric.
+    static double scaled(unsigned index, uint64_t value);
+
+    void add(Counter counter, uint64_t value = 1) { m_values[unsigned(counter)] += value; }
+    void addInstructions(BlockType type, uint64_t count) { m_values[c_instructionsBase + unsigned(type)] += count; }
+    // For the dynarecs, which emit their own additions.
+    uint64_t* instructionCounter(BlockType type) { return &m_values[c_instructionsBase + unsigned(type)]; }
+    void addPrimitive(Primitive primitive, uint64_t count, uint64_t pixels) {
+        m_values[c_primitivesBase + unsigned(primitive)] += count;
+        m_values[c_pixelsBase + unsigned(primitive)] += pixels;
+    }
+    void addDMA(unsigned channel, uint64_t bytes) { m_values[c_dmaBase + channel] += bytes; }
+    void addTime(Subsystem subsystem, std::chrono::steady_clock::duration duration) {
+        m_values[c_hostTimeBase + unsigned(subsystem)] +=
+            std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+    }
+    // Called by the SPU thread.
+    void addSPUMix(uint64_t samples, std::chrono::steady_clock::duration duration) {
+        m_spuSamples.fetch_add(samples, std::memory_order_relaxed);
+        m_spuNanoseconds.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(),
+                                   std::memory_order_relaxed);
+    }
+
+    class ScopedTimer {
+      public:
+        ScopedTimer(PerfCounters* counters, Subsystem subsystem)
+            : m_counters(counters), m_subsystem(subsystem), m_start(std::chrono::steady_clock::now()) {}
+        ~ScopedTimer() { m_counters->addTime(m_subsystem, std::chrono::steady_clock::now() - m_start); }
+
+      private:
+        PerfCounters* m_counters;
+        Subsystem m_subsystem;
+        std::chrono::steady_clock::time_point m_start;
+    };
+
+    // Called at vsync; closes the current frame.
+    void frame();
+    // The current totals.
+    Snapshot sample();
+    // How much each value moved during the last complete frame. Gauges hold
+    // their value at the end of that frame instead.
+    const Snapshot& lastFrame() const { return m_lastFrame; }
+    // The current totals, in the Prometheus text exposition format.
+    std::string prometheus();
+
+  private:
+    Snapshot m_values = {};
+    Snapshot m_frameStart = {};
+    Snapshot m_lastFrame = {};
+    std::chrono::steady_clock::time_point m_lastVSync = std::chrono::steady_clock::now();
+    std::atomic<uint64_t> m_spuSamples = 0;
+    std::atomic<uint64_t> m_spuNanoseconds = 0;
+    EventBus::Listener m_listener;
+};
+
+}  // namespace PCSX
@@ -5,14 +5,6 @@
 #include "core/pgxp_mem.h"
 #include "core/pgxp_value.h"
 
-// CPU registers
-static PGXP_value s_CPU_reg_mem[34];
-// PGXP_value CPU_Hi, CPU_Lo;
-static PGXP_value s_CP0_reg_mem[32];
-
-PGXP_value* const g_CPU_reg = s_CPU_reg_mem;
-PGXP_value* const g_CP0_reg = s_CP0_reg_mem;
-
 // Instruction register decoding
 #define op(_instr) (_instr >> 26)           // The op part of the instruction register
 #define func(_instr) ((_instr) & 0x3F)      // The funct part of the instruction register
@@ -23,8 +15,9 @@ PGXP_value* const g_CP0_reg = s_CP0_reg_mem;
 #define imm(_instr) (_instr & 0xFFFF)       // The immediate part of the instruction register
 
 void PGXP_InitCPU() {
-    memset(s_CPU_reg_mem, 0, sizeof(s_CPU_reg_mem));
-    memset(s_CP0_reg_mem, 0, sizeof(s_CP0_reg_mem));
+    auto& pgxp = *PCSX::g_emulator->m_pgxp;
+    memset(pgxp.CPU_reg, 0, sizeof(pgxp.CPU_reg));
+    memset(pgxp.CP0_reg, 0, sizeof(pgxp.CP0_reg));
 }
 
 // invalidate register (invalid 8 bit read)
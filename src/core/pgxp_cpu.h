@@ -33,8 +33,8 @@
 struct PGXP_value_Tag;
 typedef struct PGXP_value_Tag PGXP_value;
 
-extern PGXP_value* const g_CPU_reg;
-extern PGXP_value* const g_CP0_reg;
+#define g_CPU_reg (PCSX::g_emulator->m_pgxp->CPU_reg)
+#define g_CP0_reg (PCSX::g_emulator->m_pgxp->CP0_reg)
 #define CPU_Hi g_CPU_reg[33]
 #define CPU_Lo g_CPU_reg[34]
 
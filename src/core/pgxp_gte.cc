@@ -43,16 +43,11 @@
 #define min(a, b) ((a) < (b) ? (a) : (b))
 #endif
 
-// GTE registers
-static PGXP_value s_GTE_data_reg_mem[32];
-static PGXP_value s_GTE_ctrl_reg_mem[32];
-
-PGXP_value* g_GTE_data_reg = s_GTE_data_reg_mem;
-PGXP_value* g_GTE_ctrl_reg = s_GTE_ctrl_reg_mem;
-
 void PGXP_InitGTE() {
-    memset(s_GTE_data_reg_mem, 0, sizeof(s_GTE_data_reg_mem));
-    memset(s_GTE_ctrl_reg_mem, 0, sizeof(s_GTE_ctrl_reg_mem));
+    auto& pgxp = *PCSX::g_emulator->m_pgxp;
+    memset(pgxp.GTE_data_reg, 0, sizeof(pgxp.GTE_data_reg));
+    memset(pgxp.GTE_ctrl_reg, 0, sizeof(pgxp.GTE_ctrl_reg));
+    pgxp.SXY_count = 0;
 }
 
 // Instruction register decoding
@@ -77,7 +72,6 @@ void PGXP_InitGTE() {
 #define SXYP (g_GTE_data_reg[15])
 
 void PGXP_pushSXYZ2f(float _x, float _y, float _z, unsigned int _v) {
-    static unsigned int uCount = 0;
     low_value temp;
     // push values down FIFO
     SXY0 = SXY1;
@@ -88,7 +82,7 @@ void PGXP_pushSXYZ2f(float _x, float _y, float _z, unsigned int _v) {
     SXY2.z = PCSX::g_emulator->config().PGXP_Texture ? _z : 1.f;
     SXY2.value = _v;
     SXY2.flags = VALID_ALL;
-    SXY2.count = uCount++;
+    SXY2.count = PCSX::g_emulator->m_pgxp->SXY_count++;
 
     // cache value in GPU plugin
     temp.word = _v;
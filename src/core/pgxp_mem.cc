@@ -4,22 +4,26 @@
 #include "core/pgxp_gte.h"
 #include "core/pgxp_value.h"
 
-static PGXP_value s_mem[3 * 2048 * 1024 / 4];  // mirror 2MB in 32-bit words * 3
 static const uint32_t s_userMemOffset = 0;
 static const uint32_t s_scratchOffset = 2048 * 1024 / 4;
 static const uint32_t s_registerOffset = 2 * 2048 * 1024 / 4;
 static const uint32_t s_invalidAddress = 3 * 2048 * 1024 / 4;
 
-void PGXP_InitMem() { memset(s_mem, 0, sizeof(s_mem)); }
+void PGXP_InitMem() {
+    auto& pgxp = *PCSX::g_emulator->m_pgxp;
+    memset(pgxp.mem, 0, sizeof(pgxp.mem));
+}
 
 void PGXP_Init() {
+    auto& pgxp = PCSX::g_emulator->m_pgxp;
+    if (!pgxp) pgxp.reset(new PGXP_State);
     PGXP_InitMem();
     PGXP_InitCPU();
     PGXP_InitGTE();
 }
 
 uint8_t* PGXP_GetMem() {
-    return (uint8_t*)(s_mem);  // PCSX::g_emulator->config().PGXP_GTE ? (char*)(s_mem) : NULL;
+    return (uint8_t*)(PCSX::g_emulator->m_pgxp->mem);
 }
 
 /*  Playstation Memory Map (from Playstation doc by Joshua Walker)
@@ -110,7 +114,7 @@ uint32_t PGXP_ConvertAddress(uint32_t addr) {
 PGXP_value* PGXP_GetPtr(uint32_t addr) {
     addr = PGXP_ConvertAddress(addr);
 
-    if (addr != s_invalidAddress) return &s_mem[addr];
+    if (addr != s_invalidAddress) return &PCSX::g_emulator->m_pgxp->mem[addr];
     return NULL;
 }
 
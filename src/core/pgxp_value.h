@@ -79,6 +79,17 @@ typedef struct PGXP_value_Tag {
     unsigned char hFlags;
 } PGXP_value;
 
+// The precision values shadowing the CPU and GTE registers and the memory.
+// Each emulator has its own, in Emulator::m_pgxp.
+struct PGXP_State {
+    PGXP_value CPU_reg[35];  // Hi and Lo come after the GPRs, see pgxp_cpu.h
+    PGXP_value CP0_reg[32];
+    PGXP_value GTE_data_reg[32];
+    PGXP_value GTE_ctrl_reg[32];
+    unsigned int SXY_count;
+    PGXP_value mem[3 * 2048 * 1024 / 4];  // mirror 2MB in 32-bit words * 3
+};
+
 typedef enum {
     UNINITIALISED = 0,
     INVALID_PSX_VALUE = 1,
@@ -140,7 +140,9 @@ void PCSX::Counters::reset(uint32_t index) {
 void PCSX::Counters::update() {
     const uint64_t cycle = PCSX::g_emulator->m_cpu->m_regs.cycle;
 
-    {
+    // Paced by the audio output, unless unthrottled, or headless without any
+    // audio device to pace it; either way, the emulation then runs flat out.
+    if (g_emulator->throttled()) {
         uint64_t prev = g_emulator->m_cpu->m_regs.previousCycles;
         uint64_t diff = cycle - prev;
         diff *= 4410000;
@@ -156,6 +158,11 @@ void PCSX::Counters::update() {
         } else if (framesDiff < -2000000000) {
             m_audioFrames = newFrames;
         }
+    } else if (!g_system->headless()) {
+        // Unthrottled, the pacing is kept in sync, so that it picks up from
+        // here once throttled again, instead of trying to catch up.
+        g_emulator->m_cpu->m_regs.previousCycles = cycle;
+        m_audioFrames = g_emulator->m_spu->getCurrentFrames();
     }
 
     // rcnt 0.
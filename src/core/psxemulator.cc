@@ -19,24 +19,34 @@
 
 #include "core/psxemulator.h"
 
+#include "core/accesstracker.h"
 #include "core/callstacks.h"
 #include "core/cdrom.h"
 #include "core/debug.h"
 #include "core/eventslua.h"
+#include "core/fork.h"
 #include "core/gdb-server.h"
 #include "core/gpu.h"
 #include "core/gpulogger.h"
 #include "core/gte.h"
 #include "core/luaiso.h"
 #include "core/mdec.h"
+#include "core/memory-export.h"
+#include "core/movie.h"
 #include "core/pad.h"
 #include "core/patchmanager.h"
 #include "core/pcsxlua.h"
+#include "core/perf-counters.h"
+#include "core/pgxp_value.h"
 #include "core/pio-cart.h"
 #include "core/r3000a.h"
+#include "core/rewind.h"
 #include "core/sio.h"
 #include "core/sio1-server.h"
 #include "core/sio1.h"
+#include "core/sstate-io.h"
+#include "core/statehash.h"
+#include "core/trace-recorder.h"
 #include "core/web-server.h"
 #include "gpu/soft/interface.h"
 #include "lua/extra.h"
@@ -54,11 +64,17 @@ extern "C" {
 
 extern "C" int luaopen_lpeg(lua_State* L);
 
-PCSX::Emulator::Emulator()
-    : m_callStacks(new PCSX::CallStacks),
+PCSX::Emulator::Emulator() : Emulator(g_system->m_eventBus) {}
+
+PCSX::Emulator::Emulator(std::shared_ptr<EventBus::EventBus> eventBus)
+    : m_eventBus(std::move(eventBus)),
+      m_constructionBinding(std::in_place, this),
+      m_accessTracker(new PCSX::AccessTracker()),
+      m_callStacks(new PCSX::CallStacks),
       m_cdrom(PCSX::CDRom::factory()),
       m_counters(new PCSX::Counters()),
       m_debug(new PCSX::Debug()),
+      m_fork(new PCSX::Fork()),
       m_gdbServer(new PCSX::GdbServer()),
       m_gpuLogger(new PCSX::GPULogger()),
       m_gte(new PCSX::GTE()),
@@ -66,17 +82,25 @@ PCSX::Emulator::Emulator()
       m_lua(new PCSX::Lua()),
       m_mdec(new PCSX::MDEC()),
       m_mem(new PCSX::Memory()),
+      m_memoryExport(new PCSX::MemoryExport()),
+      m_movie(new PCSX::Movie()),
       m_pads(PCSX::Pads::factory()),
       m_patchManager(new PatchManager()),
+      m_perfCounters(new PCSX::PerfCounters()),
       m_pioCart(new PCSX::PIOCart),
+      m_rewind(new PCSX::Rewind()),
+      m_saveStateIO(new PCSX::SaveStateIO()),
       m_sio(new PCSX::SIO()),
       m_sio1(new PCSX::SIO1()),
       m_sio1Server(new PCSX::SIO1Server()),
       m_sio1Client(new PCSX::SIO1Client()),
       m_spu(new PCSX::SPU::impl()),
+      m_stateHash(new PCSX::StateHash()),
+      m_traceRecorder(new PCSX::TraceRecorder()),
       m_webServer(new PCSX::WebServer()) {
     auto L = *m_lua;
     L.openlibs();
+    m_constructionBinding.reset();
 }
 
 void PCSX::Emulator::setLua() {
@@ -172,16 +196,37 @@ void PCSX::Emulator::shutdown() {
     m_pads->shutdown();
 }
 
+bool PCSX::Emulator::throttled() { return !g_system->headless() && !settings.get<SettingUnthrottled>(); }
+
 void PCSX::Emulator::vsync() {
-    m_gpu->vblank();
-    g_system->m_eventBus->signal<Events::GPU::VSync>({});
-    g_system->update(true);
+    // No point in presenting frames faster than the host display can show
+    // them; the skipped ones still get fully emulated.
+    static constexpr std::chrono::microseconds c_presentationInterval{1000000 / 60};
+    m_presentingFrame = true;
+    if (fasterThanRealtime()) {
+        auto now = std::chrono::steady_clock::now();
+        m_presentingFrame = (now - m_lastPresentation) >= c_presentationInterval;
+        if (m_presentingFrame) m_lastPresentation = now;
+    }
+    {
+        PerfCounters::ScopedTimer timer(m_perfCounters.get(), PerfCounters::Subsystem::GPU);
+        m_gpu->vblank();
+    }
+    m_perfCounters->frame();
+    m_eventBus->signal<Events::GPU::VSync>({});
+    m_memoryExport->vsync(m_presentingFrame);
+    if (m_presentingFrame) {
+        PerfCounters::ScopedTimer timer(m_perfCounters.get(), PerfCounters::Subsystem::Present);
+        g_system->update(true);
+    }
+    m_memoryExport->resume();
 
-    if (m_config.RewindInterval > 0 && !(++m_rewind_counter % m_config.RewindInterval)) {
-        // CreateRewindState();
+    const int rewindInterval = settings.get<SettingRewindInterval>();
+    if (settings.get<SettingRewind>() && (rewindInterval > 0) && !(++m_rewind_counter % rewindInterval)) {
+        m_rewind->capture();
     }
 }
 
 void PCSX::Emulator::setPGXPMode(uint32_t pgxpMode) { m_cpu->psxSetPGXPMode(pgxpMode); }
 
-PCSX::Emulator* PCSX::g_emulator;
+thread_local PCSX::Emulator* PCSX::g_emulator;
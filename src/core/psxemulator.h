@@ -40,8 +40,11 @@
 #include <time.h>
 #include <zlib.h>
 
+#include <atomic>
+#include <chrono>
 #include <filesystem>
 #include <memory>
+#include <optional>
 #include <string>
 
 #include "support/settings.h"
@@ -64,12 +67,16 @@
 #define strnicmp strncasecmp
 #endif
 
+struct PGXP_State;
+
 namespace PCSX {
 
+class AccessTracker;
 class CallStacks;
 class CDRom;
 class Counters;
 class Debug;
+class Fork;
 class GdbServer;
 class GPU;
 class GPULogger;
@@ -77,13 +84,20 @@ class GTE;
 class HW;
 class Lua;
 class MDEC;
+class MemoryExport;
 class Memory;
+class Movie;
 class Pads;
 class PatchManager;
+class PerfCounters;
 class R3000Acpu;
+class Rewind;
+class SaveStateIO;
 class SIO;
 class SPUInterface;
+class StateHash;
 class System;
+class TraceRecorder;
 class WebServer;
 class SIO1;
 class SIO1Server;
@@ -91,11 +105,20 @@ class SIO1Client;
 class PIOCart;
 
 class Emulator;
-extern Emulator* g_emulator;
+// The emulator the current thread is working on. All of the emulation code
+// reaches its state through this pointer, so it is bound per thread rather
+// than global: a host can step several independent emulators, on as many
+// threads, as long as each thread binds the one it's stepping first. See
+// Emulator::Binding.
+extern thread_local Emulator* g_emulator;
 
 class Emulator {
   public:
+    // The default emulator shares the system's event bus, so that the UI sees
+    // its events, and it sees the UI's. Hosts stepping several emulators at
+    // once should give each of them a bus of its own instead.
     Emulator();
+    explicit Emulator(std::shared_ptr<EventBus::EventBus> eventBus);
     ~Emulator();
     Emulator(Emulator&&) = delete;
     Emulator(const Emulator&) = delete;
@@ -121,6 +144,7 @@ class Emulator {
         typedef Setting<bool, TYPESTRING("GdbServerTrace"), false> GdbServerTrace;
         typedef Setting<bool, TYPESTRING("WebServer"), false> WebServer;
         typedef Setting<int, TYPESTRING("WebServerPort"), 8080> WebServerPort;
+        typedef Setting<bool, TYPESTRING("SharedMemoryExport"), false> SharedMemoryExport;
         typedef Setting<uint32_t, TYPESTRING("KernelCallA0_00_1f"), 0xffffffff> KernelCallA0_00_1f;
         typedef Setting<uint32_t, TYPESTRING("KernelCallA0_20_3f"), 0xffffffff> KernelCallA0_20_3f;
         typedef Setting<uint32_t, TYPESTRING("KernelCallA0_40_5f"), 0xffffffff> KernelCallA0_40_5f;
@@ -144,11 +168,11 @@ class Emulator {
         };
         typedef Setting<SIO1Mode, TYPESTRING("SIO1Mode"), SIO1Mode::Protobuf> SIO1ModeSetting;
         typedef Settings<Debug, Trace, KernelLog, FirstChanceException, SkipISR, LoggingCDROM, GdbServer, GdbManifest,
-                         GdbLogSetting, GdbServerPort, GdbServerTrace, WebServer, WebServerPort, KernelCallA0_00_1f,
-                         KernelCallA0_20_3f, KernelCallA0_40_5f, KernelCallA0_60_7f, KernelCallA0_80_9f,
-                         KernelCallA0_a0_bf, KernelCallB0_00_1f, KernelCallB0_20_3f, KernelCallB0_40_5f,
-                         KernelCallC0_00_1f, PCdrv, PCdrvBase, SIO1Server, SIO1ServerPort, SIO1Client, SIO1ClientHost,
-                         SIO1ClientPort, SIO1ModeSetting>
+                         GdbLogSetting, GdbServerPort, GdbServerTrace, WebServer, WebServerPort, SharedMemoryExport,
+                         KernelCallA0_00_1f, KernelCallA0_20_3f, KernelCallA0_40_5f, KernelCallA0_60_7f,
+                         KernelCallA0_80_9f, KernelCallA0_a0_bf, KernelCallB0_00_1f, KernelCallB0_20_3f,
+                         KernelCallB0_40_5f, KernelCallC0_00_1f, PCdrv, PCdrvBase, SIO1Server, SIO1ServerPort,
+                         SIO1Client, SIO1ClientHost, SIO1ClientPort, SIO1ModeSetting>
             type;
     };
     typedef SettingNested<TYPESTRING("Debug"), DebugSettings::type> SettingDebugSettings;
@@ -161,6 +185,7 @@ class Emulator {
     typedef Setting<bool, TYPESTRING("SpuIrq")> SettingSpuIrq;
     typedef Setting<bool, TYPESTRING("BnWMdec")> SettingBnWMdec;
     typedef Setting<int, TYPESTRING("Scaler"), 100> SettingScaler;
+    typedef Setting<bool, TYPESTRING("Unthrottled"), false> SettingUnthrottled;
     typedef Setting<bool, TYPESTRING("AutoVideo"), true> SettingAutoVideo;
     typedef Setting<VideoType, TYPESTRING("Video"), PSX_TYPE_NTSC> SettingVideo;
     typedef Setting<bool, TYPESTRING("FastBoot"), false> SettingFastBoot;
@@ -177,6 +202,8 @@ class Emulator {
     typedef Setting<bool, TYPESTRING("ReportGLErrors"), false> SettingGLErrorReporting;
     typedef Setting<int, TYPESTRING("ReportGLErrorsSeverity"), 1> SettingGLErrorReportingSeverity;
     typedef Setting<bool, TYPESTRING("FullCaching"), false> SettingFullCaching;
+    typedef Setting<bool, TYPESTRING("ReadAhead"), false> SettingReadAhead;
+    typedef Setting<bool, TYPESTRING("ECMIndexFile"), false> SettingECMIndexFile;
     typedef Setting<bool, TYPESTRING("HardwareRenderer"), false> SettingHardwareRenderer;
     typedef Setting<bool, TYPESTRING("ShownAutoUpdateConfig"), false> SettingShownAutoUpdateConfig;
     typedef Setting<bool, TYPESTRING("AutoUpdate"), false> SettingAutoUpdate;
@@ -191,15 +218,28 @@ class Emulator {
     typedef Setting<bool, TYPESTRING("PIOConnected")> SettingPIOConnected;
     typedef SettingPath<TYPESTRING("MapBrowsePath")> SettingMapBrowsePath;
     typedef SettingVector<std::string, TYPESTRING("OpenDialogFavorites")> SettingOpenDialogFavorites;
+    typedef Setting<bool, TYPESTRING("Rewind"), false> SettingRewind;
+    // Frames between two rewind snapshots, and snapshots between two keyframes.
+    typedef Setting<int, TYPESTRING("RewindInterval"), 10> SettingRewindInterval;
+    typedef Setting<int, TYPESTRING("RewindCount"), 360> SettingRewindCount;
+    typedef Setting<int, TYPESTRING("RewindKeyframeInterval"), 30> SettingRewindKeyframeInterval;
+    enum class SaveStateCodec {
+        GZip,
+        FastGZip,
+        Uncompressed,
+    };
+    typedef Setting<SaveStateCodec, TYPESTRING("SaveStateCodec"), SaveStateCodec::GZip> SettingSaveStateCodec;
 
     Settings<SettingMcd1, SettingMcd2, SettingBios, SettingPpfDir, SettingPsxExe, SettingXa, SettingSpuIrq,
              SettingBnWMdec, SettingScaler, SettingAutoVideo, SettingVideo, SettingFastBoot, SettingDebugSettings,
              SettingRCntFix, SettingIsoPath, SettingLocale, SettingMcd1Inserted, SettingMcd2Inserted, SettingDynarec,
              Setting8MB, SettingGUITheme, SettingDither, SettingCachedDithering, SettingGLErrorReporting,
-             SettingGLErrorReportingSeverity, SettingFullCaching, SettingHardwareRenderer, SettingShownAutoUpdateConfig,
-             SettingAutoUpdate, SettingMSAA, SettingLinearFiltering, SettingKioskMode, SettingMcd1Pocketstation,
-             SettingMcd2Pocketstation, SettingBiosBrowsePath, SettingEXP1Filepath, SettingEXP1BrowsePath,
-             SettingPIOConnected, SettingMapBrowsePath, SettingOpenDialogFavorites>
+             SettingGLErrorReportingSeverity, SettingFullCaching, SettingReadAhead, SettingECMIndexFile,
+             SettingHardwareRenderer, SettingShownAutoUpdateConfig, SettingAutoUpdate, SettingMSAA,
+             SettingLinearFiltering, SettingKioskMode, SettingMcd1Pocketstation, SettingMcd2Pocketstation,
+             SettingBiosBrowsePath, SettingEXP1Filepath, SettingEXP1BrowsePath, SettingPIOConnected,
+             SettingMapBrowsePath, SettingOpenDialogFavorites, SettingRewind, SettingRewindInterval, SettingRewindCount,
+             SettingRewindKeyframeInterval, SettingSaveStateCodec, SettingUnthrottled>
         settings;
     class PcsxConfig {
       public:
@@ -209,8 +249,6 @@ class Emulator {
         bool HideCursor = false;
         bool SaveWindowPos = false;
         int32_t WindowPos[2] = {0, 0};
-        uint32_t RewindCount = 0;
-        uint32_t RewindInterval = 0;
         uint32_t AltSpeed1 = 0;  // Percent relative to natural speed.
         uint32_t AltSpeed2 = 0;
         bool OverClock = false;  // enable overclocking
@@ -242,20 +280,73 @@ class Emulator {
         }
     }
 
+    // Binds an emulator to the current thread for the lifetime of this object,
+    // and restores whichever one was bound before when going out of scope.
+    class Binding {
+      public:
+        explicit Binding(Emulator* emulator) : m_previous(g_emulator) { g_emulator = emulator; }
+        ~Binding() { g_emulator = m_previous; }
+        Binding(const Binding&) = delete;
+        Binding& operator=(const Binding&) = delete;
+
+      private:
+        Emulator* m_previous;
+    };
+
     int init();
     void reset();
     void shutdown();
     void vsync();
+    // Whether the emulation is paced by the audio output, at the speed set by
+    // the scaler. Unthrottled and headless emulators run as fast as they can.
+    bool throttled();
+    bool fasterThanRealtime() { return !throttled() || (settings.get<SettingScaler>() > 100); }
+    // Faster than realtime, frames only get presented as often as the host
+    // display refreshes, and the others are emulated without being shown.
+    bool presentingFrame() const { return m_presentingFrame; }
     void setPGXPMode(uint32_t pgxpMode);
 
+    // Each emulator is paused and resumed on its own, and signals it on its
+    // own bus. Quitting is still process-wide, and stops all of them.
+    bool running() {
+        std::atomic_signal_fence(std::memory_order_relaxed);
+        return m_running && !g_system->quitting();
+    }
+    const bool* runningPtr() { return &m_running; }
+    [[gnu::cold]] void pause(bool exception = false) {
+        if (!m_running) return;
+        m_running = false;
+        m_eventBus->signal(Events::ExecutionFlow::Pause{exception});
+    }
+    void resume() {
+        if (m_running) return;
+        m_running = true;
+        m_eventBus->signal(Events::ExecutionFlow::Run{});
+    }
+    // Flips the running state without signalling it. The lockstep harness
+    // uses this to have the dynarec return after a single dispatch.
+    void setRunningQuietly(bool running) { m_running = running; }
+
     void setLua();
 
     PcsxConfig& config() { return m_config; }
 
+    // Emulation events are signaled on this bus, and the emulator's own
+    // subsystems listen to it rather than to the system's.
+    std::shared_ptr<EventBus::EventBus> m_eventBus;
+
+  private:
+    // The subsystems reach the emulator they belong to through g_emulator
+    // while being constructed, so it's bound until the constructor is done.
+    std::optional<Binding> m_constructionBinding;
+
+  public:
+    std::unique_ptr<AccessTracker> m_accessTracker;
     std::unique_ptr<CallStacks> m_callStacks;
     std::unique_ptr<CDRom> m_cdrom;
     std::unique_ptr<Counters> m_counters;
     std::unique_ptr<Debug> m_debug;
+    std::unique_ptr<Fork> m_fork;
     std::unique_ptr<GdbServer> m_gdbServer;
     std::unique_ptr<GPU> m_gpu;
     std::unique_ptr<GPULogger> m_gpuLogger;
@@ -264,19 +355,36 @@ class Emulator {
     std::unique_ptr<Lua> m_lua;
     std::unique_ptr<MDEC> m_mdec;
     std::unique_ptr<Memory> m_mem;
+    std::unique_ptr<MemoryExport> m_memoryExport;
+    std::unique_ptr<Movie> m_movie;
     std::unique_ptr<Pads> m_pads;
     std::unique_ptr<PatchManager> m_patchManager;
+    std::unique_ptr<PerfCounters> m_perfCounters;
     std::unique_ptr<PIOCart> m_pioCart;
+    // Allocated by PGXP_Init().
+    std::unique_ptr<PGXP_State> m_pgxp;
     std::unique_ptr<R3000Acpu> m_cpu;
+    std::unique_ptr<Rewind> m_rewind;
+    std::unique_ptr<SaveStateIO> m_saveStateIO;
     std::unique_ptr<SIO> m_sio;
     std::unique_ptr<SIO1> m_sio1;
     std::unique_ptr<SIO1Server> m_sio1Server;
     std::unique_ptr<SIO1Client> m_sio1Client;
     std::unique_ptr<SPUInterface> m_spu;
+    std::unique_ptr<StateHash> m_stateHash;
+    std::unique_ptr<TraceRecorder> m_traceRecorder;
     std::unique_ptr<WebServer> m_webServer;
 
   private:
     PcsxConfig m_config;
+    // If true, indicates that the emulator is currently capturing the main loop
+    // and actively emulates the PSX hardware. If false, the emulator is paused,
+    // waiting for user input or other events inside the UI. The way the UI
+    // is refreshed is by calling update() periodically, so this boolean affects
+    // the moment when and how update() is called.
+    bool m_running = false;
+    bool m_presentingFrame = true;
+    std::chrono::steady_clock::time_point m_lastPresentation;
 };
 
 }  // namespace PCSX
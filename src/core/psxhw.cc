@@ -635,7 +635,10 @@ inline void PCSX::HW::dma1(uint32_t madr, uint32_t bcr, uint32_t chcr) {
     g_emulator->m_mdec->dma1(madr, bcr, chcr);
 }
 
-inline void PCSX::HW::dma2(uint32_t madr, uint32_t bcr, uint32_t chcr) { g_emulator->m_gpu->dma(madr, bcr, chcr); }
+inline void PCSX::HW::dma2(uint32_t madr, uint32_t bcr, uint32_t chcr) {
+    PerfCounters::ScopedTimer timer(g_emulator->m_perfCounters.get(), PerfCounters::Subsystem::GPU);
+    g_emulator->m_gpu->dma(madr, bcr, chcr);
+}
 
 inline void PCSX::HW::dma3(uint32_t madr, uint32_t bcr, uint32_t chcr) {
     PSXDMA_LOG("*** DMA3 CDROM *** %x addr = %x size = %x\n", chcr, madr, bcr);
@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include "core/perf-counters.h"
 #include "core/psxcounters.h"
 #include "core/psxdma.h"
 #include "core/psxemulator.h"
@@ -70,6 +71,7 @@ class HW {
             } else if constexpr (n == 6) {
                 dma6(madr, bcr, chcr);
             }
+            uint64_t bytes = 0;
             if (mode == 2) {
                 uint32_t usedAddr[3] = {0xffffff, 0xffffff, 0xffffff};
                 uint32_t DMACommandCounter = 0;
@@ -107,7 +109,9 @@ class HW {
                     }
 
                     usedAddr[0] = madr;
-                    uint32_t nextMadr = SWAP_LEu32(*mem->getPointer<uint32_t>(madr)) & 0xffffff;
+                    uint32_t header = SWAP_LEu32(*mem->getPointer<uint32_t>(madr));
+                    bytes += ((header >> 24) + 1) * 4;
+                    uint32_t nextMadr = header & 0xffffff;
                     if (usingMsan && nextMadr == Memory::c_msanChainMarker) {
                         madr = g_emulator->m_mem->msanGetChainPtr(madr);
                         continue;
@@ -122,7 +126,11 @@ class HW {
                 if (blocSize == 0) blocSize = 0x10000;
                 uint32_t size = blocSize * (bcr & 0xffff);
                 madr = madr + size * 4;
+                // In burst mode, the whole transfer is the low half of BCR.
+                if (mode == 0) size = (bcr & 0xffff) ? (bcr & 0xffff) : 0x10000;
+                bytes = uint64_t(size) * 4;
             }
+            g_emulator->m_perfCounters->addDMA(n, bytes);
             mem->template setMADR<n>(madr);
             if (mode == 0) {
                 mem->template setBCR<n>(bcr & 0xffff0000);
@@ -17,15 +17,18 @@
  *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
  ***************************************************************************/
 
+#include "core/accesstracker.h"
 #include "core/callstacks.h"
 #include "core/debug.h"
 #include "core/disr3000a.h"
 #include "core/gte.h"
+#include "core/perf-counters.h"
 #include "core/pgxp_cpu.h"
 #include "core/pgxp_debug.h"
 #include "core/pgxp_gte.h"
 #include "core/psxemulator.h"
 #include "core/r3000a.h"
+#include "core/trace-recorder.h"
 #include "tracy/Tracy.hpp"
 
 #undef _PC_
@@ -90,6 +93,7 @@ class InterpretedCPU final : public PCSX::R3000Acpu {
     virtual bool Init() override;
     virtual void Reset() override;
     virtual void Execute() override;
+    virtual void ExecuteInstruction() override;
     virtual void Clear(uint32_t Addr, uint32_t Size) override;
     virtual void Shutdown() override;
     virtual void SetPGXPMode(uint32_t pgxpMode) override;
@@ -114,8 +118,10 @@ class InterpretedCPU final : public PCSX::R3000Acpu {
     cIntFunc_t *s_pPsxCP2 = NULL;
     cIntFunc_t *s_pPsxCP2BSC = NULL;
 
-    template <bool debug, bool trace>
+    template <bool debug, bool trace, bool single = false>
     void execBlock();
+    // Whether the trace variant of execBlock also logs the disassembly.
+    bool m_logTrace = false;
     void doBranch(uint32_t target, bool fromLink);
 
     void MTC0(int reg, uint32_t val);
@@ -1582,14 +1588,17 @@ void InterpretedCPU::Execute() {
                                 .get<PCSX::Emulator::DebugSettings::Trace>();
         const bool &skipISR = PCSX::g_emulator->settings.get<PCSX::Emulator::SettingDebugSettings>()
                                   .get<PCSX::Emulator::DebugSettings::SkipISR>();
+        // The trace variants both log the disassembly, and feed the instruction trace recorder.
+        m_logTrace = trace && !(skipISR && m_inISR);
+        const bool tracing = m_logTrace || PCSX::g_emulator->m_traceRecorder->recording();
         if (debug) {
-            if (!trace || (skipISR && m_inISR)) {
+            if (!tracing) {
                 execBlock<true, false>();
             } else {
                 execBlock<true, true>();
             }
         } else {
-            if (!trace || (skipISR && m_inISR)) {
+            if (!tracing) {
                 execBlock<false, false>();
             } else {
                 execBlock<false, true>();
@@ -1607,9 +1616,20 @@ void InterpretedCPU::Clear(uint32_t Addr, uint32_t Size) {
 
 void InterpretedCPU::Shutdown() {}
 // interpreter execution
-template <bool debug, bool trace>
+void InterpretedCPU::ExecuteInstruction() {
+    if (PCSX::g_emulator->m_traceRecorder->recording()) {
+        m_logTrace = false;
+        execBlock<false, true, true>();
+    } else {
+        execBlock<false, false, true>();
+    }
+}
+
+template <bool debug, bool trace, bool single>
 inline void InterpretedCPU::execBlock() {
     bool ranDelaySlot = false;
+    unsigned count = 0;
+    auto &recorder = *PCSX::g_emulator->m_traceRecorder;
     do {
         if (m_nextIsDelaySlot) {
             m_inDelaySlot = true;
@@ -1619,16 +1639,21 @@ inline void InterpretedCPU::execBlock() {
         const uint32_t pc = m_regs.pc;
         // TODO: throw an exception here if we don't have a pointer
         uint32_t code = readICache(pc);
+        PCSX::g_emulator->m_accessTracker->mark(PCSX::AccessTracker::Access::Exec, pc);
 
         m_regs.code = code;
 
         if constexpr (trace) {
-            std::string ins = PCSX::Disasm::asString(code, 0, pc, nullptr, true);
-            PCSX::g_system->log(PCSX::LogClass::CPU, "%s\n", ins);
+            if (m_logTrace) {
+                std::string ins = PCSX::Disasm::asString(code, 0, pc, nullptr, true);
+                PCSX::g_system->log(PCSX::LogClass::CPU, "%s\n", ins);
+            }
+            if (recorder.recording()) recorder.begin(pc, code);
         }
 
         m_regs.pc += 4;
         m_regs.cycle += PCSX::Emulator::BIAS;
+        count++;
 
         cIntFunc_t func = s_pPsxBSC[code >> 26];
         (*this.*func)(code);
@@ -1643,6 +1668,9 @@ inline void InterpretedCPU::execBlock() {
             delayedLoad.pcActive = false;
             delayedLoad.fromLink = false;
         }
+        if constexpr (trace) {
+            if (recorder.recording()) recorder.end();
+        }
         if (m_inDelaySlot) {
             m_inDelaySlot = false;
             ranDelaySlot = true;
@@ -1654,7 +1682,9 @@ inline void InterpretedCPU::execBlock() {
             uint32_t newCode = readICache(newPC);
             PCSX::g_emulator->m_debug->process(pc, newPC, code, newCode, fromLink);
         }
-    } while (!ranDelaySlot && !debug);
+    } while (!ranDelaySlot && !debug && !single);
+    PCSX::g_emulator->m_perfCounters->addInstructions(
+        debug ? PCSX::PerfCounters::BlockType::InterpretedDebug : PCSX::PerfCounters::BlockType::Interpreted, count);
 }
 
 void InterpretedCPU::SetPGXPMode(uint32_t pgxpMode) {
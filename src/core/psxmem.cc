@@ -21,12 +21,18 @@
 
 #include <zlib.h>
 
+#include <atomic>
 #include <map>
+#include <string>
 #include <string_view>
 
+#include "core/accesstracker.h"
+#include "core/debug.h"
 #include "core/pio-cart.h"
 #include "core/psxhw.h"
 #include "core/r3000a.h"
+#include "core/trace-recorder.h"
+#include "fmt/format.h"
 #include "mips/common/util/encoder.hh"
 #include "support/file.h"
 #include "supportpsx/binloader.h"
@@ -85,7 +91,7 @@ static const std::map<uint32_t, std::string_view> s_knownBioses = {
 #endif
 };
 
-PCSX::Memory::Memory() : m_listener(g_system->m_eventBus) {
+PCSX::Memory::Memory() : m_listener(g_emulator->m_eventBus) {
     m_listener.listen<Events::ExecutionFlow::Reset>([this](auto &) {
         free(m_msanRAM);
         free(m_msanUsableBitmap);
@@ -101,8 +107,12 @@ int PCSX::Memory::init() {
     m_readLUT = (uint8_t **)calloc(0x10000, sizeof(void *));
     m_writeLUT = (uint8_t **)calloc(0x10000, sizeof(void *));
 
-    // Init all memory as named mappings
-    bool success = m_wramShared.init("wram", 0x00800000, true);
+    // Init all memory as named mappings. Only the first emulator of the process
+    // gets the plain name, so that others don't end up sharing its memory.
+    static std::atomic<unsigned> s_instances = 0;
+    unsigned instance = s_instances.fetch_add(1);
+    std::string name = instance == 0 ? "wram" : fmt::format("wram{}", instance);
+    bool success = m_wramShared.init(name.c_str(), 0x00800000, true);
     if (!success) g_system->message(_("SharedMem failed to share memory for wram, falling back to memory alloc\n"));
     m_wram = m_wramShared.getPtr();
 
@@ -117,9 +127,9 @@ int PCSX::Memory::init() {
     }
 
     // EXP1
-    if (g_emulator->settings.get<Emulator::SettingPIOConnected>().value) {
+    if (m_emulator->settings.get<Emulator::SettingPIOConnected>().value) {
         // Don't overwrite LUTs if not connected, in case these have been set externally
-        g_emulator->m_pioCart->setLuts();
+        m_emulator->m_pioCart->setLuts();
     }
 
     for (int i = 0; i < 0x08; i++) {
@@ -162,7 +172,7 @@ bool PCSX::Memory::loadEXP1FromFile(std::filesystem::path rom_path) {
     }
 
     if (result) {
-        g_emulator->settings.get<Emulator::SettingEXP1Filepath>().value = rom_path;
+        m_emulator->settings.get<Emulator::SettingEXP1Filepath>().value = rom_path;
     }
 
     return result;
@@ -206,7 +216,7 @@ The distributed OpenBIOS.bin file can be an appropriate BIOS replacement.
 
     // Load BIOS
     {
-        auto &biosPath = g_emulator->settings.get<Emulator::SettingBios>().value;
+        auto &biosPath = m_emulator->settings.get<Emulator::SettingBios>().value;
         IO<File> f(new PosixFile(biosPath.string()));
         if (f->failed()) {
             g_system->printf(_("Could not open BIOS:\"%s\". Retrying with the OpenBIOS\n"), biosPath.string());
@@ -229,7 +239,7 @@ The distributed OpenBIOS.bin file can be an appropriate BIOS replacement.
 
         if (!f->failed()) {
             BinaryLoader::Info i;
-            if (!BinaryLoader::load(f, getMemoryAsFile(), i, g_emulator->m_cpu->m_symbols)) {
+            if (!BinaryLoader::load(f, getMemoryAsFile(), i, m_emulator->m_cpu->m_symbols)) {
                 f->rSeek(0);
                 f->read(m_bios, bios_size);
             }
@@ -238,8 +248,8 @@ The distributed OpenBIOS.bin file can be an appropriate BIOS replacement.
         }
     }
 
-    if (!g_emulator->settings.get<Emulator::SettingEXP1Filepath>().value.empty()) {
-        loadEXP1FromFile(g_emulator->settings.get<Emulator::SettingEXP1Filepath>().value);
+    if (!m_emulator->settings.get<Emulator::SettingEXP1Filepath>().value.empty()) {
+        loadEXP1FromFile(m_emulator->settings.get<Emulator::SettingEXP1Filepath>().value);
     }
 
     uint32_t crc = crc32(0L, Z_NULL, 0);
@@ -273,10 +283,12 @@ void PCSX::Memory::shutdown() {
 }
 
 uint8_t PCSX::Memory::read8(uint32_t address) {
-    g_emulator->m_cpu->m_regs.cycle += 1;
+    m_emulator->m_traceRecorder->access(address, 1, 0, false);
+    if (m_hookedPages) [[unlikely]] checkHooks(address, false, 1, 0);
+    m_emulator->m_cpu->m_regs.cycle += 1;
     const uint32_t page = address >> 16;
     const auto pointer = (uint8_t *)m_readLUT[page];
-    const bool pioConnected = g_emulator->settings.get<Emulator::SettingPIOConnected>().value;
+    const bool pioConnected = m_emulator->settings.get<Emulator::SettingPIOConnected>().value;
 
     if (pointer != nullptr) {
         if (msanInitialized() && inMsanRange(address)) [[unlikely]] {
@@ -291,22 +303,23 @@ uint8_t PCSX::Memory::read8(uint32_t address) {
                 case MsanStatus::OK:
                     return m_msanRAM[address - c_msanStart];
             }
-            g_system->pause();
+            m_emulator->pause();
             return 0;
         }
         [[likely]];
         const uint32_t offset = address & 0xffff;
+        m_emulator->m_accessTracker->mark(AccessTracker::Access::Read, address);
         return *(pointer + offset);
     } else if (page == 0x1f80 || page == 0x9f80 || page == 0xbf80) {
         if ((address & 0xffff) < 0x400) {
             return m_hard[address & 0x3ff];
         } else {
-            return g_emulator->m_hw->read8(address);
+            return m_emulator->m_hw->read8(address);
         }
     } else if ((page & 0x1fff) >= 0x1f00 && (page & 0x1fff) < 0x1f80 && pioConnected) {
-        return g_emulator->m_pioCart->read8(address);
+        return m_emulator->m_pioCart->read8(address);
     } else if (sendReadToLua(address, 1)) {
-        auto L = *g_emulator->m_lua;
+        auto L = *m_emulator->m_lua;
         const uint8_t ret = L.tonumber();
         L.pop();
         return ret;
@@ -316,18 +329,20 @@ uint8_t PCSX::Memory::read8(uint32_t address) {
         return 0xff;
     } else if (isiCacheEnabled()) {
         g_system->log(LogClass::CPU, _("8-bit read from unknown address: %8.8lx\n"), address);
-        if (g_emulator->settings.get<Emulator::SettingDebugSettings>().get<Emulator::DebugSettings::Debug>()) {
-            g_system->pause();
+        if (m_emulator->settings.get<Emulator::SettingDebugSettings>().get<Emulator::DebugSettings::Debug>()) {
+            m_emulator->pause();
         }
     }
     return 0xff;
 }
 
 uint16_t PCSX::Memory::read16(uint32_t address) {
-    g_emulator->m_cpu->m_regs.cycle += 1;
+    m_emulator->m_traceRecorder->access(address, 2, 0, false);
+    if (m_hookedPages) [[unlikely]] checkHooks(address, false, 2, 0);
+    m_emulator->m_cpu->m_regs.cycle += 1;
     const uint32_t page = address >> 16;
     const auto pointer = (uint8_t *)m_readLUT[page];
-    const bool pioConnected = g_emulator->settings.get<Emulator::SettingPIOConnected>().value;
+    const bool pioConnected = m_emulator->settings.get<Emulator::SettingPIOConnected>().value;
 
     if (pointer != nullptr) {
         if (msanInitialized() && inMsanRange(address)) {
@@ -342,40 +357,45 @@ uint16_t PCSX::Memory::read16(uint32_t address) {
                 case MsanStatus::OK:
                     return SWAP_LEu16(*(uint16_t *)&m_msanRAM[address - c_msanStart]);
             }
-            g_system->pause();
+            m_emulator->pause();
             return 0;
         }
         [[likely]];
         const uint32_t offset = address & 0xffff;
+        m_emulator->m_accessTracker->mark(AccessTracker::Access::Read, address);
         return SWAP_LEu16(*(uint16_t *)(pointer + offset));
     } else if (page == 0x1f80 || page == 0x9f80 || page == 0xbf80) {
         if ((address & 0xffff) < 0x400) {
             uint16_t *ptr = (uint16_t *)&m_hard[address & 0x3ff];
             return SWAP_LEu16(*ptr);
         } else {
-            return g_emulator->m_hw->read16(address);
+            return m_emulator->m_hw->read16(address);
         }
     } else if ((page & 0x1fff) >= 0x1f00 && (page & 0x1fff) < 0x1f80 && pioConnected) {
-        return g_emulator->m_pioCart->read8(address);
+        return m_emulator->m_pioCart->read8(address);
     } else if (sendReadToLua(address, 2)) {
-        auto L = *g_emulator->m_lua;
+        auto L = *m_emulator->m_lua;
         const uint16_t ret = L.tonumber();
         L.pop();
         return ret;
     } else if (isiCacheEnabled()) {
         g_system->log(LogClass::CPU, _("16-bit read from unknown address: %8.8lx\n"), address);
-        if (g_emulator->settings.get<Emulator::SettingDebugSettings>().get<Emulator::DebugSettings::Debug>()) {
-            g_system->pause();
+        if (m_emulator->settings.get<Emulator::SettingDebugSettings>().get<Emulator::DebugSettings::Debug>()) {
+            m_emulator->pause();
         }
     }
     return 0xffff;
 }
 
 uint32_t PCSX::Memory::read32(uint32_t address, ReadType readType) {
-    if (readType == ReadType::Data) g_emulator->m_cpu->m_regs.cycle += 1;
+    if (readType == ReadType::Data) {
+        m_emulator->m_cpu->m_regs.cycle += 1;
+        m_emulator->m_traceRecorder->access(address, 4, 0, false);
+        if (m_hookedPages) [[unlikely]] checkHooks(address, false, 4, 0);
+    }
     const uint32_t page = address >> 16;
     const auto pointer = (uint8_t *)m_readLUT[page];
-    const bool pioConnected = g_emulator->settings.get<Emulator::SettingPIOConnected>().value;
+    const bool pioConnected = m_emulator->settings.get<Emulator::SettingPIOConnected>().value;
 
     if (pointer != nullptr) {
         if (msanInitialized() && inMsanRange(address)) {
@@ -390,32 +410,33 @@ uint32_t PCSX::Memory::read32(uint32_t address, ReadType readType) {
                 case MsanStatus::OK:
                     return SWAP_LEu32(*(uint32_t *)&m_msanRAM[address - c_msanStart]);
             }
-            g_system->pause();
+            m_emulator->pause();
             return 0;
         }
         [[likely]];
         const uint32_t offset = address & 0xffff;
+        if (readType == ReadType::Data) m_emulator->m_accessTracker->mark(AccessTracker::Access::Read, address);
         return SWAP_LEu32(*(uint32_t *)(pointer + offset));
     } else if (page == 0x1f80 || page == 0x9f80 || page == 0xbf80) {
         if ((address & 0xffff) < 0x400) {
             uint32_t *ptr = (uint32_t *)&m_hard[address & 0x3ff];
             return SWAP_LEu32(*ptr);
         } else {
-            return g_emulator->m_hw->read32(address);
+            return m_emulator->m_hw->read32(address);
         }
     } else if ((page & 0x1fff) >= 0x1f00 && (page & 0x1fff) < 0x1f80 && pioConnected) {
-        return g_emulator->m_pioCart->read32(address);
+        return m_emulator->m_pioCart->read32(address);
     } else if (address == 0xfffe0130) {
         return m_BIU;
     } else if (sendReadToLua(address, 4)) {
-        auto L = *g_emulator->m_lua;
+        auto L = *m_emulator->m_lua;
         const uint32_t ret = L.tonumber();
         L.pop();
         return ret;
     } else if (isiCacheEnabled()) {
         g_system->log(LogClass::CPU, _("32-bit read from unknown address: %8.8lx\n"), address);
-        if (g_emulator->settings.get<Emulator::SettingDebugSettings>().get<Emulator::DebugSettings::Debug>()) {
-            g_system->pause();
+        if (m_emulator->settings.get<Emulator::SettingDebugSettings>().get<Emulator::DebugSettings::Debug>()) {
+            m_emulator->pause();
         }
     }
     return 0xffffffff;
@@ -423,7 +444,7 @@ uint32_t PCSX::Memory::read32(uint32_t address, ReadType readType) {
 
 int PCSX::Memory::sendReadToLua(const uint32_t address, const size_t size) {
     // Grab a local pointer for our Lua VM interpreter
-    auto L = *g_emulator->m_lua;
+    auto L = *m_emulator->m_lua;
     int nresult = 0;
     // Try getting the symbol 'UnknownMemoryRead' from the global space, and put it on top of the stack
     L.getfield("UnknownMemoryRead", LUA_GLOBALSINDEX);
@@ -461,7 +482,7 @@ int PCSX::Memory::sendReadToLua(const uint32_t address, const size_t size) {
 }
 
 bool PCSX::Memory::sendWriteToLua(const uint32_t address, const size_t size, uint32_t value) {
-    auto L = *g_emulator->m_lua;
+    auto L = *m_emulator->m_lua;
     bool write_handled = false;
 
     L.getfield("UnknownMemoryWrite", LUA_GLOBALSINDEX);
@@ -496,10 +517,12 @@ bool PCSX::Memory::sendWriteToLua(const uint32_t address, const size_t size, uin
 }
 
 void PCSX::Memory::write8(uint32_t address, uint32_t value) {
-    g_emulator->m_cpu->m_regs.cycle += 1;
+    m_emulator->m_traceRecorder->access(address, 1, value, true);
+    if (m_hookedPages) [[unlikely]] checkHooks(address, true, 1, value);
+    m_emulator->m_cpu->m_regs.cycle += 1;
     const uint32_t page = address >> 16;
     const auto pointer = (uint8_t *)m_writeLUT[page];
-    const bool pioConnected = g_emulator->settings.get<Emulator::SettingPIOConnected>().value;
+    const bool pioConnected = m_emulator->settings.get<Emulator::SettingPIOConnected>().value;
 
     if (pointer != nullptr) {
         if (msanInitialized() && inMsanRange(address)) {
@@ -507,36 +530,39 @@ void PCSX::Memory::write8(uint32_t address, uint32_t value) {
                 m_msanRAM[address - c_msanStart] = value;
             } else {
                 g_system->log(LogClass::CPU, _("8-bit write to unusable msan memory: %8.8lx\n"), address);
-                g_system->pause();
+                m_emulator->pause();
             }
         }
         [[likely]];
         const uint32_t offset = address & 0xffff;
         *(pointer + offset) = static_cast<uint8_t>(value);
-        g_emulator->m_cpu->Clear((address & (~3)), 1);
+        m_emulator->m_accessTracker->mark(AccessTracker::Access::Write, address);
+        m_emulator->m_cpu->Clear((address & (~3)), 1);
     } else if (page == 0x1f80 || page == 0x9f80 || page == 0xbf80) {
         if ((address & 0xffff) < 0x400) {
             m_hard[address & 0x3ff] = value;
         } else {
-            g_emulator->m_hw->write8(address, value);
+            m_emulator->m_hw->write8(address, value);
         }
     } else if ((page & 0x1fff) >= 0x1f00 && (page & 0x1fff) < 0x1f80 && pioConnected) {
-        g_emulator->m_pioCart->write8(address, value);
+        m_emulator->m_pioCart->write8(address, value);
     } else if (sendWriteToLua(address, 1, value)) {
     } else if (isiCacheEnabled()) {
-        g_emulator->m_cpu->Clear(address, 1);
+        m_emulator->m_cpu->Clear(address, 1);
         g_system->log(LogClass::CPU, _("8-bit write to unknown address: %8.8lx\n"), address);
-        if (g_emulator->settings.get<Emulator::SettingDebugSettings>().get<Emulator::DebugSettings::Debug>()) {
-            g_system->pause();
+        if (m_emulator->settings.get<Emulator::SettingDebugSettings>().get<Emulator::DebugSettings::Debug>()) {
+            m_emulator->pause();
         }
     }
 }
 
 void PCSX::Memory::write16(uint32_t address, uint32_t value) {
-    g_emulator->m_cpu->m_regs.cycle += 1;
+    m_emulator->m_traceRecorder->access(address, 2, value, true);
+    if (m_hookedPages) [[unlikely]] checkHooks(address, true, 2, value);
+    m_emulator->m_cpu->m_regs.cycle += 1;
     const uint32_t page = address >> 16;
     const auto pointer = (uint8_t *)m_writeLUT[page];
-    const bool pioConnected = g_emulator->settings.get<Emulator::SettingPIOConnected>().value;
+    const bool pioConnected = m_emulator->settings.get<Emulator::SettingPIOConnected>().value;
 
     if (pointer != nullptr) {
         if (msanInitialized() && inMsanRange(address)) {
@@ -544,37 +570,40 @@ void PCSX::Memory::write16(uint32_t address, uint32_t value) {
                 *(uint16_t *)&m_msanRAM[address - c_msanStart] = SWAP_LEu16(value);
             } else {
                 g_system->log(LogClass::CPU, _("16-bit write to unusable msan memory: %8.8lx\n"), address);
-                g_system->pause();
+                m_emulator->pause();
             }
         }
         [[likely]];
         const uint32_t offset = address & 0xffff;
         *(uint16_t *)(pointer + offset) = SWAP_LEu16(static_cast<uint16_t>(value));
-        g_emulator->m_cpu->Clear((address & (~3)), 1);
+        m_emulator->m_accessTracker->mark(AccessTracker::Access::Write, address);
+        m_emulator->m_cpu->Clear((address & (~3)), 1);
     } else if (page == 0x1f80 || page == 0x9f80 || page == 0xbf80) {
         if ((address & 0xffff) < 0x400) {
             uint16_t *ptr = (uint16_t *)&m_hard[address & 0x3ff];
             *ptr = SWAP_LEu16(value);
         } else {
-            g_emulator->m_hw->write16(address, value);
+            m_emulator->m_hw->write16(address, value);
         }
     } else if ((page & 0x1fff) >= 0x1f00 && (page & 0x1fff) < 0x1f80 && pioConnected) {
-        g_emulator->m_pioCart->write16(address, value);
+        m_emulator->m_pioCart->write16(address, value);
     } else if (sendWriteToLua(address, 2, value)) {
     } else if (isiCacheEnabled()) {
-        g_emulator->m_cpu->Clear(address, 1);
+        m_emulator->m_cpu->Clear(address, 1);
         g_system->log(LogClass::CPU, _("16-bit write to unknown address: %8.8lx\n"), address);
-        if (g_emulator->settings.get<Emulator::SettingDebugSettings>().get<Emulator::DebugSettings::Debug>()) {
-            g_system->pause();
+        if (m_emulator->settings.get<Emulator::SettingDebugSettings>().get<Emulator::DebugSettings::Debug>()) {
+            m_emulator->pause();
         }
     }
 }
 
 void PCSX::Memory::write32(uint32_t address, uint32_t value) {
-    g_emulator->m_cpu->m_regs.cycle += 1;
+    m_emulator->m_traceRecorder->access(address, 4, value, true);
+    if (m_hookedPages) [[unlikely]] checkHooks(address, true, 4, value);
+    m_emulator->m_cpu->m_regs.cycle += 1;
     const uint32_t page = address >> 16;
     const auto pointer = (uint8_t *)m_writeLUT[page];
-    const bool pioConnected = g_emulator->settings.get<Emulator::SettingPIOConnected>().value;
+    const bool pioConnected = m_emulator->settings.get<Emulator::SettingPIOConnected>().value;
 
     if (pointer != nullptr) {
         if (msanInitialized() && inMsanRange(address)) {
@@ -582,50 +611,61 @@ void PCSX::Memory::write32(uint32_t address, uint32_t value) {
                 *(uint32_t *)&m_msanRAM[address - c_msanStart] = SWAP_LEu32(value);
             } else {
                 g_system->log(LogClass::CPU, _("32-bit write to unusable msan memory: %8.8lx\n"), address);
-                g_system->pause();
+                m_emulator->pause();
             }
         }
         [[likely]];
         const uint32_t offset = address & 0xffff;
         *(uint32_t *)(pointer + offset) = SWAP_LEu32(value);
-        g_emulator->m_cpu->Clear((address & (~3)), 1);
+        m_emulator->m_accessTracker->mark(AccessTracker::Access::Write, address);
+        m_emulator->m_cpu->Clear((address & (~3)), 1);
     } else if (page == 0x1f80 || page == 0x9f80 || page == 0xbf80) {
         if ((address & 0xffff) < 0x400) {
             uint32_t *ptr = (uint32_t *)&m_hard[address & 0x3ff];
             *ptr = SWAP_LEu32(value);
         } else {
-            g_emulator->m_hw->write32(address, value);
+            m_emulator->m_hw->write32(address, value);
         }
     } else if ((page & 0x1fff) >= 0x1f00 && (page & 0x1fff) < 0x1f80 && pioConnected) {
-        g_emulator->m_pioCart->write32(address, value);
+        m_emulator->m_pioCart->write32(address, value);
     } else if (address == 0xfffe0130) {
         m_BIU = value;
         switch (value) {
             case 0x00000800:
             case 0x00000804:
             case 0x0001e90c:  // TOCA World Touring Cars, SLES-02572, FlushCache at 0xa002f79c
-                g_emulator->m_cpu->invalidateCache();
+                m_emulator->m_cpu->invalidateCache();
                 [[fallthrough]];
             case 0x0001e988:
                 setLuts();
                 break;
             default:
                 g_system->log(LogClass::CPU, _("Unknown BIU value: %8.8lx\n"), value);
-                if (g_emulator->settings.get<Emulator::SettingDebugSettings>().get<Emulator::DebugSettings::Debug>()) {
-                    g_system->pause();
+                if (m_emulator->settings.get<Emulator::SettingDebugSettings>().get<Emulator::DebugSettings::Debug>()) {
+                    m_emulator->pause();
                 }
                 break;
         }
     } else if (sendWriteToLua(address, 4, value)) {
     } else if (isiCacheEnabled()) {
-        g_emulator->m_cpu->Clear(address, 1);
+        m_emulator->m_cpu->Clear(address, 1);
         g_system->log(LogClass::CPU, _("32-bit write to unknown address: %8.8lx\n"), address);
-        if (g_emulator->settings.get<Emulator::SettingDebugSettings>().get<Emulator::DebugSettings::Debug>()) {
-            g_system->pause();
+        if (m_emulator->settings.get<Emulator::SettingDebugSettings>().get<Emulator::DebugSettings::Debug>()) {
+            m_emulator->pause();
         }
     }
 }
 
+bool PCSX::Memory::isHooked(uint32_t address) const {
+    return m_hookedPages && m_hookedPages[Debug::watchPage(address)];
+}
+
+void PCSX::Memory::checkHooks(uint32_t address, bool write, unsigned width, uint32_t value) {
+    if (!m_hookedPages[Debug::watchPage(address)]) return;
+    auto type = write ? Debug::BreakpointType::Write : Debug::BreakpointType::Read;
+    m_emulator->m_debug->memoryHookAccess(address, type, width, value);
+}
+
 const void *PCSX::Memory::pointerRead(uint32_t address) {
     const auto page = address >> 16;
 
@@ -711,7 +751,7 @@ const void *PCSX::Memory::pointerWrite(uint32_t address, int size) {
 
 void PCSX::Memory::setLuts() {
     int max = (m_hard[0x1061] & 0x1) ? 0x80 : 0x20;
-    if (!g_emulator->settings.get<Emulator::Setting8MB>()) max = 0x20;
+    if (!m_emulator->settings.get<Emulator::Setting8MB>()) max = 0x20;
     for (int i = 0; i < 0x80; i++) m_readLUT[i + 0x0000] = (uint8_t *)&m_wram[(i & (max - 1)) << 16];
     memcpy(m_readLUT + 0x8000, m_readLUT, 0x80 * sizeof(void *));
     memcpy(m_readLUT + 0xa000, m_readLUT, 0x80 * sizeof(void *));
@@ -724,7 +764,7 @@ void PCSX::Memory::setLuts() {
         memset(m_writeLUT + 0x8000, 0, 0x80 * sizeof(void *));
         memset(m_writeLUT + 0xa000, 0, 0x80 * sizeof(void *));
     }
-    g_system->m_eventBus->signal(PCSX::Events::Memory::SetLuts{});
+    m_emulator->m_eventBus->signal(PCSX::Events::Memory::SetLuts{});
 }
 
 std::string_view PCSX::Memory::getBiosVersionString() {
@@ -844,7 +884,7 @@ void PCSX::Memory::initMsan(bool reset) {
     }
     if (msanInitialized()) {
         g_system->printf(_("MSAN system was already initialized.\n"));
-        g_system->pause();
+        m_emulator->pause();
         return;
     }
 
@@ -869,7 +909,7 @@ uint32_t PCSX::Memory::msanAlloc(uint32_t size) {
     // Check if we still have enough memory.
     if (m_msanPtr + actualSize > c_msanSize) {
         g_system->printf(_("Out of memory in MsanAlloc\n"));
-        g_system->pause();
+        m_emulator->pause();
         return 0;
     }
 
@@ -893,14 +933,14 @@ void PCSX::Memory::msanFree(uint32_t ptr) {
     // Check if the pointer is valid.
     if (!inMsanRange(ptr)) {
         g_system->printf(_("Invalid pointer passed to MsanFree: %08x\n"), ptr);
-        g_system->pause();
+        m_emulator->pause();
         return;
     }
     ptr -= c_msanStart;
     auto it = m_msanAllocs.find(ptr);
     if (it == m_msanAllocs.end()) {
         g_system->printf(_("Invalid pointer passed to MsanFree: %08x\n"), ptr);
-        g_system->pause();
+        m_emulator->pause();
         return;
     }
     // Mark the allocation as unusable.
@@ -922,14 +962,14 @@ uint32_t PCSX::Memory::msanRealloc(uint32_t ptr, uint32_t size) {
     // Check if the pointer is valid.
     if (!inMsanRange(ptr)) {
         g_system->printf(_("Invalid pointer passed to MsanRealloc: %08x\n"), ptr);
-        g_system->pause();
+        m_emulator->pause();
         return 0;
     }
     ptr -= c_msanStart;
     auto it = m_msanAllocs.find(ptr);
     if (it == m_msanAllocs.end()) {
         g_system->printf(_("Invalid pointer passed to MsanRealloc: %08x\n"), ptr);
-        g_system->pause();
+        m_emulator->pause();
         return 0;
     }
     auto oldSize = it->second;
@@ -972,7 +1012,7 @@ uint32_t PCSX::Memory::msanGetChainPtr(uint32_t headerAddr) const {
     auto it = m_msanChainRegistry.find(headerAddr);
     if (it == m_msanChainRegistry.end()) {
         g_system->printf(_("Unregistered msan chain header at %08x\n"), headerAddr);
-        g_system->pause();
+        m_emulator->pause();
         return 0xffffffff;
     }
     return it->second;
@@ -300,14 +300,30 @@ class Memory {
 
     bool isiCacheEnabled() { return m_BIU == 0x1e988; }
 
+    // Set by the debugger to its map of the pages holding read or write
+    // memory hooks, or to nullptr while there are none.
+    void setHookedPages(const uint8_t *pages) { m_hookedPages = pages; }
+    // Whether accesses to this address have to go through the memory
+    // functions, for the memory hooks to see them.
+    bool isHooked(uint32_t address) const;
+
   private:
+    // The emulator this belongs to, so that the memory functions don't have
+    // to look up the thread's g_emulator on every access.
+    Emulator *const m_emulator = g_emulator;
+
+    [[gnu::cold]] void checkHooks(uint32_t address, bool write, unsigned width, uint32_t value);
+    const uint8_t *m_hookedPages = nullptr;
+
     friend class MemoryAsFile;
     IO<MemoryAsFile> m_memoryAsFile;
 
     uint32_t m_biosCRC = 0;
 
     // Shared memory wrappers, pointers below point to these where appropriate
+    friend class Fork;
     friend class GdbClient;
+    friend class MemoryExport;
     SharedMem m_wramShared;
 
     uint32_t m_BIU = 0;
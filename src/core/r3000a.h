@@ -266,7 +266,17 @@ class R3000Acpu {
     }
     virtual bool Init() { return false; }
     virtual void Execute() = 0; /* executes up to a debug break */
+    // Executes a single instruction, regardless of the running state. Only
+    // the interpreter can do this; the dynarec always runs whole blocks.
+    virtual void ExecuteInstruction() {}
     virtual void Clear(uint32_t Addr, uint32_t Size) = 0;
+    // Called when an execution breakpoint gets added, so that recompilers can
+    // drop the code which would run through it without stopping.
+    virtual void breakpointAdded(uint32_t address, unsigned width) {}
+    // Called when a read or write memory hook gets added, so that recompilers
+    // can drop the code which accesses memory without going through the
+    // memory functions.
+    virtual void memoryHookAdded() {}
     virtual void Shutdown() = 0;
     virtual void SetPGXPMode(uint32_t pgxpMode) = 0;
     virtual bool Implemented() = 0;
@@ -384,10 +394,10 @@ class R3000Acpu {
             uint32_t &pc = m_regs.pc;
             if (pc == 0x80030000) {
                 m_shellStarted = true;
-                g_system->m_eventBus->signal(Events::ExecutionFlow::ShellReached{});
+                g_emulator->m_eventBus->signal(Events::ExecutionFlow::ShellReached{});
             }
         }
-        return g_system->running();
+        return g_emulator->running();
     }
     void processA0KernelCall(uint32_t call);
     void processB0KernelCall(uint32_t call);
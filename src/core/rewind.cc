@@ -0,0 +1,297 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/rewind.h"
+
+#include <algorithm>
+
+#include "core/psxemulator.h"
+#include "core/r3000a.h"
+#include "core/sstate.h"
+#include "core/system.h"
+#include "support/protobuf.h"
+#include "support/xordelta.h"
+
+PCSX::Rewind::Rewind() : m_listener(g_emulator->m_eventBus) {
+    m_listener.listen<Events::ExecutionFlow::Reset>([this](const auto& event) {
+        if (event.hard) clear();
+    });
+    m_listener.listen<Events::IsoMounted>([this](const auto& event) { clear(); });
+}
+
+// The save state is a message of messages. Any field of these which is large
+// enough to hold a page is one of the memory blobs, which are located here so
+// that they can be diffed against the same blob from the keyframe, even if
+// the smaller fields around them changed size.
+std::vector<PCSX::Rewind::Span> PCSX::Rewind::findSpans(std::string_view blob) {
+    std::vector<Span> spans;
+    const uint8_t* base = reinterpret_cast<const uint8_t*>(blob.data());
+    auto skip = [](Protobuf::InSlice& slice, unsigned wireType) {
+        switch (wireType) {
+            case 0:
+                slice.getVarInt();
+                break;
+            case 1:
+                slice.getU64();
+                break;
+            case 5:
+                slice.getU32();
+                break;
+            default:
+                throw Protobuf::OutOfBoundError();
+        }
+    };
+
+    try {
+        Protobuf::InSlice slice(base, blob.size());
+        while (slice.bytesLeft()) {
+            uint64_t tag = slice.getVarInt();
+            if ((tag & 7) != 2) {
+                skip(slice, tag & 7);
+                continue;
+            }
+            Protobuf::InSlice message = slice.getSubSlice(slice.getVarInt());
+            while (message.bytesLeft()) {
+                uint64_t fieldTag = message.getVarInt();
+                if ((fieldTag & 7) != 2) {
+                    skip(message, fieldTag & 7);
+                    continue;
+                }
+                uint64_t size = message.getVarInt();
+                const uint8_t* data = message.borrowBytes(size);
+                if (size < XorDelta::c_pageSize) continue;
+                spans.push_back({((tag >> 3) << 32) | (fieldTag >> 3), size_t(data - base), size});
+            }
+        }
+    } catch (...) {
+        // Diffing without spans is merely less efficient.
+        spans.clear();
+    }
+    return spans;
+}
+
+// The encoding is the size of the blob, its spans, each with the index of the
+// span of the reference it's diffed against, if any, and then the blob itself
+// as XorDelta segments: the bytes before the first span, diffed against the
+// bytes before the first span of the reference, then the first span, and so on.
+void PCSX::Rewind::encode(const Decoded& current, const Decoded& reference, std::vector<uint8_t>& out) {
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(current.blob.data());
+    const uint8_t* ref = reinterpret_cast<const uint8_t*>(reference.blob.data());
+    const size_t count = current.spans.size();
+    const size_t refCount = reference.spans.size();
+
+    XorDelta::putVarInt(out, current.blob.size());
+    XorDelta::putVarInt(out, count);
+    std::vector<bool> used(refCount);
+    std::vector<const Span*> matches(count);
+    for (size_t i = 0; i < count; i++) {
+        const auto& span = current.spans[i];
+        uint64_t match = 0;
+        for (size_t j = 0; j < refCount; j++) {
+            const auto& candidate = reference.spans[j];
+            if (used[j] || (candidate.key != span.key) || (candidate.size != span.size)) continue;
+            used[j] = true;
+            matches[i] = &candidate;
+            match = j + 1;
+            break;
+        }
+        XorDelta::putVarInt(out, span.key);
+        XorDelta::putVarInt(out, span.offset);
+        XorDelta::putVarInt(out, span.size);
+        XorDelta::putVarInt(out, match);
+    }
+
+    for (size_t i = 0; i <= count; i++) {
+        const size_t start = i == 0 ? 0 : current.spans[i - 1].offset + current.spans[i - 1].size;
+        const size_t end = i < count ? current.spans[i].offset : current.blob.size();
+        size_t refStart = 0, refEnd = 0;
+        if (i <= refCount) {
+            refStart = i == 0 ? 0 : reference.spans[i - 1].offset + reference.spans[i - 1].size;
+            refEnd = i < refCount ? reference.spans[i].offset : reference.blob.size();
+        }
+        XorDelta::encode(data + start, end - start, ref + refStart, refEnd - refStart, out);
+        if (i == count) break;
+        const auto& span = current.spans[i];
+        const Span* match = matches[i];
+        XorDelta::encode(data + span.offset, span.size, match ? ref + match->offset : nullptr, match ? match->size : 0,
+                         out);
+    }
+}
+
+bool PCSX::Rewind::decode(const std::vector<uint8_t>& data, const Decoded& reference, Decoded& result) {
+    const uint8_t* in = data.data();
+    const uint8_t* inEnd = in + data.size();
+    const uint8_t* ref = reinterpret_cast<const uint8_t*>(reference.blob.data());
+    const size_t refCount = reference.spans.size();
+
+    uint64_t blobSize, count;
+    if (!XorDelta::getVarInt(in, inEnd, blobSize) || !XorDelta::getVarInt(in, inEnd, count)) return false;
+    if (count > (blobSize / XorDelta::c_pageSize)) return false;
+    result.blob.resize(blobSize);
+    result.spans.resize(count);
+    std::vector<const Span*> matches(count);
+    size_t previousEnd = 0;
+    for (size_t i = 0; i < count; i++) {
+        auto& span = result.spans[i];
+        uint64_t key, offset, size, match;
+        if (!XorDelta::getVarInt(in, inEnd, key) || !XorDelta::getVarInt(in, inEnd, offset) ||
+            !XorDelta::getVarInt(in, inEnd, size) || !XorDelta::getVarInt(in, inEnd, match)) {
+            return false;
+        }
+        if ((offset < previousEnd) || (offset > blobSize) || (size > (blobSize - offset)) || (match > refCount)) {
+            return false;
+        }
+        if (match && (reference.spans[match - 1].size != size)) return false;
+        span = {key, offset, size};
+        matches[i] = match ? &reference.spans[match - 1] : nullptr;
+        previousEnd = offset + size;
+    }
+
+    uint8_t* out = reinterpret_cast<uint8_t*>(result.blob.data());
+    for (size_t i = 0; i <= count; i++) {
+        const size_t start = i == 0 ? 0 : result.spans[i - 1].offset + result.spans[i - 1].size;
+        const size_t end = i < count ? result.spans[i].offset : result.blob.size();
+        size_t refStart = 0, refEnd = 0;
+        if (i <= refCount) {
+            refStart = i == 0 ? 0 : reference.spans[i - 1].offset + reference.spans[i - 1].size;
+            refEnd = i < refCount ? reference.spans[i].offset : reference.blob.size();
+        }
+        if (!XorDelta::decode(in, inEnd, out + start, end - start, ref + refStart, refEnd - refStart)) return false;
+        if (i == count) break;
+        const auto& span = result.spans[i];
+        const Span* match = matches[i];
+        if (!XorDelta::decode(in, inEnd, out + span.offset, span.size, match ? ref + match->offset : nullptr,
+                              match ? match->size : 0)) {
+            return false;
+        }
+    }
+    return in == inEnd;
+}
+
+std::shared_ptr<const PCSX::Rewind::Decoded> PCSX::Rewind::decodeKeyframe(uint64_t id) {
+    if (m_keyframe && (m_keyframeId == id)) return m_keyframe;
+    if (m_restoreKeyframe && (m_restoreKeyframeId == id)) return m_restoreKeyframe;
+    if (m_snapshots.empty() || (id < m_snapshots.front().id) || (id > m_snapshots.back().id)) return nullptr;
+    static const Decoded empty;
+    auto decoded = std::make_shared<Decoded>();
+    if (!decode(m_snapshots[id - m_snapshots.front().id].data, empty, *decoded)) return nullptr;
+    m_restoreKeyframe = decoded;
+    m_restoreKeyframeId = id;
+    return decoded;
+}
+
+void PCSX::Rewind::capture() {
+    auto& settings = g_emulator->settings;
+    if (!m_live) {
+        // The emulation carried on from an older snapshot, so its future is now
+        // a different one. Ids stay contiguous, as they double as indices.
+        while (m_snapshots.size() > (m_position + 1)) m_snapshots.pop_back();
+        m_nextId = m_snapshots.back().id + 1;
+        if (m_keyframe && (m_keyframeId >= m_nextId)) m_keyframe.reset();
+        if (m_restoreKeyframe && (m_restoreKeyframeId >= m_nextId)) m_restoreKeyframe.reset();
+        if (m_keyframe) m_sinceKeyframe = m_nextId - m_keyframeId - 1;
+        m_live = true;
+    }
+
+    auto current = std::make_shared<Decoded>();
+    current->blob = SaveStates::save();
+    current->spans = findSpans(current->blob);
+
+    Snapshot snapshot;
+    snapshot.id = m_nextId++;
+    snapshot.frame = g_emulator->m_rewind_counter;
+    snapshot.cycle = g_emulator->m_cpu->m_regs.cycle;
+    const unsigned keyframeInterval = std::max(settings.get<Emulator::SettingRewindKeyframeInterval>().value, 1);
+    if (!m_keyframe || ((m_sinceKeyframe + 1) >= keyframeInterval)) {
+        static const Decoded empty;
+        encode(*current, empty, snapshot.data);
+        snapshot.keyframeId = snapshot.id;
+        m_keyframe = current;
+        m_keyframeId = snapshot.id;
+        m_sinceKeyframe = 0;
+    } else {
+        encode(*current, *m_keyframe, snapshot.data);
+        snapshot.keyframeId = m_keyframeId;
+        m_sinceKeyframe++;
+    }
+    snapshot.data.shrink_to_fit();
+    m_snapshots.push_back(std::move(snapshot));
+
+    // Deltas are useless without their keyframe, so the oldest snapshots
+    // are evicted a whole keyframe's worth at a time.
+    const size_t capacity = std::max(settings.get<Emulator::SettingRewindCount>().value, 1);
+    while (m_snapshots.size() > capacity) {
+        m_snapshots.pop_front();
+        while (!m_snapshots.empty() && (m_snapshots.front().id != m_snapshots.front().keyframeId)) {
+            m_snapshots.pop_front();
+        }
+    }
+    if (m_snapshots.empty()) m_keyframe.reset();
+}
+
+bool PCSX::Rewind::restore(size_t index) {
+    if (index >= m_snapshots.size()) return false;
+    const auto& snapshot = m_snapshots[index];
+    auto keyframe = decodeKeyframe(snapshot.keyframeId);
+    if (!keyframe) return false;
+
+    if (snapshot.id == snapshot.keyframeId) {
+        if (!SaveStates::load(keyframe->blob)) return false;
+    } else {
+        Decoded decoded;
+        if (!decode(snapshot.data, *keyframe, decoded)) return false;
+        if (!SaveStates::load(decoded.blob)) return false;
+    }
+    g_emulator->m_rewind_counter = snapshot.frame;
+    m_position = index;
+    m_live = false;
+    return true;
+}
+
+bool PCSX::Rewind::stepBack(unsigned count) {
+    const size_t current = position();
+    if ((count == 0) || (current == 0)) return false;
+    return restore(current - std::min<size_t>(count, current));
+}
+
+bool PCSX::Rewind::stepForward(unsigned count) {
+    if (m_live || (count == 0) || ((m_position + 1) >= m_snapshots.size())) return false;
+    return restore(std::min(m_position + count, m_snapshots.size() - 1));
+}
+
+void PCSX::Rewind::clear() {
+    m_snapshots.clear();
+    m_keyframe.reset();
+    m_restoreKeyframe.reset();
+    m_sinceKeyframe = 0;
+    m_live = true;
+}
+
+size_t PCSX::Rewind::memoryUsage() const {
+    size_t usage = 0;
+    for (auto& snapshot : m_snapshots) usage += snapshot.data.size();
+    if (m_keyframe) usage += m_keyframe->blob.size();
+    if (m_restoreKeyframe) usage += m_restoreKeyframe->blob.size();
+    return usage;
+}
+
+PCSX::Rewind::Info PCSX::Rewind::info(size_t index) const {
+    const auto& snapshot = m_snapshots[index];
+    return {snapshot.frame, snapshot.cycle, snapshot.id == snapshot.keyframeId, snapshot.data.size()};
+}
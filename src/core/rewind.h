@@ -0,0 +1,104 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "support/eventbus.h"
+
+namespace PCSX {
+
+// Keeps a ring of recent save states, taken every few frames, so that the
+// emulation can be stepped backwards and forwards through them. Every so
+// often a snapshot is stored whole, as a keyframe, and the following ones are
+// only stored as their difference against it, using XorDelta. The large
+// memory blobs of the save state, such as the main RAM, VRAM, or SPU RAM, are
+// matched against their counterpart in the keyframe and compared page by
+// page, so only the pages which got dirty since the keyframe take space.
+// Restoring any snapshot costs at most one keyframe and one delta decode.
+class Rewind {
+  public:
+    struct Info {
+        uint32_t frame;
+        uint64_t cycle;
+        bool keyframe;
+        size_t size;
+    };
+
+    Rewind();
+    void capture();
+    // Loads the snapshot count steps before or after the current one. When
+    // the emulation is live, stepping back once loads the latest snapshot.
+    bool stepBack(unsigned count = 1);
+    bool stepForward(unsigned count = 1);
+    bool restore(size_t index);
+    void clear();
+
+    size_t count() const { return m_snapshots.size(); }
+    // Index of the snapshot last restored, or count() while live.
+    size_t position() const { return m_live ? m_snapshots.size() : m_position; }
+    size_t memoryUsage() const;
+    Info info(size_t index) const;
+
+  private:
+    struct Span {
+        uint64_t key;
+        size_t offset;
+        size_t size;
+    };
+    struct Decoded {
+        std::string blob;
+        std::vector<Span> spans;
+    };
+    struct Snapshot {
+        uint64_t id;
+        uint64_t keyframeId;
+        uint32_t frame;
+        uint64_t cycle;
+        std::vector<uint8_t> data;
+    };
+
+    static std::vector<Span> findSpans(std::string_view blob);
+    static void encode(const Decoded& current, const Decoded& reference, std::vector<uint8_t>& out);
+    static bool decode(const std::vector<uint8_t>& data, const Decoded& reference, Decoded& result);
+    std::shared_ptr<const Decoded> decodeKeyframe(uint64_t id);
+
+    std::deque<Snapshot> m_snapshots;
+    uint64_t m_nextId = 0;
+    // The latest keyframe, decoded, which new snapshots are diffed against.
+    std::shared_ptr<const Decoded> m_keyframe;
+    uint64_t m_keyframeId = 0;
+    unsigned m_sinceKeyframe = 0;
+    // The last older keyframe decoded for a restore, since stepping through
+    // history tends to hit the same one repeatedly.
+    std::shared_ptr<const Decoded> m_restoreKeyframe;
+    uint64_t m_restoreKeyframeId = 0;
+    size_t m_position = 0;
+    bool m_live = true;
+    EventBus::Listener m_listener;
+};
+
+}  // namespace PCSX
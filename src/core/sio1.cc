@@ -44,6 +44,7 @@ void PCSX::SIO1::transmitMessage(std::string &&message) {
 
 std::string PCSX::SIO1::encodeMessage(SIOPayload message) {
     Protobuf::OutSlice outslice;
+    outslice.reserve(message.serializedSize());
     message.serialize(&outslice);
     return std::string(outslice.finalize());
 }
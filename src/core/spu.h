@@ -49,6 +49,8 @@ class SPUInterface {
     virtual void readDMAMem(uint16_t *, int) = 0;
     virtual void lockSPURAM() = 0;
     virtual void unlockSPURAM() = 0;
+    // The 512KB of SPU RAM.
+    virtual const uint8_t *getSPURAM() = 0;
     virtual void resetCaptureBuffer() = 0;
     virtual json getCfg() = 0;
     virtual void setCfg(const json &j) = 0;
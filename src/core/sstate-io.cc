@@ -0,0 +1,191 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/sstate-io.h"
+
+#include <stdint.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <system_error>
+
+#include "core/sstate.h"
+#include "core/system.h"
+#include "support/file.h"
+
+bool PCSX::SaveStateIO::save(std::filesystem::path filename, bool wait) {
+    if (g_system->quitting() || (wait && busy())) return false;
+    auto job = new Job();
+    job->saving = true;
+    job->codec = g_emulator->settings.get<Emulator::SettingSaveStateCodec>();
+    job->filename = std::move(filename);
+    job->data = SaveStates::save();
+    if (wait) {
+        runJob(job);
+        return finishJob(job);
+    }
+    queue(job);
+    return true;
+}
+
+bool PCSX::SaveStateIO::load(std::filesystem::path filename, bool wait) {
+    std::error_code ec;
+    if (g_system->quitting() || (wait && busy())) return false;
+    if (!std::filesystem::is_regular_file(filename, ec)) return false;
+    auto job = new Job();
+    job->saving = false;
+    job->filename = std::move(filename);
+    if (wait) {
+        runJob(job);
+        return finishJob(job);
+    }
+    queue(job);
+    return true;
+}
+
+std::string PCSX::SaveStateIO::compress(std::string_view data, Codec codec) {
+    if (codec == Codec::Uncompressed) return std::string(data);
+    z_stream z = {};
+    const int level = codec == Codec::FastGZip ? Z_BEST_SPEED : Z_DEFAULT_COMPRESSION;
+    auto res = deflateInit2(&z, level, Z_DEFLATED, MAX_WBITS + 16, MAX_MEM_LEVEL, Z_DEFAULT_STRATEGY);
+    if (res != Z_OK) throw std::runtime_error("deflateInit2 didn't work");
+    // The bound covers the gzip wrapper, so this can be done in a single pass.
+    std::string out;
+    out.resize(deflateBound(&z, data.size()));
+    z.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    z.avail_in = data.size();
+    z.next_out = reinterpret_cast<Bytef*>(out.data());
+    z.avail_out = out.size();
+    res = deflate(&z, Z_FINISH);
+    out.resize(z.total_out);
+    deflateEnd(&z);
+    if (res != Z_STREAM_END) throw std::runtime_error("deflate didn't finish");
+    return out;
+}
+
+bool PCSX::SaveStateIO::decompress(std::string_view data, std::string& out) {
+    auto bytes = reinterpret_cast<const uint8_t*>(data.data());
+    if ((data.size() < 18) || (bytes[0] != 0x1f) || (bytes[1] != 0x8b)) {
+        out = data;
+        return true;
+    }
+    // The gzip trailer holds the size of the uncompressed data, modulo 4GB,
+    // which is enough to size the output buffer right the first time. It's
+    // capped to what deflate can possibly expand to, in case it's garbage.
+    auto trailer = bytes + data.size() - 4;
+    size_t size = trailer[0] | (trailer[1] << 8) | (trailer[2] << 16) | (uint32_t(trailer[3]) << 24);
+    out.resize(std::max(std::min(size, data.size() * 1032), size_t(65536)));
+
+    z_stream z = {};
+    if (inflateInit2(&z, MAX_WBITS + 16) != Z_OK) return false;
+    z.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    z.avail_in = data.size();
+    int res = Z_OK;
+    while ((res == Z_OK) || ((res == Z_BUF_ERROR) && (z.avail_out == 0))) {
+        if (z.total_out == out.size()) out.resize(out.size() * 2);
+        z.next_out = reinterpret_cast<Bytef*>(out.data() + z.total_out);
+        z.avail_out = out.size() - z.total_out;
+        res = inflate(&z, Z_NO_FLUSH);
+    }
+    out.resize(z.total_out);
+    inflateEnd(&z);
+    return res == Z_STREAM_END;
+}
+
+void PCSX::SaveStateIO::queue(Job* job) {
+    job->self = this;
+    job->req.data = job;
+    m_queue.push_back(job);
+    if (!m_current) startNext();
+}
+
+void PCSX::SaveStateIO::startNext() {
+    if (m_queue.empty()) return;
+    m_current = m_queue.front();
+    m_queue.pop_front();
+    int ret = uv_queue_work(
+        g_system->getLoop(), &m_current->req,
+        [](uv_work_t* req) { runJob(reinterpret_cast<Job*>(req->data)); },
+        [](uv_work_t* req, int status) {
+            auto job = reinterpret_cast<Job*>(req->data);
+            job->self->completeJob(job);
+        });
+    // Without a threadpool, there's nothing left but doing it right here.
+    if (ret != 0) {
+        runJob(m_current);
+        completeJob(m_current);
+    }
+}
+
+// This usually runs on libuv's threadpool, so it can use the blocking File API.
+void PCSX::SaveStateIO::runJob(Job* job) {
+    try {
+        if (job->saving) {
+            std::string compressed = compress(job->data, job->codec);
+            std::string().swap(job->data);
+            auto temporary = job->filename;
+            temporary += ".tmp";
+            IO<File> file(new PosixFile(temporary, FileOps::TRUNCATE));
+            if (file->failed()) return;
+            const ssize_t size = compressed.size();
+            const bool written = file->write(compressed.data(), size) == size;
+            file->close();
+            std::error_code ec;
+            if (written) {
+                std::filesystem::rename(temporary, job->filename, ec);
+            } else {
+                std::filesystem::remove(temporary, ec);
+            }
+            job->success = written && !ec;
+        } else {
+            IO<File> file(new PosixFile(job->filename));
+            if (file->failed()) return;
+            std::string compressed;
+            compressed.resize(file->size());
+            const ssize_t size = compressed.size();
+            if (file->read(compressed.data(), size) != size) return;
+            job->success = decompress(compressed, job->data);
+        }
+    } catch (...) {
+        job->success = false;
+    }
+}
+
+void PCSX::SaveStateIO::completeJob(Job* job) {
+    m_current = nullptr;
+    finishJob(job);
+    startNext();
+}
+
+bool PCSX::SaveStateIO::finishJob(Job* job) {
+    auto path = job->filename.string();
+    bool success = job->success;
+    if (job->saving) {
+        if (!success) g_system->log(LogClass::UI, "Unable to write save state %s\n", path);
+        g_system->m_eventBus->signal(Events::SaveStates::Saved{path, success});
+    } else {
+        // Don't resurrect the emulation while it's shutting down.
+        success = success && !g_system->quitting() && SaveStates::load(job->data);
+        if (!success) g_system->log(LogClass::UI, "Unable to load save state %s\n", path);
+        g_system->m_eventBus->signal(Events::SaveStates::Loaded{path, success});
+    }
+    delete job;
+    return success;
+}
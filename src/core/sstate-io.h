@@ -0,0 +1,81 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <uv.h>
+
+#include <deque>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+#include "core/psxemulator.h"
+
+namespace PCSX {
+
+// Moves the compression and the disk I/O of save states off the emulation
+// thread. Saving only takes the serialized snapshot on the calling thread,
+// and loading only parses the decompressed state back, once it's ready. The
+// rest happens on libuv's threadpool, and the main loop signals either
+// Events::SaveStates::Saved or Events::SaveStates::Loaded when done.
+//
+// Jobs run one at a time, in the order they were queued, so that loading a
+// slot right after saving to it sees the new state. Files are written next
+// to their destination first, then renamed over it, so a crash mid-write
+// never leaves a truncated save state behind.
+class SaveStateIO {
+  public:
+    typedef Emulator::SaveStateCodec Codec;
+
+    // Both return false if the request couldn't even be queued. With `wait`, the
+    // job runs on the calling thread instead, but only while nothing is queued,
+    // so that it stays in order, and the return value is whether it succeeded.
+    bool save(std::filesystem::path filename, bool wait = false);
+    bool load(std::filesystem::path filename, bool wait = false);
+    bool busy() const { return m_current || !m_queue.empty(); }
+
+    // gzip members are detected by their magic, which can't start a save
+    // state, so anything else is taken as an uncompressed one.
+    static std::string compress(std::string_view data, Codec codec);
+    static bool decompress(std::string_view data, std::string& out);
+
+  private:
+    struct Job {
+        uv_work_t req;
+        SaveStateIO* self;
+        bool saving;
+        Codec codec;
+        std::filesystem::path filename;
+        std::string data;
+        bool success = false;
+    };
+
+    void queue(Job* job);
+    void startNext();
+    static void runJob(Job* job);
+    void completeJob(Job* job);
+    // Signals the job's event, and deletes it.
+    bool finishJob(Job* job);
+
+    std::deque<Job*> m_queue;
+    Job* m_current = nullptr;
+};
+
+}  // namespace PCSX
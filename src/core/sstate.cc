@@ -198,6 +198,7 @@ std::string PCSX::SaveStates::save() {
     g_emulator->m_callStacks->serialize(&wrapper);
 
     Protobuf::OutSlice slice;
+    slice.reserve(state.serializedSize());
     state.serialize(&slice);
     return slice.finalize();
 }
@@ -335,7 +336,7 @@ bool PCSX::SaveStates::load(std::string_view data) {
     }
     g_emulator->m_callStacks->deserialize(&wrapper);
 
-    g_system->m_eventBus->signal(Events::ExecutionFlow::SaveStateLoaded{});
+    g_emulator->m_eventBus->signal(Events::ExecutionFlow::SaveStateLoaded{});
 
     return true;
 }
@@ -0,0 +1,175 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/statehash.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "core/gpu.h"
+#include "core/psxemulator.h"
+#include "core/psxmem.h"
+#include "core/r3000a.h"
+#include "core/spu.h"
+#include "support/slice.h"
+#include "support/xxhash.h"
+
+const PCSX::StateHash::Digest& PCSX::StateHash::update() {
+    m_rehashedPages = 0;
+
+    auto& regs = g_emulator->m_cpu->m_regs;
+    uint8_t cpu[sizeof(regs.GPR) + sizeof(regs.CP0) + sizeof(regs.CP2D) + sizeof(regs.CP2C) + sizeof(regs.pc)];
+    uint8_t* ptr = cpu;
+    memcpy(ptr, &regs.GPR, sizeof(regs.GPR));
+    ptr += sizeof(regs.GPR);
+    memcpy(ptr, &regs.CP0, sizeof(regs.CP0));
+    ptr += sizeof(regs.CP0);
+    memcpy(ptr, &regs.CP2D, sizeof(regs.CP2D));
+    ptr += sizeof(regs.CP2D);
+    memcpy(ptr, &regs.CP2C, sizeof(regs.CP2C));
+    ptr += sizeof(regs.CP2C);
+    memcpy(ptr, &regs.pc, sizeof(regs.pc));
+    updateRegion(Region::CPU, cpu, sizeof(cpu));
+
+    auto& mem = g_emulator->m_mem;
+    updateRegion(Region::RAM, mem->m_wram, g_emulator->getRamMask() + 1);
+    updateRegion(Region::Scratchpad, mem->m_hard, 0x400);
+    updateRegion(Region::Hardware, mem->m_hard + 0x1000, 0x2000);
+
+    Slice vram = g_emulator->m_gpu->getVRAM();
+    updateRegion(Region::VRAM, vram.data<uint8_t>(), vram.size());
+
+    auto& spu = g_emulator->m_spu;
+    spu->lockSPURAM();
+    updateRegion(Region::SPURAM, spu->getSPURAM(), 512 * 1024);
+    spu->unlockSPURAM();
+
+    uint64_t hash = 0;
+    for (unsigned i = 0; i < c_regionCount; i++) {
+        hash = XXHash::hash64(m_digest.regionHashes + i, sizeof(uint64_t), hash);
+    }
+    m_digest.hash = hash;
+    return m_digest;
+}
+
+void PCSX::StateHash::updateRegion(Region region, const uint8_t* data, size_t size) {
+    const unsigned index = static_cast<unsigned>(region);
+    auto& shadow = m_shadows[index];
+    auto& pages = m_digest.pages[index];
+    const size_t count = (size + c_pageSize - 1) / c_pageSize;
+    // A region which changed size, such as the RAM when switching to 8MB, is
+    // hashed from scratch.
+    const bool full = shadow.size() != size;
+    if (full) {
+        shadow.assign(data, data + size);
+        pages.resize(count);
+    }
+
+    for (size_t page = 0; page < count; page++) {
+        const size_t offset = page * c_pageSize;
+        const size_t length = std::min(c_pageSize, size - offset);
+        if (!full) {
+            if (memcmp(shadow.data() + offset, data + offset, length) == 0) continue;
+            memcpy(shadow.data() + offset, data + offset, length);
+        }
+        pages[page] = XXHash::hash64(data + offset, length, page);
+        m_rehashedPages++;
+    }
+
+    m_digest.regionHashes[index] = XXHash::hash64(pages.data(), pages.size() * sizeof(uint64_t), index);
+}
+
+void PCSX::StateHash::reset() {
+    for (auto& shadow : m_shadows) shadow.clear();
+    m_digest = {};
+    m_rehashedPages = 0;
+}
+
+std::optional<PCSX::StateHash::Divergence> PCSX::StateHash::compare(const Digest& a, const Digest& b) {
+    if (a.hash == b.hash) return std::nullopt;
+    for (unsigned i = 0; i < c_regionCount; i++) {
+        if (a.regionHashes[i] == b.regionHashes[i]) continue;
+        const Region region = static_cast<Region>(i);
+        const auto& pagesA = a.pages[i];
+        const auto& pagesB = b.pages[i];
+        const size_t count = std::min(pagesA.size(), pagesB.size());
+        for (size_t page = 0; page < count; page++) {
+            if (pagesA[page] != pagesB[page]) return Divergence{region, page};
+        }
+        // Only the size differs.
+        return Divergence{region, count};
+    }
+    return std::nullopt;
+}
+
+const char* PCSX::StateHash::regionName(Region region) {
+    switch (region) {
+        case Region::CPU:
+            return "cpu";
+        case Region::RAM:
+            return "ram";
+        case Region::Scratchpad:
+            return "scratchpad";
+        case Region::Hardware:
+            return "hardware";
+        case Region::VRAM:
+            return "vram";
+        case Region::SPURAM:
+            return "spuram";
+    }
+    return "unknown";
+}
+
+// The serialized digest is the overall hash, then for each region its hash,
+// its page count, and its page hashes, all in host order, since digests are
+// only meant to be compared between runs on the same machine.
+std::string PCSX::StateHash::Digest::serialize() const {
+    std::string out;
+    auto put = [&out](const void* data, size_t size) { out.append(reinterpret_cast<const char*>(data), size); };
+    put(&hash, sizeof(hash));
+    for (unsigned i = 0; i < c_regionCount; i++) {
+        const uint32_t count = pages[i].size();
+        put(regionHashes + i, sizeof(uint64_t));
+        put(&count, sizeof(count));
+        put(pages[i].data(), count * sizeof(uint64_t));
+    }
+    return out;
+}
+
+bool PCSX::StateHash::Digest::deserialize(std::string_view data) {
+    auto get = [&data](void* out, size_t size) {
+        if (data.size() < size) return false;
+        memcpy(out, data.data(), size);
+        data.remove_prefix(size);
+        return true;
+    };
+    Digest result;
+    if (!get(&result.hash, sizeof(result.hash))) return false;
+    for (unsigned i = 0; i < c_regionCount; i++) {
+        uint32_t count;
+        if (!get(result.regionHashes + i, sizeof(uint64_t)) || !get(&count, sizeof(count))) return false;
+        if ((data.size() / sizeof(uint64_t)) < count) return false;
+        result.pages[i].resize(count);
+        get(result.pages[i].data(), count * sizeof(uint64_t));
+    }
+    if (!data.empty()) return false;
+    *this = std::move(result);
+    return true;
+}
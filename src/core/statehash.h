@@ -0,0 +1,89 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace PCSX {
+
+// Incremental hashing of the whole machine state, cheap enough to run every
+// frame, in order to find where two runs which are supposed to be identical
+// start to diverge. The state is split into regions, which are split into
+// pages, each hashed with XXH64. A shadow copy of each region is kept from
+// the previous update, and only the pages which differ from it get hashed
+// again. The generated code of the dynarec writes straight into memory, so
+// comparing against the shadow copy is the only way to find the dirty pages
+// without slowing down every single write of both CPUs.
+//
+// A digest holds all of the page hashes, so comparing the digests of two
+// runs yields the first region and page where they differ.
+class StateHash {
+  public:
+    enum class Region : unsigned {
+        CPU,         // The GPRs, COP0, GTE registers, and pc.
+        RAM,         // The main RAM, 2MB or 8MB.
+        Scratchpad,  // The 1KB of scratchpad.
+        Hardware,    // The memory mapped hardware registers.
+        VRAM,        // The 1MB of VRAM.
+        SPURAM,      // The 512KB of SPU RAM.
+    };
+    static constexpr unsigned c_regionCount = 6;
+    static constexpr size_t c_pageSize = 4096;
+
+    struct Digest {
+        uint64_t hash = 0;
+        uint64_t regionHashes[c_regionCount] = {};
+        std::vector<uint64_t> pages[c_regionCount];
+
+        std::string serialize() const;
+        bool deserialize(std::string_view data);
+    };
+    struct Divergence {
+        Region region;
+        size_t page;
+    };
+
+    // Hashes the current state, and returns the resulting digest.
+    const Digest& update();
+    const Digest& digest() const { return m_digest; }
+    // How many pages the last update had to hash.
+    size_t rehashedPages() const { return m_rehashedPages; }
+    // Drops the shadow copies, so that the next update hashes everything.
+    void reset();
+
+    // The first page where the two digests differ, if any.
+    static std::optional<Divergence> compare(const Digest& a, const Digest& b);
+    static const char* regionName(Region region);
+
+  private:
+    void updateRegion(Region region, const uint8_t* data, size_t size);
+
+    std::vector<uint8_t> m_shadows[c_regionCount];
+    Digest m_digest;
+    size_t m_rehashedPages = 0;
+};
+
+}  // namespace PCSX
@@ -24,10 +24,21 @@
 #include <iomanip>
 #include <sstream>
 
+#include "core/psxemulator.h"
 #include "support/file.h"
 
 PCSX::System* PCSX::g_system = NULL;
 
+bool PCSX::System::running() { return g_emulator && g_emulator->running(); }
+
+void PCSX::System::pause(bool exception) {
+    if (g_emulator) g_emulator->pause(exception);
+}
+
+void PCSX::System::resume() {
+    if (g_emulator) g_emulator->resume();
+}
+
 static const ImWchar c_frenchRanges[] = {0x0020, 0x00ff, 0x0152, 0x0153, 0};
 static const ImWchar c_greekRanges[] = {0x0020, 0x00ff, 0x0370, 0x03ff, 0};
 static const ImWchar c_hindiSupplementalRanges[] = {0x0900, 0x097f, 0};
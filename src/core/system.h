@@ -81,6 +81,16 @@ struct Reset {
 };
 struct SaveStateLoaded {};
 }  // namespace ExecutionFlow
+namespace SaveStates {
+struct Saved {
+    std::string path;
+    bool success;
+};
+struct Loaded {
+    std::string path;
+    bool success;
+};
+}  // namespace SaveStates
 namespace GUI {
 struct JumpToPC {
     uint32_t pc;
@@ -162,25 +172,19 @@ class System {
     // Close mem and plugins
     virtual void close() = 0;
     virtual void purgeAllEvents() = 0;
-    bool running() {
-        std::atomic_signal_fence(std::memory_order_relaxed);
-        return m_running && !m_quitting;
-    }
-    const bool *runningPtr() { return &m_running; }
+    // The run state belongs to each emulator; these act on the one bound to
+    // the calling thread. See Emulator::running().
+    bool running();
+    [[gnu::cold]] void pause(bool exception = false);
+    void resume();
     const bool *quittingPtr() { return &m_quitting; }
     bool quitting() { return m_quitting; }
+    // Forked children run the emulation alone: no UI, no audio output, and
+    // none of the parent's threads, so anything relying on those is skipped.
+    bool headless() { return m_headless; }
+    void setHeadless() { m_headless = true; }
     int exitCode() { return m_exitCode; }
     bool emergencyExit() { return m_emergencyExit; }
-    [[gnu::cold]] void pause(bool exception = false) {
-        if (!m_running) return;
-        m_running = false;
-        m_eventBus->signal(Events::ExecutionFlow::Pause{exception});
-    }
-    void resume() {
-        if (m_running) return;
-        m_running = true;
-        m_eventBus->signal(Events::ExecutionFlow::Run{});
-    }
     virtual void testQuit(int code) = 0;
     // This needs to only mutate variables, as it requires to be signal-safe.
     [[gnu::cold]] void quit(int code = 0) {
@@ -258,18 +262,13 @@ class System {
     std::map<uint64_t, std::string> m_i18n;
     std::map<std::string, decltype(m_i18n)> m_locales;
     std::string m_currentLocale;
-    // If true, indicates that the emulator is currently capturing the main loop
-    // and actively emulates the PSX hardware. If false, the emulator is paused,
-    // waiting for user input or other events inside the UI. The way the UI
-    // is refreshed is by calling update() periodically, so this boolean affects
-    // the moment when and how update() is called.
-    bool m_running = false;
     // If true, indicates that the emulator is quitting. This can be set by a
     // number of events, including the user pressing the quit button or the
     // emulator itself requesting a quit due to testing for instance. This will
     // cause the two main loop to exit: the inner one being the emulator itself,
     // and the outer one being the main.cc loop.
     bool m_quitting = false;
+    bool m_headless = false;
     int m_exitCode = 0;
     struct LocaleInfo {
         const std::string filename;
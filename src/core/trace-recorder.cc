@@ -0,0 +1,65 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/trace-recorder.h"
+
+#include <string.h>
+
+#include "core/psxemulator.h"
+#include "core/r3000a.h"
+
+bool PCSX::TraceRecorder::start(const std::filesystem::path& path) {
+    stop();
+    if (g_emulator->m_cpu->isDynarec()) {
+        g_system->printf(_("Instruction trace recording requires the interpreter.\n"));
+        return false;
+    }
+    uint32_t regs[InstructionTrace::c_registerCount];
+    gatherRegisters(regs);
+    if (!m_writer.open(path, regs)) {
+        g_system->printf(_("Unable to create instruction trace file %s.\n"), path.string());
+        return false;
+    }
+    m_recording = true;
+    return true;
+}
+
+void PCSX::TraceRecorder::stop() {
+    if (!m_recording) return;
+    m_recording = false;
+    m_writer.close();
+}
+
+void PCSX::TraceRecorder::begin(uint32_t pc, uint32_t code) {
+    m_writer.begin(g_emulator->m_cpu->m_regs.cycle, pc, code);
+}
+
+void PCSX::TraceRecorder::end() {
+    uint32_t regs[InstructionTrace::c_registerCount];
+    gatherRegisters(regs);
+    m_writer.end(regs);
+}
+
+void PCSX::TraceRecorder::gatherRegisters(uint32_t regs[InstructionTrace::c_registerCount]) {
+    auto& cpuRegs = g_emulator->m_cpu->m_regs;
+    memcpy(regs, cpuRegs.GPR.r, sizeof(cpuRegs.GPR.r));
+    regs[34] = cpuRegs.CP0.n.Status;
+    regs[35] = cpuRegs.CP0.n.Cause;
+    regs[36] = cpuRegs.CP0.n.EPC;
+}
@@ -0,0 +1,58 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <filesystem>
+
+#include "support/instruction-trace.h"
+
+namespace PCSX {
+
+// Records every instruction the interpreter runs into an InstructionTrace
+// file: its pc, opcode, the registers it changed, and the memory accesses
+// which went through the memory functions. The encoding happens inline, while
+// the compression and the disk I/O happen on a background thread. The
+// dynarec doesn't run instructions one by one, so recording requires the
+// interpreter.
+class TraceRecorder {
+  public:
+    // Returns false if the dynarec is running, or if the file can't be created.
+    bool start(const std::filesystem::path& path);
+    void stop();
+    bool recording() const { return m_recording; }
+    uint64_t instructions() const { return m_writer.count(); }
+    uint64_t bytesWritten() const { return m_writer.bytesWritten(); }
+
+    void begin(uint32_t pc, uint32_t code);
+    void access(uint32_t address, unsigned size, uint32_t value, bool write) {
+        if (m_recording) m_writer.access(address, size, value, write);
+    }
+    void end();
+
+  private:
+    static void gatherRegisters(uint32_t regs[InstructionTrace::c_registerCount]);
+
+    bool m_recording = false;
+    InstructionTrace::Writer m_writer;
+};
+
+}  // namespace PCSX
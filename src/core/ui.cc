@@ -80,12 +80,13 @@ void PCSX::UI::tick() {
     auto L = *g_emulator->m_lua;
     L.getfield("AfterPollingCleanup", LUA_GLOBALSINDEX);
     if (!L.isnil()) {
+        // Cleared first, so that the callbacks can schedule more for the next tick.
+        L.push();
+        L.setfield("AfterPollingCleanup", LUA_GLOBALSINDEX);
         try {
             L.pcall();
         } catch (...) {
         }
-        L.push();
-        L.setfield("AfterPollingCleanup", LUA_GLOBALSINDEX);
     } else {
         L.pop();
     }
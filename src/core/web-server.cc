@@ -22,42 +22,62 @@
 #include <llhttp.h>
 #include <multipart_parser.h>
 
+#include <algorithm>
 #include <charconv>
+#include <limits>
 #include <magic_enum_all.hpp>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 
 #include "GL/gl3w.h"
 #include "cdrom/cdriso.h"
 #include "cdrom/file.h"
 #include "cdrom/iso9660-reader.h"
+#include "core/accesstracker.h"
 #include "core/cdrom.h"
+#include "core/disr3000a.h"
 #include "core/gpu.h"
+#include "core/perf-counters.h"
 #include "core/psxemulator.h"
 #include "core/psxmem.h"
 #include "core/r3000a.h"
+#include "core/rewind.h"
+#include "core/sstate-io.h"
+#include "core/statehash.h"
 #include "core/system.h"
 #include "gui/gui.h"
 #include "lua/luawrapper.h"
 #include "support/file.h"
 #include "support/hashtable.h"
+#include "support/sha1.h"
 #include "support/strings-helpers.h"
 #include "supportpsx/iso9660-builder.h"
 #include "uriparser/Uri.h"
 
 namespace {
 
+// Streams a raw memory blob as a chunked response, copying it piecewise.
+void writeRawChunked(PCSX::WebClient* client, const uint8_t* data, uint32_t size) {
+    static constexpr uint32_t c_chunkSize = 64 * 1024;
+    client->beginChunked("application/octet-stream");
+    for (uint32_t offset = 0; offset < size; offset += c_chunkSize) {
+        PCSX::Slice chunk;
+        chunk.copy(data + offset, std::min(c_chunkSize, size - offset));
+        client->writeChunk(std::move(chunk));
+    }
+    client->endChunked();
+}
+
 class VramExecutor : public PCSX::WebExecutor {
     virtual bool match(PCSX::WebClient* client, const PCSX::UrlData& urldata) final {
         return urldata.path == "/api/v1/gpu/vram/raw";
     }
     virtual bool execute(PCSX::WebClient* client, PCSX::RequestData& request) final {
         if (request.method == PCSX::RequestData::Method::HTTP_HTTP_GET) {
-            client->write(
-                "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nContent-Length: 1048576\r\n\r\n");
-            client->write(PCSX::g_emulator->m_gpu->getVRAM());
-
+            auto vram = PCSX::g_emulator->m_gpu->getVRAM();
+            writeRawChunked(client, vram.data<uint8_t>(), vram.size());
             return true;
         } else if (request.method == PCSX::RequestData::Method::HTTP_POST) {
             auto vars = parseQuery(request.urlData.query);
@@ -108,19 +128,8 @@ class RamExecutor : public PCSX::WebExecutor {
     virtual bool execute(PCSX::WebClient* client, PCSX::RequestData& request) final {
         const auto& ram8M = PCSX::g_emulator->settings.get<PCSX::Emulator::Setting8MB>().value;
         if (request.method == PCSX::RequestData::Method::HTTP_HTTP_GET) {
-            if (ram8M) {
-                client->write(
-                    "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nContent-Length: 8388608\r\n\r\n");
-            } else {
-                client->write(
-                    "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nContent-Length: 2097152\r\n\r\n");
-            }
             uint32_t size = 1024 * 1024 * (ram8M ? 8 : 2);
-            uint8_t* data = (uint8_t*)malloc(size);
-            memcpy(data, PCSX::g_emulator->m_mem->m_wram, size);
-            PCSX::Slice slice;
-            slice.acquire(data, size);
-            client->write(std::move(slice));
+            writeRawChunked(client, PCSX::g_emulator->m_mem->m_wram, size);
             return true;
         } else if (request.method == PCSX::RequestData::Method::HTTP_POST) {
             const auto ramSize = (ram8M ? 8 : 2) * 1024 * 1024;
@@ -155,6 +164,276 @@ class RamExecutor : public PCSX::WebExecutor {
     virtual ~RamExecutor() = default;
 };
 
+// Runs a list of memory reads, memory writes, and register reads at once.
+// Requests are served from the main loop, which only runs between frames or
+// while paused, so the whole batch sees and changes the same machine state.
+// POST a JSON object such as:
+//   {"ops": [{"read": "0x80010000", "width": 4},
+//            {"write": 2147549188, "width": 2, "value": 5},
+//            {"register": "v0"}],
+//    "format": "binary", "watch": "hud"}
+// Each op yields a result: the bytes read, 4 little endian bytes for
+// registers, and nothing for writes. The JSON format returns them in a
+// "results" array, as numbers for up to 4 bytes, and as hex strings beyond.
+// The binary format concatenates them.
+//
+// Naming a watch set keeps its ops on the server, and only returns the
+// results which changed since the previous poll, as [index, value] pairs
+// in a "changed" array, or as a little endian 32 bits index followed by the
+// result in binary. GET ?watch=name[&format=binary] polls the set again, and
+// DELETE ?watch=name drops it. Since every poll runs the ops again, watch sets
+// can't contain writes.
+class BatchExecutor : public PCSX::WebExecutor {
+    struct Op {
+        enum { Read, Write, Register } type;
+        // The register index, for register reads.
+        uint32_t address;
+        uint32_t width;
+        uint32_t value;
+    };
+    struct WatchSet {
+        std::vector<Op> ops;
+        std::vector<std::string> last;
+    };
+    static constexpr size_t c_maxOps = 4096;
+    static constexpr uint32_t c_maxWidth = 4096;
+    static constexpr size_t c_maxWatchSets = 64;
+    // The GPRs, lo and hi are 0 to 33, then the pc, then the COP0 registers.
+    static constexpr unsigned c_pc = 34;
+    static constexpr unsigned c_cop0 = 64;
+
+    virtual bool match(PCSX::WebClient* client, const PCSX::UrlData& urldata) final {
+        return urldata.path == "/api/v1/cpu/batch";
+    }
+    virtual bool execute(PCSX::WebClient* client, PCSX::RequestData& request) final {
+        auto vars = parseQuery(request.urlData.query);
+        auto iwatch = vars.find("watch");
+        std::string watchName = iwatch != vars.end() ? iwatch->second.value_or("") : "";
+        auto iformat = vars.find("format");
+        bool binary = (iformat != vars.end()) && (iformat->second.value_or("") == "binary");
+
+        if (request.method == PCSX::RequestData::Method::HTTP_DELETE) {
+            if (m_watchSets.erase(watchName) == 0) {
+                client->write("HTTP/1.1 404 Not Found\r\n\r\nUnknown watch set.\r\n");
+            } else {
+                client->write("HTTP/1.1 200 OK\r\n\r\n");
+            }
+            return true;
+        } else if (request.method == PCSX::RequestData::Method::HTTP_HTTP_GET) {
+            auto watchSet = m_watchSets.find(watchName);
+            if (watchSet == m_watchSets.end()) {
+                client->write("HTTP/1.1 404 Not Found\r\n\r\nUnknown watch set.\r\n");
+                return true;
+            }
+            respond(client, watchSet->second.ops, &watchSet->second.last, binary);
+            return true;
+        } else if (request.method != PCSX::RequestData::Method::HTTP_POST) {
+            return false;
+        }
+
+        auto j = nlohmann::json::parse(request.body.asString(), nullptr, false);
+        if (j.is_discarded() || !j.is_object() || !j.contains("ops") || !j["ops"].is_array()) {
+            client->write("HTTP/1.1 400 Bad Request\r\n\r\nExpected a JSON object with an ops array.\r\n");
+            return true;
+        }
+        std::vector<Op> ops;
+        std::string error;
+        if (!parseOps(j["ops"], ops, error)) {
+            client->write(fmt::format("HTTP/1.1 400 Bad Request\r\n\r\n{}\r\n", error));
+            return true;
+        }
+        if (j.contains("format")) binary = j["format"] == "binary";
+        if (j.contains("watch") && j["watch"].is_string()) watchName = j["watch"].get<std::string>();
+        if (watchName.empty()) {
+            respond(client, ops, nullptr, binary);
+            return true;
+        }
+        // Polling a watch set runs its ops again, so it can't hold any write.
+        if (std::any_of(ops.begin(), ops.end(), [](const Op& op) { return op.type == Op::Write; })) {
+            client->write("HTTP/1.1 400 Bad Request\r\n\r\nWatch sets can't contain writes.\r\n");
+            return true;
+        }
+        if (!m_watchSets.contains(watchName) && (m_watchSets.size() >= c_maxWatchSets)) {
+            client->write("HTTP/1.1 400 Bad Request\r\n\r\nToo many watch sets.\r\n");
+            return true;
+        }
+        auto& watchSet = m_watchSets[watchName];
+        watchSet.ops = std::move(ops);
+        watchSet.last.clear();
+        respond(client, watchSet.ops, &watchSet.last, binary);
+        return true;
+    }
+
+    static std::optional<uint32_t> parseNumber(const nlohmann::json& value) {
+        if (value.is_number_unsigned()) {
+            auto number = value.get<uint64_t>();
+            if (number > std::numeric_limits<uint32_t>::max()) return std::nullopt;
+            return uint32_t(number);
+        }
+        if (!value.is_string()) return std::nullopt;
+        std::string_view str = value.get_ref<const std::string&>();
+        int base = 10;
+        if (str.starts_with("0x") || str.starts_with("0X")) {
+            str.remove_prefix(2);
+            base = 16;
+        }
+        uint32_t ret;
+        auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), ret, base);
+        if ((ec != std::errc()) || (ptr != (str.data() + str.size()))) return std::nullopt;
+        return ret;
+    }
+
+    static std::optional<unsigned> registerIndex(std::string_view name) {
+        if (name == "lo") return 32;
+        if (name == "hi") return 33;
+        if (name == "pc") return c_pc;
+        if (name == "badvaddr") return c_cop0 + 8;
+        if (name == "status") return c_cop0 + 12;
+        if (name == "cause") return c_cop0 + 13;
+        if (name == "epc") return c_cop0 + 14;
+        for (unsigned i = 0; i < 32; i++) {
+            if (name == PCSX::Disasm::s_disRNameGPR[i]) return i;
+        }
+        return std::nullopt;
+    }
+
+    static uint32_t readRegister(unsigned index) {
+        auto& regs = PCSX::g_emulator->m_cpu->m_regs;
+        if (index < c_pc) return regs.GPR.r[index];
+        if (index == c_pc) return regs.pc;
+        return regs.CP0.r[index - c_cop0];
+    }
+
+    static bool parseOps(const nlohmann::json& list, std::vector<Op>& ops, std::string& error) {
+        if (list.size() > c_maxOps) {
+            error = fmt::format("Too many ops, the limit is {}.", c_maxOps);
+            return false;
+        }
+        for (auto& entry : list) {
+            if (!entry.is_object()) {
+                error = "Ops have to be objects.";
+                return false;
+            }
+            Op op;
+            if (entry.contains("register")) {
+                auto index = entry["register"].is_string() ? registerIndex(entry["register"].get<std::string>())
+                                                           : std::nullopt;
+                if (!index.has_value()) {
+                    error = fmt::format("Unknown register in op {}.", ops.size());
+                    return false;
+                }
+                op = {Op::Register, index.value(), 4, 0};
+            } else {
+                const bool isWrite = entry.contains("write");
+                auto address = parseNumber(isWrite ? entry["write"] : entry.value("read", nlohmann::json()));
+                auto width = entry.contains("width") ? parseNumber(entry["width"]) : std::optional<uint32_t>(4);
+                auto value = entry.contains("value") ? parseNumber(entry["value"]) : std::nullopt;
+                if (!address.has_value() || !width.has_value() || (width.value() == 0)) {
+                    error = fmt::format("Op {} needs a read or write address, and a valid width.", ops.size());
+                    return false;
+                }
+                if (isWrite && ((width.value() > 4) || (width.value() == 3) || !value.has_value())) {
+                    error = fmt::format("Write op {} needs a width of 1, 2 or 4, and a value.", ops.size());
+                    return false;
+                }
+                if (width.value() > c_maxWidth) {
+                    error = fmt::format("Op {} is wider than {} bytes.", ops.size(), c_maxWidth);
+                    return false;
+                }
+                op = {isWrite ? Op::Write : Op::Read, address.value(), width.value(), value.value_or(0)};
+            }
+            ops.push_back(op);
+        }
+        return true;
+    }
+
+    static void run(const std::vector<Op>& ops, std::vector<std::string>& results) {
+        auto memory = PCSX::g_emulator->m_mem->getMemoryAsFile();
+        results.resize(ops.size());
+        for (size_t i = 0; i < ops.size(); i++) {
+            auto& op = ops[i];
+            auto& result = results[i];
+            switch (op.type) {
+                case Op::Read:
+                    result.resize(op.width);
+                    memory->readAt(result.data(), op.width, op.address);
+                    break;
+                case Op::Write: {
+                    uint8_t bytes[4];
+                    for (unsigned b = 0; b < 4; b++) bytes[b] = op.value >> (b * 8);
+                    memory->writeAt(bytes, op.width, op.address);
+                    PCSX::g_emulator->m_cpu->Clear(op.address & ~3, ((op.address & 3) + op.width + 3) / 4);
+                    result.clear();
+                    break;
+                }
+                case Op::Register: {
+                    uint32_t value = readRegister(op.address);
+                    result.resize(4);
+                    for (unsigned b = 0; b < 4; b++) result[b] = char(value >> (b * 8));
+                    break;
+                }
+            }
+        }
+    }
+
+    static nlohmann::json toJson(const std::string& result) {
+        if (result.empty()) return nullptr;
+        if (result.size() > 4) {
+            std::string hex;
+            hex.reserve(result.size() * 2);
+            for (auto c : result) hex += fmt::format("{:02x}", uint8_t(c));
+            return hex;
+        }
+        uint32_t value = 0;
+        for (size_t b = 0; b < result.size(); b++) value |= uint32_t(uint8_t(result[b])) << (b * 8);
+        return value;
+    }
+
+    void respond(PCSX::WebClient* client, const std::vector<Op>& ops, std::vector<std::string>* last, bool binary) {
+        std::vector<std::string> results;
+        run(ops, results);
+        std::string packed;
+        nlohmann::json j = nlohmann::json::object();
+        if (last) {
+            // A fresh watch set reports everything on its first poll.
+            const bool first = last->size() != results.size();
+            auto& changed = j["changed"] = nlohmann::json::array();
+            for (size_t i = 0; i < results.size(); i++) {
+                if (results[i].empty() || (!first && (results[i] == (*last)[i]))) continue;
+                if (binary) {
+                    for (unsigned b = 0; b < 4; b++) packed += char(i >> (b * 8));
+                    packed += results[i];
+                } else {
+                    changed.push_back({i, toJson(results[i])});
+                }
+            }
+            last->swap(results);
+        } else {
+            auto& array = j["results"] = nlohmann::json::array();
+            for (auto& result : results) {
+                if (binary) {
+                    packed += result;
+                } else {
+                    array.push_back(toJson(result));
+                }
+            }
+        }
+        if (!binary) {
+            write200(client, j);
+            return;
+        }
+        client->write(fmt::format(
+            "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nContent-Length: {}\r\n\r\n", packed.size()));
+        client->write(std::move(packed));
+    }
+
+    std::map<std::string, WatchSet> m_watchSets;
+
+  public:
+    BatchExecutor() = default;
+    virtual ~BatchExecutor() = default;
+};
+
 class AssemblyExecutor : public PCSX::WebExecutor {
     virtual bool match(PCSX::WebClient* client, const PCSX::UrlData& urldata) final {
         return urldata.path == "/api/v1/assembly/symbols";
@@ -248,6 +527,8 @@ class FlowExecutor : public PCSX::WebExecutor {
             j["isDynarec"] = PCSX::g_emulator->m_cpu->isDynarec();
             j["8mb"] = PCSX::g_emulator->settings.get<PCSX::Emulator::Setting8MB>().value;
             j["debugger"] = debugSettings.get<PCSX::Emulator::DebugSettings::Debug>().value;
+            j["speed"] = PCSX::g_emulator->settings.get<PCSX::Emulator::SettingScaler>() / 100.0f;
+            j["unthrottled"] = PCSX::g_emulator->settings.get<PCSX::Emulator::SettingUnthrottled>().value;
             write200(client, j);
             return true;
         } else if (request.method == PCSX::RequestData::Method::HTTP_POST) {
@@ -273,6 +554,26 @@ class FlowExecutor : public PCSX::WebExecutor {
                 client->write("HTTP/1.1 200 OK\r\n\r\n");
                 return true;
             }
+            if (function.compare("speed") == 0) {
+                auto ivalue = vars.find("value");
+                std::string value = ivalue == vars.end() ? "" : ivalue->second.value_or("");
+                auto& settings = PCSX::g_emulator->settings;
+                if (value.compare("unlimited") == 0) {
+                    settings.get<PCSX::Emulator::SettingUnthrottled>() = true;
+                    client->write("HTTP/1.1 200 OK\r\n\r\n");
+                    return true;
+                }
+                char* end = nullptr;
+                float scale = strtof(value.c_str(), &end);
+                if (value.empty() || (*end != 0) || !(scale > 0.0f)) {
+                    client->write("HTTP/1.1 400 Bad Request\r\n\r\n");
+                    return true;
+                }
+                settings.get<PCSX::Emulator::SettingScaler>() = scale * 100.0f;
+                settings.get<PCSX::Emulator::SettingUnthrottled>() = false;
+                client->write("HTTP/1.1 200 OK\r\n\r\n");
+                return true;
+            }
             /* Start of functions that requires a type */
             auto itype = vars.find("type");
             if (itype == vars.end()) {
@@ -303,6 +604,235 @@ class FlowExecutor : public PCSX::WebExecutor {
     virtual ~FlowExecutor() = default;
 };
 
+class RewindExecutor : public PCSX::WebExecutor {
+    virtual bool match(PCSX::WebClient* client, const PCSX::UrlData& urldata) final {
+        return urldata.path == "/api/v1/rewind";
+    }
+    virtual bool execute(PCSX::WebClient* client, PCSX::RequestData& request) final {
+        auto& rewind = PCSX::g_emulator->m_rewind;
+        if (request.method == PCSX::RequestData::Method::HTTP_HTTP_GET) {
+            nlohmann::json j;
+            j["enabled"] = PCSX::g_emulator->settings.get<PCSX::Emulator::SettingRewind>().value;
+            j["count"] = rewind->count();
+            j["position"] = rewind->position();
+            j["memory"] = rewind->memoryUsage();
+            j["snapshots"] = nlohmann::json::array();
+            for (size_t i = 0; i < rewind->count(); i++) {
+                auto info = rewind->info(i);
+                j["snapshots"][i]["frame"] = info.frame;
+                j["snapshots"][i]["cycle"] = info.cycle;
+                j["snapshots"][i]["keyframe"] = info.keyframe;
+                j["snapshots"][i]["size"] = info.size;
+            }
+            write200(client, j);
+            return true;
+        } else if (request.method == PCSX::RequestData::Method::HTTP_POST) {
+            auto vars = parseQuery(request.urlData.query);
+            auto ifunction = vars.find("function");
+            if (ifunction == vars.end()) {
+                client->write("HTTP/1.1 400 Bad Request\r\n\r\n");
+                return true;
+            }
+            std::string function = ifunction->second.value_or("");
+            auto getNumber = [&vars](const char* name, unsigned defaultValue) -> std::optional<unsigned> {
+                auto ivalue = vars.find(name);
+                if (ivalue == vars.end()) return defaultValue;
+                std::string value = ivalue->second.value_or("");
+                unsigned ret;
+                auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), ret);
+                if ((ec != std::errc()) || (ptr != value.data() + value.size())) return std::nullopt;
+                return ret;
+            };
+            bool success = false;
+            if (function == "capture") {
+                rewind->capture();
+                success = true;
+            } else if (function == "clear") {
+                rewind->clear();
+                success = true;
+            } else if ((function == "back") || (function == "forward")) {
+                auto count = getNumber("count", 1);
+                if (!count.has_value()) {
+                    client->write("HTTP/1.1 400 Bad Request\r\n\r\n");
+                    return true;
+                }
+                success = function == "back" ? rewind->stepBack(count.value()) : rewind->stepForward(count.value());
+            } else if (function == "restore") {
+                auto index = getNumber("index", rewind->count());
+                if (!index.has_value() || (index.value() >= rewind->count())) {
+                    client->write("HTTP/1.1 400 Bad Request\r\n\r\n");
+                    return true;
+                }
+                success = rewind->restore(index.value());
+            } else {
+                client->write("HTTP/1.1 400 Bad Request\r\n\r\n");
+                return true;
+            }
+            if (success) {
+                client->write(fmt::format("HTTP/1.1 200 OK\r\n\r\nRewind position is now {} of {}.",
+                                          rewind->position(), rewind->count()));
+            } else {
+                client->write(std::string("HTTP/1.1 500 Internal Server Error\r\n\r\nRewind failed."));
+            }
+            return true;
+        }
+        return false;
+    }
+
+  public:
+    RewindExecutor() = default;
+    virtual ~RewindExecutor() = default;
+};
+
+class StateHashExecutor : public PCSX::WebExecutor {
+    virtual bool match(PCSX::WebClient* client, const PCSX::UrlData& urldata) final {
+        return urldata.path == "/api/v1/state-hash";
+    }
+    virtual bool execute(PCSX::WebClient* client, PCSX::RequestData& request) final {
+        if (request.method != PCSX::RequestData::Method::HTTP_HTTP_GET) return false;
+        auto vars = parseQuery(request.urlData.query);
+        auto ipages = vars.find("pages");
+        const bool withPages = (ipages != vars.end()) && (ipages->second.value_or("") != "false");
+        auto& stateHash = PCSX::g_emulator->m_stateHash;
+        const auto& digest = stateHash->update();
+        nlohmann::json j;
+        j["hash"] = fmt::format("{:016x}", digest.hash);
+        j["rehashedPages"] = stateHash->rehashedPages();
+        j["pageSize"] = PCSX::StateHash::c_pageSize;
+        for (unsigned i = 0; i < PCSX::StateHash::c_regionCount; i++) {
+            const char* name = PCSX::StateHash::regionName(static_cast<PCSX::StateHash::Region>(i));
+            j["regions"][name]["hash"] = fmt::format("{:016x}", digest.regionHashes[i]);
+            j["regions"][name]["pages"] = digest.pages[i].size();
+            if (!withPages) continue;
+            auto& pages = j["regions"][name]["pageHashes"] = nlohmann::json::array();
+            for (auto hash : digest.pages[i]) pages.push_back(fmt::format("{:016x}", hash));
+        }
+        write200(client, j);
+        return true;
+    }
+
+  public:
+    StateHashExecutor() = default;
+    virtual ~StateHashExecutor() = default;
+};
+
+class MetricsExecutor : public PCSX::WebExecutor {
+    virtual bool match(PCSX::WebClient* client, const PCSX::UrlData& urldata) final {
+        return urldata.path == "/api/v1/metrics";
+    }
+    virtual bool execute(PCSX::WebClient* client, PCSX::RequestData& request) final {
+        if (request.method != PCSX::RequestData::Method::HTTP_HTTP_GET) return false;
+        std::string metrics = PCSX::g_emulator->m_perfCounters->prometheus();
+        client->write(fmt::format(
+            "HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: {}\r\n\r\n",
+            metrics.size()));
+        client->write(std::move(metrics));
+        return true;
+    }
+
+  public:
+    MetricsExecutor() = default;
+    virtual ~MetricsExecutor() = default;
+};
+
+class ExecutionFlowExecutor : public PCSX::WebExecutor {
+    virtual bool match(PCSX::WebClient* client, const PCSX::UrlData& urldata) final {
+        return urldata.path == "/api/v1/execution-flow";
+    }
+    virtual bool execute(PCSX::WebClient* client, PCSX::RequestData& request) final {
+        using PCSX::AccessTracker;
+        auto& tracker = PCSX::g_emulator->m_accessTracker;
+        auto vars = parseQuery(request.urlData.query);
+        if (request.method == PCSX::RequestData::Method::HTTP_HTTP_GET) {
+            auto getNumber = [&vars](const char* name, uint32_t defaultValue) -> std::optional<uint32_t> {
+                auto ivalue = vars.find(name);
+                if (ivalue == vars.end()) return defaultValue;
+                std::string value = ivalue->second.value_or("");
+                int base = 10;
+                if (PCSX::StringsHelpers::startsWith(value, "0x")) {
+                    value = value.substr(2);
+                    base = 16;
+                }
+                uint32_t ret;
+                auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), ret, base);
+                if ((ec != std::errc()) || (ptr != value.data() + value.size())) return std::nullopt;
+                return ret;
+            };
+            auto halfLife = getNumber("halfLife", 30);
+            auto iaccess = vars.find("access");
+            if (!halfLife.has_value()) {
+                client->write("HTTP/1.1 400 Bad Request\r\n\r\n");
+                return true;
+            }
+            if (iaccess == vars.end()) {
+                nlohmann::json j;
+                j["enabled"] = tracker->enabled();
+                j["now"] = tracker->now();
+                j["lineSize"] = AccessTracker::c_lineSize;
+                j["lines"] = tracker->ramLines();
+                // How many lines were ever accessed, and how many still are hot, for a quick overview.
+                std::vector<uint8_t> heat(tracker->ramLines());
+                for (unsigned i = 0; i < AccessTracker::c_accessCount; i++) {
+                    const auto access = static_cast<AccessTracker::Access>(i);
+                    tracker->heat(access, 0, heat.size(), halfLife.value(), heat.data());
+                    unsigned touched = 0, hot = 0;
+                    for (auto h : heat) {
+                        if (h != 0) touched++;
+                        if (h >= 128) hot++;
+                    }
+                    j["accesses"][AccessTracker::accessName(access)]["touched"] = touched;
+                    j["accesses"][AccessTracker::accessName(access)]["hot"] = hot;
+                }
+                write200(client, j);
+                return true;
+            }
+            // One byte of heat per line of the requested range, just like AccessTracker::heat.
+            std::optional<AccessTracker::Access> access;
+            for (unsigned i = 0; i < AccessTracker::c_accessCount; i++) {
+                if (iaccess->second.value_or("") == AccessTracker::accessName(static_cast<AccessTracker::Access>(i))) {
+                    access = static_cast<AccessTracker::Access>(i);
+                }
+            }
+            auto address = getNumber("address", 0x80000000);
+            auto size = getNumber("size", tracker->ramLines() * AccessTracker::c_lineSize);
+            if (!access.has_value() || !address.has_value() || !size.has_value() ||
+                (size.value() > AccessTracker::c_lineCount * AccessTracker::c_lineSize)) {
+                client->write("HTTP/1.1 400 Bad Request\r\n\r\n");
+                return true;
+            }
+            const uint32_t lines = (size.value() + AccessTracker::c_lineSize - 1) >> AccessTracker::c_lineShift;
+            uint8_t* data = (uint8_t*)malloc(lines);
+            tracker->heat(access.value(), tracker->lineOf(address.value()), lines, halfLife.value(), data);
+            client->write(fmt::format(
+                "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nContent-Length: {}\r\n\r\n", lines));
+            PCSX::Slice slice;
+            slice.acquire(data, lines);
+            client->write(std::move(slice));
+            return true;
+        } else if (request.method == PCSX::RequestData::Method::HTTP_POST) {
+            auto ifunction = vars.find("function");
+            std::string function = ifunction == vars.end() ? "" : ifunction->second.value_or("");
+            if (function == "enable") {
+                tracker->setEnabled(true);
+            } else if (function == "disable") {
+                tracker->setEnabled(false);
+            } else if (function == "clear") {
+                tracker->clear();
+            } else {
+                client->write("HTTP/1.1 400 Bad Request\r\n\r\n");
+                return true;
+            }
+            client->write(std::string("HTTP/1.1 200 OK\r\n\r\n"));
+            return true;
+        }
+        return false;
+    }
+
+  public:
+    ExecutionFlowExecutor() = default;
+    virtual ~ExecutionFlowExecutor() = default;
+};
+
 class LuaExecutor : public PCSX::WebExecutor {
     virtual bool match(PCSX::WebClient* client, const PCSX::UrlData& urldata) final {
         return PCSX::StringsHelpers::startsWith(urldata.path, c_prefix);
@@ -563,6 +1093,12 @@ class StateExecutor : public PCSX::WebExecutor {
                 write200(client, j);
                 return true;
             } else if (path == "load" || path == "save" || path == "delete") {
+                // Loads and saves are done synchronously, so the reply tells how they
+                // went, which is only possible while nothing else is queued.
+                if ((path != "delete") && PCSX::g_emulator->m_saveStateIO->busy()) {
+                    client->write("HTTP/1.1 503 Service Unavailable\r\n\r\nSave state I/O in progress.");
+                    return true;
+                }
                 auto vars = parseQuery(request.urlData.query);
                 auto islot = vars.find("slot");
                 auto iname = vars.find("name");
@@ -596,9 +1132,9 @@ class StateExecutor : public PCSX::WebExecutor {
                     } else {
                         bool success = false;
                         if (path == "load") {
-                            success = PCSX::g_gui->loadSaveStateSlot(slot);
+                            success = PCSX::g_gui->loadSaveStateSlot(slot, true);
                         } else if (path == "save") {
-                            success = PCSX::g_gui->saveSaveStateSlot(slot);
+                            success = PCSX::g_gui->saveSaveStateSlot(slot, true);
                         } else if (path == "delete") {
                             success = PCSX::g_gui->deleteSaveStateSlot(slot);
                         }
@@ -635,9 +1171,9 @@ class StateExecutor : public PCSX::WebExecutor {
                         std::filesystem::path saveFilepath(PCSX::g_gui->buildSaveStateFilename(name));
                         bool success = false;
                         if (path == "load") {
-                            success = PCSX::g_gui->loadSaveState(saveFilepath);
+                            success = PCSX::g_gui->loadSaveState(saveFilepath, true);
                         } else if (path == "save") {
-                            success = PCSX::g_gui->saveSaveState(saveFilepath);
+                            success = PCSX::g_gui->saveSaveState(saveFilepath, true);
                         } else if (path == "delete") {
                             success = PCSX::g_gui->deleteSaveState(saveFilepath);
                         }
@@ -765,6 +1301,129 @@ class ScreenExecutor : public PCSX::WebExecutor {
     virtual ~ScreenExecutor() = default;
 };
 
+// Pushes emulator events to a WebSocket client, as JSON text messages. The
+// client picks what it wants to receive with messages such as:
+//   {"subscribe": ["vsync", "pause", "run", "log", "memory"]}
+//   {"unsubscribe": ["log"]}
+//   {"watch": [{"address": 2147549184, "size": 64}]}
+// Watched memory ranges are compared at each vsync, and sent as hex strings
+// whenever they changed since the last time they were sent.
+class EventStream : public PCSX::WebSocketHandler {
+  public:
+    EventStream(PCSX::WebClient* client) : m_client(client), m_listener(PCSX::g_system->m_eventBus) {
+        m_listener.listen<PCSX::Events::GPU::VSync>([this](const auto& event) { onVSync(); });
+        m_listener.listen<PCSX::Events::ExecutionFlow::Pause>([this](const auto& event) {
+            if (!m_subscriptions.contains("pause")) return;
+            send({{"event", "pause"}, {"pc", PCSX::g_emulator->m_cpu->m_regs.pc}, {"exception", event.exception}});
+        });
+        m_listener.listen<PCSX::Events::ExecutionFlow::Run>([this](const auto& event) {
+            if (!m_subscriptions.contains("run")) return;
+            send({{"event", "run"}});
+        });
+        m_listener.listen<PCSX::Events::LogMessage>([this](const auto& event) {
+            if (!m_subscriptions.contains("log")) return;
+            send({{"event", "log"}, {"class", magic_enum::enum_name(event.logClass)}, {"message", event.message}});
+        });
+    }
+
+  private:
+    struct Watch {
+        uint32_t address;
+        uint32_t size;
+        std::vector<uint8_t> last;
+    };
+    static constexpr unsigned c_maxWatches = 64;
+    static constexpr uint32_t c_maxWatchSize = 4096;
+
+    virtual void onMessage(PCSX::WebClient* client, PCSX::Slice&& message, bool binary) final {
+        auto j = nlohmann::json::parse(message.asString(), nullptr, false);
+        if (j.is_discarded() || !j.is_object()) {
+            sendError("Messages have to be JSON objects.");
+            return;
+        }
+        auto names = [](const nlohmann::json& value) {
+            std::vector<std::string> ret;
+            if (value.is_string()) ret.push_back(value.get<std::string>());
+            if (value.is_array()) {
+                for (auto& name : value) {
+                    if (name.is_string()) ret.push_back(name.get<std::string>());
+                }
+            }
+            return ret;
+        };
+        if (j.contains("subscribe")) {
+            for (auto& name : names(j["subscribe"])) {
+                if ((name != "vsync") && (name != "pause") && (name != "run") && (name != "log") &&
+                    (name != "memory")) {
+                    sendError(fmt::format("Unknown event `{}`.", name));
+                    continue;
+                }
+                m_subscriptions.insert(name);
+            }
+        }
+        if (j.contains("unsubscribe")) {
+            for (auto& name : names(j["unsubscribe"])) m_subscriptions.erase(name);
+        }
+        if (j.contains("watch") && j["watch"].is_array()) {
+            m_watches.clear();
+            for (auto& range : j["watch"]) {
+                if (!range.is_object() || !range["address"].is_number_unsigned() ||
+                    !range["size"].is_number_unsigned()) {
+                    sendError("Watches need an address and a size.");
+                    continue;
+                }
+                uint32_t size = range["size"].get<uint32_t>();
+                if ((size == 0) || (size > c_maxWatchSize) || (m_watches.size() == c_maxWatches)) {
+                    sendError("Watch too large, or too many watches.");
+                    continue;
+                }
+                m_watches.push_back({range["address"].get<uint32_t>(), size, {}});
+            }
+        }
+    }
+
+    void onVSync() {
+        if (m_subscriptions.contains("vsync")) {
+            send({{"event", "vsync"}, {"cycle", PCSX::g_emulator->m_cpu->m_regs.cycle}});
+        }
+        if (!m_subscriptions.contains("memory")) return;
+        auto memory = PCSX::g_emulator->m_mem->getMemoryAsFile();
+        std::vector<uint8_t> current;
+        for (auto& watch : m_watches) {
+            current.resize(watch.size);
+            memory->readAt(current.data(), watch.size, watch.address);
+            if (current == watch.last) continue;
+            std::string hex;
+            hex.reserve(watch.size * 2);
+            for (auto byte : current) hex += fmt::format("{:02x}", byte);
+            send({{"event", "memory"}, {"address", watch.address}, {"data", std::move(hex)}});
+            watch.last.swap(current);
+        }
+    }
+
+    void send(const nlohmann::json& j) { m_client->sendWebSocket(PCSX::Slice(j.dump())); }
+    void sendError(std::string_view message) { send({{"error", message}}); }
+
+    PCSX::WebClient* m_client;
+    PCSX::EventBus::Listener m_listener;
+    std::set<std::string> m_subscriptions;
+    std::vector<Watch> m_watches;
+};
+
+class EventsExecutor : public PCSX::WebExecutor {
+    virtual bool match(PCSX::WebClient* client, const PCSX::UrlData& urldata) final {
+        return urldata.path == "/api/v1/events";
+    }
+    virtual bool execute(PCSX::WebClient* client, PCSX::RequestData& request) final {
+        client->acceptWebSocket(request, std::make_unique<EventStream>(client));
+        return true;
+    }
+
+  public:
+    EventsExecutor() = default;
+    virtual ~EventsExecutor() = default;
+};
+
 }  // namespace
 
 std::multimap<std::string, std::optional<std::string>> PCSX::WebExecutor::parseQuery(std::string_view query) {
@@ -798,6 +1457,7 @@ void PCSX::WebExecutor::write200(PCSX::WebClient* client, const nlohmann::json&
 PCSX::WebServer::WebServer() : m_listener(g_system->m_eventBus) {
     m_executors.push_back(new VramExecutor());
     m_executors.push_back(new RamExecutor());
+    m_executors.push_back(new BatchExecutor());
     m_executors.push_back(new AssemblyExecutor());
     m_executors.push_back(new CacheExecutor());
     m_executors.push_back(new FlowExecutor());
@@ -805,6 +1465,11 @@ PCSX::WebServer::WebServer() : m_listener(g_system->m_eventBus) {
     m_executors.push_back(new CDExecutor());
     m_executors.push_back(new StateExecutor());
     m_executors.push_back(new ScreenExecutor());
+    m_executors.push_back(new RewindExecutor());
+    m_executors.push_back(new StateHashExecutor());
+    m_executors.push_back(new MetricsExecutor());
+    m_executors.push_back(new ExecutionFlowExecutor());
+    m_executors.push_back(new EventsExecutor());
     m_listener.listen<Events::SettingsLoaded>([this](const auto& event) {
         auto& debugSettings = g_emulator->settings.get<Emulator::SettingDebugSettings>();
         if (debugSettings.get<Emulator::DebugSettings::WebServer>() && (m_serverStatus != SERVER_STARTED)) {
@@ -953,18 +1618,45 @@ struct PCSX::WebClient::WebClientImpl {
     }
 
     void onEOF() {
+        if (m_webSocket) {
+            close();
+            return;
+        }
         auto error = llhttp_finish(&m_httpParser);
-        if (error == HPE_PAUSED_UPGRADE) {
-            onUpgrade();
-        } else if (error != HPE_OK) {
+        if ((error != HPE_OK) && (error != HPE_PAUSED) && (error != HPE_PAUSED_UPGRADE)) {
             send400(magic_enum::enum_name(error));
         } else {
             scheduleClose();
         }
     }
 
-    void onUpgrade() {}
-    int onMessageBegin() { return 0; }
+    // The parser stops right after a request asking for a protocol upgrade.
+    // Whatever follows it belongs to the new protocol, if the executor
+    // accepted it.
+    void onUpgrade(const char* end) {
+        if (!m_webSocket) {
+            scheduleClose();
+            return;
+        }
+        const char* rest = llhttp_get_error_pos(&m_httpParser);
+        if (rest && (rest < end)) {
+            Slice slice;
+            slice.borrow(rest, end - rest);
+            processWebSocket(slice);
+        }
+    }
+    int onMessageBegin() {
+        // Clear what the previous request on this connection left behind.
+        m_requestData = RequestData();
+        m_currentHeader.clear();
+        m_currentValue.clear();
+        m_currentFormHeader.clear();
+        m_currentFormValue.clear();
+        m_headerState = PARSING_HEADER;
+        m_formHeaderState = PARSING_HEADER;
+        m_multipart = false;
+        return 0;
+    }
     int onUrl(const Slice& slice) {
         UriUriA uri;
         std::string urlString = slice.asString();
@@ -1095,7 +1787,8 @@ struct PCSX::WebClient::WebClientImpl {
             multipart_parser_free(m_multipartParser);
         }
         executeRequest();
-        return 0;
+        // Don't parse any pipelined request past one we're closing after.
+        return m_closeRequested ? HPE_PAUSED : 0;
     }
     int onChunkHeader() { return 0; }
     int onChunkComplete() { return 0; }
@@ -1113,7 +1806,11 @@ struct PCSX::WebClient::WebClientImpl {
         }
         Slice slice;
         slice.borrow(m_buffer, nread);
-        processData(slice);
+        if (m_webSocket) {
+            processWebSocket(slice);
+        } else {
+            processData(slice);
+        }
     }
     static void closeCB(uv_handle_t* handle) {
         WebClientImpl* client = static_cast<WebClientImpl*>(handle->data);
@@ -1126,12 +1823,104 @@ struct PCSX::WebClient::WebClientImpl {
         auto error = llhttp_execute(&m_httpParser, ptr, size);
         if (m_status != OPEN) return;
         if (error == HPE_PAUSED_UPGRADE) {
-            onUpgrade();
-        } else if (error != HPE_OK) {
+            onUpgrade(ptr + size);
+        } else if ((error != HPE_OK) && (error != HPE_PAUSED)) {
             send400(magic_enum::enum_name(error));
         }
     }
 
+    void processWebSocket(const Slice& slice) {
+        m_webSocketBuffer.append(slice.data<char>(), slice.size());
+        while (m_status == OPEN) {
+            const uint8_t* frame = reinterpret_cast<const uint8_t*>(m_webSocketBuffer.data());
+            const size_t available = m_webSocketBuffer.size();
+            if (available < 2) return;
+            const bool fin = frame[0] & 0x80;
+            const unsigned opcode = frame[0] & 0x0f;
+            const bool masked = frame[1] & 0x80;
+            uint64_t length = frame[1] & 0x7f;
+            size_t header = 2;
+            if (length == 126) {
+                if (available < 4) return;
+                length = (frame[2] << 8) | frame[3];
+                header = 4;
+            } else if (length == 127) {
+                if (available < 10) return;
+                length = 0;
+                for (unsigned i = 0; i < 8; i++) length = (length << 8) | frame[2 + i];
+                header = 10;
+            }
+            // Clients always have to mask their frames.
+            if (!masked || (length > c_maxWebSocketMessage)) {
+                sendWebSocketClose(masked ? 1009 : 1002);
+                return;
+            }
+            if (available < (header + 4 + length)) return;
+            const uint8_t* mask = frame + header;
+            std::string payload(reinterpret_cast<const char*>(mask + 4), length);
+            for (size_t i = 0; i < length; i++) payload[i] ^= mask[i & 3];
+            m_webSocketBuffer.erase(0, header + 4 + length);
+
+            switch (opcode) {
+                case 0x0:
+                case 0x1:
+                case 0x2:
+                    if (opcode != 0x0) {
+                        m_webSocketMessage.clear();
+                        m_webSocketBinary = opcode == 0x2;
+                    }
+                    m_webSocketMessage += payload;
+                    if (m_webSocketMessage.size() > c_maxWebSocketMessage) {
+                        sendWebSocketClose(1009);
+                        return;
+                    }
+                    if (fin) {
+                        m_webSocket->onMessage(m_parent, Slice(std::move(m_webSocketMessage)), m_webSocketBinary);
+                        m_webSocketMessage.clear();
+                    }
+                    break;
+                case 0x8:
+                    sendWebSocketClose(1000);
+                    return;
+                case 0x9:
+                    sendWebSocketFrame(0xa, Slice(std::move(payload)));
+                    break;
+                case 0xa:
+                    break;
+                default:
+                    sendWebSocketClose(1002);
+                    return;
+            }
+        }
+    }
+
+    void sendWebSocketFrame(unsigned opcode, Slice&& payload) {
+        if ((m_status != OPEN) || m_closeScheduled) return;
+        const uint64_t length = payload.size();
+        std::string header;
+        header += char(0x80 | opcode);
+        if (length < 126) {
+            header += char(length);
+        } else if (length < 65536) {
+            header += char(126);
+            header += char(length >> 8);
+            header += char(length);
+        } else {
+            header += char(127);
+            for (int shift = 56; shift >= 0; shift -= 8) header += char(length >> shift);
+        }
+        write(std::move(header));
+        if (length != 0) write(std::move(payload));
+    }
+
+    void sendWebSocketClose(uint16_t code) {
+        std::string payload;
+        payload += char(code >> 8);
+        payload += char(code);
+        sendWebSocketFrame(0x8, Slice(std::move(payload)));
+        scheduleClose();
+    }
+
     template <size_t L>
     void write(const char (&str)[L]) {
         static_assert((L - 1) <= std::numeric_limits<uint32_t>::max());
@@ -1141,10 +1930,136 @@ struct PCSX::WebClient::WebClientImpl {
     }
 
     void write(Slice&& slice) {
+        if (m_gathering) {
+            gather(std::move(slice));
+            return;
+        }
         auto* req = new WriteRequest(std::move(slice));
         req->enqueue(this);
     }
 
+    void gather(Slice&& slice) {
+        if (m_responseHeadComplete) {
+            m_responseBodySize += slice.size();
+            m_responseBody.push_back(std::move(slice));
+            return;
+        }
+        // The end of the headers may be split across two writes.
+        const size_t searchFrom = m_responseHead.size() >= 3 ? m_responseHead.size() - 3 : 0;
+        m_responseHead.append(slice.data<char>(), slice.size());
+        auto end = m_responseHead.find("\r\n\r\n", searchFrom);
+        if (end == std::string::npos) return;
+        m_responseHeadComplete = true;
+        end += 4;
+        if (end < m_responseHead.size()) {
+            m_responseBodySize = m_responseHead.size() - end;
+            m_responseBody.emplace_back(m_responseHead.substr(end));
+            m_responseHead.resize(end);
+        }
+    }
+
+    static bool hasHeader(std::string_view head, std::string_view name) {
+        size_t pos = 0;
+        while ((pos = head.find("\r\n", pos)) != std::string_view::npos) {
+            pos += 2;
+            auto line = head.substr(pos, name.size() + 1);
+            if ((line.size() == (name.size() + 1)) && (line.back() == ':') &&
+                StringsHelpers::strcasecmp(line.substr(0, name.size()), name)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Frames the gathered response, so the connection can be reused after it.
+    void flushResponse() {
+        m_gathering = false;
+        if (m_responseHeadComplete) {
+            unsigned status = 0;
+            if (m_responseHead.size() > 12) {
+                std::from_chars(m_responseHead.data() + 9, m_responseHead.data() + 12, status);
+            }
+            const bool bodyless = ((status >= 100) && (status < 200)) || (status == 204) || (status == 304);
+            std::string extra;
+            if (!bodyless && !hasHeader(m_responseHead, "Content-Length") &&
+                !hasHeader(m_responseHead, "Transfer-Encoding")) {
+                extra += fmt::format("Content-Length: {}\r\n", m_responseBodySize);
+            }
+            if ((status != 101) && !hasHeader(m_responseHead, "Connection")) {
+                extra += m_keepAlive ? "Connection: keep-alive\r\n" : "Connection: close\r\n";
+            }
+            m_responseHead.insert(m_responseHead.size() - 2, extra);
+        }
+        if (!m_responseHead.empty()) write(std::move(m_responseHead));
+        for (auto& slice : m_responseBody) write(std::move(slice));
+        m_responseHead.clear();
+        m_responseBody.clear();
+        m_responseBodySize = 0;
+        m_responseHeadComplete = false;
+    }
+
+    void beginChunked(std::string_view contentType) {
+        // Chunked framing delimits the body by itself, so the chunks can go
+        // out as they come instead of being gathered until the executor returns.
+        flushResponse();
+        m_chunked = true;
+        write(fmt::format("HTTP/1.1 200 OK\r\nContent-Type: {}\r\nTransfer-Encoding: chunked\r\nConnection: {}\r\n\r\n",
+                          contentType, m_keepAlive ? "keep-alive" : "close"));
+    }
+
+    void writeChunk(Slice&& slice) {
+        // An empty chunk would end the stream.
+        if (slice.size() == 0) return;
+        write(fmt::format("{:x}\r\n", slice.size()));
+        write(std::move(slice));
+        write("\r\n");
+    }
+
+    void endChunked() { write("0\r\n\r\n"); }
+
+    static std::string base64(const uint8_t* data, size_t size) {
+        static constexpr char c_alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        std::string ret;
+        for (size_t i = 0; i < size; i += 3) {
+            uint32_t triplet = data[i] << 16;
+            if ((i + 1) < size) triplet |= data[i + 1] << 8;
+            if ((i + 2) < size) triplet |= data[i + 2];
+            ret += c_alphabet[(triplet >> 18) & 0x3f];
+            ret += c_alphabet[(triplet >> 12) & 0x3f];
+            ret += ((i + 1) < size) ? c_alphabet[(triplet >> 6) & 0x3f] : '=';
+            ret += ((i + 2) < size) ? c_alphabet[triplet & 0x3f] : '=';
+        }
+        return ret;
+    }
+
+    bool acceptWebSocket(const RequestData& request, std::unique_ptr<WebSocketHandler> handler) {
+        auto findHeader = [&request](std::string_view name) -> std::optional<std::string_view> {
+            for (auto& header : request.headers) {
+                if (StringsHelpers::strcasecmp(header.first, name)) return StringsHelpers::trim(header.second);
+            }
+            return std::nullopt;
+        };
+        auto key = findHeader("Sec-WebSocket-Key");
+        auto upgrade = findHeader("Upgrade");
+        if ((request.method != RequestData::Method::HTTP_HTTP_GET) || !llhttp_get_upgrade(&m_httpParser) ||
+            !key.has_value() || !upgrade.has_value() || !StringsHelpers::strcasecmp(upgrade.value(), "websocket")) {
+            write("HTTP/1.1 400 Bad Request\r\n\r\nExpected a WebSocket upgrade request.\r\n");
+            return false;
+        }
+        static constexpr std::string_view c_guid = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+        uint8_t digest[20];
+        SHA1 sha1;
+        sha1.update(key->data(), key->size());
+        sha1.update(c_guid.data(), c_guid.size());
+        sha1.finish(digest);
+        write(fmt::format(
+            "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+            "Sec-WebSocket-Accept: {}\r\n\r\n",
+            base64(digest, sizeof(digest))));
+        m_webSocket = std::move(handler);
+        return true;
+    }
+
     void write(std::string&& str) {
         Slice slice(std::move(str));
         write(std::move(slice));
@@ -1177,11 +2092,18 @@ struct PCSX::WebClient::WebClientImpl {
     }
     int executeRequest() {
         m_requestData.method = static_cast<RequestData::Method>(m_httpParser.method);
+        m_keepAlive = llhttp_should_keep_alive(&m_httpParser);
+        m_gathering = true;
+        m_chunked = false;
         m_currentExecutor->execute(m_parent, m_requestData);
-        scheduleClose();
+        // Executors which didn't answer rely on the connection closing.
+        const bool answered = m_chunked || !m_responseHead.empty();
+        flushResponse();
+        if ((!m_keepAlive || !answered) && !m_webSocket) scheduleClose();
         return 0;
     }
     void scheduleClose() {
+        m_closeRequested = true;
         if (m_requests.size() == 0) {
             close();
         } else {
@@ -1217,11 +2139,35 @@ struct PCSX::WebClient::WebClientImpl {
     multipart_parser_settings m_multipartParserCallbacks;
 
     bool m_closeScheduled = false;
+    bool m_closeRequested = false;
+
+    bool m_keepAlive = false;
+    bool m_gathering = false;
+    bool m_chunked = false;
+    bool m_responseHeadComplete = false;
+    std::string m_responseHead;
+    std::vector<Slice> m_responseBody;
+    size_t m_responseBodySize = 0;
+
+    static constexpr size_t c_maxWebSocketMessage = 16 * 1024 * 1024;
+    std::unique_ptr<WebSocketHandler> m_webSocket;
+    std::string m_webSocketBuffer;
+    std::string m_webSocketMessage;
+    bool m_webSocketBinary = false;
 };
 
 PCSX::WebClient::WebClient(WebServer* server) : m_impl(std::make_unique<WebClientImpl>(server, this)) {}
 void PCSX::WebClient::close() { m_impl->close(); }
 bool PCSX::WebClient::accept(uv_tcp_t* srv) { return m_impl->accept(srv); }
+void PCSX::WebClient::beginChunked(std::string_view contentType) { m_impl->beginChunked(contentType); }
+void PCSX::WebClient::writeChunk(Slice&& slice) { m_impl->writeChunk(std::move(slice)); }
+void PCSX::WebClient::endChunked() { m_impl->endChunked(); }
+bool PCSX::WebClient::acceptWebSocket(const RequestData& request, std::unique_ptr<WebSocketHandler> handler) {
+    return m_impl->acceptWebSocket(request, std::move(handler));
+}
+void PCSX::WebClient::sendWebSocket(Slice&& message, bool binary) {
+    m_impl->sendWebSocketFrame(binary ? 0x2 : 0x1, std::move(message));
+}
 void PCSX::WebClient::write(Slice&& slice) { m_impl->write(std::move(slice)); }
 void PCSX::WebClient::write(std::string&& str) { m_impl->write(std::move(str)); }
 void PCSX::WebClient::write(const std::string& str) { m_impl->write(str); }
@@ -98,12 +98,34 @@ class WebExecutor : public Intrusive::List<WebExecutor>::Node {
     void write200(WebClient* client, const nlohmann::json& j);
 };
 
+// Receives the messages of a connection upgraded to a WebSocket. It is owned
+// by the client, and destroyed along with it.
+class WebSocketHandler {
+  public:
+    virtual ~WebSocketHandler() = default;
+    virtual void onMessage(WebClient* client, Slice&& message, bool binary) = 0;
+};
+
+// Connections are kept alive between requests when the client asks for it.
+// Everything an executor writes while handling a request is gathered, and
+// the response is given a Content-Length if it has neither one nor chunked
+// framing, so executors can keep writing bodies of unknown size.
 class WebClient : public Intrusive::List<WebClient>::Node {
   public:
     WebClient(WebServer* server);
     typedef Intrusive::List<WebClient> ListType;
     void close();
     bool accept(uv_tcp_t* srv);
+    // Chunked transfer encoding, for streaming large payloads piecewise. The
+    // chunks are written out directly rather than gathered.
+    void beginChunked(std::string_view contentType);
+    void writeChunk(Slice&& slice);
+    void endChunked();
+    // Completes the WebSocket handshake of the request, and hands all of the
+    // following traffic to the handler. Answers 400 and returns false if the
+    // request isn't a valid WebSocket upgrade.
+    bool acceptWebSocket(const RequestData& request, std::unique_ptr<WebSocketHandler> handler);
+    void sendWebSocket(Slice&& message, bool binary = false);
     void write(Slice&& slice);
     template <size_t L>
     void write(const char (&str)[L]) {
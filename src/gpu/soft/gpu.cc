@@ -212,6 +212,10 @@ void PCSX::SoftGPU::impl::updateDisplayIfChanged() {
 void PCSX::SoftGPU::impl::vblank(bool fromGui) {
     m_statusRet ^= 0x80000000;  // odd/even bit
 
+    // nothing to display to, or a skipped frame, which leaves any pending
+    // update to the next presented one
+    if (g_system->headless() || !g_emulator->presentingFrame()) return;
+
     if (m_softDisplay.Interlaced) {
         // interlaced mode?
         if (m_doVSyncUpdate && m_softDisplay.DisplayMode.x > 0 && m_softDisplay.DisplayMode.y > 0) {
@@ -54,12 +54,14 @@ extern "C" {
 #include "core/gdb-server.h"
 #include "core/gpu.h"
 #include "core/gpulogger.h"
+#include "core/memory-export.h"
 #include "core/pad.h"
 #include "core/psxemulator.h"
 #include "core/psxmem.h"
 #include "core/r3000a.h"
 #include "core/sio1-server.h"
 #include "core/sio1.h"
+#include "core/sstate-io.h"
 #include "core/sstate.h"
 #include "core/web-server.h"
 #include "flags.h"
@@ -1406,6 +1408,7 @@ in Configuration->Emulation, restart PCSX-Redux, then try again.)"));
                         ImGui::EndMenu();
                     }
                     ImGui::MenuItem(_("Show Memory Observer"), nullptr, &m_memoryObserver.m_show);
+                    ImGui::MenuItem(_("Show Access Map"), nullptr, &m_accessMap.m_show);
                     ImGui::MenuItem(_("Show Typed Debugger"), nullptr, &m_typedDebugger.m_show);
                     ImGui::MenuItem(_("Show Patches"), nullptr, &m_patches.m_show);
                     ImGui::MenuItem(_("Show Interrupts Scaler"), nullptr, &m_showInterruptsScaler);
@@ -1692,6 +1695,10 @@ in Configuration->Emulation, restart PCSX-Redux, then try again.)"));
         m_memoryObserver.draw(_("Memory Observer"));
     }
 
+    if (m_accessMap.m_show) {
+        m_accessMap.draw(_("Access Map"));
+    }
+
     if (m_typedDebugger.m_show) {
         m_typedDebugger.draw(_("Typed Debugger"), this);
     }
@@ -1783,6 +1790,50 @@ their TV set to match the aspect ratio of the game.)"));
         if (ImGui::Begin(_("System Configuration"), &m_showSysCfg)) {
             changed |=
                 ImGui::Checkbox(_("Preload Disk Image files"), &emuSettings.get<Emulator::SettingFullCaching>().value);
+            changed |= ImGui::Checkbox(_("Read ahead Disk Image sectors"),
+                                       &emuSettings.get<Emulator::SettingReadAhead>().value);
+            ImGuiHelpers::ShowHelpMarker(_(R"(Decodes disk image sectors in the background,
+ahead of the emulated CD-ROM drive, when it reads
+sequentially. This helps with images stored on slow
+media, or in compressed formats such as ECM or PBP.
+
+Takes effect the next time a disk image is opened.)"));
+            changed |= ImGui::Checkbox(_("Save ECM image indexes"),
+                                       &emuSettings.get<Emulator::SettingECMIndexFile>().value);
+            ImGuiHelpers::ShowHelpMarker(_(R"(Seeking in ECM images requires an index of the
+image, which is built in the background when the
+image is opened. When enabled, the index is saved
+in a .idx file next to the image, so it can be
+reused the next time the image is opened.)"));
+            changed |= ImGui::Checkbox(_("Enable rewind"), &emuSettings.get<Emulator::SettingRewind>().value);
+            ImGuiHelpers::ShowHelpMarker(_(R"(Keeps snapshots of the emulation in memory, so
+it can be stepped backwards and forwards, from
+Lua or the web server. Only the differences
+between snapshots are stored, but they still
+cost some time to take, every few frames.)"));
+            changed |= ImGui::SliderInt(_("Frames between rewind snapshots"),
+                                        &emuSettings.get<Emulator::SettingRewindInterval>().value, 1, 120);
+            changed |= ImGui::SliderInt(_("Rewind snapshots"), &emuSettings.get<Emulator::SettingRewindCount>().value,
+                                        10, 3600);
+            changed |= ImGui::SliderInt(_("Rewind snapshots between keyframes"),
+                                        &emuSettings.get<Emulator::SettingRewindKeyframeInterval>().value, 1, 120);
+            auto& currentCodec = emuSettings.get<Emulator::SettingSaveStateCodec>().value;
+            if (ImGui::BeginCombo(_("Save state compression"), magic_enum::enum_name(currentCodec).data())) {
+                for (auto v : magic_enum::enum_values<Emulator::SaveStateCodec>()) {
+                    bool selected = (v == currentCodec);
+                    if (ImGui::Selectable(magic_enum::enum_name(v).data(), selected)) {
+                        currentCodec = v;
+                        changed = true;
+                    }
+                    if (selected) ImGui::SetItemDefaultFocus();
+                }
+                ImGui::EndCombo();
+            }
+            ImGuiHelpers::ShowHelpMarker(_(R"(Save states are compressed and written in the
+background, but the compression still costs
+some CPU time. FastGZip trades some file size
+for speed, and Uncompressed skips it entirely.
+Either kind of file can always be loaded.)"));
             changed |= ImGui::Checkbox(_("Enable Auto Update"), &emuSettings.get<Emulator::SettingAutoUpdate>().value);
         }
         ImGui::End();
@@ -2098,6 +2149,11 @@ bool PCSX::GUI::configure() {
         scale /= 100.0f;
         changed |= ImGui::SliderFloat(_("Speed Scaler"), &scale, 0.1f, 25.0f);
         settings.get<Emulator::SettingScaler>() = scale * 100.0f;
+        changed |= ImGui::Checkbox(_("Unthrottled"), &settings.get<Emulator::SettingUnthrottled>().value);
+        ImGuiHelpers::ShowHelpMarker(_(R"(Runs the emulation as fast as possible, instead of
+pacing it with the audio output at the speed set above.
+Audio will be choppy, and frames are only displayed
+as often as the screen refreshes.)"));
         changed |= ImGui::Checkbox(_("Enable XA decoder"), &settings.get<Emulator::SettingXa>().value);
         changed |= ImGui::Checkbox(_("Always enable SPU IRQ"), &settings.get<Emulator::SettingSpuIrq>().value);
         changed |= ImGui::Checkbox(_("Decode MDEC videos in B&W"), &settings.get<Emulator::SettingBnWMdec>().value);
@@ -2111,7 +2167,8 @@ bool PCSX::GUI::configure() {
 
         ImGuiHelpers::ShowHelpMarker(_(R"(Activates the dynamic recompiler CPU core.
 It is significantly faster than the interpreted CPU,
-however it doesn't play nicely with the debugger.
+however it only supports the debugger's breakpoints,
+and not stepping nor the memory maps.
 Changing this setting requires a reboot to take effect.
 The dynarec core isn't available for all CPUs, so
 this setting may not have any effect for you.)"));
@@ -2232,6 +2289,19 @@ query using a REST api. See the wiki for details.
 The debugger might be required in some cases.)"));
         changed |=
             ImGui::InputInt(_("Web Server Port"), &debugSettings.get<Emulator::DebugSettings::WebServerPort>().value);
+        if (ImGui::Checkbox(_("Enable Shared Memory Export"),
+                            &debugSettings.get<Emulator::DebugSettings::SharedMemoryExport>().value)) {
+            changed = true;
+            if (debugSettings.get<Emulator::DebugSettings::SharedMemoryExport>()) {
+                g_emulator->m_memoryExport->enable();
+            } else {
+                g_emulator->m_memoryExport->disable();
+            }
+        }
+        ImGuiHelpers::ShowHelpMarker(_(R"(This will export the scratchpad, registers,
+VRAM and SPU RAM into a shared memory segment,
+refreshed every frame, alongside the main RAM,
+for external tools to read. See the wiki for details.)"));
         if (ImGui::Checkbox(_("Enable SIO1 Server"), &debugSettings.get<Emulator::DebugSettings::SIO1Server>().value)) {
             changed = true;
             if (debugSettings.get<Emulator::DebugSettings::SIO1Server>()) {
@@ -2331,14 +2401,14 @@ See the wiki for details.)"));
     }
     if (showDynarecDebugWarning && showDynarecWarning) {
         addNotification(R"(Debugger and dynarec enabled at the same time.
-Consider turning either one off, otherwise
-debugging features may not work. Additionally,
+Breakpoints will work, but consider turning the
+dynarec off for stepping and the memory maps. Additionally,
 changing the dynarec option requires a restart
 of the emulator to take effect.)");
     } else if (showDynarecDebugWarning) {
         addNotification(R"(Debugger and dynarec enabled at the same time.
-Consider turning either one off, otherwise
-debugging features may not work.)");
+Breakpoints will work, but consider turning the
+dynarec off for stepping and the memory maps.)");
     } else if (showDynarecWarning) {
         addNotification(R"(Toggling the Dynarec option requires a restart
 of the emulator to take effect.)");
@@ -2715,44 +2785,18 @@ std::string PCSX::GUI::buildSaveStateFilename(std::string saveStateName) {
     return fmt::format("{}{}{}", getSaveStatePrefix(true), saveStateName, getSaveStatePostfix());
 }
 
-bool PCSX::GUI::saveSaveState(std::filesystem::path filename) {
+bool PCSX::GUI::saveSaveState(std::filesystem::path filename, bool wait) {
     if (filename.is_relative()) {
         filename = g_system->getPersistentDir() / filename;
     }
-    // TODO: yeet this to libuv's threadpool.
-    ZWriter save(new UvFile(filename, FileOps::TRUNCATE), ZWriter::GZIP);
-    bool success = !save.failed();
-    if (success) save.writeString(SaveStates::save());
-    save.close();
-    return success;
+    return g_emulator->m_saveStateIO->save(filename, wait);
 }
 
-bool PCSX::GUI::loadSaveState(std::filesystem::path filename) {
+bool PCSX::GUI::loadSaveState(std::filesystem::path filename, bool wait) {
     if (filename.is_relative()) {
         filename = g_system->getPersistentDir() / filename;
     }
-    ZReader save(new PosixFile(filename));
-    if (save.failed()) return false;
-    std::ostringstream os;
-    constexpr unsigned buff_size = 1 << 16;
-    char* buff = new char[buff_size];
-    bool error = false;
-
-    while (!save.eof()) {
-        auto cnt = save.read(buff, buff_size);
-        if (cnt == 0) break;
-        if (cnt < 0) {
-            error = true;
-            break;
-        }
-        os.write(buff, cnt);
-    }
-
-    save.close();
-    delete[] buff;
-
-    if (!error) SaveStates::load(os.str());
-    return !error;
+    return g_emulator->m_saveStateIO->load(filename, wait);
 }
 
 bool PCSX::GUI::deleteSaveState(std::filesystem::path filename) {
@@ -2762,9 +2806,13 @@ bool PCSX::GUI::deleteSaveState(std::filesystem::path filename) {
     return std::remove(filename.string().c_str()) == 0;
 }
 
-bool PCSX::GUI::saveSaveStateSlot(uint32_t slot) { return saveSaveState(buildSaveStateFilename(slot)); }
+bool PCSX::GUI::saveSaveStateSlot(uint32_t slot, bool wait) {
+    return saveSaveState(buildSaveStateFilename(slot), wait);
+}
 
-bool PCSX::GUI::loadSaveStateSlot(uint32_t slot) { return loadSaveState(buildSaveStateFilename(slot)); }
+bool PCSX::GUI::loadSaveStateSlot(uint32_t slot, bool wait) {
+    return loadSaveState(buildSaveStateFilename(slot), wait);
+}
 
 bool PCSX::GUI::deleteSaveStateSlot(uint32_t slot) { return deleteSaveState(buildSaveStateFilename(slot)); }
 
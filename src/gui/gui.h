@@ -36,6 +36,7 @@
 #include "core/ui.h"
 #include "flags.h"
 #include "fmt/printf.h"
+#include "gui/widgets/access_map.h"
 #include "gui/widgets/assembly.h"
 #include "gui/widgets/breakpoints.h"
 #include "gui/widgets/callstacks.h"
@@ -113,6 +114,7 @@ class GUI final : public UI {
     typedef Setting<bool, TYPESTRING("ShowSIO1")> ShowSIO1;
     typedef Setting<bool, TYPESTRING("ShowIsoBrowser")> ShowIsoBrowser;
     typedef Setting<bool, TYPESTRING("ShowGPULogger")> ShowGPULogger;
+    typedef Setting<bool, TYPESTRING("ShowAccessMap")> ShowAccessMap;
     typedef Setting<int, TYPESTRING("WindowPosX"), 0> WindowPosX;
     typedef Setting<int, TYPESTRING("WindowPosY"), 0> WindowPosY;
     typedef Setting<int, TYPESTRING("WindowSizeX"), 1280> WindowSizeX;
@@ -157,11 +159,11 @@ class GUI final : public UI {
              ShowCLUTVRAMViewer, ShowVRAMViewer1, ShowVRAMViewer2, ShowVRAMViewer3, ShowVRAMViewer4, ShowMemoryObserver,
              ShowTypedDebugger, ShowPatches, ShowMemcardManager, ShowRegisters, ShowAssembly, ShowDisassembly,
              ShowBreakpoints, ShowNamedSaveStates, ShowEvents, ShowHandlers, ShowKernelLog, ShowCallstacks, ShowSIO1,
-             ShowIsoBrowser, ShowGPULogger, MainFontSize, MonoFontSize, GUITheme, AllowMouseCaptureToggle,
-             EnableRawMouseMotion, WidescreenRatio, ShowPIOCartConfig, ShowMemoryEditor1, ShowMemoryEditor2,
-             ShowMemoryEditor3, ShowMemoryEditor4, ShowMemoryEditor5, ShowMemoryEditor6, ShowMemoryEditor7,
-             ShowMemoryEditor8, ShowParallelPortEditor, ShowScratchpadEditor, ShowHWRegsEditor, ShowBiosEditor,
-             ShowVRAMEditor, MemoryEditor1Addr, MemoryEditor2Addr, MemoryEditor3Addr, MemoryEditor4Addr,
+             ShowIsoBrowser, ShowGPULogger, ShowAccessMap, MainFontSize, MonoFontSize, GUITheme,
+             AllowMouseCaptureToggle, EnableRawMouseMotion, WidescreenRatio, ShowPIOCartConfig, ShowMemoryEditor1,
+             ShowMemoryEditor2, ShowMemoryEditor3, ShowMemoryEditor4, ShowMemoryEditor5, ShowMemoryEditor6,
+             ShowMemoryEditor7, ShowMemoryEditor8, ShowParallelPortEditor, ShowScratchpadEditor, ShowHWRegsEditor,
+             ShowBiosEditor, ShowVRAMEditor, MemoryEditor1Addr, MemoryEditor2Addr, MemoryEditor3Addr, MemoryEditor4Addr,
              MemoryEditor5Addr, MemoryEditor6Addr, MemoryEditor7Addr, MemoryEditor8Addr, ParallelPortEditorAddr,
              ScratchpadEditorAddr, HWRegsEditorAddr, BiosEditorAddr, VRAMEditorAddr>
         settings;
@@ -365,6 +367,7 @@ class GUI final : public UI {
     MemoryEditorWrapper m_vramEditor = {this, settings.get<ShowVRAMEditor>().value,
                                         settings.get<VRAMEditorAddr>().value};
     Widgets::MemoryObserver m_memoryObserver = {settings.get<ShowMemoryObserver>().value};
+    Widgets::AccessMap m_accessMap = {settings.get<ShowAccessMap>().value};
     Widgets::TypedDebugger m_typedDebugger;
     Widgets::Patches m_patches = {settings.get<ShowPatches>().value};
     Widgets::MemcardManager m_memcardManager;
@@ -407,11 +410,12 @@ class GUI final : public UI {
     EventBus::Listener m_listener;
 
   public:
-    bool saveSaveState(std::filesystem::path filename);
-    bool loadSaveState(std::filesystem::path filename);
+    // These queue the I/O, unless `wait` is set; see SaveStateIO.
+    bool saveSaveState(std::filesystem::path filename, bool wait = false);
+    bool loadSaveState(std::filesystem::path filename, bool wait = false);
     bool deleteSaveState(std::filesystem::path filename);
-    bool saveSaveStateSlot(uint32_t slot);
-    bool loadSaveStateSlot(uint32_t slot);
+    bool saveSaveStateSlot(uint32_t slot, bool wait = false);
+    bool loadSaveStateSlot(uint32_t slot, bool wait = false);
     bool deleteSaveStateSlot(uint32_t slot);
     std::string getSaveStatePrefix(bool includeSeparator);
     static std::string getSaveStatePostfix();
@@ -0,0 +1,113 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "gui/widgets/access_map.h"
+
+#include <algorithm>
+
+#include "core/accesstracker.h"
+#include "core/psxemulator.h"
+#include "core/system.h"
+#include "fmt/format.h"
+#include "imgui.h"
+
+void PCSX::Widgets::AccessMap::draw(const char* title) {
+    ImGui::SetNextWindowPos(ImVec2(520, 30), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowSize(ImVec2(560, 360), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin(title, &m_show)) {
+        ImGui::End();
+        return;
+    }
+
+    using Access = AccessTracker::Access;
+    auto& tracker = g_emulator->m_accessTracker;
+    bool enabled = tracker->enabled();
+    if (ImGui::Checkbox(_("Enable tracking"), &enabled)) tracker->setEnabled(enabled);
+    ImGui::SameLine();
+    if (ImGui::Button(_("Clear"))) tracker->clear();
+    ImGui::SameLine();
+    ImGui::Checkbox(_("Write"), &m_showAccess[static_cast<unsigned>(Access::Write)]);
+    ImGui::SameLine();
+    ImGui::Checkbox(_("Read"), &m_showAccess[static_cast<unsigned>(Access::Read)]);
+    ImGui::SameLine();
+    ImGui::Checkbox(_("Exec"), &m_showAccess[static_cast<unsigned>(Access::Exec)]);
+    ImGui::SliderInt(_("Half-life (frames)"), &m_halfLife, 1, 600);
+    ImGui::SliderInt(_("Zoom"), &m_zoom, 1, 4);
+    ImGui::TextUnformatted(_("Red: write, green: read, blue: exec. Each pixel is 16 bytes of RAM, each row 8KB."));
+
+    const uint32_t lines = tracker->ramLines();
+    const unsigned height = lines / c_width;
+    if (m_textureHeight != height) {
+        if (m_texture == 0) glGenTextures(1, &m_texture);
+        glBindTexture(GL_TEXTURE_2D, m_texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, c_width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        m_textureHeight = height;
+    }
+
+    // The colors only depend on how long ago the lines were accessed, so the whole map gets recomputed each time.
+    m_pixels.resize(lines);
+    for (unsigned i = 0; i < AccessTracker::c_accessCount; i++) {
+        m_heat[i].resize(lines);
+        tracker->heat(static_cast<Access>(i), 0, lines, m_halfLife, m_heat[i].data());
+    }
+    const uint8_t* writes = m_heat[static_cast<unsigned>(Access::Write)].data();
+    const uint8_t* reads = m_heat[static_cast<unsigned>(Access::Read)].data();
+    const uint8_t* execs = m_heat[static_cast<unsigned>(Access::Exec)].data();
+    const uint32_t writeMask = m_showAccess[static_cast<unsigned>(Access::Write)] ? 0xff : 0;
+    const uint32_t readMask = m_showAccess[static_cast<unsigned>(Access::Read)] ? 0xff : 0;
+    const uint32_t execMask = m_showAccess[static_cast<unsigned>(Access::Exec)] ? 0xff : 0;
+    for (uint32_t i = 0; i < lines; i++) {
+        m_pixels[i] = (writes[i] & writeMask) | ((reads[i] & readMask) << 8) | ((execs[i] & execMask) << 16) |
+                      0xff000000;
+    }
+    glBindTexture(GL_TEXTURE_2D, m_texture);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, c_width, height, GL_RGBA, GL_UNSIGNED_BYTE, m_pixels.data());
+
+    ImGui::BeginChild("map", ImVec2(0, 0), false, ImGuiWindowFlags_HorizontalScrollbar);
+    const ImVec2 origin = ImGui::GetCursorScreenPos();
+    ImGui::Image(m_texture, ImVec2(c_width * m_zoom, height * m_zoom));
+    if (ImGui::IsItemHovered()) {
+        const ImVec2 mouse = ImGui::GetMousePos();
+        const unsigned x = std::min(unsigned((mouse.x - origin.x) / m_zoom), c_width - 1);
+        const unsigned y = std::min(unsigned((mouse.y - origin.y) / m_zoom), height - 1);
+        const uint32_t line = y * c_width + x;
+        const uint32_t address = 0x80000000 | (line << AccessTracker::c_lineShift);
+        const uint32_t now = tracker->now();
+        ImGui::BeginTooltip();
+        ImGui::Text("%08x - %08x", address, address + AccessTracker::c_lineSize - 1);
+        for (unsigned i = 0; i < AccessTracker::c_accessCount; i++) {
+            const auto access = static_cast<Access>(i);
+            const uint32_t stamp = tracker->lastAccess(access, line);
+            if (stamp == 0) {
+                ImGui::Text(_("%s: never"), AccessTracker::accessName(access));
+            } else {
+                ImGui::Text(_("%s: %u frames ago"), AccessTracker::accessName(access), now - stamp);
+            }
+        }
+        ImGui::TextUnformatted(_("Click to show in the memory editor"));
+        ImGui::EndTooltip();
+        if (ImGui::IsMouseClicked(ImGuiMouseButton_Left)) {
+            g_system->m_eventBus->signal(PCSX::Events::GUI::JumpToMemory{address, AccessTracker::c_lineSize});
+        }
+    }
+    ImGui::EndChild();
+    ImGui::End();
+}
@@ -0,0 +1,54 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "GL/gl3w.h"
+
+namespace PCSX {
+
+namespace Widgets {
+
+class AccessMap {
+  public:
+    AccessMap(bool& show) : m_show(show) {}
+    void draw(const char* title);
+
+    bool& m_show;
+
+  private:
+    // One pixel per line, with 8KB of RAM per row.
+    static constexpr unsigned c_width = 512;
+
+    GLuint m_texture = 0;
+    unsigned m_textureHeight = 0;
+    int m_halfLife = 15;
+    int m_zoom = 1;
+    bool m_showAccess[3] = {true, true, true};
+    std::vector<uint8_t> m_heat[3];
+    std::vector<uint32_t> m_pixels;
+};
+
+}  // namespace Widgets
+
+}  // namespace PCSX
@@ -550,8 +550,8 @@ bool PCSX::Widgets::Assembly::draw(GUI* gui, psxRegisters* registers, Memory* me
         if (g_emulator->settings.get<Emulator::SettingDynarec>() &&
             debugSettings.get<Emulator::DebugSettings::Debug>()) {
             gui->addNotification(R"(Debugger and dynarec enabled at the same time.
-Consider turning the dynarec off in the main Emulation
-settings, otherwise debugging features may not work.)");
+Breakpoints will work, but consider turning the dynarec
+off in the main Emulation settings for stepping.)");
         }
     }
     ImGui::SameLine();
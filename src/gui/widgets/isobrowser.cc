@@ -144,6 +144,12 @@ significantly by caching the files beforehand.)"));
 
     auto str = fmt::format(f_("Disc size: {} ({}) - CRC32: {:08x}"), iso->getTD(0), iso->getTD(0).toLBA(), m_fullCRC);
     ImGui::TextUnformatted(str.c_str());
+    if (iso->hasReadAhead()) {
+        auto stats = iso->getReadAheadStats();
+        str = fmt::format(f_("Read-ahead: {} hits, {} misses, {} prefetched, {} wasted"), stats.hits, stats.misses,
+                          stats.prefetched, stats.wasted);
+        ImGui::TextUnformatted(str.c_str());
+    }
     if (ImGui::BeginTable("Tracks", 5, ImGuiTableFlags_Resizable)) {
         ImGui::TableSetupColumn(_("Track"));
         ImGui::TableSetupColumn(_("Start"));
@@ -0,0 +1,357 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "main/batch.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+#include "cdrom/cdriso.h"
+#include "core/cdrom.h"
+#include "core/fork.h"
+#include "core/gpu.h"
+#include "core/lockstep.h"
+#include "core/psxemulator.h"
+#include "core/r3000a.h"
+#include "core/statehash.h"
+#include "core/system.h"
+#include "core/ui.h"
+#include "fmt/format.h"
+#include "json.hpp"
+#include "support/eventbus.h"
+#include "support/file.h"
+#include "support/uvfile.h"
+
+namespace {
+
+using json = nlohmann::json;
+
+std::string hashFrame() {
+    auto screenshot = PCSX::g_emulator->m_gpu->takeScreenShot();
+    uint32_t crc = crc32(0L, reinterpret_cast<const Bytef*>(screenshot.data.data()), screenshot.data.size());
+    return fmt::format("{:08x}", crc);
+}
+
+json hashState() {
+    const auto& digest = PCSX::g_emulator->m_stateHash->update();
+    json entry;
+    entry["hash"] = fmt::format("{:016x}", digest.hash);
+    for (unsigned i = 0; i < PCSX::StateHash::c_regionCount; i++) {
+        auto region = static_cast<PCSX::StateHash::Region>(i);
+        entry[PCSX::StateHash::regionName(region)] = fmt::format("{:016x}", digest.regionHashes[i]);
+    }
+    return entry;
+}
+
+// Finds the first state hash which doesn't match its expectation. The
+// expectations are either the entries of a previous report, in which case the
+// diverging regions are listed, or only their overall hashes.
+json findStateDivergence(const json& hashes, const json& expected) {
+    for (size_t i = 0; i < std::max(hashes.size(), expected.size()); i++) {
+        json divergence;
+        divergence["index"] = i;
+        if ((i >= hashes.size()) || (i >= expected.size())) return divergence;
+        const auto& actual = hashes[i];
+        const auto& wanted = expected[i];
+        const bool detailed = wanted.is_object();
+        if (actual["hash"] == (detailed ? wanted["hash"] : wanted)) continue;
+        if (!detailed) return divergence;
+        divergence["regions"] = json::array();
+        for (unsigned r = 0; r < PCSX::StateHash::c_regionCount; r++) {
+            const char* name = PCSX::StateHash::regionName(static_cast<PCSX::StateHash::Region>(r));
+            if (actual[name] != wanted.value(name, json())) divergence["regions"].push_back(name);
+        }
+        return divergence;
+    }
+    return json();
+}
+
+}  // namespace
+
+void PCSX::BatchRunner::loadManifest(const std::filesystem::path& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) throw std::runtime_error(fmt::format("Unable to open manifest {}", path.string()));
+    json manifest = json::parse(file);
+    if (!manifest.is_object() || !manifest["jobs"].is_array()) {
+        throw std::runtime_error("The manifest needs to be an object with a jobs array");
+    }
+    m_workers = std::max(manifest.value("workers", std::thread::hardware_concurrency()), 1u);
+    m_jobs.clear();
+    for (auto& entry : manifest["jobs"]) {
+        Job job;
+        job.name = entry.at("name").get<std::string>();
+        job.bios = entry.value("bios", std::string());
+        job.iso = entry.value("iso", std::string());
+        job.exe = entry.value("exe", std::string());
+        job.script = entry.value("script", std::string());
+        job.state = entry.value("state", std::string());
+        job.lockstep = entry.value("lockstep", false);
+        job.frames = entry.value("frames", 0u);
+        job.cycles = entry.value("cycles", uint64_t(0));
+        job.hashInterval = entry.value("hashInterval", 0u);
+        if (entry.contains("expectedHashes")) {
+            job.expectedHashes = entry["expectedHashes"].get<std::vector<std::string>>();
+        }
+        if (entry.contains("expectedStateHashes")) {
+            job.expectedStateHashes = entry["expectedStateHashes"];
+            if (!job.expectedStateHashes.is_array()) {
+                throw std::runtime_error(fmt::format("Job {} has malformed expectedStateHashes", job.name));
+            }
+        }
+        if (entry.contains("expectedExitCode")) job.expectedExitCode = entry["expectedExitCode"].get<int>();
+        if (!job.frames && !job.cycles) {
+            throw std::runtime_error(fmt::format("Job {} has neither a frame nor a cycle budget", job.name));
+        }
+        m_jobs.push_back(std::move(job));
+    }
+}
+
+// The children can't read anything through the parent's I/O thread, so all
+// of the images need to be fully in memory before forking.
+void PCSX::BatchRunner::preload() {
+    auto& settings = g_emulator->settings;
+    settings.get<Emulator::SettingFullCaching>() = true;
+    settings.get<Emulator::SettingReadAhead>() = false;
+    for (auto& job : m_jobs) {
+        if (job.iso.empty() || m_isos.contains(job.iso)) continue;
+        auto iso = std::make_shared<CDRIso>(job.iso);
+        if (iso->failed()) throw std::runtime_error(fmt::format("Unable to open disc image {}", job.iso.string()));
+        m_isos[job.iso] = iso;
+    }
+    m_isos[{}] = std::make_shared<CDRIso>(new FailedFile);
+
+    UvThreadOp::iterateOverAllOps([](UvThreadOp* f) {
+        if (!f->caching() && f->canCache()) f->startCaching();
+    });
+    bool cached = false;
+    while (!cached) {
+        cached = true;
+        UvThreadOp::iterateOverAllOps([&cached](UvThreadOp* f) {
+            if (f->caching() && (f->cacheProgress() < 1.0f)) cached = false;
+        });
+        if (!cached) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+void PCSX::BatchRunner::prepare(const Job& job) {
+    g_emulator->settings.get<Emulator::SettingBios>().value = job.bios.empty() ? m_defaultBios : job.bios;
+    g_emulator->m_cdrom->setIso(m_isos[job.iso]);
+    g_emulator->m_cdrom->check();
+    g_system->hardReset();
+}
+
+void PCSX::BatchRunner::startJob(const Job& job) {
+    if (!job.state.empty()) {
+        if (!Lockstep::loadCheckpoint(job.state)) {
+            throw std::runtime_error(fmt::format("Unable to load save state {}", job.state.string()));
+        }
+    } else if (!job.exe.empty()) {
+        m_ui->m_exeToLoad.set(job.exe.u8string());
+    }
+    if (!job.script.empty()) {
+        auto& L = g_emulator->m_lua;
+        L->load("return function(name) Support.extra.dofile(name) end", "internal:dofile.lua");
+        L->push(job.script.string());
+        L->pcall(1);
+        L->pop(L->gettop());
+    }
+}
+
+// Runs within the child, and returns the json report of the job.
+std::string PCSX::BatchRunner::runJob(const Job& job) {
+    if (job.lockstep) return runLockstepJob(job);
+    auto& regs = g_emulator->m_cpu->m_regs;
+    const uint64_t startCycle = regs.cycle;
+    unsigned frames = 0;
+    std::vector<std::string> hashes;
+    json stateHashes = json::array();
+
+    EventBus::Listener listener(g_emulator->m_eventBus);
+    listener.listen<Events::GPU::VSync>([&](const auto& event) {
+        frames++;
+        if (job.hashInterval && !(frames % job.hashInterval)) {
+            hashes.push_back(hashFrame());
+            stateHashes.push_back(hashState());
+        }
+        if (job.cycles && ((regs.cycle - startCycle) >= job.cycles)) g_system->pause();
+    });
+
+    // Resuming first, so that the binary loader doesn't pause the emulation
+    // once it's done.
+    g_system->resume();
+    startJob(job);
+
+    const auto start = std::chrono::steady_clock::now();
+    g_emulator->m_fork->runFrames(job.frames ? job.frames : std::numeric_limits<unsigned>::max());
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (!job.hashInterval) {
+        hashes.push_back(hashFrame());
+        stateHashes.push_back(hashState());
+    }
+
+    const uint64_t cycles = regs.cycle - startCycle;
+    json report;
+    report["frames"] = frames;
+    report["emulatedCycles"] = cycles;
+    report["emulationTime"] = elapsed;
+    report["cyclesPerSecond"] = elapsed > 0.0 ? cycles / elapsed : 0.0;
+    report["frameHashes"] = hashes;
+    report["stateHashes"] = stateHashes;
+    report["quit"] = g_system->quitting();
+    report["exitCode"] = g_system->quitting() ? g_system->exitCode() : 0;
+    return report.dump();
+}
+
+// The harness replays every slice on both cores, so events fire more than
+// once, and the frames can't be counted. They're turned into cycles instead.
+std::string PCSX::BatchRunner::runLockstepJob(const Job& job) {
+    startJob(job);
+    if (job.state.empty()) Lockstep::runToShell();
+
+    Lockstep::Options options;
+    options.cycles = job.cycles ? job.cycles : uint64_t(job.frames) * (g_emulator->m_psxClockSpeed / 60);
+    Lockstep lockstep;
+    const auto start = std::chrono::steady_clock::now();
+    auto result = lockstep.run(options);
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    json report;
+    json details;
+    details["supported"] = result.supported;
+    details["dispatches"] = result.dispatches;
+    if (result.mismatch) {
+        auto& mismatch = *result.mismatch;
+        json entry;
+        entry["cycle"] = mismatch.cycle;
+        entry["pc"] = fmt::format("{:08x}", mismatch.pc);
+        entry["narrowed"] = mismatch.narrowed;
+        entry["differences"] = mismatch.differences;
+        entry["disassembly"] = mismatch.disassembly;
+        details["mismatch"] = entry;
+    }
+    report["lockstep"] = details;
+    report["emulatedCycles"] = result.cycles;
+    report["emulationTime"] = elapsed;
+    report["frameHashes"] = json::array({hashFrame()});
+    report["stateHashes"] = json::array({hashState()});
+    report["quit"] = g_system->quitting();
+    report["exitCode"] = g_system->quitting() ? g_system->exitCode() : 0;
+    return report.dump();
+}
+
+int PCSX::BatchRunner::run(FILE* out) {
+    auto& fork = *g_emulator->m_fork;
+    if (!Fork::supported()) {
+        fmt::print(stderr, "Batch runs need fork(), which isn't available on this platform\n");
+        return 1;
+    }
+    g_system->pause();
+    m_defaultBios = g_emulator->settings.get<Emulator::SettingBios>().value;
+    preload();
+
+    struct Running {
+        const Job* job;
+        std::chrono::steady_clock::time_point start;
+    };
+    std::map<int, Running> running;
+    bool allPassed = true;
+
+    auto emit = [out, &allPassed](const Job& job, const Fork::Result* result, double wallTime) {
+        json record;
+        record["name"] = job.name;
+        record["wallTime"] = wallTime;
+        bool passed = false;
+        json report = result && result->success ? json::parse(result->output, nullptr, false) : json();
+        if (report.is_object()) {
+            record.update(report);
+            record["stateHash"] = fmt::format("{:08x}", result->stateHash);
+            bool hashesMatch = true;
+            if (!job.expectedHashes.empty()) {
+                hashesMatch = report["frameHashes"] == json(job.expectedHashes);
+                record["hashesMatch"] = hashesMatch;
+            }
+            bool stateMatches = true;
+            if (!job.expectedStateHashes.empty()) {
+                json divergence = findStateDivergence(report["stateHashes"], job.expectedStateHashes);
+                stateMatches = divergence.is_null();
+                if (!stateMatches) record["stateDivergence"] = divergence;
+            }
+            const bool exitCodeMatches = !job.expectedExitCode || (report["exitCode"] == *job.expectedExitCode);
+            bool lockstepPassed = true;
+            if (job.lockstep) {
+                const auto& lockstep = report["lockstep"];
+                lockstepPassed = lockstep.value("supported", false) && !lockstep.contains("mismatch");
+            }
+            passed = hashesMatch && stateMatches && exitCodeMatches && lockstepPassed;
+        } else if (!result) {
+            record["error"] = "Unable to fork";
+        } else {
+            record["error"] = result->output.empty() ? "The job crashed" : result->output;
+        }
+        record["passed"] = passed;
+        if (!passed) allPassed = false;
+        fmt::print(out, "{}\n", record.dump());
+        fflush(out);
+    };
+
+    size_t next = 0;
+    while ((next < m_jobs.size()) || fork.outstanding()) {
+        if ((next < m_jobs.size()) && (fork.outstanding() < m_workers) && !g_system->quitting()) {
+            const Job& job = m_jobs[next++];
+            prepare(job);
+            const auto start = std::chrono::steady_clock::now();
+            int index = fork.spawn(1);
+            if (index >= 0) {
+                std::string output;
+                bool success = true;
+                try {
+                    output = runJob(job);
+                } catch (std::exception& e) {
+                    output = e.what();
+                    success = false;
+                }
+                fork.report(output, success);
+            }
+            if (index == -2) {
+                emit(job, nullptr, 0.0);
+            } else {
+                running[fork.lastSpawned()] = {&job, start};
+            }
+            continue;
+        }
+        if ((next < m_jobs.size()) && g_system->quitting() && !fork.outstanding()) break;
+        Fork::Result result;
+        if (!fork.waitAny(result)) break;
+        auto it = running.find(result.pid);
+        if (it == running.end()) continue;
+        const double wallTime =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - it->second.start).count();
+        emit(*it->second.job, &result, wallTime);
+        running.erase(it);
+    }
+
+    // Anything left over got interrupted.
+    return (allPassed && (next == m_jobs.size())) ? 0 : 1;
+}
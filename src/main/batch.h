@@ -0,0 +1,119 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "json.hpp"
+
+namespace PCSX {
+
+class CDRIso;
+class UI;
+
+// Runs a manifest of emulation jobs, each in its own headless child process
+// forked from the paused emulator, with up to a given amount of them running
+// at once. The manifest is a json object:
+//
+//   {
+//     "workers": 8,
+//     "jobs": [
+//       {
+//         "name": "boot",
+//         "bios": "openbios.bin",
+//         "iso": "game.cue",
+//         "exe": "test.ps-exe",
+//         "script": "check.lua",
+//         "state": "checkpoint.sstate",
+//         "lockstep": false,
+//         "frames": 600,
+//         "cycles": 0,
+//         "hashInterval": 60,
+//         "expectedHashes": ["1234abcd", ...],
+//         "expectedStateHashes": [{"hash": "0123456789abcdef", "ram": ...}, ...],
+//         "expectedExitCode": 0
+//       }
+//     ]
+//   }
+//
+// Only the name, and at least one of frames or cycles, are mandatory. The disc
+// images are all loaded and fully cached before the first job starts, and
+// then shared between the jobs using them. Every finished job gets a json
+// object written on its own line, with its timings, emulated cycles, frame
+// hashes, machine state hashes, and exit code. The state hashes are taken at
+// the same points as the frame hashes, and when they don't match their
+// expectation, the first diverging one is reported, along with its regions.
+//
+// A job can start from a save state instead of booting, in which case the
+// exe is ignored. Lockstep jobs run their budget through the lockstep
+// harness, comparing the dynarec against the interpreter, and pass only if
+// both agreed all along; the frames are only used to compute a cycle budget,
+// and no hashes are taken until the end.
+class BatchRunner {
+  public:
+    struct Job {
+        std::string name;
+        std::filesystem::path bios;
+        std::filesystem::path iso;
+        std::filesystem::path exe;
+        std::filesystem::path script;
+        std::filesystem::path state;
+        bool lockstep = false;
+        unsigned frames = 0;
+        uint64_t cycles = 0;
+        // Hashes the displayed frame every that many frames, or only the last
+        // one if zero.
+        unsigned hashInterval = 0;
+        std::vector<std::string> expectedHashes;
+        // Either overall hashes, or full entries from a previous report.
+        nlohmann::json expectedStateHashes;
+        std::optional<int> expectedExitCode;
+    };
+
+    explicit BatchRunner(UI* ui) : m_ui(ui) {}
+    // Throws on malformed manifests.
+    void loadManifest(const std::filesystem::path& path);
+    void setWorkers(unsigned workers) { m_workers = workers; }
+    // Returns 0 if all of the jobs ran, and matched their expectations.
+    int run(FILE* out);
+
+  private:
+    void preload();
+    void prepare(const Job& job);
+    void startJob(const Job& job);
+    std::string runJob(const Job& job);
+    std::string runLockstepJob(const Job& job);
+
+    UI* m_ui;
+    unsigned m_workers = 1;
+    std::vector<Job> m_jobs;
+    std::map<std::filesystem::path, std::shared_ptr<CDRIso>> m_isos;
+    std::filesystem::path m_defaultBios;
+};
+
+}  // namespace PCSX
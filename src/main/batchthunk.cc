@@ -0,0 +1,51 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <stdio.h>
+
+#include <exception>
+#include <vector>
+
+#include "main/main.h"
+
+// The pcsx-redux-batch binary: a thin wrapper which runs the emulator without
+// any UI, and with the software renderer, over a manifest of jobs. Any extra
+// argument is passed along as is, such as -workers, -output, or -bios.
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s manifest.json [-workers count] [-output metrics.json] [options...]\n", argv[0]);
+        return 1;
+    }
+    std::vector<char *> args;
+    args.push_back(argv[0]);
+    args.push_back(const_cast<char *>("-no-ui"));
+    args.push_back(const_cast<char *>("-softgpu"));
+    args.push_back(const_cast<char *>("-batch"));
+    for (int i = 1; i < argc; i++) args.push_back(argv[i]);
+    args.push_back(nullptr);
+
+    try {
+        return pcsxMain(args.size() - 1, args.data());
+    } catch (std::exception &e) {
+        fprintf(stderr, "%s\n", e.what());
+    } catch (...) {
+        fprintf(stderr, "An unknown exception occured.\n");
+    }
+    return -1;
+}
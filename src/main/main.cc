@@ -23,10 +23,13 @@
 #include <map>
 #include <string>
 
+#include "cdrom/converter.h"
 #include "core/arguments.h"
 #include "core/cdrom.h"
 #include "core/gpu.h"
 #include "core/logger.h"
+#include "core/lockstep.h"
+#include "core/movie.h"
 #include "core/psxemulator.h"
 #include "core/r3000a.h"
 #include "core/sstate.h"
@@ -36,6 +39,7 @@
 #include "gui/gui.h"
 #include "lua/extra.h"
 #include "lua/luawrapper.h"
+#include "main/batch.h"
 #include "main/textui.h"
 #include "spu/interface.h"
 #include "support/binpath.h"
@@ -97,19 +101,20 @@ class SystemImpl final : public PCSX::System {
 
     virtual void update(bool vsync = false) final override {
         // called on vblank to update states
-        s_ui->update(vsync);
+        m_eventBus->deliverPosted();
+        if (!headless()) s_ui->update(vsync);
     }
 
     virtual void softReset() final override {
         // debugger or UI is requesting a reset
         PCSX::g_emulator->m_cpu->psxReset();
-        m_eventBus->signal(PCSX::Events::ExecutionFlow::Reset{});
+        PCSX::g_emulator->m_eventBus->signal(PCSX::Events::ExecutionFlow::Reset{});
     }
 
     virtual void hardReset() final override {
         // debugger or UI is requesting a reset
         PCSX::g_emulator->reset();
-        m_eventBus->signal(PCSX::Events::ExecutionFlow::Reset{true});
+        PCSX::g_emulator->m_eventBus->signal(PCSX::Events::ExecutionFlow::Reset{true});
     }
 
     virtual void close() final override {
@@ -227,6 +232,36 @@ int pcsxMain(int argc, char **argv) {
     PCSX::g_emulator = emulator;
     auto &favorites = emulator->settings.get<PCSX::Emulator::SettingOpenDialogFavorites>().value;
 
+    // Converting a disc image only needs the emulator's default settings, so
+    // this is the last early out, before any UI gets created.
+    auto toConvert = args.get<std::string>("convert");
+    if (toConvert.has_value()) {
+        auto output = args.get<std::string>("output");
+        if (!output.has_value() || (std::filesystem::path(output.value()).extension() != ".cue")) {
+            fmt::print("Usage: -convert input -output output.cue [-threads count] [-no-edc]\n");
+            return 1;
+        }
+        PCSX::CDRIso iso(std::filesystem::path(toConvert.value()));
+        if (iso.failed()) {
+            fmt::print("Unable to open disc image {}\n", toConvert.value());
+            return 1;
+        }
+        PCSX::ImageConverter::Options options;
+        options.threads = args.get<unsigned>("threads", std::thread::hardware_concurrency());
+        options.regenerateEDCECC = !args.get<bool>("no-edc");
+        try {
+            auto report = PCSX::ImageConverter(&iso, options).toCueBin(output.value());
+            fmt::print("Sectors: {}\nUnreadable: {}\nRegenerated EDC/ECC: {}\nSubQ errors: {}\nSBI mismatches: {}\n",
+                       report.sectors, report.unreadable, report.regenerated, report.subqErrors,
+                       report.sbiMismatches);
+            if (report.sbiEntries) fmt::print("SBI entries written: {}\n", report.sbiEntries);
+            return report.unreadable ? 1 : 0;
+        } catch (std::exception &e) {
+            fmt::print("{}\n", e.what());
+            return 1;
+        }
+    }
+
     s_ui = args.get<bool>("no-ui") || args.get<bool>("cli") ? reinterpret_cast<PCSX::UI *>(new PCSX::TUI())
                                                             : reinterpret_cast<PCSX::UI *>(new PCSX::GUI(favorites));
     // Settings will be loaded after this initialization.
@@ -321,6 +356,19 @@ int pcsxMain(int argc, char **argv) {
             emuSettings.get<PCSX::Emulator::SettingHardwareRenderer>() = false;
         }
 
+        auto speed = args.get<std::string>("speed");
+        if (speed.has_value()) {
+            if (speed.value() == "unlimited") {
+                emuSettings.get<PCSX::Emulator::SettingUnthrottled>() = true;
+            } else {
+                emuSettings.get<PCSX::Emulator::SettingUnthrottled>() = false;
+                auto scale = args.get<float>("speed");
+                if (scale.has_value() && (scale.value() > 0.0f)) {
+                    emuSettings.get<PCSX::Emulator::SettingScaler>() = scale.value() * 100.0f;
+                }
+            }
+        }
+
         if (args.get<bool>("kiosk")) {
             emuSettings.get<PCSX::Emulator::SettingKioskMode>() = true;
         }
@@ -443,8 +491,57 @@ runner.init({
                 L->load(std::string(luaexec), "cmdline:");
             }
 
+            // Movies both start with a hard reset, so they go last.
+            auto movie = args.get<std::string>("movie");
+            auto recordMovie = args.get<std::string>("record-movie");
+            if (movie.has_value() && !emulator->m_movie->play(movie.value())) {
+                fmt::print(stderr, "Unable to play movie {}\n", movie.value());
+            } else if (recordMovie.has_value() &&
+                       !emulator->m_movie->record(recordMovie.value(), PCSX::Movie::Start::PowerOn)) {
+                fmt::print(stderr, "Unable to record movie {}\n", recordMovie.value());
+            }
+
             system->m_inStartup = false;
 
+            // Batch runs take over the main loop entirely, and quit once done.
+            auto batch = args.get<std::string>("batch");
+            if (batch.has_value()) {
+                PCSX::BatchRunner runner(s_ui);
+                auto output = args.get<std::string>("output");
+                FILE *out = output.has_value() ? fopen(output.value().c_str(), "w") : stdout;
+                int code = 1;
+                try {
+                    if (!out) throw std::runtime_error(fmt::format("Unable to create {}", output.value()));
+                    runner.loadManifest(batch.value());
+                    auto workers = args.get<unsigned>("workers");
+                    if (workers.has_value()) runner.setWorkers(std::max(workers.value(), 1u));
+                    code = runner.run(out);
+                } catch (std::exception &e) {
+                    fmt::print(stderr, "{}\n", e.what());
+                }
+                if (out && (out != stdout)) fclose(out);
+                system->quit(code);
+            }
+
+            // Lockstep runs compare the dynarec against the interpreter, and quit once done.
+            if (args.get<bool>("lockstep")) {
+                PCSX::Lockstep::Options options;
+                options.cycles = args.get<uint64_t>("lockstep-cycles", 0);
+                options.sliceSize = std::max(args.get<unsigned>("lockstep-slice", unsigned{options.sliceSize}), 1u);
+                auto state = args.get<std::string>("lockstep-state");
+                int code = 1;
+                if (state.has_value() && !PCSX::Lockstep::loadCheckpoint(state.value())) {
+                    fmt::print(stderr, "Unable to load save state {}\n", state.value());
+                } else {
+                    if (!state.has_value()) PCSX::Lockstep::runToShell();
+                    PCSX::Lockstep lockstep;
+                    auto result = lockstep.run(options);
+                    fmt::print("{}", PCSX::Lockstep::format(result));
+                    code = result.supported && !result.mismatch ? 0 : 1;
+                }
+                system->quit(code);
+            }
+
             // And finally, main loop.
             while (!system->quitting()) {
                 if (system->running()) {
@@ -454,6 +551,7 @@ runner.init({
                     // The "update" method will be called periodically by the emulator while
                     // it's running, meaning if we want our UI to work, we have to manually
                     // call "update" when the emulator is paused.
+                    system->m_eventBus->deliverPosted();
                     s_ui->update();
                 }
             }
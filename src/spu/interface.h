@@ -50,6 +50,7 @@ class impl final : public SPUInterface {
     uint16_t readRegister(uint32_t) final;
     void lockSPURAM() final;
     void unlockSPURAM() final;
+    const uint8_t *getSPURAM() final { return spuMemC; }
     void resetCaptureBuffer() final;
     void writeDMAMem(uint16_t *, int) final;
     void readDMAMem(uint16_t *, int) final;
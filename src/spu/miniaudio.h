@@ -23,6 +23,7 @@
 
 #include <array>
 #include <atomic>
+#include <chrono>
 #include <string>
 #include <vector>
 
@@ -63,13 +64,14 @@ class MiniAudio {
     }
     const std::vector<std::string>& getBackends() { return m_backends; }
     const std::vector<std::string>& getDevices() { return m_devices; }
-    bool feedStreamData(const Frame* data, size_t frames, unsigned streamId = 0) {
+    bool feedStreamData(const Frame* data, size_t frames, unsigned streamId = 0,
+                        std::chrono::milliseconds maxWait = std::chrono::milliseconds(200)) {
         switch (streamId) {
             case 0:
-                return m_voicesStream.enqueue(data, frames);
+                return m_voicesStream.enqueue(data, frames, maxWait);
                 break;
             case 1:
-                return m_audioStream.enqueue(data, frames);
+                return m_audioStream.enqueue(data, frames, maxWait);
                 break;
             default:
                 throw std::runtime_error("Invalid stream ID");
@@ -96,6 +96,8 @@
 #include <chrono>
 #include <thread>
 
+#include "core/perf-counters.h"
+#include "core/psxemulator.h"
 #include "spu/adsr.h"
 #include "spu/externals.h"
 #include "spu/gauss.h"
@@ -479,6 +481,8 @@ void PCSX::SPU::impl::MainThread() {
                     1;  // if a new channel kicks in (or, of course, sound buffer runs low), we will leave the loop
         }
 
+        const auto mixStart = std::chrono::steady_clock::now();
+
         //--------------------------------------------------// continue from irq handling in timer mode?
 
         if (lastch >= 0)  // will be -1 if no continue is pending
@@ -788,6 +792,7 @@ void PCSX::SPU::impl::MainThread() {
         }
 
         InitREVERB();
+        g_emulator->m_perfCounters->addSPUMix(NSSIZE, std::chrono::steady_clock::now() - mixStart);
 
         //////////////////////////////////////////////////////
         // feed the sound
@@ -911,7 +916,10 @@ void PCSX::SPU::impl::SetupThread() {
     bThreadEnded = 0;
     bSpuInit = 1;  // flag: we are inited
 
-    hMainThread = std::thread([this]() { MainThread(); });
+    hMainThread = std::thread([this, emulator = g_emulator]() {
+        Emulator::Binding binding(emulator);
+        MainThread();
+    });
 }
 
 ////////////////////////////////////////////////////////////////////////
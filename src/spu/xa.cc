@@ -159,5 +159,9 @@ void PCSX::SPU::impl::FeedXA(xa_decode_t *xap) {
     }
     if (pMixIrq) cbMtx.unlock();
 
-    m_audioOut.feedStreamData(reinterpret_cast<MiniAudio::Frame *>(XABuffer), (XAFeed - XABuffer), 1);
+    // Faster than realtime, XA audio comes in faster than it plays, and waiting
+    // for room in the stream would throttle the emulation, so it gets dropped.
+    const auto maxWait =
+        g_emulator->fasterThanRealtime() ? std::chrono::milliseconds(0) : std::chrono::milliseconds(200);
+    m_audioOut.feedStreamData(reinterpret_cast<MiniAudio::Frame *>(XABuffer), (XAFeed - XABuffer), 1, maxWait);
 }
@@ -26,51 +26,45 @@ SOFTWARE.
 
 #pragma once
 
-#include <any>
+#include <atomic>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <utility>
+#include <vector>
 
-#include "support/hashtable.h"
 #include "support/list.h"
 
-#if defined(_CPPRTTI) || defined(__GXX_RTTI) || defined(__cpp_rtti)
-#define PCSX_RTTI 1
-#include <typeindex>
-#include <typeinfo>
-#define PCSX_HASH_TYPE(type) typeid(type).hash_code()
-#else
-#define PCSX_RTTI 0
-#define CTTI_HAS_ENUM_AWARE_PRETTY_FUNCTION 1
-#include "ctti/type_id.hpp"
-#define PCSX_HASH_TYPE(type) ctti::unnamed_type_id<type>().hash()
-#endif
-
 namespace PCSX {
 
 namespace EventBus {
 
-#if PCSX_RTTI
-typedef std::size_t HashType;
-#else
-typedef std::uint64_t HashType;
-#endif
-
 struct ListenerElementBaseEventBusList {};
 struct ListenerElementBase;
 typedef PCSX::Intrusive::List<ListenerElementBase> ListenerBaseListType;
 typedef PCSX::Intrusive::List<ListenerElementBase, ListenerElementBaseEventBusList> ListenerBaseEventBusList;
-struct ListenerElementBase : public ListenerBaseListType::Node, public ListenerBaseEventBusList::Node {
-    virtual std::any getCB() = 0;
-};
+struct ListenerElementBase : public ListenerBaseListType::Node, public ListenerBaseEventBusList::Node {};
 template <typename M>
 struct ListenerElement : public ListenerElementBase {
     typedef std::function<void(const M&)> Functor;
-    virtual std::any getCB() { return &cb; }
     ListenerElement(Functor&& cb) : cb(std::move(cb)) {}
     Functor cb;
 };
 
+// Hands out a small, dense index for each event type, the first time it is
+// used, which the buses then use to index their channels directly.
+class TypeIndex {
+  public:
+    template <typename Event>
+    static unsigned get() {
+        static const unsigned index = s_next.fetch_add(1, std::memory_order_relaxed);
+        return index;
+    }
+
+  private:
+    static inline std::atomic<unsigned> s_next = 0;
+};
+
 class EventBus;
 
 class Listener {
@@ -85,37 +79,91 @@ class Listener {
     ListenerBaseListType m_listeners;
 };
 
-struct ListenerElementsHashTableList;
-typedef PCSX::Intrusive::HashTable<HashType, ListenerElementsHashTableList> ListenersHashTable;
-struct ListenerElementsHashTableList : public ListenersHashTable::Node {
-    ~ListenerElementsHashTableList() { list.destroyAll(); }
-    ListenerBaseEventBusList list;
-};
-
+// Listening and signaling happen on the thread owning the bus: the main thread
+// for the system's, or the one stepping the emulator for an emulator's own bus.
+// Each event type gets its own channel, and signaling an event calls its
+// listeners directly, without any lookup or allocation. Other threads, or code
+// which wants its event delivered later, post it instead: posted events are
+// copied into a queue, and get signaled in the order they were posted when the
+// owning thread calls deliverPosted(). The queues keep their storage, so
+// posting doesn't allocate either once they've grown to their working size.
 class EventBus {
   public:
-    ~EventBus() { m_table.destroyAll(); }
+    ~EventBus() {
+        for (auto& channel : m_channels) {
+            if (channel) channel->destroyAll();
+        }
+    }
     template <typename Event>
     void signal(const Event& event) {
-        using Functor = typename ListenerElement<Event>::Functor;
-        auto list = m_table.find(PCSX_HASH_TYPE(Event));
-        if (list == m_table.end()) return;
-        for (auto& listener : list->list) {
-            std::any cb = listener.getCB();
-            Functor* func = std::any_cast<Functor*>(cb);
-            (*func)(event);
+        const unsigned index = TypeIndex::get<Event>();
+        if (index >= m_channels.size()) return;
+        auto& channel = m_channels[index];
+        if (!channel) return;
+        for (auto& listener : *channel) static_cast<ListenerElement<Event>&>(listener).cb(event);
+    }
+    template <typename Event>
+    void post(Event event) {
+        const unsigned index = TypeIndex::get<Event>();
+        std::lock_guard lock(m_postedLock);
+        if (index >= m_queues.size()) m_queues.resize(index + 1);
+        auto& queue = m_queues[index];
+        if (!queue) queue.reset(new Queue<Event>());
+        static_cast<Queue<Event>*>(queue.get())->pending.push_back(std::move(event));
+        m_postedOrder.push_back(queue.get());
+    }
+    // Signals all the events posted so far. Events posted while delivering
+    // wait for the next call.
+    void deliverPosted() {
+        if (m_delivering) return;
+        {
+            std::lock_guard lock(m_postedLock);
+            if (m_postedOrder.empty()) return;
+            std::swap(m_postedOrder, m_deliveringOrder);
+            for (auto& queue : m_queues) {
+                if (queue) queue->swap();
+            }
         }
+        m_delivering = true;
+        for (auto queue : m_deliveringOrder) queue->deliverNext(*this);
+        for (auto queue : m_deliveringOrder) queue->clear();
+        m_deliveringOrder.clear();
+        m_delivering = false;
     }
 
   private:
-    void listen(HashType id, ListenerElementBase* listenerElement) {
-        auto list = m_table.find(id);
-        if (list == m_table.end()) {
-            list = m_table.insert(id, new ListenerElementsHashTableList());
+    struct QueueBase {
+        virtual ~QueueBase() = default;
+        virtual void swap() = 0;
+        virtual void deliverNext(EventBus& bus) = 0;
+        virtual void clear() = 0;
+    };
+    template <typename Event>
+    struct Queue : public QueueBase {
+        void swap() override {
+            delivering.swap(pending);
+            cursor = 0;
         }
-        list->list.push_back(listenerElement);
+        void deliverNext(EventBus& bus) override { bus.signal(delivering[cursor++]); }
+        void clear() override { delivering.clear(); }
+        std::vector<Event> pending;
+        std::vector<Event> delivering;
+        size_t cursor = 0;
+    };
+
+    void listen(unsigned index, ListenerElementBase* listenerElement) {
+        if (index >= m_channels.size()) m_channels.resize(index + 1);
+        auto& channel = m_channels[index];
+        if (!channel) channel.reset(new ListenerBaseEventBusList());
+        channel->push_back(listenerElement);
     }
-    ListenersHashTable m_table;
+    std::vector<std::unique_ptr<ListenerBaseEventBusList>> m_channels;
+
+    std::mutex m_postedLock;
+    std::vector<std::unique_ptr<QueueBase>> m_queues;
+    std::vector<QueueBase*> m_postedOrder;
+    std::vector<QueueBase*> m_deliveringOrder;
+    bool m_delivering = false;
     friend class Listener;
 };
 
@@ -123,7 +171,7 @@ template <typename Event>
 void Listener::listen(typename ListenerElement<Event>::Functor&& cb) {
     ListenerElement<Event>* element = new ListenerElement(std::move(cb));
     m_listeners.push_back(element);
-    m_bus->listen(PCSX_HASH_TYPE(Event), element);
+    m_bus->listen(TypeIndex::get<Event>(), element);
 }
 
 }  // namespace EventBus
@@ -0,0 +1,392 @@
+/*
+
+MIT License
+
+Copyright (c) 2025 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "support/instruction-trace.h"
+
+#include <string.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <bit>
+
+#include "support/xordelta.h"
+
+namespace {
+
+constexpr char c_fileMagic[8] = {'P', 'C', 'S', 'X', 'T', 'R', 'C', 'E'};
+constexpr char c_indexMagic[8] = {'P', 'C', 'S', 'X', 'T', 'I', 'D', 'X'};
+constexpr uint32_t c_version = 1;
+constexpr size_t c_fileHeaderSize = 16;
+// compressed size, raw size, first index, first cycle, count, reserved
+constexpr size_t c_chunkHeaderSize = 32;
+// index offset, chunk count, magic
+constexpr size_t c_trailerSize = 20;
+// offset, first index, first cycle, count
+constexpr size_t c_indexEntrySize = 28;
+// Past this many chunks waiting for the writer, the emulation waits for it.
+constexpr size_t c_maxQueuedChunks = 8;
+
+constexpr uint64_t zigzag(int32_t v) { return (uint32_t(v) << 1) ^ uint32_t(v >> 31); }
+constexpr int32_t unzigzag(uint64_t v) { return int32_t(uint32_t(v >> 1) ^ -uint32_t(v & 1)); }
+
+}  // namespace
+
+using namespace PCSX::InstructionTrace;
+
+bool Writer::open(const std::filesystem::path& path, const uint32_t regs[c_registerCount]) {
+    close();
+    m_file.setFile(new PosixFile(path, FileOps::TRUNCATE));
+    if (m_file->failed()) return false;
+    m_file->write(c_fileMagic, sizeof(c_fileMagic));
+    m_file->write<uint32_t>(c_version);
+    m_file->write<uint32_t>(c_registerCount);
+
+    memcpy(m_regs, regs, sizeof(m_regs));
+    m_index = 0;
+    m_inRecord = false;
+    m_closing = false;
+    m_failed = false;
+    m_bytesWritten = c_fileHeaderSize;
+    m_chunks.clear();
+    startChunk();
+    m_thread = std::thread([this]() { run(); });
+    return true;
+}
+
+void Writer::close() {
+    if (!isOpen()) return;
+    flushChunk();
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_closing = true;
+    }
+    m_cv.notify_all();
+    m_thread.join();
+
+    if (!m_failed) {
+        const uint64_t indexOffset = m_bytesWritten;
+        for (auto& chunk : m_chunks) {
+            m_file->write<uint64_t>(chunk.offset);
+            m_file->write<uint64_t>(chunk.firstIndex);
+            m_file->write<uint64_t>(chunk.firstCycle);
+            m_file->write<uint32_t>(chunk.count);
+        }
+        m_file->write<uint64_t>(indexOffset);
+        m_file->write<uint32_t>(m_chunks.size());
+        m_file->write(c_indexMagic, sizeof(c_indexMagic));
+    }
+    m_file->close();
+    m_file.reset();
+}
+
+uint64_t Writer::bytesWritten() const {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_bytesWritten;
+}
+
+bool Writer::failed() const {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_failed;
+}
+
+void Writer::begin(uint64_t cycle, uint32_t pc, uint32_t code) {
+    m_inRecord = true;
+    m_cycle = cycle;
+    m_pc = pc;
+    m_code = code;
+    m_accessCount = 0;
+}
+
+void Writer::end(const uint32_t regs[c_registerCount]) {
+    if (!m_inRecord) return;
+    m_inRecord = false;
+    if (m_chunkInfo.count == 0) m_chunkInfo.firstCycle = m_cycle;
+
+    const bool jump = m_pc != m_expectedPC;
+    XorDelta::putVarInt(m_chunk, ((m_cycle - m_lastCycle) << 3) | (m_accessCount << 1) | (jump ? 1 : 0));
+    if (jump) XorDelta::putVarInt(m_chunk, zigzag(int32_t(m_pc - m_expectedPC)));
+    for (unsigned i = 0; i < 4; i++) m_chunk.push_back(m_code >> (i * 8));
+
+    uint64_t changed = 0;
+    for (unsigned i = 0; i < c_registerCount; i++) {
+        if (regs[i] != m_regs[i]) changed |= uint64_t(1) << i;
+    }
+    XorDelta::putVarInt(m_chunk, changed);
+    for (unsigned i = 0; i < c_registerCount; i++) {
+        if (!(changed & (uint64_t(1) << i))) continue;
+        XorDelta::putVarInt(m_chunk, regs[i] ^ m_regs[i]);
+        m_regs[i] = regs[i];
+    }
+
+    for (unsigned i = 0; i < m_accessCount; i++) {
+        const auto& access = m_accesses[i];
+        XorDelta::putVarInt(m_chunk, access.address ^ m_lastAddress);
+        m_chunk.push_back((std::countr_zero(unsigned(access.size)) & 3) | (access.write ? 4 : 0));
+        if (access.write) XorDelta::putVarInt(m_chunk, access.value);
+        m_lastAddress = access.address;
+    }
+
+    m_lastCycle = m_cycle;
+    m_expectedPC = m_pc + 4;
+    m_index++;
+    if (++m_chunkInfo.count == c_chunkRecords) {
+        flushChunk();
+        startChunk();
+    }
+}
+
+void Writer::startChunk() {
+    m_chunk.clear();
+    m_chunk.reserve(c_chunkRecords * 12);
+    for (auto reg : m_regs) {
+        for (unsigned i = 0; i < 4; i++) m_chunk.push_back(reg >> (i * 8));
+    }
+    m_chunkInfo = {0, m_index, 0, 0};
+    m_lastCycle = 0;
+    m_expectedPC = 0;
+    m_lastAddress = 0;
+}
+
+void Writer::flushChunk() {
+    if (m_chunkInfo.count == 0) return;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this]() { return m_failed || (m_queue.size() < c_maxQueuedChunks); });
+    // Once the writer failed, records are only counted, and thrown away.
+    if (!m_failed) m_queue.push_back({std::move(m_chunk), m_chunkInfo});
+    m_chunk.clear();
+    m_chunkInfo.count = 0;
+    lock.unlock();
+    m_cv.notify_all();
+}
+
+void Writer::run() {
+    std::vector<uint8_t> compressed;
+    while (true) {
+        Pending pending;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this]() { return m_closing || !m_queue.empty(); });
+            if (m_queue.empty()) return;
+            pending = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+        m_cv.notify_all();
+
+        z_stream z = {};
+        bool success = deflateInit2(&z, Z_BEST_SPEED, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) == Z_OK;
+        if (success) {
+            compressed.resize(deflateBound(&z, pending.data.size()));
+            z.next_in = pending.data.data();
+            z.avail_in = pending.data.size();
+            z.next_out = compressed.data();
+            z.avail_out = compressed.size();
+            success = deflate(&z, Z_FINISH) == Z_STREAM_END;
+            compressed.resize(z.total_out);
+            deflateEnd(&z);
+        }
+
+        auto& info = pending.info;
+        info.offset = m_bytesWritten;
+        m_file->write<uint32_t>(compressed.size());
+        m_file->write<uint32_t>(pending.data.size());
+        m_file->write<uint64_t>(info.firstIndex);
+        m_file->write<uint64_t>(info.firstCycle);
+        m_file->write<uint32_t>(info.count);
+        m_file->write<uint32_t>(0);
+        success = success && (m_file->write(compressed.data(), compressed.size()) == ssize_t(compressed.size()));
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!success) {
+            m_failed = true;
+            m_queue.clear();
+            m_cv.notify_all();
+            return;
+        }
+        m_chunks.push_back(info);
+        m_bytesWritten += c_chunkHeaderSize + compressed.size();
+    }
+}
+
+bool Reader::open(const std::filesystem::path& path) {
+    m_file.setFile(new PosixFile(path));
+    m_chunks.clear();
+    m_loadedChunk = SIZE_MAX;
+    if (m_file->failed() || (m_file->size() < c_fileHeaderSize)) return false;
+    char magic[sizeof(c_fileMagic)];
+    m_file->readAt(magic, sizeof(magic), 0);
+    if (memcmp(magic, c_fileMagic, sizeof(magic)) != 0) return false;
+    if (m_file->readAt<uint32_t>(8) != c_version) return false;
+    if (m_file->readAt<uint32_t>(12) != c_registerCount) return false;
+    return readIndex() || scanChunks();
+}
+
+bool Reader::readIndex() {
+    const size_t size = m_file->size();
+    if (size < c_fileHeaderSize + c_trailerSize) return false;
+    char magic[sizeof(c_indexMagic)];
+    m_file->readAt(magic, sizeof(magic), size - sizeof(magic));
+    if (memcmp(magic, c_indexMagic, sizeof(magic)) != 0) return false;
+    const uint64_t indexOffset = m_file->readAt<uint64_t>(size - c_trailerSize);
+    const uint32_t chunkCount = m_file->readAt<uint32_t>(size - c_trailerSize + 8);
+    if (indexOffset + uint64_t(chunkCount) * c_indexEntrySize + c_trailerSize != size) return false;
+    m_chunks.resize(chunkCount);
+    size_t pos = indexOffset;
+    for (auto& chunk : m_chunks) {
+        chunk.offset = m_file->readAt<uint64_t>(pos);
+        chunk.firstIndex = m_file->readAt<uint64_t>(pos + 8);
+        chunk.firstCycle = m_file->readAt<uint64_t>(pos + 16);
+        chunk.count = m_file->readAt<uint32_t>(pos + 24);
+        pos += c_indexEntrySize;
+    }
+    return true;
+}
+
+// Without an index, walk the chunk headers, and stop at the first truncated one.
+bool Reader::scanChunks() {
+    const size_t size = m_file->size();
+    size_t pos = c_fileHeaderSize;
+    uint64_t index = 0;
+    while (pos + c_chunkHeaderSize <= size) {
+        const uint32_t compressedSize = m_file->readAt<uint32_t>(pos);
+        ChunkInfo chunk;
+        chunk.offset = pos;
+        chunk.firstIndex = m_file->readAt<uint64_t>(pos + 8);
+        chunk.firstCycle = m_file->readAt<uint64_t>(pos + 16);
+        chunk.count = m_file->readAt<uint32_t>(pos + 24);
+        if ((chunk.firstIndex != index) || (pos + c_chunkHeaderSize + compressedSize > size)) break;
+        m_chunks.push_back(chunk);
+        index += chunk.count;
+        pos += c_chunkHeaderSize + compressedSize;
+    }
+    return true;
+}
+
+bool Reader::loadChunk(size_t chunk) {
+    if (m_loadedChunk == chunk) return true;
+    m_loadedChunk = SIZE_MAX;
+    const uint64_t offset = m_chunks[chunk].offset;
+    const uint32_t compressedSize = m_file->readAt<uint32_t>(offset);
+    const uint32_t rawSize = m_file->readAt<uint32_t>(offset + 4);
+    std::vector<uint8_t> compressed(compressedSize);
+    if (m_file->readAt(compressed.data(), compressedSize, offset + c_chunkHeaderSize) != ssize_t(compressedSize)) {
+        return false;
+    }
+    m_raw.resize(rawSize);
+    z_stream z = {};
+    if (inflateInit2(&z, -MAX_WBITS) != Z_OK) return false;
+    z.next_in = compressed.data();
+    z.avail_in = compressedSize;
+    z.next_out = m_raw.data();
+    z.avail_out = rawSize;
+    const int res = inflate(&z, Z_FINISH);
+    inflateEnd(&z);
+    if ((res != Z_STREAM_END) || (z.total_out != rawSize)) return false;
+    m_loadedChunk = chunk;
+    return true;
+}
+
+bool Reader::read(uint64_t first, uint64_t count, const std::function<bool(const Record&)>& callback) {
+    auto it = std::upper_bound(m_chunks.begin(), m_chunks.end(), first,
+                               [](uint64_t index, const ChunkInfo& chunk) { return index < chunk.firstIndex; });
+    if (it == m_chunks.begin()) return true;
+    size_t chunk = it - m_chunks.begin() - 1;
+    const uint64_t last = first + count;
+
+    Record record;
+    for (; chunk < m_chunks.size(); chunk++) {
+        const auto& info = m_chunks[chunk];
+        if (info.firstIndex >= last) break;
+        if (!loadChunk(chunk)) return false;
+        const uint8_t* in = m_raw.data();
+        const uint8_t* end = in + m_raw.size();
+        if (size_t(end - in) < c_registerCount * 4) return false;
+        for (auto& reg : record.regs) {
+            reg = in[0] | (in[1] << 8) | (in[2] << 16) | (uint32_t(in[3]) << 24);
+            in += 4;
+        }
+        uint64_t cycle = 0;
+        uint32_t expectedPC = 0;
+        uint32_t lastAddress = 0;
+        for (uint32_t i = 0; i < info.count; i++) {
+            uint64_t v;
+            if (!XorDelta::getVarInt(in, end, v)) return false;
+            cycle += v >> 3;
+            record.index = info.firstIndex + i;
+            record.cycle = cycle;
+            record.accessCount = (v >> 1) & 3;
+            record.pc = expectedPC;
+            if (v & 1) {
+                uint64_t delta;
+                if (!XorDelta::getVarInt(in, end, delta)) return false;
+                record.pc += unzigzag(delta);
+            }
+            if ((end - in) < 4) return false;
+            record.code = in[0] | (in[1] << 8) | (in[2] << 16) | (uint32_t(in[3]) << 24);
+            in += 4;
+            if (!XorDelta::getVarInt(in, end, record.changed)) return false;
+            for (unsigned r = 0; r < c_registerCount; r++) {
+                if (!(record.changed & (uint64_t(1) << r))) continue;
+                if (!XorDelta::getVarInt(in, end, v)) return false;
+                record.regs[r] ^= v;
+            }
+            if (record.accessCount > c_maxAccesses) return false;
+            for (unsigned a = 0; a < record.accessCount; a++) {
+                auto& access = record.accesses[a];
+                if (!XorDelta::getVarInt(in, end, v) || (in == end)) return false;
+                access.address = lastAddress ^ v;
+                lastAddress = access.address;
+                const uint8_t flags = *in++;
+                access.size = 1 << (flags & 3);
+                access.write = flags & 4;
+                access.value = 0;
+                if (access.write) {
+                    if (!XorDelta::getVarInt(in, end, v)) return false;
+                    access.value = v;
+                }
+            }
+            expectedPC = record.pc + 4;
+            if (record.index < first) continue;
+            if (record.index >= last) return true;
+            if (!callback(record)) return true;
+        }
+    }
+    return true;
+}
+
+std::optional<uint64_t> Reader::findCycle(uint64_t cycle) {
+    auto it = std::upper_bound(m_chunks.begin(), m_chunks.end(), cycle,
+                               [](uint64_t cycle, const ChunkInfo& chunk) { return cycle < chunk.firstCycle; });
+    if (it != m_chunks.begin()) it--;
+    std::optional<uint64_t> ret;
+    for (; it != m_chunks.end() && !ret.has_value(); it++) {
+        read(it->firstIndex, it->count, [&ret, cycle](const Record& record) {
+            if (record.cycle < cycle) return true;
+            ret = record.index;
+            return false;
+        });
+    }
+    return ret;
+}
@@ -0,0 +1,177 @@
+/*
+
+MIT License
+
+Copyright (c) 2025 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "support/file.h"
+
+namespace PCSX {
+
+// A compact binary format for long instruction traces. Records are gathered
+// in chunks of up to c_chunkRecords instructions, and each chunk starts with
+// a full copy of the registers, so that any of them can be decoded on its
+// own. Within a chunk, each record only holds what changed:
+//   - a varint with the cycle delta, the amount of memory accesses, and
+//     whether the pc isn't the previous one plus 4, in which case a zigzag
+//     varint delta follows,
+//   - the opcode, as 4 little endian bytes,
+//   - a varint mask of the registers which changed, followed by a varint of
+//     each new value XORed with the old one,
+//   - for each memory access, a varint of its address XORed with the one of
+//     the previous access, a flags byte with the size and direction, and a
+//     varint of the value for writes.
+// Chunks are then deflated independently, on a background thread, and an
+// index of all of them is appended when closing the file. Files without an
+// index, such as the ones left behind by a crash, get their chunks scanned.
+namespace InstructionTrace {
+
+// The 32 GPRs, lo, hi, then the COP0 Status, Cause, and EPC registers.
+static constexpr unsigned c_registerCount = 37;
+static constexpr unsigned c_maxAccesses = 3;
+static constexpr uint32_t c_chunkRecords = 65536;
+
+struct MemoryAccess {
+    uint32_t address;
+    uint32_t value;  // Only meaningful for writes.
+    uint8_t size;
+    bool write;
+};
+
+struct Record {
+    uint64_t index;
+    uint64_t cycle;
+    uint32_t pc;
+    uint32_t code;
+    // Which registers the instruction changed, and all of them after it ran.
+    uint64_t changed;
+    uint32_t regs[c_registerCount];
+    unsigned accessCount;
+    MemoryAccess accesses[c_maxAccesses];
+};
+
+struct ChunkInfo {
+    uint64_t offset;
+    uint64_t firstIndex;
+    uint64_t firstCycle;
+    uint32_t count;
+};
+
+class Writer {
+  public:
+    ~Writer() { close(); }
+    // Truncates the file, and starts the background thread. The registers
+    // are the state before the first instruction.
+    bool open(const std::filesystem::path& path, const uint32_t regs[c_registerCount]);
+    // Flushes everything, writes the index, and waits for the file to be done.
+    void close();
+    bool isOpen() const { return m_thread.joinable(); }
+    uint64_t count() const { return m_index; }
+    uint64_t bytesWritten() const;
+    // Whether the background thread failed to write, which stops it.
+    bool failed() const;
+
+    // Each record is framed by begin and end, with the memory accesses of
+    // the instruction in between. Accesses past c_maxAccesses are dropped.
+    void begin(uint64_t cycle, uint32_t pc, uint32_t code);
+    void access(uint32_t address, unsigned size, uint32_t value, bool write) {
+        if (!m_inRecord || (m_accessCount == c_maxAccesses)) return;
+        m_accesses[m_accessCount++] = {address, value, uint8_t(size), write};
+    }
+    void end(const uint32_t regs[c_registerCount]);
+
+  private:
+    struct Pending {
+        std::vector<uint8_t> data;
+        ChunkInfo info;
+    };
+    void startChunk();
+    void flushChunk();
+    void run();
+
+    IO<File> m_file;
+    std::thread m_thread;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<Pending> m_queue;
+    bool m_closing = false;
+    bool m_failed = false;
+    uint64_t m_bytesWritten = 0;
+    std::vector<ChunkInfo> m_chunks;
+
+    // Only touched by the emulation thread.
+    std::vector<uint8_t> m_chunk;
+    ChunkInfo m_chunkInfo;
+    uint64_t m_index = 0;
+    uint64_t m_lastCycle;
+    uint32_t m_expectedPC;
+    uint32_t m_lastAddress;
+    uint32_t m_regs[c_registerCount];
+    bool m_inRecord = false;
+    uint32_t m_pc;
+    uint32_t m_code;
+    uint64_t m_cycle;
+    unsigned m_accessCount = 0;
+    MemoryAccess m_accesses[c_maxAccesses];
+};
+
+class Reader {
+  public:
+    bool open(const std::filesystem::path& path);
+    uint64_t count() const { return m_chunks.empty() ? 0 : m_chunks.back().firstIndex + m_chunks.back().count; }
+    const std::vector<ChunkInfo>& chunks() const { return m_chunks; }
+    // Decodes up to count records, starting at the first one, and calls the
+    // callback for each, until it returns false. Returns false if the file
+    // is corrupted.
+    bool read(uint64_t first, uint64_t count, const std::function<bool(const Record&)>& callback);
+    // The index of the first record which ran at or after that cycle.
+    std::optional<uint64_t> findCycle(uint64_t cycle);
+
+  private:
+    bool readIndex();
+    bool scanChunks();
+    bool loadChunk(size_t chunk);
+
+    IO<File> m_file;
+    std::vector<ChunkInfo> m_chunks;
+    std::vector<uint8_t> m_raw;
+    size_t m_loadedChunk = SIZE_MAX;
+};
+
+}  // namespace InstructionTrace
+
+}  // namespace PCSX
@@ -153,6 +153,8 @@ class List final {
         m_count = 0;
     }
     iterator insert(iterator i, Node* node) {
+        // Inserting a node right before itself leaves it where it is.
+        if (i.m_node == node) return i;
         node->unlink();
         node->m_next = i.m_node;
         node->m_prev = i.m_node->m_prev;
@@ -0,0 +1,63 @@
+/*
+
+MIT License
+
+Copyright (c) 2025 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#if !defined(_WIN32) && !defined(_WIN64)
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "support/mmapfile.h"
+
+PCSX::MmapFile::MmapFile(const char *filename) : File(RO_SEEKABLE), m_filename(filename) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return;
+    struct stat st;
+    // Empty files can't be mapped, and aren't very useful anyway.
+    if ((fstat(fd, &st) == 0) && (st.st_size > 0)) {
+        void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (data != MAP_FAILED) {
+            m_data = reinterpret_cast<const uint8_t *>(data);
+            m_size = st.st_size;
+        }
+    }
+    // The mapping holds its own reference to the file.
+    ::close(fd);
+}
+
+void PCSX::MmapFile::closeInternal() {
+    if (!m_data) return;
+    munmap(const_cast<uint8_t *>(m_data), m_size);
+    m_data = nullptr;
+}
+
+void PCSX::MmapFile::prefetch() {
+    if (!m_data) return;
+    madvise(const_cast<uint8_t *>(m_data), m_size, MADV_WILLNEED);
+}
+
+#endif
@@ -0,0 +1,79 @@
+/*
+
+MIT License
+
+Copyright (c) 2025 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#if defined(_WIN32) || defined(_WIN64)
+
+#include <malloc.h>
+
+#include "support/mmapfile.h"
+#include "support/windowswrapper.h"
+
+PCSX::MmapFile::MmapFile(const char *filename) : File(RO_SEEKABLE), m_filename(filename) {
+    int needed = MultiByteToWideChar(CP_UTF8, 0, filename, -1, NULL, 0);
+    if (needed <= 0) return;
+    LPWSTR str = (LPWSTR)_malloca(needed * sizeof(wchar_t));
+    MultiByteToWideChar(CP_UTF8, 0, filename, -1, str, needed);
+    HANDLE file =
+        CreateFileW(str, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    _freea(str);
+    if (file == INVALID_HANDLE_VALUE) return;
+
+    LARGE_INTEGER size;
+    // Empty files can't be mapped, and aren't very useful anyway.
+    if (GetFileSizeEx(file, &size) && (size.QuadPart > 0)) {
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping) {
+            void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            if (data) {
+                m_data = reinterpret_cast<const uint8_t *>(data);
+                m_size = size.QuadPart;
+                m_mappingHandle = mapping;
+            } else {
+                CloseHandle(mapping);
+            }
+        }
+    }
+    // The mapping holds its own reference to the file.
+    CloseHandle(file);
+}
+
+void PCSX::MmapFile::closeInternal() {
+    if (!m_data) return;
+    UnmapViewOfFile(m_data);
+    CloseHandle(m_mappingHandle);
+    m_data = nullptr;
+    m_mappingHandle = nullptr;
+}
+
+void PCSX::MmapFile::prefetch() {
+    if (!m_data) return;
+    WIN32_MEMORY_RANGE_ENTRY range;
+    range.VirtualAddress = const_cast<uint8_t *>(m_data);
+    range.NumberOfBytes = m_size;
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+}
+
+#endif
@@ -0,0 +1,65 @@
+/*
+
+MIT License
+
+Copyright (c) 2025 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "support/mmapfile.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+ssize_t PCSX::MmapFile::rSeek(ssize_t pos, int wheel) {
+    if (failed()) throw std::runtime_error("Invalid file");
+    switch (wheel) {
+        case SEEK_SET:
+            m_ptrR = pos;
+            break;
+        case SEEK_END:
+            m_ptrR = m_size + pos;
+            break;
+        case SEEK_CUR:
+            m_ptrR += pos;
+            break;
+    }
+    m_ptrR = std::min(m_ptrR, m_size);
+    return m_ptrR;
+}
+
+ssize_t PCSX::MmapFile::read(void *dest, size_t size) {
+    if (failed()) throw std::runtime_error("Invalid file");
+    if (m_ptrR >= m_size) return -1;
+    size = std::min(size, m_size - m_ptrR);
+    memcpy(dest, m_data + m_ptrR, size);
+    m_ptrR += size;
+    return size;
+}
+
+ssize_t PCSX::MmapFile::readAt(void *dest, size_t size, size_t ptr) {
+    if (failed()) throw std::runtime_error("Invalid file");
+    if (ptr >= m_size) return -1;
+    size = std::min(size, m_size - ptr);
+    memcpy(dest, m_data + ptr, size);
+    return size;
+}
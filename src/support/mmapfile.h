@@ -0,0 +1,84 @@
+/*
+
+MIT License
+
+Copyright (c) 2025 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+
+#include "support/file.h"
+
+namespace PCSX {
+
+// Read-only file, mapped in memory in its entirety. Reads are plain memory copies
+// which don't touch the file cursor, so readAt is thread-safe, and the contents
+// can be accessed directly through data(), without copying anything at all.
+// The mapped pages are backed by the OS' file cache, so several processes mapping
+// the same file will share the same physical memory.
+class MmapFile : public File {
+  public:
+    virtual ssize_t rSeek(ssize_t pos, int wheel) final override;
+    virtual ssize_t rTell() final override { return m_ptrR; }
+    virtual size_t size() final override { return m_size; }
+    virtual ssize_t read(void* dest, size_t size) final override;
+    virtual ssize_t readAt(void* dest, size_t size, size_t ptr) final override;
+    virtual bool eof() final override { return m_ptrR >= m_size; }
+    virtual File* dup() final override { return new MmapFile(m_filename); }
+    virtual bool failed() final override { return m_data == nullptr; }
+    virtual std::filesystem::path filename() final override { return m_filename; }
+    virtual int getc() final override {
+        if (failed()) throw std::runtime_error("Invalid file");
+        if (m_ptrR >= m_size) return -1;
+        return m_data[m_ptrR++];
+    }
+
+    // Map the file in read-only mode.
+    MmapFile(const std::filesystem::path& filename) : MmapFile(filename.u8string()) {}
+#if defined(__cpp_lib_char8_t)
+    MmapFile(const std::u8string& filename) : MmapFile(reinterpret_cast<const char*>(filename.c_str())) {}
+#endif
+    MmapFile(const std::string& filename) : MmapFile(filename.c_str()) {}
+    MmapFile(const char* filename);
+
+    // Pointer to the whole file's contents, valid until the file is closed.
+    const uint8_t* data() { return m_data; }
+    // Asks the OS to start reading the whole file in the background, so that
+    // accessing it later won't stall on page faults.
+    void prefetch();
+
+  private:
+    virtual void closeInternal() final override;
+    const std::filesystem::path m_filename;
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    size_t m_ptrR = 0;
+    void* m_mappingHandle = nullptr;
+};
+
+}  // namespace PCSX
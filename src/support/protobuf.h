@@ -92,6 +92,11 @@ class InSlice {
         skipBytes(size);
         memcpy(data, m_data + m_ptr - size, size);
     }
+    // Returns a pointer straight into the slice's data, which needs to outlive it.
+    constexpr const uint8_t *borrowBytes(uint64_t size) {
+        skipBytes(size);
+        return m_data + m_ptr - size;
+    }
     constexpr void skipBytes(uint64_t size) {
         boundsCheck(size);
         m_ptr += size;
@@ -120,9 +125,13 @@ class InSlice {
     }
 };
 
+// Messages can compute their serialized size ahead of time, which is what
+// reserve() should be called with before serializing them, so that the whole
+// message is written in a single buffer, without any reallocation.
 class OutSlice {
   public:
-    void putU8(uint8_t value) { m_data += std::string(reinterpret_cast<const char *>(&value), 1); }
+    void reserve(uint64_t size) { m_data.reserve(size); }
+    void putU8(uint8_t value) { m_data.push_back(static_cast<char>(value)); }
     void putU16(uint16_t value) {
         putU8(value & 0xff);
         value >>= 8;
@@ -138,9 +147,7 @@ class OutSlice {
         value >>= 32;
         putU32(value & 0xffffffff);
     }
-    void putBytes(const uint8_t *bytes, uint64_t size) {
-        m_data += std::string(reinterpret_cast<const char *>(bytes), size);
-    }
+    void putBytes(const uint8_t *bytes, uint64_t size) { m_data.append(reinterpret_cast<const char *>(bytes), size); }
     void putBytes(const std::string &str) { m_data += str; }
     void putSlice(OutSlice *slice) { m_data += slice->m_data; }
     void putVarInt(uint64_t value) {
@@ -151,6 +158,11 @@ class OutSlice {
             putU8(b | (value ? 0x80 : 0x00));
         } while (value);
     }
+    static constexpr uint64_t varIntSize(uint64_t value) {
+        uint64_t size = 1;
+        while (value >>= 7) size++;
+        return size;
+    }
     std::string finalize() { return std::move(m_data); }
 
   private:
@@ -173,6 +185,7 @@ struct FieldType {
 #if 0
 struct Int8 : public FieldType<int8_t, 0> {
     void serialize(OutSlice *slice) const { slice->putVarInt(value); }
+    constexpr uint64_t serializedSize() const { return OutSlice::varIntSize(value); }
     constexpr void deserialize(InSlice *slice, unsigned) { value = static_cast<int8_t>(slice->getVarInt()); }
     static constexpr char const typeName[] = "int32";
 };
@@ -181,6 +194,7 @@ struct Int8 : public FieldType<int8_t, 0> {
 struct Int16 : public FieldType<int16_t, 0> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putVarInt(value); }
+    constexpr uint64_t serializedSize() const { return OutSlice::varIntSize(value); }
     constexpr void deserialize(InSlice *slice, unsigned) { value = static_cast<int16_t>(slice->getVarInt()); }
     static constexpr char const typeName[] = "int32";
 };
@@ -188,6 +202,7 @@ struct Int16 : public FieldType<int16_t, 0> {
 struct Int32 : public FieldType<int32_t, 0> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putVarInt(value); }
+    constexpr uint64_t serializedSize() const { return OutSlice::varIntSize(value); }
     constexpr void deserialize(InSlice *slice, unsigned) { value = static_cast<int32_t>(slice->getVarInt()); }
     static constexpr char const typeName[] = "int32";
 };
@@ -195,6 +210,7 @@ struct Int32 : public FieldType<int32_t, 0> {
 struct Int64 : public FieldType<int64_t, 0> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putVarInt(value); }
+    constexpr uint64_t serializedSize() const { return OutSlice::varIntSize(value); }
     constexpr void deserialize(InSlice *slice, unsigned) { value = slice->getVarInt(); }
     static constexpr char const typeName[] = "int64";
 };
@@ -202,6 +218,7 @@ struct Int64 : public FieldType<int64_t, 0> {
 struct UInt8 : public FieldType<uint8_t, 0> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putVarInt(value); }
+    constexpr uint64_t serializedSize() const { return OutSlice::varIntSize(value); }
     constexpr void deserialize(InSlice *slice, unsigned) { value = static_cast<uint8_t>(slice->getVarInt()); }
     static constexpr char const typeName[] = "uint32";
 };
@@ -209,6 +226,7 @@ struct UInt8 : public FieldType<uint8_t, 0> {
 struct UInt16 : public FieldType<uint16_t, 0> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putVarInt(value); }
+    constexpr uint64_t serializedSize() const { return OutSlice::varIntSize(value); }
     constexpr void deserialize(InSlice *slice, unsigned) { value = static_cast<uint16_t>(slice->getVarInt()); }
     static constexpr char const typeName[] = "uint32";
 };
@@ -216,6 +234,7 @@ struct UInt16 : public FieldType<uint16_t, 0> {
 struct UInt32 : public FieldType<uint32_t, 0> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putVarInt(value); }
+    constexpr uint64_t serializedSize() const { return OutSlice::varIntSize(value); }
     constexpr void deserialize(InSlice *slice, unsigned) { value = static_cast<uint32_t>(slice->getVarInt()); }
     static constexpr char const typeName[] = "uint32";
 };
@@ -223,6 +242,7 @@ struct UInt32 : public FieldType<uint32_t, 0> {
 struct UInt64 : public FieldType<uint64_t, 0> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putVarInt(value); }
+    constexpr uint64_t serializedSize() const { return OutSlice::varIntSize(value); }
     constexpr void deserialize(InSlice *slice, unsigned) { value = slice->getVarInt(); }
     static constexpr char const typeName[] = "uint64";
 };
@@ -230,6 +250,7 @@ struct UInt64 : public FieldType<uint64_t, 0> {
 struct SInt32 : public FieldType<int32_t, 0> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putVarInt((value << 1) ^ (value >> 31)); }
+    constexpr uint64_t serializedSize() const { return OutSlice::varIntSize((value << 1) ^ (value >> 31)); }
     constexpr void deserialize(InSlice *slice, unsigned) {
         value = static_cast<int32_t>(slice->getVarInt());
         value = (value >> 1) ^ -(value & 1);
@@ -240,6 +261,7 @@ struct SInt32 : public FieldType<int32_t, 0> {
 struct SInt64 : public FieldType<int64_t, 0> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putVarInt((value << 1) ^ (value >> 63)); }
+    constexpr uint64_t serializedSize() const { return OutSlice::varIntSize((value << 1) ^ (value >> 63)); }
     constexpr void deserialize(InSlice *slice, unsigned) {
         value = slice->getVarInt();
         value = (value >> 1) ^ -(value & 1);
@@ -250,6 +272,7 @@ struct SInt64 : public FieldType<int64_t, 0> {
 struct Bool : public FieldType<bool, 0> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putVarInt(value); }
+    constexpr uint64_t serializedSize() const { return OutSlice::varIntSize(value); }
     constexpr void deserialize(InSlice *slice, unsigned) { value = slice->getVarInt(); }
     static constexpr char const typeName[] = "bool";
 };
@@ -257,6 +280,7 @@ struct Bool : public FieldType<bool, 0> {
 struct Fixed64 : public FieldType<uint64_t, 1> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putU64(value); }
+    constexpr uint64_t serializedSize() const { return 8; }
     constexpr void deserialize(InSlice *slice, unsigned) { value = slice->getU64(); }
     static constexpr char const typeName[] = "fixed64";
 };
@@ -264,6 +288,7 @@ struct Fixed64 : public FieldType<uint64_t, 1> {
 struct SFixed64 : public FieldType<int64_t, 1> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putU64(value); }
+    constexpr uint64_t serializedSize() const { return 8; }
     constexpr void deserialize(InSlice *slice, unsigned) { value = slice->getU64(); }
     static constexpr char const typeName[] = "sfixed64";
 };
@@ -277,6 +302,7 @@ struct Double : public FieldType<double, 1> {
         } u = {value};
         slice->putU64(u.v);
     }
+    constexpr uint64_t serializedSize() const { return 8; }
     constexpr void deserialize(InSlice *slice, unsigned) {
         union {
             uint64_t v;
@@ -293,6 +319,7 @@ struct String : public FieldType<std::string, 2> {
         slice->putVarInt(value.size());
         slice->putBytes(value);
     }
+    constexpr uint64_t serializedSize() const { return OutSlice::varIntSize(value.size()) + value.size(); }
     void deserialize(InSlice *slice, unsigned) { value = slice->getBytes(slice->getVarInt()); }
     static constexpr char const typeName[] = "string";
 };
@@ -303,6 +330,7 @@ struct Bytes : public FieldType<std::string, 2> {
         slice->putVarInt(value.size());
         slice->putBytes(value);
     }
+    constexpr uint64_t serializedSize() const { return OutSlice::varIntSize(value.size()) + value.size(); }
     void deserialize(InSlice *slice, unsigned) { value = slice->getBytes(slice->getVarInt()); }
     static constexpr char const typeName[] = "bytes";
 };
@@ -328,11 +356,11 @@ struct FixedBytes {
         slice->putVarInt(amount);
         slice->putBytes(value, amount);
     }
+    static constexpr uint64_t serializedSize() { return OutSlice::varIntSize(amount) + amount; }
     constexpr void deserialize(InSlice *slice, unsigned) {
         uint64_t size = slice->getVarInt();
         if (size > amount) throw OutOfBoundError();
-        reset();
-        slice->getBytes(value, size);
+        copyFrom(slice->borrowBytes(size), size);
     }
     static constexpr char const typeName[] = "bytes";
     uint8_t *value = nullptr;
@@ -343,6 +371,12 @@ struct FixedBytes {
         allocate();
         memcpy(value, src, amount);
     }
+    // Shorter sources are padded with zeroes.
+    void copyFrom(const uint8_t *src, size_t size) {
+        allocate();
+        if (size) memcpy(value, src, size);
+        memset(value + size, 0, amount - size);
+    }
     constexpr void copyTo(uint8_t *dst) const {
         if (!value) {
             memset(dst, 0, amount);
@@ -355,6 +389,7 @@ struct FixedBytes {
         allocate();
         memset(value, 0, amount);
     }
+    static constexpr size_t capacity = amount;
     static constexpr unsigned wireType = 2;
     static constexpr bool matches(unsigned otherWireType) { return otherWireType == 2; }
     constexpr bool hasData() const { return value; }
@@ -363,6 +398,7 @@ struct FixedBytes {
 struct Fixed32 : public FieldType<uint32_t, 5> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putU32(value); }
+    constexpr uint64_t serializedSize() const { return 4; }
     constexpr void deserialize(InSlice *slice, unsigned) { value = slice->getU32(); }
     static constexpr char const typeName[] = "fixed32";
 };
@@ -370,6 +406,7 @@ struct Fixed32 : public FieldType<uint32_t, 5> {
 struct SFixed32 : public FieldType<int32_t, 5> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putU32(value); }
+    constexpr uint64_t serializedSize() const { return 4; }
     constexpr void deserialize(InSlice *slice, unsigned) { value = slice->getU32(); }
     static constexpr char const typeName[] = "sfixed32";
 };
@@ -383,6 +420,7 @@ struct Float : public FieldType<float, 5> {
         } u = {value};
         slice->putU32(u.v);
     }
+    constexpr uint64_t serializedSize() const { return 4; }
     constexpr void deserialize(InSlice *slice, unsigned) {
         union {
             uint64_t v;
@@ -434,6 +472,10 @@ struct FieldRef<FieldType, irqus::typestring<C...>, fieldNumberValue> {
         const FieldType *field = reinterpret_cast<const FieldType *>(&ref);
         field->serialize(slice);
     }
+    constexpr uint64_t serializedSize() const {
+        const FieldType *field = reinterpret_cast<const FieldType *>(&ref);
+        return field->serializedSize();
+    }
     constexpr void deserialize(InSlice *slice, unsigned wireType) {
         FieldType *field = reinterpret_cast<FieldType *>(&copy);
         field->deserialize(slice, wireType);
@@ -452,6 +494,10 @@ struct FieldRef<FieldType, irqus::typestring<C...>, fieldNumberValue> {
     type copy = type();
 };
 
+// Points to a FixedBytes blob living outside of the message, such as the
+// emulated memory. It is serialized straight from there, and deserializing it
+// only records where the data is in the input, which is then copied over on
+// commit(), so the input needs to stay alive until then.
 template <typename FieldType, typename name, uint64_t fieldNumberValue>
 struct FieldPtr;
 template <typename FieldType, char... C, uint64_t fieldNumberValue>
@@ -472,11 +518,19 @@ struct FieldPtr<FieldType, irqus::typestring<C...>, fieldNumberValue> {
         const FieldType *field = reinterpret_cast<const FieldType *>(&ref);
         field->serialize(slice);
     }
-    constexpr void deserialize(InSlice *slice, unsigned wireType) { copy.deserialize(slice, wireType); }
+    constexpr uint64_t serializedSize() const {
+        const FieldType *field = reinterpret_cast<const FieldType *>(&ref);
+        return field->serializedSize();
+    }
+    constexpr void deserialize(InSlice *slice, unsigned wireType) {
+        pendingSize = slice->getVarInt();
+        if (pendingSize > FieldType::capacity) throw OutOfBoundError();
+        pending = slice->borrowBytes(pendingSize);
+    }
     constexpr void reset() {}
     constexpr void commit() {
         FieldType *field = reinterpret_cast<FieldType *>(&ref);
-        field->copyFrom(copy.value);
+        field->copyFrom(pending, pendingSize);
     }
     constexpr bool hasData() const {
         const FieldType *field = reinterpret_cast<const FieldType *>(&ref);
@@ -487,7 +541,8 @@ struct FieldPtr<FieldType, irqus::typestring<C...>, fieldNumberValue> {
 
   private:
     type ref;
-    FieldType copy = FieldType();
+    const uint8_t *pending = nullptr;
+    uint64_t pendingSize = 0;
 };
 
 template <typename FieldType, size_t amount, typename name, uint64_t fieldNumberValue>
@@ -514,22 +569,29 @@ struct RepeatedField<FieldType, amount, irqus::typestring<C...>, fieldNumberValu
     void serialize(OutSlice *slice) const {
         if (FieldType::wireType == 2) {
             for (const auto &v : value) {
-                OutSlice subSlice;
-                v.serialize(&subSlice);
-                std::string subSliceData = subSlice.finalize();
                 slice->putVarInt((fieldNumber << 3) | FieldType::wireType);
-                slice->putVarInt(subSliceData.size());
-                slice->putBytes(subSliceData);
+                slice->putVarInt(v.serializedSize());
+                v.serialize(slice);
             }
         } else {
-            OutSlice subSlice;
+            slice->putVarInt(packedSize());
+            for (const auto &v : value) {
+                v.serialize(slice);
+            }
+        }
+    }
+    uint64_t serializedSize() const {
+        if (FieldType::wireType == 2) {
+            uint64_t size = 0;
             for (const auto &v : value) {
-                v.serialize(&subSlice);
+                uint64_t elementSize = v.serializedSize();
+                size += OutSlice::varIntSize((fieldNumber << 3) | FieldType::wireType);
+                size += OutSlice::varIntSize(elementSize) + elementSize;
             }
-            std::string subSliceData = subSlice.finalize();
-            slice->putVarInt(subSliceData.size());
-            slice->putBytes(subSliceData);
+            return size;
         }
+        uint64_t size = packedSize();
+        return OutSlice::varIntSize(size) + size;
     }
     void deserialize(InSlice *slice, unsigned wireType) {
         if (FieldType::wireType != wireType) {
@@ -545,6 +607,11 @@ struct RepeatedField<FieldType, amount, irqus::typestring<C...>, fieldNumberValu
     constexpr void commit() {}
 
   private:
+    uint64_t packedSize() const {
+        uint64_t size = 0;
+        for (const auto &v : value) size += v.serializedSize();
+        return size;
+    }
     void deserializeOne(InSlice *slice, unsigned wireType) {
         if (count >= amount) throw OutOfBoundError();
         if (FieldType::wireType == 2) {
@@ -583,24 +650,32 @@ struct RepeatedFieldRef<FieldType, amount, irqus::typestring<C...>, fieldNumberV
     void serialize(OutSlice *slice) const {
         if (FieldType::wireType == 2) {
             for (size_t i = 0; i < amount; i++) {
-                OutSlice subSlice;
                 FieldType *field = reinterpret_cast<FieldType *>(ref + i);
-                field->serialize(&subSlice);
-                std::string subSliceData = subSlice.finalize();
                 slice->putVarInt((fieldNumber << 3) | FieldType::wireType);
-                slice->putVarInt(subSliceData.size());
-                slice->putBytes(subSliceData);
+                slice->putVarInt(field->serializedSize());
+                field->serialize(slice);
             }
         } else {
-            OutSlice subSlice;
+            slice->putVarInt(packedSize());
+            for (size_t i = 0; i < amount; i++) {
+                FieldType *field = reinterpret_cast<FieldType *>(ref + i);
+                field->serialize(slice);
+            }
+        }
+    }
+    uint64_t serializedSize() const {
+        if (FieldType::wireType == 2) {
+            uint64_t size = 0;
             for (size_t i = 0; i < amount; i++) {
                 FieldType *field = reinterpret_cast<FieldType *>(ref + i);
-                field->serialize(&subSlice);
+                uint64_t elementSize = field->serializedSize();
+                size += OutSlice::varIntSize((fieldNumber << 3) | FieldType::wireType);
+                size += OutSlice::varIntSize(elementSize) + elementSize;
             }
-            std::string subSliceData = subSlice.finalize();
-            slice->putVarInt(subSliceData.size());
-            slice->putBytes(subSliceData);
+            return size;
         }
+        uint64_t size = packedSize();
+        return OutSlice::varIntSize(size) + size;
     }
     void deserialize(InSlice *slice, unsigned wireType) {
         if (FieldType::wireType != wireType) {
@@ -616,6 +691,14 @@ struct RepeatedFieldRef<FieldType, amount, irqus::typestring<C...>, fieldNumberV
     constexpr void commit() { memcpy(ref, copy, amount * sizeof(innerType)); }
 
   private:
+    uint64_t packedSize() const {
+        uint64_t size = 0;
+        for (size_t i = 0; i < amount; i++) {
+            FieldType *field = reinterpret_cast<FieldType *>(ref + i);
+            size += field->serializedSize();
+        }
+        return size;
+    }
     void deserializeOne(InSlice *slice, unsigned wireType) {
         if (count >= amount) throw OutOfBoundError();
         FieldType *field = reinterpret_cast<FieldType *>(copy + count++);
@@ -651,23 +734,30 @@ struct RepeatedVariableField<FieldType, irqus::typestring<C...>, fieldNumberValu
     void serialize(OutSlice *slice) const {
         if (FieldType::wireType == 2) {
             for (const auto &v : value) {
-                OutSlice subSlice;
-                v.serialize(&subSlice);
-                std::string subSliceData = subSlice.finalize();
                 slice->putVarInt((fieldNumber << 3) | FieldType::wireType);
-                slice->putVarInt(subSliceData.size());
-                slice->putBytes(subSliceData);
+                slice->putVarInt(v.serializedSize());
+                v.serialize(slice);
             }
         } else {
-            OutSlice subSlice;
+            slice->putVarInt(packedSize());
             for (const auto &v : value) {
-                v.serialize(&subSlice);
+                v.serialize(slice);
             }
-            std::string subSliceData = subSlice.finalize();
-            slice->putVarInt(subSliceData.size());
-            slice->putBytes(subSliceData);
         }
     }
+    uint64_t serializedSize() const {
+        if (FieldType::wireType == 2) {
+            uint64_t size = 0;
+            for (const auto &v : value) {
+                uint64_t elementSize = v.serializedSize();
+                size += OutSlice::varIntSize((fieldNumber << 3) | FieldType::wireType);
+                size += OutSlice::varIntSize(elementSize) + elementSize;
+            }
+            return size;
+        }
+        uint64_t size = packedSize();
+        return OutSlice::varIntSize(size) + size;
+    }
     void deserialize(InSlice *slice, unsigned wireType) {
         if (FieldType::wireType != wireType) {
             InSlice subSlice = slice->getSubSlice(slice->getVarInt());
@@ -682,6 +772,11 @@ struct RepeatedVariableField<FieldType, irqus::typestring<C...>, fieldNumberValu
     constexpr void commit() {}
 
   private:
+    uint64_t packedSize() const {
+        uint64_t size = 0;
+        for (const auto &v : value) size += v.serializedSize();
+        return size;
+    }
     void deserializeOne(InSlice *slice, unsigned wireType) {
         value.resize(++count);
         if (FieldType::wireType == 2) {
@@ -714,11 +809,12 @@ struct MessageField<MessageType, irqus::typestring<C...>, fieldNumberValue> : pu
     }
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const {
-        OutSlice subSlice;
-        MessageType::serialize(&subSlice);
-        std::string subSliceData = subSlice.finalize();
-        slice->putVarInt(subSliceData.size());
-        slice->putBytes(subSliceData);
+        slice->putVarInt(MessageType::serializedSize());
+        MessageType::serialize(slice);
+    }
+    uint64_t serializedSize() const {
+        uint64_t size = MessageType::serializedSize();
+        return OutSlice::varIntSize(size) + size;
     }
     void deserialize(InSlice *slice, unsigned wireType) {
         InSlice subSlice = slice->getSubSlice(slice->getVarInt());
@@ -760,6 +856,8 @@ class Message<irqus::typestring<C...>, fields...> : private std::tuple<fields...
     }
     static constexpr bool needsToSerializeHeader() { return false; }
     constexpr void serialize(OutSlice *slice) const { serialize<0, fields...>(slice); }
+    // The exact amount of bytes serialize() is going to output.
+    constexpr uint64_t serializedSize() const { return serializedSize<0, fields...>(); }
     constexpr void deserialize(InSlice *slice, unsigned wireType) {
         while (slice->bytesLeft()) {
             uint64_t fieldNumber = slice->getVarInt();
@@ -822,6 +920,22 @@ class Message<irqus::typestring<C...>, fields...> : private std::tuple<fields...
         serialize<index + 1, nestedFields...>(slice);
     }
     template <size_t index>
+    constexpr uint64_t serializedSize() const {
+        return 0;
+    }
+    template <size_t index, typename FieldType, typename... nestedFields>
+    constexpr uint64_t serializedSize() const {
+        const FieldType &field = std::get<index>(*this);
+        uint64_t size = 0;
+        if (field.hasData()) {
+            if (!FieldType::needsToSerializeHeader()) {
+                size += OutSlice::varIntSize((FieldType::fieldNumber << 3) | FieldType::wireType);
+            }
+            size += field.serializedSize();
+        }
+        return size + serializedSize<index + 1, nestedFields...>();
+    }
+    template <size_t index>
     constexpr void deserialize(uint64_t fieldNumber, unsigned wireType, InSlice *slice) {
         // Unknown field, skip it.
         switch (wireType) {
@@ -890,6 +1004,7 @@ class EmptyMessage<irqus::typestring<C...>> {
     constexpr void reset() {}
     static constexpr bool needsToSerializeHeader() { return false; }
     constexpr void serialize(OutSlice *slice) const {}
+    constexpr uint64_t serializedSize() const { return 0; }
     constexpr void deserialize(InSlice *slice, unsigned wireType) {}
     constexpr bool hasData() const { return false; }
     constexpr void commit() {}
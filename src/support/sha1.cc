@@ -0,0 +1,145 @@
+/*
+
+MIT License
+
+Copyright (c) 2025 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "support/sha1.h"
+
+#include <cstring>
+
+PCSX::SHA1::SHA1() {
+    m_state[0] = 0x67452301;
+    m_state[1] = 0xefcdab89;
+    m_state[2] = 0x98badcfe;
+    m_state[3] = 0x10325476;
+    m_state[4] = 0xc3d2e1f0;
+}
+
+void PCSX::SHA1::update(const void* data_, uint64_t length) {
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(data_);
+    unsigned fill = m_length & 0x3f;
+
+    if (!length) return;
+
+    m_length += length;
+
+    if (fill && ((length + fill) >= 64)) {
+        unsigned stub = 64 - fill;
+        std::memcpy(m_buffer + fill, data, stub);
+        process(m_buffer);
+        data += stub;
+        length -= stub;
+        fill = 0;
+    }
+
+    while (length >= 64) {
+        process(data);
+        data += 64;
+        length -= 64;
+    }
+
+    if (length) std::memcpy(m_buffer + fill, data, length);
+}
+
+void PCSX::SHA1::finish(uint8_t digest[20]) {
+    uint8_t size[8];
+    uint64_t bitLength = m_length * 8;
+
+    // Unlike MD5, the length is stored big endian.
+    for (unsigned i = 0; i < 8; i++) size[i] = (bitLength >> (56 - i * 8)) & 0xff;
+
+    static const uint8_t sha1Padding[64] = {
+        0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    };
+
+    update(sha1Padding, 1 + ((55 - m_length) & 0x3f));
+    update(size, 8);
+
+    for (unsigned i = 0; i < 5; i++) {
+        digest[i * 4 + 0] = (m_state[i] >> 24) & 0xff;
+        digest[i * 4 + 1] = (m_state[i] >> 16) & 0xff;
+        digest[i * 4 + 2] = (m_state[i] >> 8) & 0xff;
+        digest[i * 4 + 3] = (m_state[i] >> 0) & 0xff;
+    }
+}
+
+static inline uint32_t get32(const uint8_t* src, unsigned pos) {
+    uint32_t ret = 0;
+    ret <<= 8;
+    ret |= src[pos + 0];
+    ret <<= 8;
+    ret |= src[pos + 1];
+    ret <<= 8;
+    ret |= src[pos + 2];
+    ret <<= 8;
+    ret |= src[pos + 3];
+    return ret;
+}
+
+static constexpr inline uint32_t rotl(uint32_t x, unsigned n) { return (x << n) | (x >> (32 - n)); }
+
+void PCSX::SHA1::process(const uint8_t* data) {
+    uint32_t W[80], a, b, c, d, e;
+
+    for (unsigned i = 0; i < 16; i++) W[i] = get32(data, i * 4);
+    for (unsigned i = 16; i < 80; i++) W[i] = rotl(W[i - 3] ^ W[i - 8] ^ W[i - 14] ^ W[i - 16], 1);
+
+    a = m_state[0];
+    b = m_state[1];
+    c = m_state[2];
+    d = m_state[3];
+    e = m_state[4];
+
+    for (unsigned i = 0; i < 80; i++) {
+        uint32_t f, k;
+        if (i < 20) {
+            f = (b & c) | (~b & d);
+            k = 0x5a827999;
+        } else if (i < 40) {
+            f = b ^ c ^ d;
+            k = 0x6ed9eba1;
+        } else if (i < 60) {
+            f = (b & c) | (b & d) | (c & d);
+            k = 0x8f1bbcdc;
+        } else {
+            f = b ^ c ^ d;
+            k = 0xca62c1d6;
+        }
+        uint32_t temp = rotl(a, 5) + f + e + k + W[i];
+        e = d;
+        d = c;
+        c = rotl(b, 30);
+        b = a;
+        a = temp;
+    }
+
+    m_state[0] += a;
+    m_state[1] += b;
+    m_state[2] += c;
+    m_state[3] += d;
+    m_state[4] += e;
+}
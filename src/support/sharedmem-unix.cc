@@ -28,6 +28,7 @@ SOFTWARE.
 
 #include <assert.h>
 #include <fcntl.h>
+#include <stdlib.h>
 #include <string.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
@@ -81,8 +82,32 @@ bool PCSX::SharedMem::init(const char* id, size_t size, bool initToZero) {
     return !(doRawAlloc && id != nullptr);
 }
 
+bool PCSX::SharedMem::unshare() {
+    if (m_fd == -1) return true;
+    // Pointers to this memory are all over the place, so the private mapping
+    // has to land at the same address, replacing the shared one.
+    uint8_t* copy = (uint8_t*)malloc(m_size);
+    if (copy == nullptr) return false;
+    memcpy(copy, m_mem, m_size);
+    void* basePointer = mmap(m_mem, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+    if (basePointer == MAP_FAILED) {
+        free(copy);
+        return false;
+    }
+    memcpy(m_mem, copy, m_size);
+    free(copy);
+    // The name belongs to the parent, which will unlink it itself.
+    close(m_fd);
+    m_fd = -1;
+    m_sharedName.clear();
+    m_anonymous = true;
+    return true;
+}
+
 PCSX::SharedMem::~SharedMem() {
-    if (m_fd == -1) {
+    if (m_anonymous) {
+        munmap(m_mem, m_size);
+    } else if (m_fd == -1) {
         free(m_mem);
     } else {
         munmap(m_mem, m_size);
@@ -72,6 +72,9 @@ bool PCSX::SharedMem::init(const char* id, size_t size, bool initToZero) {
     return !(doRawAlloc && id != nullptr);
 }
 
+// There's no fork on Windows, so nothing would ever need this.
+bool PCSX::SharedMem::unshare() { return m_fileHandle == nullptr; }
+
 PCSX::SharedMem::~SharedMem() {
     if (m_fileHandle != nullptr) {
         UnmapViewOfFile(m_mem);
@@ -46,6 +46,14 @@ class SharedMem {
      */
     bool init(const char* id, size_t size, bool initToZero);
 
+    /**
+     * Turns a shared mapping back into private memory, at the same address
+     * and with the same contents, and stops advertising it. This is meant
+     * for a forked process, which otherwise would write straight into its
+     * parent's memory. Returns false if that's not possible on this platform.
+     */
+    bool unshare();
+
     uint8_t* getPtr() { return m_mem; }
     size_t getSize() { return m_size; }
 
@@ -61,6 +69,7 @@ class SharedMem {
     void* m_fileHandle = nullptr;
     std::string m_sharedName;
     int m_fd = -1;
+    bool m_anonymous = false;
 };
 
 }  // namespace PCSX
@@ -65,7 +65,7 @@ uv_timer_t PCSX::UvThreadOp::s_curlTimeout;
 CURLM *PCSX::UvThreadOp::s_curlMulti = nullptr;
 
 uint64_t PCSX::UvThreadOp::s_readSequence = 0;
-uint64_t PCSX::UvThreadOp::s_writeSequence = 0;
+std::atomic<uint64_t> PCSX::UvThreadOp::s_writeSequence = 0;
 
 void PCSX::UvThreadOp::startThread() {
     if (s_threadRunning) throw std::runtime_error("UV thread already running");
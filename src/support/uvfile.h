@@ -100,7 +100,7 @@ class UvThreadOp : public UvThreadOpListType::Node {
     static void request(std::function<void(uv_loop_t*)>&& functor) {
         UvRequest req;
         req.functor = std::move(functor);
-        req.sequence = s_writeSequence++;
+        req.sequence = s_writeSequence.fetch_add(1);
         s_queue.Enqueue(std::move(req));
         uv_async_send(&s_kicker);
     }
@@ -131,7 +131,9 @@ class UvThreadOp : public UvThreadOpListType::Node {
 
   private:
     static ConcurrentQueue<UvRequest> s_queue;
-    static uint64_t s_writeSequence;
+    // Requests can come from more than one thread, e.g. the read-ahead
+    // engine's workers, so this one needs to be atomic.
+    static std::atomic<uint64_t> s_writeSequence;
     static uint64_t s_readSequence;
 };
 
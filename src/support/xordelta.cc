@@ -0,0 +1,164 @@
+/*
+
+MIT License
+
+Copyright (c) 2025 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "support/xordelta.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+namespace {
+
+enum : unsigned { SAME = 0, LITERAL = 1, FILL = 2 };
+
+// Shorter runs are cheaper to leave in the middle of literals.
+constexpr size_t c_minRun = 8;
+
+class Encoder {
+  public:
+    Encoder(std::vector<uint8_t>& out) : m_out(out) {}
+    void same(size_t size) { m_same += size; }
+    // Tokenizes bytes which have already been XORed with the reference.
+    void bytes(const uint8_t* x, size_t size) {
+        size_t literal = 0;
+        size_t i = 0;
+        while (i < size) {
+            size_t j = i + 1;
+            while ((j < size) && (x[j] == x[i])) j++;
+            if ((j - i) >= c_minRun) {
+                flushLiteral(x + literal, i - literal);
+                if (x[i] == 0) {
+                    m_same += j - i;
+                } else {
+                    flushSame();
+                    token(FILL, j - i);
+                    m_out.push_back(x[i]);
+                }
+                literal = j;
+            }
+            i = j;
+        }
+        flushLiteral(x + literal, size - literal);
+    }
+    void flush() { flushSame(); }
+
+  private:
+    void token(unsigned type, size_t size) {
+        PCSX::XorDelta::putVarInt(m_out, (static_cast<uint64_t>(size) << 2) | type);
+    }
+    void flushSame() {
+        if (m_same == 0) return;
+        token(SAME, m_same);
+        m_same = 0;
+    }
+    void flushLiteral(const uint8_t* x, size_t size) {
+        if (size == 0) return;
+        flushSame();
+        token(LITERAL, size);
+        m_out.insert(m_out.end(), x, x + size);
+    }
+
+    std::vector<uint8_t>& m_out;
+    size_t m_same = 0;
+};
+
+}  // namespace
+
+void PCSX::XorDelta::putVarInt(std::vector<uint8_t>& out, uint64_t value) {
+    do {
+        uint8_t b = value & 0x7f;
+        value >>= 7;
+        out.push_back(b | (value ? 0x80 : 0x00));
+    } while (value);
+}
+
+bool PCSX::XorDelta::getVarInt(const uint8_t*& in, const uint8_t* end, uint64_t& value) {
+    value = 0;
+    for (unsigned shift = 0; (in < end) && (shift < 64); shift += 7) {
+        uint8_t b = *in++;
+        value |= static_cast<uint64_t>(b & 0x7f) << shift;
+        if ((b & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+void PCSX::XorDelta::encode(const uint8_t* data, size_t size, const uint8_t* reference, size_t referenceSize,
+                            std::vector<uint8_t>& out) {
+    Encoder encoder(out);
+    uint8_t x[c_pageSize];
+    for (size_t offset = 0; offset < size; offset += c_pageSize) {
+        const size_t pageSize = std::min(c_pageSize, size - offset);
+        const uint8_t* page = data + offset;
+        const size_t compared = offset < referenceSize ? std::min(pageSize, referenceSize - offset) : 0;
+        // Most pages don't change between two snapshots, so they aren't
+        // worth XORing before finding out.
+        if ((compared == pageSize) && (memcmp(page, reference + offset, pageSize) == 0)) {
+            encoder.same(pageSize);
+            continue;
+        }
+        for (size_t i = 0; i < compared; i++) x[i] = page[i] ^ reference[offset + i];
+        memcpy(x + compared, page + compared, pageSize - compared);
+        encoder.bytes(x, pageSize);
+    }
+    encoder.flush();
+}
+
+bool PCSX::XorDelta::decode(const uint8_t*& in, const uint8_t* end, uint8_t* out, size_t size,
+                            const uint8_t* reference, size_t referenceSize) {
+    size_t offset = 0;
+    while (offset < size) {
+        uint64_t token;
+        if (!getVarInt(in, end, token)) return false;
+        const uint64_t count = token >> 2;
+        if ((count == 0) || (count > size - offset)) return false;
+        const size_t referenced = offset < referenceSize ? std::min<size_t>(count, referenceSize - offset) : 0;
+        const uint8_t* ref = referenced ? reference + offset : nullptr;
+        uint8_t* dst = out + offset;
+        switch (token & 3) {
+            case SAME:
+                if (referenced) memcpy(dst, ref, referenced);
+                memset(dst + referenced, 0, count - referenced);
+                break;
+            case LITERAL:
+                if (static_cast<uint64_t>(end - in) < count) return false;
+                for (size_t i = 0; i < referenced; i++) dst[i] = in[i] ^ ref[i];
+                memcpy(dst + referenced, in + referenced, count - referenced);
+                in += count;
+                break;
+            case FILL: {
+                if (in == end) return false;
+                const uint8_t value = *in++;
+                for (size_t i = 0; i < referenced; i++) dst[i] = ref[i] ^ value;
+                memset(dst + referenced, value, count - referenced);
+                break;
+            }
+            default:
+                return false;
+        }
+        offset += count;
+    }
+    return true;
+}
@@ -0,0 +1,69 @@
+/*
+
+MIT License
+
+Copyright (c) 2025 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+namespace PCSX {
+
+// Run-length encoding of a buffer XORed against a reference buffer, which
+// makes for a compact and fast to apply delta between two versions of a
+// mostly unchanged buffer. Without a reference, this is plain run-length
+// encoding. Only the first referenceSize bytes of the data are compared
+// against the reference; anything past it is encoded as if XORed with zeroes.
+//
+// The encoding is a sequence of tokens, each starting with a varint whose low
+// two bits are the token type, and the rest is the amount of bytes covered:
+//   - 0: bytes identical to the reference,
+//   - 1: literal bytes to XOR with the reference, which follow the varint,
+//   - 2: a single byte to XOR with that many bytes of the reference.
+namespace XorDelta {
+
+static constexpr size_t c_pageSize = 4096;
+
+// The varints used by the tokens, for containers of encodings to use.
+void putVarInt(std::vector<uint8_t>& out, uint64_t value);
+bool getVarInt(const uint8_t*& in, const uint8_t* end, uint64_t& value);
+
+// Appends to out the encoding of size bytes of data. Tokens never span
+// further than size, so that encodings of consecutive buffers can be
+// concatenated, and decoded one after the other.
+void encode(const uint8_t* data, size_t size, const uint8_t* reference, size_t referenceSize,
+            std::vector<uint8_t>& out);
+
+// Decodes exactly size bytes into out, consuming tokens from in, which gets
+// advanced. The output can't overlap the reference. Returns false if the
+// encoding is corrupted or too short.
+bool decode(const uint8_t*& in, const uint8_t* end, uint8_t* out, size_t size, const uint8_t* reference,
+            size_t referenceSize);
+
+}  // namespace XorDelta
+
+}  // namespace PCSX
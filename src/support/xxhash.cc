@@ -0,0 +1,116 @@
+/*
+
+MIT License
+
+Copyright (c) 2025 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "support/xxhash.h"
+
+#include <string.h>
+
+namespace {
+
+constexpr uint64_t c_prime1 = 0x9e3779b185ebca87ULL;
+constexpr uint64_t c_prime2 = 0xc2b2ae3d27d4eb4fULL;
+constexpr uint64_t c_prime3 = 0x165667b19e3779f9ULL;
+constexpr uint64_t c_prime4 = 0x85ebca77c2b2ae63ULL;
+constexpr uint64_t c_prime5 = 0x27d4eb2f165667c5ULL;
+
+inline uint64_t rotl(uint64_t x, unsigned r) { return (x << r) | (x >> (64 - r)); }
+
+// The reference reads are little endian, which is all we run on.
+inline uint64_t read64(const uint8_t* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint32_t read32(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint64_t accumulate(uint64_t acc, uint64_t input) {
+    acc += input * c_prime2;
+    acc = rotl(acc, 31);
+    return acc * c_prime1;
+}
+
+inline uint64_t mergeRound(uint64_t acc, uint64_t value) {
+    acc ^= accumulate(0, value);
+    return acc * c_prime1 + c_prime4;
+}
+
+}  // namespace
+
+uint64_t PCSX::XXHash::hash64(const void* data, size_t size, uint64_t seed) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+    const uint8_t* const end = p + size;
+    uint64_t h;
+
+    if (size >= 32) {
+        uint64_t v1 = seed + c_prime1 + c_prime2;
+        uint64_t v2 = seed + c_prime2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - c_prime1;
+        const uint8_t* const limit = end - 32;
+        do {
+            v1 = accumulate(v1, read64(p));
+            v2 = accumulate(v2, read64(p + 8));
+            v3 = accumulate(v3, read64(p + 16));
+            v4 = accumulate(v4, read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+        h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        h = mergeRound(h, v1);
+        h = mergeRound(h, v2);
+        h = mergeRound(h, v3);
+        h = mergeRound(h, v4);
+    } else {
+        h = seed + c_prime5;
+    }
+    h += size;
+
+    while ((end - p) >= 8) {
+        h ^= accumulate(0, read64(p));
+        h = rotl(h, 27) * c_prime1 + c_prime4;
+        p += 8;
+    }
+    if ((end - p) >= 4) {
+        h ^= uint64_t(read32(p)) * c_prime1;
+        h = rotl(h, 23) * c_prime2 + c_prime3;
+        p += 4;
+    }
+    while (p < end) {
+        h ^= *p++ * c_prime5;
+        h = rotl(h, 11) * c_prime1;
+    }
+
+    h ^= h >> 33;
+    h *= c_prime2;
+    h ^= h >> 29;
+    h *= c_prime3;
+    h ^= h >> 32;
+    return h;
+}
@@ -77,3 +77,5 @@ uint16_t PCSX::IEC60908b::subqCRC(const uint8_t* d, int len) {
 }
 
 void PCSX::IEC60908b::computeEDCECC(uint8_t* sector) { compute_edcecc(sector); }
+
+void PCSX::IEC60908b::computeECC(uint8_t* sector) { compute_ecc(sector); }
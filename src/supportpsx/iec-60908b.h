@@ -154,6 +154,9 @@ struct MSF {
 // Compute the EDC and ECC for a mode2 sector.
 void computeEDCECC(uint8_t *sector);
 
+// Compute only the ECC of a sector, over its header as-is.
+void computeECC(uint8_t *sector);
+
 // Compute the CRC-16 for the SubQ channel.
 uint16_t subqCRC(const uint8_t *d, int len = 10);
 
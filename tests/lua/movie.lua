@@ -0,0 +1,96 @@
+--   Copyright (C) 2025 PCSX-Redux authors
+--
+--   This program is free software; you can redistribute it and/or modify
+--   it under the terms of the GNU General Public License as published by
+--   the Free Software Foundation; either version 2 of the License, or
+--   (at your option) any later version.
+--
+--   This program is distributed in the hope that it will be useful,
+--   but WITHOUT ANY WARRANTY; without even the implied warranty of
+--   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+--   GNU General Public License for more details.
+--
+--   You should have received a copy of the GNU General Public License
+--   along with this program; if not, write to the
+--   Free Software Foundation, Inc.,
+--   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+local lu = require 'luaunit'
+
+TestMovie = {}
+
+local moviePath = 'test-movie.pcsxmov'
+-- The hashes are recorded every 60 frames.
+local frames = 120
+
+-- Runs the emulation until something pauses it, at the latest after
+-- maxFrames frames. The onFrame callback gets called after the movie
+-- is done with each frame.
+local function run(maxFrames, onFrame)
+    local testCoroutine = coroutine.running()
+    local count = 0
+    local vsync = PCSX.Events.createEventListener('GPU::Vsync', function()
+        count = count + 1
+        if onFrame then onFrame(count) end
+        if count == maxFrames then PCSX.pauseEmulator() end
+    end)
+    local pause = PCSX.Events.createEventListener('ExecutionFlow::Pause', function()
+        PCSX.nextTick(function() coroutine.resume(testCoroutine) end)
+    end)
+    PCSX.resumeEmulator()
+    coroutine.yield()
+    vsync:remove()
+    pause:remove()
+    return count
+end
+
+local function record()
+    lu.assertTrue(PCSX.Movie.record(moviePath))
+    run(frames)
+    PCSX.Movie.stop()
+    lu.assertEquals(PCSX.Movie.frame(), frames)
+end
+
+function TestMovie:tearDown()
+    PCSX.Movie.stop()
+    os.remove(moviePath)
+end
+
+function TestMovie:test_roundtrip()
+    record()
+    lu.assertTrue(PCSX.Movie.play(moviePath))
+    lu.assertTrue(PCSX.Movie.isPlaying())
+    -- The playback pauses the emulation by itself once done.
+    lu.assertEquals(run(frames + 10), frames)
+    lu.assertFalse(PCSX.Movie.isPlaying())
+    lu.assertEquals(PCSX.Movie.frame(), frames)
+    lu.assertNil(PCSX.Movie.desyncFrame())
+end
+
+function TestMovie:test_hashMismatch()
+    record()
+    lu.assertTrue(PCSX.Movie.play(moviePath))
+    local mem = PCSX.getMemPtr()
+    run(frames + 10, function(frame)
+        -- Right before the first hash gets checked.
+        if frame == 59 then mem[0x100000] = bit.bxor(mem[0x100000], 0xff) end
+    end)
+    lu.assertFalse(PCSX.Movie.isPlaying())
+    lu.assertEquals(PCSX.Movie.desyncFrame(), 60)
+end
+
+function TestMovie:test_truncated()
+    record()
+    local file = io.open(moviePath, 'rb')
+    local data = file:read('*a')
+    file:close()
+    -- Cuts the last hash token short.
+    file = io.open(moviePath, 'wb')
+    file:write(data:sub(1, #data - 3))
+    file:close()
+
+    lu.assertTrue(PCSX.Movie.play(moviePath))
+    lu.assertEquals(run(frames + 10), frames)
+    lu.assertFalse(PCSX.Movie.isPlaying())
+    lu.assertEquals(PCSX.Movie.desyncFrame(), frames)
+end
@@ -0,0 +1,181 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <stdint.h>
+#include <zlib.h>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "core/arguments.h"
+#include "core/gpu.h"
+#include "core/psxemulator.h"
+#include "core/psxmem.h"
+#include "core/r3000a.h"
+#include "core/system.h"
+#include "flags.h"
+#include "gtest/gtest.h"
+#include "spu/interface.h"
+#include "support/eventbus.h"
+#include "support/uvfile.h"
+
+namespace {
+
+// The emulators only need the system for the arguments and the logs.
+class HostSystem final : public PCSX::System {
+  public:
+    HostSystem() : m_commandLine(1, m_argv), m_args(m_commandLine) {
+        setHeadless();
+        PCSX::g_system = this;
+    }
+    ~HostSystem() { PCSX::g_system = nullptr; }
+
+    void softReset() override {}
+    void hardReset() override {}
+    void biosPutc(int c) override {}
+    const PCSX::Arguments& getArgs() const override { return m_args; }
+    void printf(std::string&&) override {}
+    void log(PCSX::LogClass, std::string&&) override {}
+    void message(std::string&&) override {}
+    void luaMessage(const std::string&, bool error) override {}
+    void update(bool vsync = false) override {}
+    void close() override {}
+    void purgeAllEvents() override {}
+    void testQuit(int code) override {}
+
+  private:
+    char m_arg0[11] = "pcsx-redux";
+    char* m_argv[2] = {m_arg0, nullptr};
+    const CommandLine::args m_commandLine;
+    PCSX::Arguments m_args;
+};
+
+std::filesystem::path findBios() {
+    auto path = std::filesystem::current_path();
+    while (true) {
+        auto bios = path / "src" / "mips" / "openbios" / "openbios.bin";
+        if (std::filesystem::exists(bios)) return bios;
+        if (path.parent_path() == path) return {};
+        path = path.parent_path();
+    }
+}
+
+// Where an emulation ended up after running for a while.
+struct Outcome {
+    uint32_t ramCRC = 0;
+    uint32_t pc = 0;
+    uint64_t cycle = 0;
+    unsigned vsyncs = 0;
+};
+
+// A headless emulator booting the OpenBIOS, with a bus of its own.
+class Machine {
+  public:
+    Machine(const std::filesystem::path& bios, bool dynarec)
+        : m_emulator(new PCSX::Emulator(std::make_shared<PCSX::EventBus::EventBus>())) {
+        PCSX::Emulator::Binding binding(m_emulator.get());
+        auto& settings = m_emulator->settings;
+        settings.get<PCSX::Emulator::SettingBios>().value = bios;
+        settings.get<PCSX::Emulator::SettingDynarec>().value = dynarec;
+        m_emulator->m_spu->init();
+        m_initialized = m_emulator->init() == 0;
+        if (!m_initialized) return;
+        m_emulator->m_gpu->init(nullptr);
+        m_emulator->reset();
+    }
+    ~Machine() {
+        PCSX::Emulator::Binding binding(m_emulator.get());
+        if (m_initialized) {
+            m_emulator->m_gpu->shutdown();
+            m_emulator->shutdown();
+        }
+        m_emulator.reset();
+    }
+    bool initialized() const { return m_initialized; }
+
+    // Runs the CPU on the calling thread until the emulator pauses itself
+    // after that many frames.
+    Outcome run(unsigned frames) {
+        PCSX::Emulator::Binding binding(m_emulator.get());
+        Outcome outcome;
+        PCSX::EventBus::Listener listener(m_emulator->m_eventBus);
+        listener.listen<PCSX::Events::GPU::VSync>([this, &outcome, frames](const auto& event) {
+            if (++outcome.vsyncs == frames) m_emulator->pause();
+        });
+        m_emulator->resume();
+        while (m_emulator->running()) m_emulator->m_cpu->Execute();
+
+        const auto& regs = m_emulator->m_cpu->m_regs;
+        outcome.ramCRC = crc32(crc32(0L, Z_NULL, 0), m_emulator->m_mem->m_wram, m_emulator->getRamMask() + 1);
+        outcome.pc = regs.pc;
+        outcome.cycle = regs.cycle;
+        return outcome;
+    }
+
+  private:
+    std::unique_ptr<PCSX::Emulator> m_emulator;
+    bool m_initialized = false;
+};
+
+// The emulation is deterministic, so each emulator has to end up exactly
+// where it does when running alone, even with the other one running at the
+// same time on another thread. Any state they share, or one of them pausing
+// the other, would show up as a difference.
+void runConcurrently(bool dynarec) {
+    PCSX::UvThreadOp::UvThread uvThread;
+    HostSystem system;
+    const auto bios = findBios();
+    ASSERT_FALSE(bios.empty());
+
+    static constexpr unsigned c_frames[2] = {60, 90};
+    Outcome expected[2];
+    for (unsigned i = 0; i < 2; i++) {
+        Machine machine(bios, dynarec);
+        ASSERT_TRUE(machine.initialized());
+        expected[i] = machine.run(c_frames[i]);
+        EXPECT_EQ(expected[i].vsyncs, c_frames[i]);
+    }
+    EXPECT_NE(expected[0].cycle, expected[1].cycle);
+    EXPECT_EQ(PCSX::g_emulator, nullptr);
+
+    std::unique_ptr<Machine> machines[2];
+    for (auto& machine : machines) {
+        machine.reset(new Machine(bios, dynarec));
+        ASSERT_TRUE(machine->initialized());
+    }
+    Outcome outcomes[2];
+    auto run = [&machines, &outcomes](unsigned index) { outcomes[index] = machines[index]->run(c_frames[index]); };
+    std::thread threads[2] = {std::thread(run, 0), std::thread(run, 1)};
+    for (auto& thread : threads) thread.join();
+
+    for (unsigned i = 0; i < 2; i++) {
+        EXPECT_EQ(outcomes[i].vsyncs, expected[i].vsyncs);
+        EXPECT_EQ(outcomes[i].cycle, expected[i].cycle);
+        EXPECT_EQ(outcomes[i].pc, expected[i].pc);
+        EXPECT_EQ(outcomes[i].ramCRC, expected[i].ramCRC);
+    }
+    EXPECT_EQ(PCSX::g_emulator, nullptr);
+}
+
+}  // namespace
+
+TEST(Emulators, Interpreter) { runConcurrently(false); }
+TEST(Emulators, Dynarec) { runConcurrently(true); }
@@ -68,3 +68,5 @@ TEST(LuaFile, Interpreter) { EXPECT_EQ(runLuaIntTest("tests.lua.file"), 0); }
 TEST(LuaFile, Dynarec) { EXPECT_EQ(runLuaDynTest("tests.lua.file"), 0); }
 TEST(LuaAdpcm, Interpreter) { EXPECT_EQ(runLuaIntTest("tests.lua.adpcm"), 0); }
 TEST(LuaAdpcm, Dynarec) { EXPECT_EQ(runLuaDynTest("tests.lua.adpcm"), 0); }
+TEST(LuaMovie, Interpreter) { EXPECT_EQ(runLuaIntTest("tests.lua.movie"), 0); }
+TEST(LuaMovie, Dynarec) { EXPECT_EQ(runLuaDynTest("tests.lua.movie"), 0); }
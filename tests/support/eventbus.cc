@@ -0,0 +1,113 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "support/eventbus.h"
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace PCSX;
+
+namespace {
+
+struct EventA {
+    int value;
+};
+
+struct EventB {
+    std::string value;
+};
+
+}  // namespace
+
+TEST(EventBus, Signal) {
+    auto bus = std::make_shared<EventBus::EventBus>();
+    int sumA = 0;
+    std::string concatB;
+    {
+        EventBus::Listener listener(bus);
+        listener.listen<EventA>([&sumA](const auto& event) { sumA += event.value; });
+        listener.listen<EventA>([&sumA](const auto& event) { sumA += event.value * 10; });
+        listener.listen<EventB>([&concatB](const auto& event) { concatB += event.value; });
+        bus->signal(EventA{1});
+        bus->signal(EventB{"foo"});
+        bus->signal(EventA{2});
+        EXPECT_EQ(sumA, 33);
+        EXPECT_EQ(concatB, "foo");
+    }
+    bus->signal(EventA{4});
+    bus->signal(EventB{"bar"});
+    EXPECT_EQ(sumA, 33);
+    EXPECT_EQ(concatB, "foo");
+}
+
+TEST(EventBus, NoListeners) {
+    auto bus = std::make_shared<EventBus::EventBus>();
+    bus->signal(EventA{1});
+    bus->post(EventA{1});
+    bus->deliverPosted();
+}
+
+TEST(EventBus, PostedOrder) {
+    auto bus = std::make_shared<EventBus::EventBus>();
+    EventBus::Listener listener(bus);
+    std::vector<std::string> received;
+    listener.listen<EventA>([&](const auto& event) {
+        received.push_back(std::to_string(event.value));
+        // Posted while delivering: waits for the next delivery.
+        if (event.value == 1) bus->post(EventA{3});
+    });
+    listener.listen<EventB>([&](const auto& event) { received.push_back(event.value); });
+    bus->post(EventA{1});
+    bus->post(EventB{"x"});
+    bus->post(EventA{2});
+    EXPECT_TRUE(received.empty());
+    bus->deliverPosted();
+    EXPECT_EQ(received, (std::vector<std::string>{"1", "x", "2"}));
+    bus->deliverPosted();
+    EXPECT_EQ(received, (std::vector<std::string>{"1", "x", "2", "3"}));
+    bus->deliverPosted();
+    EXPECT_EQ(received.size(), 4);
+}
+
+TEST(EventBus, PostFromThreads) {
+    auto bus = std::make_shared<EventBus::EventBus>();
+    EventBus::Listener listener(bus);
+    int sum = 0;
+    int count = 0;
+    listener.listen<EventA>([&](const auto& event) {
+        sum += event.value;
+        count++;
+    });
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([bus]() {
+            for (int i = 1; i <= 1000; i++) bus->post(EventA{i});
+        });
+    }
+    while (count < 4000) bus->deliverPosted();
+    for (auto& thread : threads) thread.join();
+    bus->deliverPosted();
+    EXPECT_EQ(count, 4000);
+    EXPECT_EQ(sum, 4 * 500500);
+}
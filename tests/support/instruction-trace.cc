@@ -0,0 +1,141 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "support/instruction-trace.h"
+
+#include <string.h>
+
+#include <filesystem>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace PCSX;
+
+namespace {
+
+struct Step {
+    uint64_t cycle;
+    uint32_t pc;
+    uint32_t code;
+    uint32_t regs[InstructionTrace::c_registerCount];
+    std::vector<InstructionTrace::MemoryAccess> accesses;
+};
+
+std::vector<Step> makeSteps(unsigned count) {
+    std::vector<Step> steps(count);
+    uint32_t state = 1;
+    uint64_t cycle = 100;
+    uint32_t pc = 0x80010000;
+    uint32_t regs[InstructionTrace::c_registerCount] = {};
+    for (auto& step : steps) {
+        state = state * 1103515245 + 12345;
+        cycle += 2 + (state >> 30);
+        pc = (state & 0x100) ? 0x80020000 + (state & 0xfffc) : pc + 4;
+        regs[1 + (state >> 27) % 31] = state;
+        if (state & 0x200) regs[32] ^= state << 3;
+        step.cycle = cycle;
+        step.pc = pc;
+        step.code = state ^ 0x12345678;
+        memcpy(step.regs, regs, sizeof(regs));
+        if (state & 0x400) step.accesses.push_back({0x80100000 + (state & 0xffc), state, 4, true});
+        if (state & 0x800) step.accesses.push_back({0x1f801070, 0, 2, false});
+    }
+    return steps;
+}
+
+}  // namespace
+
+TEST(InstructionTrace, RoundTrip) {
+    auto path = std::filesystem::temp_directory_path() / "pcsx-instruction-trace-test.bin";
+    auto steps = makeSteps(InstructionTrace::c_chunkRecords * 2 + 1000);
+    uint32_t initial[InstructionTrace::c_registerCount] = {};
+    {
+        InstructionTrace::Writer writer;
+        ASSERT_TRUE(writer.open(path, initial));
+        for (auto& step : steps) {
+            writer.begin(step.cycle, step.pc, step.code);
+            for (auto& access : step.accesses) writer.access(access.address, access.size, access.value, access.write);
+            writer.end(step.regs);
+        }
+        writer.close();
+        EXPECT_FALSE(writer.failed());
+        EXPECT_EQ(writer.count(), steps.size());
+    }
+
+    InstructionTrace::Reader reader;
+    ASSERT_TRUE(reader.open(path));
+    EXPECT_EQ(reader.count(), steps.size());
+    EXPECT_EQ(reader.chunks().size(), 3);
+
+    uint64_t expected = InstructionTrace::c_chunkRecords - 10;
+    EXPECT_TRUE(reader.read(expected, 20000, [&](const InstructionTrace::Record& record) {
+        const auto& step = steps[expected];
+        EXPECT_EQ(record.index, expected);
+        EXPECT_EQ(record.cycle, step.cycle);
+        EXPECT_EQ(record.pc, step.pc);
+        EXPECT_EQ(record.code, step.code);
+        EXPECT_EQ(memcmp(record.regs, step.regs, sizeof(step.regs)), 0);
+        EXPECT_EQ(record.accessCount, step.accesses.size());
+        for (unsigned i = 0; i < record.accessCount; i++) {
+            EXPECT_EQ(record.accesses[i].address, step.accesses[i].address);
+            EXPECT_EQ(record.accesses[i].size, step.accesses[i].size);
+            EXPECT_EQ(record.accesses[i].write, step.accesses[i].write);
+            if (record.accesses[i].write) EXPECT_EQ(record.accesses[i].value, step.accesses[i].value);
+        }
+        expected++;
+        return true;
+    }));
+    EXPECT_EQ(expected, InstructionTrace::c_chunkRecords - 10 + 20000);
+
+    auto found = reader.findCycle(steps[100000].cycle);
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ(found.value(), 100000);
+    std::filesystem::remove(path);
+}
+
+TEST(InstructionTrace, MissingIndex) {
+    auto path = std::filesystem::temp_directory_path() / "pcsx-instruction-trace-noindex.bin";
+    auto steps = makeSteps(InstructionTrace::c_chunkRecords + 5);
+    uint32_t initial[InstructionTrace::c_registerCount] = {};
+    {
+        InstructionTrace::Writer writer;
+        ASSERT_TRUE(writer.open(path, initial));
+        for (auto& step : steps) {
+            writer.begin(step.cycle, step.pc, step.code);
+            writer.end(step.regs);
+        }
+        writer.close();
+    }
+    // Chop off the index, and half of the last chunk.
+    const auto size = std::filesystem::file_size(path);
+    std::filesystem::resize_file(path, size - 28 * 2 - 20 - 20);
+
+    InstructionTrace::Reader reader;
+    ASSERT_TRUE(reader.open(path));
+    EXPECT_EQ(reader.count(), InstructionTrace::c_chunkRecords);
+    uint64_t count = 0;
+    EXPECT_TRUE(reader.read(0, reader.count(), [&](const InstructionTrace::Record& record) {
+        EXPECT_EQ(record.pc, steps[record.index].pc);
+        count++;
+        return true;
+    }));
+    EXPECT_EQ(count, InstructionTrace::c_chunkRecords);
+    std::filesystem::remove(path);
+}
@@ -118,6 +118,21 @@ TEST(AdvancedList, MoveElement) {
     list.destroyAll();
 }
 
+TEST(AdvancedList, MoveFrontElement) {
+    ListType list;
+    list.push_back(new ListElement(1));
+    list.push_back(new ListElement(2));
+
+    list.push_front(&*list.begin());
+    EXPECT_EQ(list.size(), 2);
+    auto i = list.begin();
+    EXPECT_EQ(i->m_tag, 1);
+    i++;
+    EXPECT_EQ(i->m_tag, 2);
+    EXPECT_TRUE(++i == list.end());
+    list.destroyAll();
+}
+
 TEST(AdvancedList, TwoListsExclusive) {
     ListType list1;
     ListType list2;
@@ -0,0 +1,109 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "support/protobuf.h"
+
+#include <string.h>
+
+#include <string>
+#include <string_view>
+
+#include "gtest/gtest.h"
+#include "support/typestring-wrapper.h"
+
+using namespace PCSX;
+
+typedef Protobuf::Field<Protobuf::UInt32, TYPESTRING("number"), 1> Number;
+typedef Protobuf::Message<TYPESTRING("Simple"), Number> Simple;
+
+typedef Protobuf::Field<Protobuf::String, TYPESTRING("name"), 1> Name;
+typedef Protobuf::Field<Protobuf::SInt32, TYPESTRING("delta"), 2> Delta;
+typedef Protobuf::Message<TYPESTRING("Inner"), Name, Delta> Inner;
+typedef Protobuf::MessageField<Inner, TYPESTRING("inner"), 1> InnerField;
+typedef Protobuf::RepeatedVariableField<Inner, TYPESTRING("inners"), 2> Inners;
+typedef Protobuf::RepeatedFieldRef<Protobuf::UInt32, 4, TYPESTRING("registers"), 3> Registers;
+typedef Protobuf::FieldPtr<Protobuf::FixedBytes<4096>, TYPESTRING("memory"), 4> Memory;
+typedef Protobuf::Field<Protobuf::FixedBytes<16>, TYPESTRING("scratch"), 5> Scratch;
+typedef Protobuf::Field<Protobuf::Double, TYPESTRING("ratio"), 6> Ratio;
+typedef Protobuf::Message<TYPESTRING("Outer"), InnerField, Inners, Registers, Memory, Scratch, Ratio> Outer;
+
+TEST(Protobuf, VarIntWireFormat) {
+    Simple simple;
+    simple.get<Number>().value = 150;
+    EXPECT_EQ(simple.serializedSize(), 3);
+    Protobuf::OutSlice slice;
+    simple.serialize(&slice);
+    EXPECT_EQ(slice.finalize(), std::string("\x08\x96\x01", 3));
+}
+
+TEST(Protobuf, SerializedSizeIsExact) {
+    uint32_t registers[4] = {0, 127, 128, 0xffffffff};
+    uint8_t memory[4096];
+    for (unsigned i = 0; i < sizeof(memory); i++) memory[i] = i * 7;
+    Outer outer{InnerField{}, Inners{}, Registers{registers}, Memory{memory}, Scratch{}, Ratio{}};
+    outer.get<InnerField>().get<Name>().value = std::string(300, 'x');
+    outer.get<InnerField>().get<Delta>().value = -64;
+    for (int i = 0; i < 3; i++) {
+        Inner inner;
+        inner.get<Name>().value = std::to_string(i);
+        inner.get<Delta>().value = -i * 1000;
+        outer.get<Inners>().value.push_back(inner);
+    }
+    outer.get<Scratch>().reset();
+    outer.get<Ratio>().value = 0.5;
+
+    Protobuf::OutSlice slice;
+    slice.reserve(outer.serializedSize());
+    outer.serialize(&slice);
+    std::string data = slice.finalize();
+    EXPECT_EQ(data.size(), outer.serializedSize());
+
+    uint32_t loadedRegisters[4] = {};
+    uint8_t loadedMemory[4096] = {};
+    Outer loaded{InnerField{}, Inners{}, Registers{loadedRegisters}, Memory{loadedMemory}, Scratch{}, Ratio{}};
+    Protobuf::InSlice inSlice(reinterpret_cast<const uint8_t *>(data.data()), data.size());
+    loaded.deserialize(&inSlice, 0);
+    // Pointer fields are only written to on commit.
+    EXPECT_EQ(loadedMemory[1], 0);
+    loaded.commit();
+
+    EXPECT_EQ(loaded.get<InnerField>().get<Name>().value, std::string(300, 'x'));
+    EXPECT_EQ(loaded.get<InnerField>().get<Delta>().value, -64);
+    ASSERT_EQ(loaded.get<Inners>().value.size(), 3);
+    EXPECT_EQ(loaded.get<Inners>().value[2].get<Name>().value, "2");
+    EXPECT_EQ(loaded.get<Inners>().value[2].get<Delta>().value, -2000);
+    EXPECT_EQ(memcmp(loadedRegisters, registers, sizeof(registers)), 0);
+    EXPECT_EQ(memcmp(loadedMemory, memory, sizeof(memory)), 0);
+    EXPECT_EQ(loaded.get<Ratio>().value, 0.5);
+}
+
+TEST(Protobuf, ShortBlobIsZeroPadded) {
+    typedef Protobuf::FieldPtr<Protobuf::FixedBytes<8>, TYPESTRING("blob"), 1> Blob;
+    typedef Protobuf::Message<TYPESTRING("Blobs"), Blob> Blobs;
+    uint8_t blob[8];
+    memset(blob, 0xff, sizeof(blob));
+    Blobs blobs{Blob{blob}};
+    // Field 1, length delimited, 3 bytes.
+    static constexpr uint8_t data[] = {0x0a, 0x03, 1, 2, 3};
+    Protobuf::InSlice slice(data, sizeof(data));
+    blobs.deserialize(&slice, 0);
+    blobs.commit();
+    static constexpr uint8_t expected[8] = {1, 2, 3, 0, 0, 0, 0, 0};
+    EXPECT_EQ(memcmp(blob, expected, sizeof(expected)), 0);
+}
@@ -0,0 +1,109 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "support/xordelta.h"
+
+#include <string.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace PCSX;
+
+namespace {
+
+std::vector<uint8_t> makeData(size_t size, unsigned seed) {
+    std::vector<uint8_t> data(size);
+    uint32_t state = seed;
+    for (auto& b : data) {
+        state = state * 1103515245 + 12345;
+        b = state >> 24;
+    }
+    return data;
+}
+
+std::vector<uint8_t> roundTrip(const std::vector<uint8_t>& data, const std::vector<uint8_t>& reference,
+                               size_t* encodedSize = nullptr) {
+    std::vector<uint8_t> encoded;
+    XorDelta::encode(data.data(), data.size(), reference.data(), reference.size(), encoded);
+    if (encodedSize) *encodedSize = encoded.size();
+    std::vector<uint8_t> decoded(data.size());
+    const uint8_t* in = encoded.data();
+    EXPECT_TRUE(XorDelta::decode(in, encoded.data() + encoded.size(), decoded.data(), decoded.size(),
+                                 reference.data(), reference.size()));
+    EXPECT_EQ(in, encoded.data() + encoded.size());
+    return decoded;
+}
+
+}  // namespace
+
+TEST(XorDelta, NoReference) {
+    auto data = makeData(20000, 1);
+    memset(data.data() + 100, 0, 5000);
+    memset(data.data() + 9000, 0xff, 3000);
+    size_t encodedSize;
+    EXPECT_EQ(roundTrip(data, {}, &encodedSize), data);
+    EXPECT_LT(encodedSize, data.size() - 7000);
+}
+
+TEST(XorDelta, SparseChanges) {
+    auto reference = makeData(1024 * 1024, 2);
+    auto data = reference;
+    data[5] ^= 1;
+    data[300000] = 42;
+    memset(data.data() + 500000, 0x55, 100);
+    size_t encodedSize;
+    EXPECT_EQ(roundTrip(data, reference, &encodedSize), data);
+    EXPECT_LT(encodedSize, 128);
+}
+
+TEST(XorDelta, SizeMismatch) {
+    auto reference = makeData(10000, 3);
+    auto longer = makeData(15000, 3);
+    EXPECT_EQ(roundTrip(longer, reference), longer);
+    auto shorter = makeData(5000, 3);
+    EXPECT_EQ(roundTrip(shorter, reference), shorter);
+}
+
+TEST(XorDelta, Concatenation) {
+    auto a = makeData(3000, 4);
+    auto b = makeData(7000, 5);
+    std::vector<uint8_t> encoded;
+    XorDelta::encode(a.data(), a.size(), nullptr, 0, encoded);
+    XorDelta::encode(b.data(), b.size(), a.data(), a.size(), encoded);
+    std::vector<uint8_t> decodedA(a.size()), decodedB(b.size());
+    const uint8_t* in = encoded.data();
+    const uint8_t* end = encoded.data() + encoded.size();
+    EXPECT_TRUE(XorDelta::decode(in, end, decodedA.data(), decodedA.size(), nullptr, 0));
+    EXPECT_TRUE(XorDelta::decode(in, end, decodedB.data(), decodedB.size(), a.data(), a.size()));
+    EXPECT_EQ(in, end);
+    EXPECT_EQ(decodedA, a);
+    EXPECT_EQ(decodedB, b);
+}
+
+TEST(XorDelta, Truncated) {
+    auto data = makeData(10000, 6);
+    std::vector<uint8_t> encoded;
+    XorDelta::encode(data.data(), data.size(), nullptr, 0, encoded);
+    encoded.resize(encoded.size() / 2);
+    std::vector<uint8_t> decoded(data.size());
+    const uint8_t* in = encoded.data();
+    EXPECT_FALSE(XorDelta::decode(in, encoded.data() + encoded.size(), decoded.data(), decoded.size(), nullptr, 0));
+}
@@ -0,0 +1,60 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "support/xxhash.h"
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace PCSX;
+
+namespace {
+
+std::vector<uint8_t> makeData() {
+    std::vector<uint8_t> data(4096);
+    for (size_t i = 0; i < data.size(); i++) data[i] = i * 7 + 3;
+    return data;
+}
+
+}  // namespace
+
+TEST(XXHash, Empty) { EXPECT_EQ(XXHash::hash64("", 0), 0xef46db3751d8e999ULL); }
+
+TEST(XXHash, SingleByte) { EXPECT_EQ(XXHash::hash64("a", 1), 0xd24ec4f1a98c6e5bULL); }
+
+// Covers each of the tail paths, with and without the 32 bytes stripes.
+TEST(XXHash, Lengths) {
+    static constexpr struct {
+        size_t size;
+        uint64_t hash;
+    } c_expected[] = {
+        {0, 0x6e01c0317d5c53d0ULL},   {1, 0xf0e5a9efb6ffa77aULL},  {3, 0x6eff9567adea527eULL},
+        {4, 0xf9ec1e8d5a515194ULL},   {7, 0x47a3c908c07b52bfULL},  {8, 0x5b1325783b26d5b2ULL},
+        {31, 0x8be368b26863e7fcULL},  {32, 0xda916a2278bf4cd2ULL}, {33, 0x6a779c2c5c26cadbULL},
+        {63, 0xf026ae8464b25737ULL},  {64, 0xe15dd2bb4da6c7bfULL}, {100, 0x9c7c53d78f060efdULL},
+        {4096, 0xffa7233047904d4fULL},
+    };
+    auto data = makeData();
+    for (auto& expected : c_expected) {
+        EXPECT_EQ(XXHash::hash64(data.data(), expected.size, 0x1234), expected.hash) << expected.size;
+    }
+}
@@ -28,61 +28,9 @@ SOFTWARE.
 
 #include "tables.h"
 
-void compute_edcecc(uint8_t* sector) {
-    sector += 12;
-    uint8_t* location = sector;
-    sector += 3;
-    uint8_t mode = *sector++;
-
-    if (mode != 2) return;
-
-    uint8_t* subheader = sector;
-    // form1 or form2?
-    unsigned form = subheader[2] & 0x20 ? 2 : 1;
-    // in addition to user data, we're also computing the edc over
-    // the subheader, which is 8 bytes long
-    unsigned len = ((form == 2) ? 2324 : 2048) + 8;
-
-    // advancing at the location of the EDC
-    uint8_t* edc_data = subheader;
-    uint8_t* edc_ptr = edc_data + len;
-
-    uint32_t edc = 0;
+static void compute_pq(uint8_t* ecc_data) {
     unsigned i, j;
 
-    // this is the typical CRC32 formula, simply using the special
-    // crc32 lookup table as specified by the yellow book
-    for (i = 0; i < len; i++) {
-        edc = yellow_book_crctable[(edc ^ *edc_data++) & 0xff] ^ (edc >> 8);
-    }
-
-    // done, write the edc
-    *edc_ptr++ = edc & 0xff;
-    edc >>= 8;
-    *edc_ptr++ = edc & 0xff;
-    edc >>= 8;
-    *edc_ptr++ = edc & 0xff;
-    edc >>= 8;
-    *edc_ptr++ = edc & 0xff;
-
-    // if the sector was form 2, then that's all we had to do
-    // the edc doesn't cover the ecc, so this can be done in this order
-    if (form == 2) return;
-
-    // otherwise, we need to compute ECC's P and Q too
-    uint8_t* ecc_data = location;
-
-    // the fucked up part about MODE2 FORM1 ECC is that it needs to have
-    // the location fields to be zeroes to work; luckily, we can rebuild it
-    uint8_t actualLocation[3];
-    actualLocation[0] = location[0];
-    actualLocation[1] = location[1];
-    actualLocation[2] = location[2];
-    location[0] = 0;
-    location[1] = 0;
-    location[2] = 0;
-    location[3] = 0;
-
     // for our P and Q ECC channels, Q is covering P, so we need to compute
     // P first, then Q, in order to have a consistent ECC overall
 
@@ -251,6 +199,64 @@ void compute_edcecc(uint8_t* sector) {
         ecc >>= 8;
         ecc_data[44 * 26 * 2 + i] = ecc & 0xff;
     }
+}
+
+void compute_edcecc(uint8_t* sector) {
+    sector += 12;
+    uint8_t* location = sector;
+    sector += 3;
+    uint8_t mode = *sector++;
+
+    if (mode != 2) return;
+
+    uint8_t* subheader = sector;
+    // form1 or form2?
+    unsigned form = subheader[2] & 0x20 ? 2 : 1;
+    // in addition to user data, we're also computing the edc over
+    // the subheader, which is 8 bytes long
+    unsigned len = ((form == 2) ? 2324 : 2048) + 8;
+
+    // advancing at the location of the EDC
+    uint8_t* edc_data = subheader;
+    uint8_t* edc_ptr = edc_data + len;
+
+    uint32_t edc = 0;
+    unsigned i;
+
+    // this is the typical CRC32 formula, simply using the special
+    // crc32 lookup table as specified by the yellow book
+    for (i = 0; i < len; i++) {
+        edc = yellow_book_crctable[(edc ^ *edc_data++) & 0xff] ^ (edc >> 8);
+    }
+
+    // done, write the edc
+    *edc_ptr++ = edc & 0xff;
+    edc >>= 8;
+    *edc_ptr++ = edc & 0xff;
+    edc >>= 8;
+    *edc_ptr++ = edc & 0xff;
+    edc >>= 8;
+    *edc_ptr++ = edc & 0xff;
+
+    // if the sector was form 2, then that's all we had to do
+    // the edc doesn't cover the ecc, so this can be done in this order
+    if (form == 2) return;
+
+    // otherwise, we need to compute ECC's P and Q too
+    uint8_t* ecc_data = location;
+
+    // the fucked up part about MODE2 FORM1 ECC is that it needs to have
+    // the location fields to be zeroes to work; luckily, we can rebuild it
+    uint8_t actualLocation[3];
+    actualLocation[0] = location[0];
+    actualLocation[1] = location[1];
+    actualLocation[2] = location[2];
+    location[0] = 0;
+    location[1] = 0;
+    location[2] = 0;
+    location[3] = 0;
+
+    compute_pq(ecc_data);
 
     // once all is done, we need to restore the location field as it was
     location[0] = actualLocation[0];
@@ -260,3 +266,5 @@ void compute_edcecc(uint8_t* sector) {
 
     // and we're all done now
 }
+
+void compute_ecc(uint8_t* sector) { compute_pq(sector + 12); }
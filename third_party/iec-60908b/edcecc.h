@@ -33,6 +33,8 @@ extern "C" {
 #endif
 
 void compute_edcecc(uint8_t* sector);
+// Only computes the ECC's P and Q, leaving the header as-is, such as for MODE1 sectors.
+void compute_ecc(uint8_t* sector);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,117 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <stdint.h>
+
+#include <string>
+
+#include "flags.h"
+#include "fmt/format.h"
+#include "support/instruction-trace.h"
+
+namespace {
+
+const char* const c_registerNames[PCSX::InstructionTrace::c_registerCount] = {
+    "r0", "at", "v0", "v1", "a0", "a1", "a2", "a3", "t0", "t1", "t2", "t3", "t4", "t5", "t6", "t7",
+    "s0", "s1", "s2", "s3", "s4", "s5", "s6", "s7", "t8", "t9", "k0", "k1", "gp", "sp", "s8", "ra",
+    "lo", "hi", "status", "cause", "epc",
+};
+
+void printRecord(const PCSX::InstructionTrace::Record& record) {
+    std::string line = fmt::format("{:>10} {:>12} {:08x}: {:08x}", record.index, record.cycle, record.pc, record.code);
+    for (unsigned i = 0; i < PCSX::InstructionTrace::c_registerCount; i++) {
+        if (record.changed & (uint64_t(1) << i)) line += fmt::format(" {}={:08x}", c_registerNames[i], record.regs[i]);
+    }
+    for (unsigned i = 0; i < record.accessCount; i++) {
+        auto& access = record.accesses[i];
+        if (access.write) {
+            line += fmt::format(" [{:08x}]{}<-{:x}", access.address, access.size * 8, access.value);
+        } else {
+            line += fmt::format(" [{:08x}]{}->", access.address, access.size * 8);
+        }
+    }
+    fmt::print("{}\n", line);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    CommandLine::args args(argc, argv);
+
+    auto inputs = args.positional();
+    const bool asksForHelp = args.get<bool>("h").value_or(false);
+    const bool oneInput = inputs.size() == 1;
+    if (asksForHelp || !oneInput) {
+        fmt::print(R"(
+trace-reader
+https://github.com/grumpycoders/pcsx-redux/tree/main/tools/trace-reader/
+
+Usage: {} input.trace [-h] [-summary] [-from index] [-cycle cycle] [-count count]
+  input.trace       mandatory: specify the instruction trace file.
+  -summary          only display the amount of records and the chunk index.
+  -from index       index of the first record to display, 0 by default.
+  -cycle cycle      start at the first record which ran at or after that cycle.
+  -count count      maximum amount of records to display, 100 by default.
+  -h                displays this help information and exit.
+
+Each record displays its index, cycle, pc, opcode, the registers it changed
+with their new values, and its memory accesses.
+)",
+                   argv[0]);
+        return -1;
+    }
+
+    auto& input = inputs[0];
+    PCSX::InstructionTrace::Reader reader;
+    if (!reader.open(input)) {
+        fmt::print("Unable to open trace file: {}\n", input);
+        return -1;
+    }
+
+    if (args.get<bool>("summary").value_or(false)) {
+        fmt::print("{} records in {} chunks\n", reader.count(), reader.chunks().size());
+        for (auto& chunk : reader.chunks()) {
+            fmt::print("  offset {:>12}: records {:>10} to {:>10}, from cycle {}\n", chunk.offset, chunk.firstIndex,
+                       chunk.firstIndex + chunk.count - 1, chunk.firstCycle);
+        }
+        return 0;
+    }
+
+    uint64_t first = args.get<uint64_t>("from").value_or(0);
+    auto cycle = args.get<uint64_t>("cycle");
+    if (cycle.has_value()) {
+        auto index = reader.findCycle(cycle.value());
+        if (!index.has_value()) {
+            fmt::print("No record at or after cycle {}\n", cycle.value());
+            return -1;
+        }
+        first = index.value();
+    }
+    const uint64_t count = args.get<uint64_t>("count").value_or(100);
+
+    if (!reader.read(first, count, [](const PCSX::InstructionTrace::Record& record) {
+            printRecord(record);
+            return true;
+        })) {
+        fmt::print("Trace file {} is corrupted.\n", input);
+        return -1;
+    }
+
+    return 0;
+}